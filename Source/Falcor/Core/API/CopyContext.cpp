@@ -142,6 +142,15 @@ CopyContext::ReadTextureTask::SharedPtr CopyContext::asyncReadTextureSubresource
     return CopyContext::ReadTextureTask::create(this, pTexture, subresourceIndex);
 }
 
+CopyContext::ReadTextureTask::SharedPtr CopyContext::asyncReadTextureSubresource(
+    const Texture* pTexture,
+    uint32_t subresourceIndex,
+    ref<Buffer> pReadbackBuffer
+)
+{
+    return CopyContext::ReadTextureTask::create(this, pTexture, subresourceIndex, std::move(pReadbackBuffer));
+}
+
 std::vector<uint8_t> CopyContext::readTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex)
 {
     CopyContext::ReadTextureTask::SharedPtr pTask = asyncReadTextureSubresource(pTexture, subresourceIndex);
@@ -317,30 +326,53 @@ void CopyContext::updateTextureSubresources(
     }
 }
 
+CopyContext::ReadTextureTask::Footprint CopyContext::ReadTextureTask::getFootprint(const Texture* pTexture, uint32_t subresourceIndex)
+{
+    gfx::ITextureResource* srcTexture = pTexture->getGfxTextureResource();
+    gfx::FormatInfo formatInfo;
+    gfx::gfxGetFormatInfo(srcTexture->getDesc()->format, &formatInfo);
+
+    auto mipLevel = pTexture->getSubresourceMipLevel(subresourceIndex);
+    Footprint footprint;
+    footprint.actualRowSize =
+        uint32_t((pTexture->getWidth(mipLevel) + formatInfo.blockWidth - 1) / formatInfo.blockWidth * formatInfo.blockSizeInBytes);
+    size_t rowAlignment = 1;
+    pTexture->getDevice()->getGfxDevice()->getTextureRowAlignment(&rowAlignment);
+    footprint.rowSize = align_to(static_cast<uint32_t>(rowAlignment), footprint.actualRowSize);
+    footprint.rowCount = (pTexture->getHeight(mipLevel) + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
+    footprint.depth = pTexture->getDepth(mipLevel);
+    return footprint;
+}
+
+uint64_t CopyContext::ReadTextureTask::getBufferSize(const Texture* pTexture, uint32_t subresourceIndex)
+{
+    Footprint footprint = getFootprint(pTexture, subresourceIndex);
+    return uint64_t(footprint.depth) * footprint.rowCount * footprint.rowSize;
+}
+
 CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(
     CopyContext* pCtx,
     const Texture* pTexture,
-    uint32_t subresourceIndex
+    uint32_t subresourceIndex,
+    ref<Buffer> pBuffer
 )
 {
     SharedPtr pThis = SharedPtr(new ReadTextureTask);
     pThis->mpContext = pCtx;
     // Get footprint
     gfx::ITextureResource* srcTexture = pTexture->getGfxTextureResource();
-    gfx::FormatInfo formatInfo;
-    gfx::gfxGetFormatInfo(srcTexture->getDesc()->format, &formatInfo);
-
     auto mipLevel = pTexture->getSubresourceMipLevel(subresourceIndex);
-    pThis->mActualRowSize =
-        uint32_t((pTexture->getWidth(mipLevel) + formatInfo.blockWidth - 1) / formatInfo.blockWidth * formatInfo.blockSizeInBytes);
-    size_t rowAlignment = 1;
-    pCtx->mpDevice->getGfxDevice()->getTextureRowAlignment(&rowAlignment);
-    pThis->mRowSize = align_to(static_cast<uint32_t>(rowAlignment), pThis->mActualRowSize);
-    uint64_t rowCount = (pTexture->getHeight(mipLevel) + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
-    uint64_t size = pTexture->getDepth(mipLevel) * rowCount * pThis->mRowSize;
-
-    // Create buffer
-    pThis->mpBuffer = pCtx->getDevice()->createBuffer(size, ResourceBindFlags::None, MemoryType::ReadBack, nullptr);
+    Footprint footprint = getFootprint(pTexture, subresourceIndex);
+    pThis->mActualRowSize = footprint.actualRowSize;
+    pThis->mRowSize = footprint.rowSize;
+    uint64_t rowCount = footprint.rowCount;
+    uint64_t size = footprint.depth * rowCount * footprint.rowSize;
+
+    // Create buffer unless the given one can be reused.
+    if (pBuffer && pBuffer->getSize() >= size && pBuffer->getMemoryType() == MemoryType::ReadBack)
+        pThis->mpBuffer = std::move(pBuffer);
+    else
+        pThis->mpBuffer = pCtx->getDevice()->createBuffer(size, ResourceBindFlags::None, MemoryType::ReadBack, nullptr);
 
     // Copy from texture to buffer
     pCtx->resourceBarrier(pTexture, Resource::State::CopySource);
@@ -400,6 +432,11 @@ void CopyContext::ReadTextureTask::getData(void* pData, size_t size) const
     mpBuffer->unmap();
 }
 
+bool CopyContext::ReadTextureTask::isReady() const
+{
+    return mpFence->getCurrentValue() >= mpFence->getSignaledValue();
+}
+
 std::vector<uint8_t> CopyContext::ReadTextureTask::getData() const
 {
     std::vector<uint8_t> result(size_t(mRowCount) * mActualRowSize * mDepth);
@@ -548,6 +585,39 @@ void CopyContext::updateBuffer(const Buffer* pBuffer, const void* pData, size_t
     mCommandsPending = true;
 }
 
+void CopyContext::updateBufferRegions(const Buffer* pBuffer, const void* pData, const std::vector<std::pair<size_t, size_t>>& regions)
+{
+    size_t totalSize = 0;
+    for (const auto& [offset, numBytes] : regions)
+    {
+        FALCOR_CHECK(offset + numBytes <= pBuffer->getSize(), "'offset' ({}) and 'size' ({}) don't fit the buffer size {}.", offset, numBytes, pBuffer->getSize());
+        totalSize += numBytes;
+    }
+    if (totalSize == 0)
+        return;
+
+    const auto& pUploadHeap = mpDevice->getUploadHeap();
+    auto allocation = pUploadHeap->allocate(totalSize);
+
+    bufferBarrier(pBuffer, Resource::State::CopyDest);
+    auto resourceEncoder = getLowLevelData()->getResourceCommandEncoder();
+
+    size_t stagingOffset = 0;
+    for (const auto& [offset, numBytes] : regions)
+    {
+        if (numBytes == 0)
+            continue;
+        std::memcpy(allocation.pData + stagingOffset, static_cast<const uint8_t*>(pData) + offset, numBytes);
+        resourceEncoder->copyBuffer(
+            pBuffer->getGfxBufferResource(), offset, allocation.gfxBufferResource, allocation.offset + stagingOffset, numBytes
+        );
+        stagingOffset += numBytes;
+    }
+
+    pUploadHeap->release(allocation);
+    mCommandsPending = true;
+}
+
 void CopyContext::readBuffer(const Buffer* pBuffer, void* pData, size_t offset, size_t numBytes)
 {
     if (numBytes == 0)
@@ -34,6 +34,7 @@
 #include "Core/Macros.h"
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #if FALCOR_HAS_CUDA
@@ -53,11 +54,30 @@ public:
     {
     public:
         using SharedPtr = std::shared_ptr<ReadTextureTask>;
-        static SharedPtr create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex);
+        static SharedPtr create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex, ref<Buffer> pBuffer = nullptr);
         void getData(void* pData, size_t size) const;
         std::vector<uint8_t> getData() const;
 
+        /// Returns true if the readback has finished on the GPU, i.e. getData() will not block.
+        bool isReady() const;
+
+        /// Get the readback buffer. It can be passed to a new task for reuse once the data has been read.
+        const ref<Buffer>& getBuffer() const { return mpBuffer; }
+
+        /// Get the size of the readback buffer for a subresource, including the row pitch alignment of the device.
+        static uint64_t getBufferSize(const Texture* pTexture, uint32_t subresourceIndex);
+
     private:
+        struct Footprint
+        {
+            uint32_t rowCount;
+            uint32_t rowSize;
+            uint32_t actualRowSize;
+            uint32_t depth;
+        };
+
+        static Footprint getFootprint(const Texture* pTexture, uint32_t subresourceIndex);
+
         ReadTextureTask() = default;
         ref<Fence> mpFence;
         ref<Buffer> mpBuffer;
@@ -198,6 +218,15 @@ public:
      */
     void updateBuffer(const Buffer* pBuffer, const void* pData, size_t offset = 0, size_t numBytes = 0);
 
+    /**
+     * Update multiple regions of a buffer.
+     * The data for all regions is staged in a single upload heap allocation and copied after a single barrier.
+     * @param[in] pBuffer The buffer to update.
+     * @param[in] pData Pointer to the source data. Each region is read at the same offset it is written to in the buffer.
+     * @param[in] regions List of regions given as pairs of byte offset and byte size.
+     */
+    void updateBufferRegions(const Buffer* pBuffer, const void* pData, const std::vector<std::pair<size_t, size_t>>& regions);
+
     void readBuffer(const Buffer* pBuffer, void* pData, size_t offset = 0, size_t numBytes = 0);
 
     template<typename T>
@@ -224,6 +253,14 @@ public:
      */
     ReadTextureTask::SharedPtr asyncReadTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex);
 
+    /**
+     * Read texture data asynchronously into an existing readback buffer.
+     * @param[in] pTexture The texture to read.
+     * @param[in] subresourceIndex The subresource index.
+     * @param[in] pReadbackBuffer Readback buffer to reuse, e.g. from a previous task. A new buffer is created if it is nullptr or too small.
+     */
+    ReadTextureTask::SharedPtr asyncReadTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex, ref<Buffer> pReadbackBuffer);
+
     /**
      * Get the low-level context data
      */
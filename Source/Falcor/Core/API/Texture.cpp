@@ -50,6 +50,35 @@ namespace
 {
 static constexpr bool kTopDown = true; // Memory layout when loading from file
 
+/**
+ * Hash decoded texel data. Processes 8 bytes per step as textures can be large, a byte-wise hash is too slow here.
+ */
+uint64_t hashTexelData(const void* pData, size_t size)
+{
+    const uint64_t kMul = UINT64_C(0x9e3779b97f4a7c15);
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+
+    uint64_t hash = size * kMul;
+    size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, pBytes + offset, sizeof(word));
+        hash = (hash ^ (word * kMul)) * kMul;
+        hash ^= hash >> 29;
+    }
+    for (; offset < size; offset++)
+        hash = (hash ^ pBytes[offset]) * kMul;
+
+    // Final avalanche (MurmurHash3 fmix64).
+    hash ^= hash >> 33;
+    hash *= UINT64_C(0xff51afd7ed558ccd);
+    hash ^= hash >> 33;
+    hash *= UINT64_C(0xc4ceb9fe1a85ec53);
+    hash ^= hash >> 33;
+    return hash;
+}
+
 gfx::IResource::Type getGfxResourceType(Texture::Type type)
 {
     switch (type)
@@ -339,6 +368,8 @@ ref<Texture> Texture::createMippedFromFiles(
         // Create mip mapped texture.
         pTex =
             pDevice->createTexture2D(mips[0]->getWidth(), mips[0]->getHeight(), texFormat, 1, mips.size(), combinedData.get(), bindFlags);
+        if (pTex != nullptr)
+            pTex->mContentHash = hashTexelData(combinedData.get(), combinedSize);
     }
 
     if (pTex != nullptr)
@@ -408,6 +439,8 @@ ref<Texture> Texture::createFromFile(
                 pBitmap->getData(),
                 bindFlags
             );
+            if (pTex != nullptr)
+                pTex->mContentHash = hashTexelData(pBitmap->getData(), pBitmap->getSize());
         }
     }
 
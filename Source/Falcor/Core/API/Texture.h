@@ -34,6 +34,7 @@
 #include "Core/Macros.h"
 #include "Utils/Image/Bitmap.h"
 #include <filesystem>
+#include <optional>
 #include <fstd/span.h>
 
 namespace Falcor
@@ -315,6 +316,19 @@ public:
      */
     Bitmap::ImportFlags getImportFlags() const { return mImportFlags; }
 
+    /**
+     * In case the texture was created from image data decoded from files, get a hash of the decoded data.
+     * Textures with identical descs (see compareDesc()) and content hashes hold the same texels.
+     * @return The content hash, or std::nullopt if the texture was not created from decoded image data.
+     */
+    const std::optional<uint64_t>& getContentHash() const { return mContentHash; }
+
+    /**
+     * Set the content hash, e.g. for textures created from image data in memory.
+     * Textures with identical descs must only share a hash if they hold the same texels, see getContentHash().
+     */
+    void setContentHash(std::optional<uint64_t> hash) { mContentHash = hash; }
+
     /**
      * Returns the total number of texels across all mip levels and array slices.
      */
@@ -339,6 +353,7 @@ protected:
     bool mReleaseRtvsAfterGenMips = true;
     std::filesystem::path mSourcePath;
     Bitmap::ImportFlags mImportFlags = Bitmap::ImportFlags::None; ///< Flags used for import if loaded from file.
+    std::optional<uint64_t> mContentHash;                         ///< Hash of the decoded image data if loaded from file.
 
     ResourceFormat mFormat = ResourceFormat::Unknown;
     uint32_t mWidth = 0;
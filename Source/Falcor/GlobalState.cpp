@@ -39,6 +39,11 @@ void setActivePythonSceneBuilder(SceneBuilder* pSceneBuilder)
     spActivePythonSceneBuilder = pSceneBuilder;
 }
 
+SceneBuilder* getActivePythonSceneBuilder()
+{
+    return spActivePythonSceneBuilder;
+}
+
 SceneBuilder& accessActivePythonSceneBuilder()
 {
     if (!spActivePythonSceneBuilder)
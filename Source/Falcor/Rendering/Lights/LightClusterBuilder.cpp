@@ -0,0 +1,255 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "LightClusterBuilder.h"
+#include "Core/Error.h"
+#include "Utils/Math/MatrixMath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Relative padding of the cluster bounds, so that points on a cluster boundary are conservatively covered
+        // regardless of floating-point rounding in the cluster lookup.
+        const float kBoundsEpsilon = 1e-4f;
+
+        /** Squared distance from a point to an axis-aligned box.
+        */
+        float distanceSquaredToBox(float3 p, float3 boxMin, float3 boxMax)
+        {
+            const float3 d = max(max(boxMin - p, p - boxMax), float3(0.f));
+            return dot(d, d);
+        }
+
+        uint32_t clampTile(float t, uint32_t tileCount)
+        {
+            return (uint32_t)std::clamp(std::floor(t), 0.f, (float)(tileCount - 1));
+        }
+    }
+
+    LightClusterBuilder::LightClusterBuilder()
+        : LightClusterBuilder(Options())
+    {}
+
+    LightClusterBuilder::LightClusterBuilder(const Options& options)
+        : mOptions(options)
+    {
+        FALCOR_CHECK(all(mOptions.gridSize > uint3(0)), "Light cluster grid size must be non-zero.");
+    }
+
+    void LightClusterBuilder::build(const ViewParams& view, const std::vector<LightBounds>& lights)
+    {
+        FALCOR_CHECK(view.nearZ > 0.f && view.farZ > view.nearZ, "Invalid light cluster depth range [{}, {}].", view.nearZ, view.farZ);
+        FALCOR_CHECK(view.tanHalfFovX > 0.f && view.tanHalfFovY > 0.f, "Invalid light cluster field of view.");
+
+        const uint3 gridSize = mOptions.gridSize;
+
+        mView = view;
+        mGrid.gridSize = gridSize;
+        mGrid.nearZ = view.nearZ;
+        mGrid.farZ = view.farZ;
+        mGrid.depthSliceScale = (float)gridSize.z / std::log(view.farZ / view.nearZ);
+
+        mAssignments.clear();
+        mStats = {};
+        mStats.clusterCount = getClusterCount();
+
+        // Assign each light to the clusters overlapped by its sphere of influence.
+        // The candidate clusters are found from the bounds of the sphere in screen space and depth,
+        // then each candidate cluster is tested against the sphere using the view space bounding box of the cluster.
+        for (uint32_t lightIndex = 0; lightIndex < (uint32_t)lights.size(); ++lightIndex)
+        {
+            const LightBounds& light = lights[lightIndex];
+            FALCOR_CHECK(light.radius >= 0.f && light.weight >= 0.f, "Invalid bounds for light {}.", lightIndex);
+
+            const float3 centerV = transformPoint(view.viewMat, light.center);
+            const float r = light.radius;
+            const float depth = -centerV.z;
+
+            const size_t assignmentCount = mAssignments.size();
+
+            if (depth + r >= view.nearZ && depth - r <= view.farZ)
+            {
+                const float minDepth = std::max(depth - r, view.nearZ);
+                const float maxDepth = std::min(depth + r, view.farZ);
+
+                // x/depth and y/depth are monotonic over the box bounding the sphere, so their extrema are at its corners.
+                float2 ndcMin(std::numeric_limits<float>::max());
+                float2 ndcMax(-std::numeric_limits<float>::max());
+                for (float x : {centerV.x - r, centerV.x + r})
+                {
+                    for (float y : {centerV.y - r, centerV.y + r})
+                    {
+                        for (float d : {minDepth, maxDepth})
+                        {
+                            const float2 ndc(x / (d * view.tanHalfFovX), y / (d * view.tanHalfFovY));
+                            ndcMin = min(ndcMin, ndc);
+                            ndcMax = max(ndcMax, ndc);
+                        }
+                    }
+                }
+
+                if (ndcMax.x >= -1.f && ndcMin.x <= 1.f && ndcMax.y >= -1.f && ndcMin.y <= 1.f)
+                {
+                    // Tile y goes down the screen.
+                    const uint32_t x0 = clampTile((ndcMin.x * 0.5f + 0.5f) * gridSize.x - kBoundsEpsilon, gridSize.x);
+                    const uint32_t x1 = clampTile((ndcMax.x * 0.5f + 0.5f) * gridSize.x + kBoundsEpsilon, gridSize.x);
+                    const uint32_t y0 = clampTile((0.5f - ndcMax.y * 0.5f) * gridSize.y - kBoundsEpsilon, gridSize.y);
+                    const uint32_t y1 = clampTile((0.5f - ndcMin.y * 0.5f) * gridSize.y + kBoundsEpsilon, gridSize.y);
+                    const uint32_t z0 = getSlice(minDepth * (1.f - kBoundsEpsilon));
+                    const uint32_t z1 = getSlice(maxDepth * (1.f + kBoundsEpsilon));
+
+                    for (uint32_t z = z0; z <= z1; ++z)
+                    {
+                        const float d0 = getSliceDepth(z) * (1.f - kBoundsEpsilon);
+                        const float d1 = getSliceDepth(z + 1) * (1.f + kBoundsEpsilon);
+
+                        for (uint32_t y = y0; y <= y1; ++y)
+                        {
+                            const float ndcTop = 1.f - 2.f * y / gridSize.y + kBoundsEpsilon;
+                            const float ndcBottom = 1.f - 2.f * (y + 1) / gridSize.y - kBoundsEpsilon;
+                            const float viewMinY = std::min(ndcBottom * d0, ndcBottom * d1) * view.tanHalfFovY;
+                            const float viewMaxY = std::max(ndcTop * d0, ndcTop * d1) * view.tanHalfFovY;
+
+                            for (uint32_t x = x0; x <= x1; ++x)
+                            {
+                                const float ndcLeft = 2.f * x / gridSize.x - 1.f - kBoundsEpsilon;
+                                const float ndcRight = 2.f * (x + 1) / gridSize.x - 1.f + kBoundsEpsilon;
+                                const float viewMinX = std::min(ndcLeft * d0, ndcLeft * d1) * view.tanHalfFovX;
+                                const float viewMaxX = std::max(ndcRight * d0, ndcRight * d1) * view.tanHalfFovX;
+
+                                const float3 boxMin(viewMinX, viewMinY, -d1);
+                                const float3 boxMax(viewMaxX, viewMaxY, -d0);
+                                if (distanceSquaredToBox(centerV, boxMin, boxMax) <= r * r)
+                                    mAssignments.push_back(uint2(getClusterIndex(uint3(x, y, z)), lightIndex));
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (mAssignments.size() == assignmentCount)
+                mStats.culledLightCount++;
+        }
+
+        // Sort the assignments by cluster with a counting sort. Lights stay in increasing index order within each cluster.
+        mClusterRanges.assign(mStats.clusterCount, uint2(0));
+        for (const uint2& assignment : mAssignments)
+            mClusterRanges[assignment.x].y++;
+
+        uint32_t offset = 0;
+        for (uint2& range : mClusterRanges)
+        {
+            range.x = offset;
+            offset += range.y;
+        }
+
+        mEntries.resize(mAssignments.size());
+        std::vector<uint32_t> fill(mStats.clusterCount, 0);
+        for (const uint2& assignment : mAssignments)
+        {
+            const uint32_t clusterIndex = assignment.x;
+            mEntries[mClusterRanges[clusterIndex].x + fill[clusterIndex]++] = {assignment.y, 0.f};
+        }
+
+        // Compute the per-cluster CDFs. Clusters whose lights all have zero weight select them uniformly.
+        for (const uint2& range : mClusterRanges)
+        {
+            if (range.y == 0)
+                continue;
+
+            double weightSum = 0.0;
+            for (uint32_t i = range.x; i < range.x + range.y; ++i)
+                weightSum += lights[mEntries[i].lightIndex].weight;
+
+            double cdf = 0.0;
+            for (uint32_t i = range.x; i < range.x + range.y; ++i)
+            {
+                cdf += weightSum > 0.0 ? lights[mEntries[i].lightIndex].weight / weightSum : 1.0 / range.y;
+                mEntries[i].cdf = (float)cdf;
+            }
+            mEntries[range.x + range.y - 1].cdf = 1.f;
+
+            mStats.nonEmptyClusterCount++;
+            mStats.maxLightsPerCluster = std::max(mStats.maxLightsPerCluster, range.y);
+        }
+
+        mStats.lightReferenceCount = (uint32_t)mEntries.size();
+        if (mStats.nonEmptyClusterCount > 0)
+            mStats.avgLightsPerNonEmptyCluster = (float)mStats.lightReferenceCount / mStats.nonEmptyClusterCount;
+    }
+
+    uint32_t LightClusterBuilder::findCluster(float3 posV) const
+    {
+        const float depth = -posV.z;
+        if (depth < mView.nearZ || depth > mView.farZ)
+            return kInvalidIndex;
+
+        const float2 ndc(posV.x / (depth * mView.tanHalfFovX), posV.y / (depth * mView.tanHalfFovY));
+        if (any(abs(ndc) > float2(1.f)))
+            return kInvalidIndex;
+
+        const uint3 gridSize = mOptions.gridSize;
+        const uint32_t x = clampTile((ndc.x * 0.5f + 0.5f) * gridSize.x, gridSize.x);
+        const uint32_t y = clampTile((0.5f - ndc.y * 0.5f) * gridSize.y, gridSize.y);
+        return getClusterIndex(uint3(x, y, getSlice(depth)));
+    }
+
+    uint32_t LightClusterBuilder::sampleLight(uint32_t clusterIndex, float u, float& pmf) const
+    {
+        FALCOR_ASSERT(clusterIndex < mClusterRanges.size());
+        const uint2 range = mClusterRanges[clusterIndex];
+        pmf = 0.f;
+        if (range.y == 0)
+            return kInvalidIndex;
+
+        const auto begin = mEntries.begin() + range.x;
+        const auto end = begin + range.y;
+        auto it = std::upper_bound(begin, end, u, [](float value, const LightClusterEntry& entry) { return value < entry.cdf; });
+        if (it == end)
+            it = end - 1;
+
+        pmf = it->cdf - (it != begin ? (it - 1)->cdf : 0.f);
+        return it->lightIndex;
+    }
+
+    float LightClusterBuilder::getSliceDepth(uint32_t slice) const
+    {
+        if (slice >= mOptions.gridSize.z)
+            return mView.farZ;
+        return mView.nearZ * std::pow(mView.farZ / mView.nearZ, (float)slice / mOptions.gridSize.z);
+    }
+
+    uint32_t LightClusterBuilder::getSlice(float depth) const
+    {
+        // Same as LightClusters::getClusterIndex() on the GPU.
+        const float slice = std::log(std::max(depth, mView.nearZ) / mView.nearZ) * mGrid.depthSliceScale;
+        return std::min((uint32_t)slice, mOptions.gridSize.z - 1);
+    }
+}
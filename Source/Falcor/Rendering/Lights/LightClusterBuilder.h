@@ -0,0 +1,131 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "LightClusterTypes.slang"
+#include "Core/Macros.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Vector.h"
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+    /** Utility class for building clustered light lists on the CPU.
+
+        The view frustum is divided into a grid of clusters (froxels): screen space tiles and exponentially
+        spaced depth slices, see LightClusterGrid. Each light is described by a bounding sphere of influence
+        and is referenced by all clusters the sphere overlaps. For every cluster the builder also computes
+        the CDF for selecting its lights proportionally to their weights.
+
+        The result is meant to be uploaded as is and used with the LightClusters struct in LightClusters.slang.
+    */
+    class FALCOR_API LightClusterBuilder
+    {
+    public:
+        static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        struct Options
+        {
+            uint3 gridSize = uint3(16, 9, 24);  ///< Number of tiles in x and y and number of depth slices.
+        };
+
+        /** Camera parameters. The view space follows the Falcor convention: right-handed, looking down -z.
+        */
+        struct ViewParams
+        {
+            float4x4 viewMat = float4x4::identity();    ///< World to view space transform.
+            float tanHalfFovX = 1.f;                    ///< Tangent of half the horizontal field of view.
+            float tanHalfFovY = 1.f;                    ///< Tangent of half the vertical field of view.
+            float nearZ = 0.1f;                         ///< Depth of the first slice.
+            float farZ = 1000.f;                        ///< Depth of the end of the last slice.
+        };
+
+        /** Bounding sphere of influence of a light in world space.
+        */
+        struct LightBounds
+        {
+            float3 center = float3(0.f);
+            float radius = 0.f;
+            float weight = 1.f;     ///< Non-negative selection weight of the light.
+        };
+
+        struct Stats
+        {
+            uint32_t clusterCount = 0;              ///< Total number of clusters.
+            uint32_t nonEmptyClusterCount = 0;      ///< Number of clusters referencing at least one light.
+            uint32_t lightReferenceCount = 0;       ///< Total number of cluster light list entries.
+            uint32_t culledLightCount = 0;          ///< Number of lights not overlapping any cluster.
+            uint32_t maxLightsPerCluster = 0;       ///< Largest cluster light list.
+            float avgLightsPerNonEmptyCluster = 0.f;
+        };
+
+        LightClusterBuilder();
+        LightClusterBuilder(const Options& options);
+
+        /** Assign the lights to the clusters of the given view. Replaces the result of the previous build.
+        */
+        void build(const ViewParams& view, const std::vector<LightBounds>& lights);
+
+        const Options& getOptions() const { return mOptions; }
+        const LightClusterGrid& getGrid() const { return mGrid; }
+        uint32_t getClusterCount() const { return mOptions.gridSize.x * mOptions.gridSize.y * mOptions.gridSize.z; }
+        uint32_t getClusterIndex(uint3 cluster) const { return (cluster.z * mOptions.gridSize.y + cluster.y) * mOptions.gridSize.x + cluster.x; }
+
+        /** Return the index of the cluster containing a view space position, or kInvalidIndex if it is outside the frustum.
+        */
+        uint32_t findCluster(float3 posV) const;
+
+        /** Offset and count in the entry list of each cluster.
+        */
+        const std::vector<uint2>& getClusterRanges() const { return mClusterRanges; }
+        const std::vector<LightClusterEntry>& getEntries() const { return mEntries; }
+
+        /** Select a light of a non-empty cluster, same as LightClusters::sampleLight() on the GPU.
+            \param[in] clusterIndex Cluster index.
+            \param[in] u Uniform random number in [0,1).
+            \param[out] pmf Probability of selecting the returned light in this cluster.
+            \return Index of the light, or kInvalidIndex if the cluster is empty.
+        */
+        uint32_t sampleLight(uint32_t clusterIndex, float u, float& pmf) const;
+
+        const Stats& getStats() const { return mStats; }
+
+    private:
+        float getSliceDepth(uint32_t slice) const;
+        uint32_t getSlice(float depth) const;
+
+        Options mOptions;
+        ViewParams mView;
+        LightClusterGrid mGrid = {};
+
+        std::vector<uint2> mClusterRanges;
+        std::vector<LightClusterEntry> mEntries;
+        std::vector<uint2> mAssignments;    ///< Scratch list of (cluster, light) pairs.
+        Stats mStats;
+    };
+}
@@ -0,0 +1,102 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "LightTileBuilder.h"
+#include "Core/Error.h"
+#include <algorithm>
+
+namespace Falcor
+{
+    LightTileBuilder::LightTileBuilder()
+        : LightTileBuilder(Options())
+    {}
+
+    LightTileBuilder::LightTileBuilder(const Options& options)
+        : mOptions(options)
+    {
+        FALCOR_CHECK(mOptions.tileCount > 0 && mOptions.tileSize > 0, "Light tile count and size must be non-zero.");
+    }
+
+    void LightTileBuilder::setWeights(const std::vector<float>& weights)
+    {
+        double weightSum = 0.0;
+        for (float weight : weights)
+        {
+            FALCOR_CHECK(weight >= 0.f, "Light weights must be non-negative.");
+            weightSum += weight;
+        }
+        FALCOR_CHECK(weightSum > 0.0, "Light weights must have a positive sum.");
+
+        mPdfs.resize(weights.size());
+        mCdf.resize(weights.size());
+
+        double cdf = 0.0;
+        for (size_t i = 0; i < weights.size(); ++i)
+        {
+            mPdfs[i] = (float)(weights[i] / weightSum);
+            cdf += weights[i] / weightSum;
+            mCdf[i] = (float)cdf;
+        }
+
+        // Make sure the last non-zero weight light ends the CDF exactly, trailing zero weight lights are never selected.
+        for (size_t i = weights.size(); i-- > 0;)
+        {
+            mCdf[i] = 1.f;
+            if (weights[i] > 0.f)
+                break;
+        }
+    }
+
+    void LightTileBuilder::build(std::mt19937& rng)
+    {
+        FALCOR_CHECK(!mCdf.empty(), "Light weights are not set.");
+
+        std::uniform_real_distribution<float> dist;
+        const uint32_t tileSize = mOptions.tileSize;
+
+        mSamples.resize((size_t)mOptions.tileCount * tileSize);
+        for (uint32_t tileIndex = 0; tileIndex < mOptions.tileCount; ++tileIndex)
+        {
+            Sample* pTile = mSamples.data() + (size_t)tileIndex * tileSize;
+            for (uint32_t i = 0; i < tileSize; ++i)
+            {
+                const float u = std::min((i + dist(rng)) / tileSize, std::nextafter(1.f, 0.f));
+                const uint32_t lightIndex = sampleLight(u);
+                pTile[i] = {lightIndex, mPdfs[lightIndex]};
+            }
+        }
+    }
+
+    uint32_t LightTileBuilder::sampleLight(float u) const
+    {
+        FALCOR_ASSERT(!mCdf.empty());
+
+        // Same as the GPU binary search: the first light with cdf > u.
+        const auto it = std::upper_bound(mCdf.begin(), mCdf.end(), u);
+        return (uint32_t)std::min<size_t>(it - mCdf.begin(), mCdf.size() - 1);
+    }
+}
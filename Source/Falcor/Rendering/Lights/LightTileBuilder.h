@@ -0,0 +1,94 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+    /** Utility class for pre-sampling lights into tiles on the CPU.
+
+        The builder draws tileCount tiles of tileSize light samples from the distribution proportional to the
+        light weights. The samples of each tile are stratified: sample i is drawn by inverting the CDF at
+        (i + u) / tileSize with u uniform in [0,1), so every tile follows the distribution closely.
+        Shading points then draw their candidates from a single tile, which is stored contiguously.
+
+        This is the reference implementation of the GPU pre-sampling passes, which use the same CDF and stratification.
+    */
+    class FALCOR_API LightTileBuilder
+    {
+    public:
+        static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        struct Options
+        {
+            uint32_t tileCount = 128;   ///< Number of tiles built per frame.
+            uint32_t tileSize = 1024;   ///< Number of light samples per tile.
+        };
+
+        struct Sample
+        {
+            uint32_t lightIndex = kInvalidIndex;
+            float pdf = 0.f;    ///< Probability of selecting the light from the whole distribution.
+        };
+
+        LightTileBuilder();
+        LightTileBuilder(const Options& options);
+
+        /** Set the light weights and compute the CDF. The weights must be non-negative with a positive sum.
+        */
+        void setWeights(const std::vector<float>& weights);
+
+        /** Draw all the tiles. Replaces the tiles of the previous build.
+        */
+        void build(std::mt19937& rng);
+
+        /** Return the index of the light selected by inverting the CDF at u in [0,1).
+        */
+        uint32_t sampleLight(float u) const;
+
+        const Options& getOptions() const { return mOptions; }
+        uint32_t getLightCount() const { return (uint32_t)mPdfs.size(); }
+        float getPdf(uint32_t lightIndex) const { return mPdfs[lightIndex]; }
+        const std::vector<float>& getPdfs() const { return mPdfs; }
+        const std::vector<float>& getCdf() const { return mCdf; }
+
+        /** All tiles, tile t occupies samples [t * tileSize, (t + 1) * tileSize).
+        */
+        const std::vector<Sample>& getSamples() const { return mSamples; }
+        const Sample* getTile(uint32_t tileIndex) const { return mSamples.data() + (size_t)tileIndex * mOptions.tileSize; }
+
+    private:
+        Options mOptions;
+        std::vector<float> mPdfs;
+        std::vector<float> mCdf;
+        std::vector<Sample> mSamples;
+    };
+}
@@ -0,0 +1,114 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "DynamicResolution.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+FrameTimeController::Options getControllerOptions(const DynamicResolution::Options& options)
+{
+    // The controller scales the pixel count.
+    FrameTimeController::Options controllerOptions;
+    controllerOptions.targetTimeMs = options.targetTimeMs;
+    controllerOptions.minScale = options.minScale * options.minScale;
+    controllerOptions.maxScale = options.maxScale * options.maxScale;
+    controllerOptions.initialScale = controllerOptions.maxScale;
+    return controllerOptions;
+}
+} // namespace
+
+DynamicResolution::DynamicResolution(uint2 maxResolution) : DynamicResolution(maxResolution, Options()) {}
+
+DynamicResolution::DynamicResolution(uint2 maxResolution, const Options& options)
+    : mOptions(options), mMaxResolution(maxResolution), mController(getControllerOptions(options))
+{
+    FALCOR_CHECK(maxResolution.x > 0 && maxResolution.y > 0, "Invalid maximum resolution {}x{}.", maxResolution.x, maxResolution.y);
+    FALCOR_CHECK(
+        mOptions.minScale > 0.f && mOptions.minScale <= mOptions.maxScale && mOptions.maxScale <= 1.f,
+        "Invalid resolution scale range [{}, {}].",
+        mOptions.minScale,
+        mOptions.maxScale
+    );
+    FALCOR_CHECK(mOptions.scaleStep >= 0.f, "Resolution scale step must not be negative.");
+
+    reset();
+}
+
+bool DynamicResolution::update(float frameTimeMs)
+{
+    const float scale = quantizeScale(std::sqrt(mController.update(frameTimeMs)));
+    if (scale == mScale)
+        return false;
+
+    const uint2 renderResolution = computeRenderResolution(mMaxResolution, scale);
+    mScale = scale;
+
+    const bool changed = any(renderResolution != mRenderResolution);
+    mRenderResolution = renderResolution;
+    return changed;
+}
+
+void DynamicResolution::reset()
+{
+    mController.reset();
+    mScale = quantizeScale(mOptions.maxScale);
+    mRenderResolution = computeRenderResolution(mMaxResolution, mScale);
+}
+
+uint2 DynamicResolution::computeRenderResolution(uint2 maxResolution, float scale)
+{
+    FALCOR_CHECK(scale > 0.f && scale <= 1.f, "Resolution scale {} is out of range (0,1].", scale);
+
+    auto scaleDim = [scale](uint32_t dim) { return std::clamp((uint32_t)std::lround((float)dim * scale), 1u, dim); };
+    return uint2(scaleDim(maxResolution.x), scaleDim(maxResolution.y));
+}
+
+float2 DynamicResolution::computeUvScale(uint2 renderResolution, uint2 maxResolution)
+{
+    return float2(renderResolution) / float2(maxResolution);
+}
+
+uint2 DynamicResolution::mapPixel(uint2 pixel, uint2 srcResolution, uint2 dstResolution)
+{
+    const float2 uv = (float2(pixel) + 0.5f) / float2(srcResolution);
+    const uint2 dstPixel = uint2(uv * float2(dstResolution));
+    return min(dstPixel, dstResolution - 1u);
+}
+
+float DynamicResolution::quantizeScale(float scale) const
+{
+    // Round down so that the frame time target is not exceeded, but keep within the bounds.
+    if (mOptions.scaleStep > 0.f)
+        scale = std::floor(scale / mOptions.scaleStep + 1e-4f) * mOptions.scaleStep;
+    return std::clamp(scale, mOptions.minScale, mOptions.maxScale);
+}
+} // namespace Falcor
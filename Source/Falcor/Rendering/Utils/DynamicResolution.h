@@ -0,0 +1,103 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/Timing/FrameTimeController.h"
+
+namespace Falcor
+{
+/**
+ * Dynamic resolution scaling driven by a frame time target.
+ *
+ * Render targets are allocated once at the maximum resolution, and each frame renders into the top-left
+ * sub-rectangle of size getRenderResolution(). The resolution scale is driven by a FrameTimeController:
+ * the controller scales the pixel count, so the per-axis resolution scale is its square root.
+ * The scale is quantized to multiples of scaleStep so that small frame time variations don't change the
+ * resolution every frame.
+ */
+class FALCOR_API DynamicResolution
+{
+public:
+    struct Options
+    {
+        float minScale = 0.5f;              ///< Lowest per-axis resolution scale.
+        float maxScale = 1.f;               ///< Highest per-axis resolution scale, at most 1.
+        float scaleStep = 0.05f;            ///< Quantization step of the resolution scale, 0 disables quantization.
+        float targetTimeMs = 16.6f;         ///< Frame time to converge to.
+    };
+
+    DynamicResolution(uint2 maxResolution);
+    DynamicResolution(uint2 maxResolution, const Options& options);
+
+    /**
+     * Update the resolution scale with the frame time measured for the last frame.
+     * @param[in] frameTimeMs Measured frame time in milliseconds. Non-positive frame times are ignored.
+     * @return True if the render resolution changed.
+     */
+    bool update(float frameTimeMs);
+
+    /**
+     * Reset the controller and go back to the maximum scale.
+     */
+    void reset();
+
+    float getScale() const { return mScale; }
+    uint2 getMaxResolution() const { return mMaxResolution; }
+    uint2 getRenderResolution() const { return mRenderResolution; }
+    const FrameTimeController& getController() const { return mController; }
+    const Options& getOptions() const { return mOptions; }
+
+    /**
+     * Compute the render resolution for a given scale. Each dimension is rounded to the nearest pixel and is at least 1.
+     * @param[in] maxResolution Allocated resolution.
+     * @param[in] scale Per-axis resolution scale in (0,1].
+     */
+    static uint2 computeRenderResolution(uint2 maxResolution, float scale);
+
+    /**
+     * Compute the UV scale mapping [0,1] UVs of the render sub-rectangle to UVs of the allocated texture.
+     */
+    static float2 computeUvScale(uint2 renderResolution, uint2 maxResolution);
+
+    /**
+     * Map a pixel from a frame rendered at one resolution to a frame rendered at another one.
+     * Both frames cover the same view, the pixel centers are mapped and the result is clamped to the destination.
+     */
+    static uint2 mapPixel(uint2 pixel, uint2 srcResolution, uint2 dstResolution);
+
+private:
+    float quantizeScale(float scale) const;
+
+    Options mOptions;
+    uint2 mMaxResolution;
+    FrameTimeController mController;
+    float mScale;
+    uint2 mRenderResolution;
+};
+} // namespace Falcor
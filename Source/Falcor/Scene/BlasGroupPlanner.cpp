@@ -0,0 +1,282 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlasGroupPlanner.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Falcor
+{
+namespace
+{
+/// Number of evenly spaced splits of the memory budget into result and scratch budgets that are evaluated.
+const uint32_t kBudgetSplitCount = 8;
+/// Maximum number of steps used to shrink the budget after the number of groups has been determined.
+const uint32_t kMaxShrinkSteps = 16;
+
+using BlasDesc = BlasGroupPlanner::BlasDesc;
+using Plan = BlasGroupPlanner::Plan;
+
+struct Bin
+{
+    uint64_t resultByteSize = 0;
+    uint64_t scratchByteSize = 0;
+    std::vector<uint32_t> blasIndices;
+};
+
+/**
+ * Pack BLASes into bins with best-fit decreasing.
+ * BLASes are sorted by their largest size relative to the bin capacity and each BLAS is put into the bin
+ * that has the least capacity left after insertion. BLASes that don't fit any bin open a new bin.
+ */
+std::vector<Bin> packBestFitDecreasing(const std::vector<BlasDesc>& blases, uint64_t resultCapacity, uint64_t scratchCapacity)
+{
+    FALCOR_ASSERT(resultCapacity > 0 && scratchCapacity > 0);
+    const double invResultCapacity = 1.0 / (double)resultCapacity;
+    const double invScratchCapacity = 1.0 / (double)scratchCapacity;
+
+    auto dominantSize = [&](const BlasDesc& blas)
+    { return std::max((double)blas.resultByteSize * invResultCapacity, (double)blas.scratchByteSize * invScratchCapacity); };
+
+    std::vector<uint32_t> order(blases.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(
+        order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return dominantSize(blases[a]) > dominantSize(blases[b]); }
+    );
+
+    std::vector<Bin> bins;
+    for (uint32_t blasId : order)
+    {
+        const auto& blas = blases[blasId];
+        size_t bestBin = bins.size();
+        double bestSlack = std::numeric_limits<double>::max();
+
+        for (size_t i = 0; i < bins.size(); i++)
+        {
+            const uint64_t resultByteSize = bins[i].resultByteSize + blas.resultByteSize;
+            const uint64_t scratchByteSize = bins[i].scratchByteSize + blas.scratchByteSize;
+            if (resultByteSize > resultCapacity || scratchByteSize > scratchCapacity)
+                continue;
+
+            const double slack = (double)(resultCapacity - resultByteSize) * invResultCapacity +
+                                 (double)(scratchCapacity - scratchByteSize) * invScratchCapacity;
+            if (slack < bestSlack)
+            {
+                bestSlack = slack;
+                bestBin = i;
+            }
+        }
+
+        if (bestBin == bins.size())
+            bins.emplace_back();
+        auto& bin = bins[bestBin];
+        bin.resultByteSize += blas.resultByteSize;
+        bin.scratchByteSize += blas.scratchByteSize;
+        bin.blasIndices.push_back(blasId);
+    }
+
+    return bins;
+}
+
+Plan createPlan(const std::vector<BlasDesc>& blases, std::vector<Bin> bins)
+{
+    // Order the groups by their lowest BLAS index to keep the build order close to the ID order.
+    for (auto& bin : bins)
+        std::sort(bin.blasIndices.begin(), bin.blasIndices.end());
+    std::sort(bins.begin(), bins.end(), [](const Bin& a, const Bin& b) { return a.blasIndices.front() < b.blasIndices.front(); });
+
+    Plan plan;
+    plan.groups.reserve(bins.size());
+    for (auto& bin : bins)
+    {
+        auto& group = plan.groups.emplace_back();
+        group.blasIndices = std::move(bin.blasIndices);
+        for (uint32_t blasId : group.blasIndices)
+        {
+            group.resultByteSize += blases[blasId].resultByteSize;
+            group.scratchByteSize += blases[blasId].scratchByteSize;
+            group.predictedFinalByteSize += blases[blasId].predictedFinalByteSize;
+        }
+        plan.resultBufferSize = std::max(plan.resultBufferSize, group.resultByteSize);
+        plan.scratchBufferSize = std::max(plan.scratchBufferSize, group.scratchByteSize);
+        plan.predictedFinalByteSize += group.predictedFinalByteSize;
+    }
+    return plan;
+}
+
+/// Returns true if plan a is better than plan b, i.e. it has fewer groups or the same number of groups and less transient memory.
+bool isBetter(const Plan& a, const Plan& b)
+{
+    if (a.groups.size() != b.groups.size())
+        return a.groups.size() < b.groups.size();
+    return a.resultBufferSize + a.scratchBufferSize < b.resultBufferSize + b.scratchBufferSize;
+}
+} // namespace
+
+BlasGroupPlanner::Plan BlasGroupPlanner::plan(const std::vector<BlasDesc>& blases, uint64_t memoryBudget)
+{
+    if (blases.empty())
+        return {};
+
+    uint64_t maxResultByteSize = 0;
+    uint64_t maxScratchByteSize = 0;
+    uint64_t totalResultByteSize = 0;
+    uint64_t totalScratchByteSize = 0;
+    for (const auto& blas : blases)
+    {
+        FALCOR_CHECK(blas.resultByteSize > 0 && blas.scratchByteSize > 0, "BLAS result and scratch sizes must be non-zero.");
+        maxResultByteSize = std::max(maxResultByteSize, blas.resultByteSize);
+        maxScratchByteSize = std::max(maxScratchByteSize, blas.scratchByteSize);
+        totalResultByteSize += blas.resultByteSize;
+        totalScratchByteSize += blas.scratchByteSize;
+    }
+
+    // The shared buffers are sized for the largest group in each dimension, so the transient memory
+    // can never be less than the largest result size plus the largest scratch size.
+    const uint64_t minCapacity = maxResultByteSize + maxScratchByteSize;
+    const double resultFraction = (double)totalResultByteSize / (double)(totalResultByteSize + totalScratchByteSize);
+
+    // Split the capacity into result and scratch capacity, keeping room for the largest BLAS in each dimension.
+    auto pack = [&](uint64_t capacity, double fraction)
+    {
+        FALCOR_ASSERT(capacity >= minCapacity);
+        uint64_t resultCapacity = (uint64_t)std::llround((double)capacity * fraction);
+        resultCapacity = std::clamp(resultCapacity, maxResultByteSize, capacity - maxScratchByteSize);
+        return createPlan(blases, packBestFitDecreasing(blases, resultCapacity, capacity - resultCapacity));
+    };
+
+    // Find the split of the budget that results in the fewest groups. Start with a split proportional
+    // to the total result and scratch sizes and then try evenly spaced splits.
+    const uint64_t capacity = std::max(memoryBudget, minCapacity);
+    Plan best = pack(capacity, resultFraction);
+    double bestFraction = resultFraction;
+
+    for (uint32_t i = 0; i <= kBudgetSplitCount; i++)
+    {
+        const uint64_t resultCapacity = maxResultByteSize + (capacity - minCapacity) * i / kBudgetSplitCount;
+        const double fraction = (double)resultCapacity / (double)capacity;
+        Plan candidate = pack(capacity, fraction);
+        if (isBetter(candidate, best))
+        {
+            best = std::move(candidate);
+            bestFraction = fraction;
+        }
+    }
+
+    // Shrink the capacity as long as the number of groups doesn't increase. This reduces the peak memory
+    // and spreads the BLASes more evenly over the groups. Packing is not monotonic in the capacity,
+    // so the search is bounded and the best plan seen is kept.
+    const uint64_t groupCount = best.groups.size();
+    uint64_t lo = std::max(minCapacity, (totalResultByteSize + totalScratchByteSize + groupCount - 1) / groupCount);
+    uint64_t hi = best.resultBufferSize + best.scratchBufferSize;
+    for (uint32_t step = 0; step < kMaxShrinkSteps && lo < hi; step++)
+    {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        Plan candidate = pack(mid, bestFraction);
+        if (candidate.groups.size() <= groupCount)
+        {
+            hi = mid;
+            if (isBetter(candidate, best))
+                best = std::move(candidate);
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+
+    return best;
+}
+
+BlasGroupPlanner::Plan BlasGroupPlanner::planSequential(const std::vector<BlasDesc>& blases, uint64_t memoryBudget)
+{
+    std::vector<Bin> bins;
+    uint64_t binSize = 0;
+
+    for (uint32_t blasId = 0; blasId < blases.size(); blasId++)
+    {
+        const auto& blas = blases[blasId];
+        const uint64_t blasSize = blas.resultByteSize + blas.scratchByteSize;
+
+        // Start new bin on first iteration or if bin size would exceed the budget.
+        if (binSize == 0 || binSize + blasSize > memoryBudget)
+        {
+            bins.emplace_back();
+            binSize = 0;
+        }
+
+        bins.back().blasIndices.push_back(blasId);
+        binSize += blasSize;
+    }
+
+    return createPlan(blases, std::move(bins));
+}
+
+uint64_t BlasCompactionHistory::predictFinalByteSize(uint32_t blasId, uint64_t resultByteSize, bool useCompaction) const
+{
+    if (!useCompaction)
+        return resultByteSize;
+
+    double ratio = getCompactionRatio();
+    if (blasId < mEntries.size() && mEntries[blasId].resultByteSize > 0)
+        ratio = (double)mEntries[blasId].finalByteSize / (double)mEntries[blasId].resultByteSize;
+
+    return std::min(resultByteSize, (uint64_t)std::ceil((double)resultByteSize * ratio));
+}
+
+void BlasCompactionHistory::record(uint32_t blasId, uint64_t resultByteSize, uint64_t finalByteSize, bool useCompaction)
+{
+    if (!useCompaction || resultByteSize == 0)
+        return;
+
+    if (blasId >= mEntries.size())
+        mEntries.resize(blasId + 1);
+
+    auto& entry = mEntries[blasId];
+    mTotalResultByteSize += resultByteSize - entry.resultByteSize;
+    mTotalFinalByteSize += finalByteSize - entry.finalByteSize;
+    entry.resultByteSize = resultByteSize;
+    entry.finalByteSize = finalByteSize;
+}
+
+double BlasCompactionHistory::getCompactionRatio() const
+{
+    if (mTotalResultByteSize == 0)
+        return kDefaultCompactionRatio;
+    return (double)mTotalFinalByteSize / (double)mTotalResultByteSize;
+}
+
+void BlasCompactionHistory::clear()
+{
+    mEntries.clear();
+    mTotalResultByteSize = 0;
+    mTotalFinalByteSize = 0;
+}
+} // namespace Falcor
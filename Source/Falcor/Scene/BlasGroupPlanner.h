@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Plans how BLASes are split into groups (build batches) for the initial BLAS build.
+ *
+ * All groups are built into a shared result buffer and a shared scratch buffer, which are sized for the largest
+ * group in each dimension. The BLASes are then compacted into one final buffer per group, which stays alive.
+ * The peak memory use during the build is therefore the largest group result size plus the largest group scratch
+ * size plus the sum of all final sizes. Only the first two terms depend on the grouping.
+ *
+ * The planner solves a two-dimensional bin packing problem: the result and scratch budgets of a group are
+ * chosen such that they sum to the memory budget, and BLASes are packed with best-fit decreasing. Several splits
+ * of the budget are tried and the bins are shrunk as long as the number of groups doesn't increase. This keeps
+ * the number of build batches low while reducing the peak memory and balancing the groups.
+ *
+ * The planner is pure host code and has no dependency on the device.
+ */
+class FALCOR_API BlasGroupPlanner
+{
+public:
+    /// Memory requirements of a single BLAS.
+    struct BlasDesc
+    {
+        uint64_t resultByteSize = 0;         ///< Maximum result data size for the BLAS build, including padding.
+        uint64_t scratchByteSize = 0;        ///< Maximum scratch data size for the BLAS build, including padding.
+        uint64_t predictedFinalByteSize = 0; ///< Predicted size of the final BLAS post-compaction, including padding.
+    };
+
+    struct Group
+    {
+        std::vector<uint32_t> blasIndices;   ///< Indices of all BLASes in the group in ascending order.
+        uint64_t resultByteSize = 0;         ///< Sum of the result sizes of all BLASes in the group.
+        uint64_t scratchByteSize = 0;        ///< Sum of the scratch sizes of all BLASes in the group.
+        uint64_t predictedFinalByteSize = 0; ///< Sum of the predicted final sizes of all BLASes in the group.
+    };
+
+    struct Plan
+    {
+        std::vector<Group> groups;
+        uint64_t resultBufferSize = 0;       ///< Size of the shared result buffer, i.e. the largest group result size.
+        uint64_t scratchBufferSize = 0;      ///< Size of the shared scratch buffer, i.e. the largest group scratch size.
+        uint64_t predictedFinalByteSize = 0; ///< Sum of the predicted final sizes of all BLASes.
+
+        /// Returns the predicted peak memory use during the build.
+        uint64_t getPeakByteSize() const { return resultBufferSize + scratchBufferSize + predictedFinalByteSize; }
+    };
+
+    /**
+     * Plan the BLAS groups with bin packing.
+     * @param[in] blases Memory requirements of all BLASes.
+     * @param[in] memoryBudget Target for the result plus scratch memory used by the build. BLASes that don't fit
+     * the budget on their own are still built, which raises the budget to the smallest feasible one.
+     * @return The plan. Every BLAS is contained in exactly one group.
+     */
+    static Plan plan(const std::vector<BlasDesc>& blases, uint64_t memoryBudget);
+
+    /**
+     * Plan the BLAS groups by greedily packing them in ID order until the memory budget is hit.
+     * This is the reference strategy that plan() improves on.
+     * @param[in] blases Memory requirements of all BLASes.
+     * @param[in] memoryBudget Target for the result plus scratch memory of each group.
+     * @return The plan.
+     */
+    static Plan planSequential(const std::vector<BlasDesc>& blases, uint64_t memoryBudget);
+};
+
+/**
+ * Predicts post-compaction BLAS sizes from the sizes observed in previous builds.
+ *
+ * The ratio of compacted to uncompacted size is recorded per BLAS. BLASes that have not been built before
+ * are predicted with the aggregate ratio of all recorded BLASes, or a conservative default if there is no history.
+ */
+class FALCOR_API BlasCompactionHistory
+{
+public:
+    /// Compaction ratio used before any BLAS has been recorded.
+    static constexpr double kDefaultCompactionRatio = 0.6;
+
+    /**
+     * Predict the final size of a BLAS.
+     * @param[in] blasId BLAS index.
+     * @param[in] resultByteSize Maximum result data size for the BLAS build.
+     * @param[in] useCompaction Whether the BLAS is compacted. Otherwise the result size is returned.
+     * @return Predicted final size in bytes.
+     */
+    uint64_t predictFinalByteSize(uint32_t blasId, uint64_t resultByteSize, bool useCompaction) const;
+
+    /**
+     * Record the final size of a built BLAS.
+     * @param[in] blasId BLAS index.
+     * @param[in] resultByteSize Maximum result data size for the BLAS build.
+     * @param[in] finalByteSize Final size of the BLAS post-compaction.
+     * @param[in] useCompaction Whether the BLAS was compacted. Uncompacted BLASes are not recorded.
+     */
+    void record(uint32_t blasId, uint64_t resultByteSize, uint64_t finalByteSize, bool useCompaction);
+
+    /// Returns the aggregate compaction ratio of all recorded BLASes.
+    double getCompactionRatio() const;
+
+    /// Clear all history, e.g. when the set of BLASes changes.
+    void clear();
+
+private:
+    struct Entry
+    {
+        uint64_t resultByteSize = 0; ///< Result size of the last recorded build, or zero if unknown.
+        uint64_t finalByteSize = 0;  ///< Final size of the last recorded build.
+    };
+
+    std::vector<Entry> mEntries;       ///< Last recorded build per BLAS.
+    uint64_t mTotalResultByteSize = 0; ///< Sum of the result sizes of all entries.
+    uint64_t mTotalFinalByteSize = 0;  ///< Sum of the final sizes of all entries.
+};
+} // namespace Falcor
@@ -32,6 +32,8 @@
 #include "Utils/Math/CubicSpline.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/Math/Quaternion.h"
+#include "Utils/JobSystem.h"
+#include <algorithm>
 #include <cmath>
 
 namespace Falcor
@@ -59,21 +61,36 @@ namespace Falcor
 
     struct CubicSplineCache
     {
-        CubicSpline<float3> optSplinePoints;
-        CubicSpline<float>  optSplineWidths;
-        CubicSpline<float2> optSplineUVs;
-
         CubicSpline<float3> splinePoints;
         CubicSpline<float>  splineWidths;
         CubicSpline<float2> splineUVs;
     };
 
+    /// Location of a tessellated strand in the input and output arrays.
+    struct StrandLayout
+    {
+        uint32_t strand;        ///< Index of the strand in the input.
+        uint32_t pointOffset;   ///< Offset of the first control point in the input arrays.
+        uint32_t outputOffset;  ///< Offset of the first tessellated point in the output arrays.
+        uint32_t outputCount;   ///< Number of tessellated points of the strand.
+    };
+
+    /// Per-thread scratch memory used while tessellating a chunk of strands.
+    struct StrandScratch
+    {
+        StrandArrays strandArrays;
+        CubicSplineCache splineCache;
+    };
+
     namespace
     {
         // Curves tessellated to quad-tubes have the width somewhere between curveWidth and (curveWidth / sqrt(2)), depending on the viewing angle.
         // To achieve curveWidth on average, however, we need to scale the initial curveWidth by 1.11 (the number was deducted numerically).
         const float kMeshCompensationScale = 1.11f;
 
+        // Number of strands processed by a single parallel task.
+        const uint32_t kStrandsPerTask = 64;
+
         float4 transformSphere(const float4x4& xform, const float4& sphere)
         {
             // Spheres are represented as (center.x, center.y, center.z, radius).
@@ -98,7 +115,69 @@ namespace Falcor
             return std::max(w, (float)std::numeric_limits<float16_t>::min());
         }
 
-        void optimizeStrandGeometry(CubicSplineCache& splineCache, const CurveArrays& curveArrays, StrandArrays& strandArrays, StrandArrays& optimizedStrandArrays, uint32_t pointOffset, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, float widthScale)
+        /// Count the control points of a strand that remain after removing consecutive duplicates.
+        uint32_t countUniqueStrandPoints(const CurveArrays& curveArrays, uint32_t pointOffset, uint32_t vertexCount)
+        {
+            uint32_t count = 1;
+            for (uint32_t j = 0; j < vertexCount - 1; j++)
+            {
+                if (any(curveArrays.controlPoints[pointOffset + j] != curveArrays.controlPoints[pointOffset + j + 1])) count++;
+            }
+            return count;
+        }
+
+        /// Compute the number of tessellated points of a strand with the given number of unique control points.
+        uint32_t getTessellatedPointCount(uint32_t uniquePointCount, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand)
+        {
+            return div_round_up(subdivPerSegment * (uniquePointCount - 1), keepOneEveryXVerticesPerStrand) + 1;
+        }
+
+        /** Compute the input and output location of all strands that are kept.
+            The control point offsets are a prefix sum over all strands, the output offsets a prefix sum over the tessellated point counts of the kept strands.
+            \return Total number of tessellated points.
+        */
+        uint32_t computeStrandLayouts(std::vector<StrandLayout>& layouts, uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const CurveArrays& curveArrays, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand)
+        {
+            layouts.resize(div_round_up(strandCount, keepOneEveryXStrands));
+
+            uint32_t pointOffset = 0;
+            for (uint32_t i = 0; i < strandCount; i++)
+            {
+                if (i % keepOneEveryXStrands == 0) layouts[i / keepOneEveryXStrands] = { i, pointOffset, 0, 0 };
+                pointOffset += vertexCountsPerStrand[i];
+            }
+
+            JobSystem::getGlobal().parallelFor(0, layouts.size(), [&](size_t s)
+            {
+                StrandLayout& layout = layouts[s];
+                uint32_t uniquePointCount = countUniqueStrandPoints(curveArrays, layout.pointOffset, vertexCountsPerStrand[layout.strand]);
+                layout.outputCount = getTessellatedPointCount(uniquePointCount, subdivPerSegment, keepOneEveryXVerticesPerStrand);
+            });
+
+            uint32_t outputOffset = 0;
+            for (StrandLayout& layout : layouts)
+            {
+                layout.outputOffset = outputOffset;
+                outputOffset += layout.outputCount;
+            }
+            return outputOffset;
+        }
+
+        /// Run a function over all strand layouts in parallel. Each task processes a contiguous range of strands with its own scratch memory.
+        template<typename Func>
+        void parallelForStrands(const std::vector<StrandLayout>& layouts, Func func)
+        {
+            uint32_t taskCount = div_round_up((uint32_t)layouts.size(), kStrandsPerTask);
+            JobSystem::getGlobal().parallelFor(0, taskCount, [&](size_t task)
+            {
+                StrandScratch scratch;
+                uint32_t end = std::min((uint32_t)layouts.size(), ((uint32_t)task + 1) * kStrandsPerTask);
+                for (uint32_t s = (uint32_t)task * kStrandsPerTask; s < end; s++) func(s, layouts[s], scratch);
+            }, 1);
+        }
+
+        /// Copy the control points of a strand, removing consecutive duplicates.
+        void removeDuplicatePoints(const CurveArrays& curveArrays, StrandArrays& strandArrays, uint32_t pointOffset)
         {
             strandArrays.controlPoints.clear();
             strandArrays.UVs.clear();
@@ -119,77 +198,61 @@ namespace Falcor
             strandArrays.controlPoints.push_back(curveArrays.controlPoints[pointOffset + strandArrays.vertexCount - 1]);
             strandArrays.widths.push_back(curveArrays.widths[pointOffset + strandArrays.vertexCount - 1]);
             if (curveArrays.UVs) strandArrays.UVs.push_back(curveArrays.UVs[pointOffset + strandArrays.vertexCount - 1]);
+        }
 
-            optimizedStrandArrays.vertexCount = static_cast<uint32_t>(strandArrays.controlPoints.size());
-
-            const CubicSpline<float3>& splinePoints = splineCache.optSplinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
-            const CubicSpline<float>& splineWidths = splineCache.optSplineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
-
-            uint32_t tmpCount = 0;
-            for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+        /** Sample a cubic spline at the tessellated points of a strand.
+            Points are taken at every keepOneEveryXVerticesPerStrand-th sub-segment, and the end point of the strand is always kept.
+            \param[in] spline Spline through the unique control points.
+            \param[in] uniquePointCount Number of unique control points.
+            \param[in] segmentTs Spline parameters of the sub-segments within a segment.
+            \param[in] keepOneEveryXVerticesPerStrand Keep one of every X vertices.
+            \param[in] func Function called with the index of the tessellated point and the interpolated value.
+        */
+        template<typename T, typename Func>
+        void sampleSpline(const CubicSpline<T>& spline, uint32_t uniquePointCount, const std::vector<float>& segmentTs, uint32_t keepOneEveryXVerticesPerStrand, Func func)
+        {
+            uint32_t subdivPerSegment = (uint32_t)segmentTs.size();
+            uint32_t subdivCount = subdivPerSegment * (uniquePointCount - 1);
+            uint32_t index = 0;
+            for (uint32_t i = 0; i < subdivCount; i += keepOneEveryXVerticesPerStrand)
             {
-                for (uint32_t k = 0; k < subdivPerSegment; k++)
-                {
-                    if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                    {
-                        float t = (float)k / (float)subdivPerSegment;
-                        optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(j, t));
-                        optimizedStrandArrays.widths.push_back(sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(j, t)));
-                    }
-                    tmpCount++;
-                }
+                func(index++, spline.interpolate(i / subdivPerSegment, segmentTs[i % subdivPerSegment]));
             }
 
             // Always keep the last vertex.
-            optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
-            optimizedStrandArrays.widths.push_back(sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f)));
-
-            // Texture coordinates.
-            if (curveArrays.UVs)
-            {
-                const CubicSpline<float2>& splineUVs = splineCache.optSplineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
-                tmpCount = 0;
-                for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
-                {
-                    for (uint32_t k = 0; k < subdivPerSegment; k++)
-                    {
-                        if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                        {
-                            float t = (float)k / (float)subdivPerSegment;
-                            optimizedStrandArrays.UVs.push_back(splineUVs.interpolate(j, t));
-                        }
-                        tmpCount++;
-                    }
-                }
+            func(index, spline.interpolate(uniquePointCount - 2, 1.f));
+        }
 
-                // Always keep the last vertex.
-                optimizedStrandArrays.UVs.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
-            }
+        std::vector<float> computeSegmentTs(uint32_t subdivPerSegment)
+        {
+            std::vector<float> segmentTs(subdivPerSegment);
+            for (uint32_t k = 0; k < subdivPerSegment; k++) segmentTs[k] = (float)k / (float)subdivPerSegment;
+            return segmentTs;
         }
 
-        void updateCurveFrame(const StrandArrays& strandArrays, float3& fwd, float3& s, float3& t, uint32_t j)
+        void updateCurveFrame(const float3* controlPoints, uint32_t pointCount, float3& fwd, float3& s, float3& t, uint32_t j)
         {
             float3 prevFwd;
 
-            if (j <= 0 || j >= strandArrays.controlPoints.size() || strandArrays.controlPoints.size() == 2)
+            if (j <= 0 || j >= pointCount || pointCount == 2)
             {
                 // The forward tangents should be the same, meaning s & t are also the same
                 prevFwd = fwd;
             }
             else if (j == 1)
             {
-                prevFwd = normalize(strandArrays.controlPoints[j] - strandArrays.controlPoints[j - 1]);
-                fwd = normalize(strandArrays.controlPoints[j + 1] - strandArrays.controlPoints[j - 1]);
+                prevFwd = normalize(controlPoints[j] - controlPoints[j - 1]);
+                fwd = normalize(controlPoints[j + 1] - controlPoints[j - 1]);
             }
-            else if (j < strandArrays.controlPoints.size() - 2)
+            else if (j < pointCount - 1)
             {
-                prevFwd = normalize(strandArrays.controlPoints[j] - strandArrays.controlPoints[j - 2]);
-                fwd = normalize(strandArrays.controlPoints[j + 1] - strandArrays.controlPoints[j - 1]);
+                prevFwd = normalize(controlPoints[j] - controlPoints[j - 2]);
+                fwd = normalize(controlPoints[j + 1] - controlPoints[j - 1]);
             }
-            else if (j == strandArrays.controlPoints.size() - 1)
+            else if (j == pointCount - 1)
             {
-                prevFwd = normalize(strandArrays.controlPoints[j] - strandArrays.controlPoints[j - 2]);
-                fwd = normalize(strandArrays.controlPoints[j] - strandArrays.controlPoints[j - 1]);
+                prevFwd = normalize(controlPoints[j] - controlPoints[j - 2]);
+                fwd = normalize(controlPoints[j] - controlPoints[j - 1]);
             }
 
             // Use quaternions to smoothly rotate the other vectors and update s & t vectors.
@@ -202,43 +265,6 @@ namespace Falcor
             FALCOR_ASSERT_LT(std::abs(length(s) - 1.f), 1e-3f);
             FALCOR_ASSERT_LT(std::abs(length(t) - 1.f), 1e-3f);
         }
-
-        void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t j)
-        {
-            // Mesh vertices, normals, tangents, and texCrds (if any).
-            for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
-            {
-                float phi = (float)k / (float)pointCountPerCrossSection * (float)M_PI * 2.f;
-                float3 vNormal = std::cos(phi) * s + std::sin(phi) * t;
-
-                float curveRadius = 0.5f * optimizedStrandArrays.widths[j];
-                result.vertices.push_back(optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal);
-                result.normals.push_back(vNormal);
-                result.tangents.push_back(float4(fwd.x, fwd.y, fwd.z, 1));
-                result.radii.push_back(curveRadius);
-
-                if (curveArrays.UVs)
-                {
-                    result.texCrds.push_back(optimizedStrandArrays.UVs[j]);
-                }
-            }
-        }
-
-        void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t meshVertexOffset, uint32_t pointCountPerCrossSection, uint32_t quadCountLimit, uint32_t nextCrossSectionVertexOffset, uint32_t multiplier, uint32_t j)
-        {
-            for (uint32_t k = 0; k < quadCountLimit; k++)
-            {
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + k);
-            }
-        }
     }
 
     CurveTessellation::SweptSphereResult CurveTessellation::convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, const float4x4& xform)
@@ -250,93 +276,54 @@ namespace Falcor
         FALCOR_ASSERT(degree == 1);
         result.degree = degree;
 
-        uint32_t pointCounts = 0;
-        uint32_t segCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            pointCounts += tmpPointCount;
-            segCounts += tmpPointCount - 1;
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
-        }
-        result.indices.reserve(segCounts);
-        result.points.reserve(pointCounts);
-        result.radius.reserve(pointCounts);
-        result.texCrds.reserve(pointCounts);
+        CurveArrays curveArrays(controlPoints, widths, UVs);
 
-        uint32_t pointOffset = 0;
+        // Size the output from a prefix sum over the tessellated point counts.
+        // Each strand contributes one segment less than it has points.
+        std::vector<StrandLayout> layouts;
+        uint32_t pointCount = computeStrandLayouts(layouts, strandCount, vertexCountsPerStrand, curveArrays, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand);
+        result.indices.resize(pointCount - layouts.size());
+        result.points.resize(pointCount);
+        result.radius.resize(pointCount);
+        if (UVs) result.texCrds.resize(pointCount);
 
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
-        CurveArrays curveArrays(controlPoints, widths, UVs);
+        const std::vector<float> segmentTs = computeSegmentTs(subdivPerSegment);
 
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+        // Tessellate strands in parallel directly into the output arrays.
+        parallelForStrands(layouts, [&](uint32_t strandIndex, const StrandLayout& layout, StrandScratch& scratch)
         {
-            optimizedStrandArrays.controlPoints.clear();
-            optimizedStrandArrays.UVs.clear();
-            optimizedStrandArrays.widths.clear();
-            optimizedStrandArrays.vertexCount = 0;
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
+            StrandArrays& strandArrays = scratch.strandArrays;
+            strandArrays.vertexCount = vertexCountsPerStrand[layout.strand];
+            removeDuplicatePoints(curveArrays, strandArrays, layout.pointOffset);
+            uint32_t uniquePointCount = (uint32_t)strandArrays.controlPoints.size();
 
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+            const CubicSpline<float3>& splinePoints = scratch.splineCache.splinePoints.setup(strandArrays.controlPoints.data(), uniquePointCount);
+            const CubicSpline<float>& splineWidths = scratch.splineCache.splineWidths.setup(strandArrays.widths.data(), uniquePointCount);
 
-            const CubicSpline<float3>& splinePoints = splineCache.splinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
-            const CubicSpline<float>& splineWidths = splineCache.splineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
+            float3* points = result.points.data() + layout.outputOffset;
+            float* radius = result.radius.data() + layout.outputOffset;
+            sampleSpline(splinePoints, uniquePointCount, segmentTs, keepOneEveryXVerticesPerStrand, [&](uint32_t index, const float3& p) { points[index] = p; });
+            sampleSpline(splineWidths, uniquePointCount, segmentTs, keepOneEveryXVerticesPerStrand, [&](uint32_t index, float w) { radius[index] = sanitizeWidth(w * 0.5f * widthScale); });
 
-            uint32_t tmpCount = 0;
-            for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+            // Pre-transform curve points.
+            for (uint32_t j = 0; j < layout.outputCount; j++)
             {
-                for (uint32_t k = 0; k < subdivPerSegment; k++)
-                {
-                    if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                    {
-                        float t = (float)k / (float)subdivPerSegment;
-                        result.indices.push_back((uint32_t)result.points.size());
-
-                        // Pre-transform curve points.
-                        float4 sph = transformSphere(xform, float4(splinePoints.interpolate(j, t), sanitizeWidth(splineWidths.interpolate(j, t) * 0.5f * widthScale)));
-
-                        result.points.push_back(sph.xyz());
-                        result.radius.push_back(sph.w);
-                    }
-                    tmpCount++;
-                }
+                float4 sph = transformSphere(xform, float4(points[j], radius[j]));
+                points[j] = sph.xyz();
+                radius[j] = sph.w;
             }
 
-            // Always keep the last vertex.
-            float4 sph = transformSphere(xform, float4(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f), sanitizeWidth(splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f) * 0.5f * widthScale)));
-            result.points.push_back(sph.xyz());
-            result.radius.push_back(sph.w);
+            uint32_t* indices = result.indices.data() + layout.outputOffset - strandIndex;
+            for (uint32_t j = 0; j < layout.outputCount - 1; j++) indices[j] = layout.outputOffset + j;
 
             // Texture coordinates.
             if (UVs)
             {
-                const CubicSpline<float2>& splineUVs = splineCache.splineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
-                tmpCount = 0;
-                for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
-                {
-                    for (uint32_t k = 0; k < subdivPerSegment; k++)
-                    {
-                        if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                        {
-                            float t = (float)k / (float)subdivPerSegment;
-                            result.texCrds.push_back(splineUVs.interpolate(j, t));
-                        }
-                        tmpCount++;
-                    }
-                }
-
-                // Always keep the last vertex.
-                result.texCrds.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+                const CubicSpline<float2>& splineUVs = scratch.splineCache.splineUVs.setup(strandArrays.UVs.data(), uniquePointCount);
+                float2* texCrds = result.texCrds.data() + layout.outputOffset;
+                sampleSpline(splineUVs, uniquePointCount, segmentTs, keepOneEveryXVerticesPerStrand, [&](uint32_t index, const float2& uv) { texCrds[index] = uv; });
             }
-
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
-        }
+        });
 
         return result;
     }
@@ -344,73 +331,117 @@ namespace Falcor
     CurveTessellation::MeshResult CurveTessellation::convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection)
     {
         MeshResult result;
-        uint32_t vertexCounts = 0;
-        uint32_t faceCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            vertexCounts += pointCountPerCrossSection * tmpPointCount;
-            faceCounts += 2 * pointCountPerCrossSection * (tmpPointCount - 1);
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
-        }
-        result.vertices.reserve(vertexCounts);
-        result.normals.reserve(vertexCounts);
-        result.tangents.reserve(vertexCounts);
-        result.texCrds.reserve(vertexCounts);
-        result.radii.reserve(vertexCounts);
-        result.faceVertexCounts.reserve(faceCounts);
-        result.faceVertexIndices.reserve(faceCounts * 3);
 
-        uint32_t pointOffset = 0;
-        uint32_t meshVertexOffset = 0;
-
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
         CurveArrays curveArrays(controlPoints, widths, UVs);
 
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+        // Size the output from a prefix sum over the tessellated point counts.
+        // Each tessellated point becomes a cross-section, each pair of consecutive cross-sections is connected by two triangles per point.
+        std::vector<StrandLayout> layouts;
+        uint32_t pointCount = computeStrandLayouts(layouts, strandCount, vertexCountsPerStrand, curveArrays, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand);
+        uint32_t vertexCounts = pointCountPerCrossSection * pointCount;
+        uint32_t faceCounts = 2 * pointCountPerCrossSection * (pointCount - (uint32_t)layouts.size());
+        result.vertices.resize(vertexCounts);
+        result.normals.resize(vertexCounts);
+        result.tangents.resize(vertexCounts);
+        if (UVs) result.texCrds.resize(vertexCounts);
+        result.radii.resize(vertexCounts);
+        result.faceVertexCounts.resize(faceCounts, 3);
+        result.faceVertexIndices.resize(faceCounts * 3);
+
+        const std::vector<float> segmentTs = computeSegmentTs(subdivPerSegment);
+
+        // Cross-section directions are the same for all points.
+        std::vector<float> cosPhi(pointCountPerCrossSection);
+        std::vector<float> sinPhi(pointCountPerCrossSection);
+        for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
         {
-            optimizedStrandArrays.controlPoints.clear();
-            optimizedStrandArrays.UVs.clear();
-            optimizedStrandArrays.widths.clear();
-            optimizedStrandArrays.vertexCount = 0;
+            float phi = (float)k / (float)pointCountPerCrossSection * (float)M_PI * 2.f;
+            cosPhi[k] = std::cos(phi);
+            sinPhi[k] = std::sin(phi);
+        }
 
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
+        // Tessellate strands in parallel directly into the output arrays.
+        parallelForStrands(layouts, [&](uint32_t strandIndex, const StrandLayout& layout, StrandScratch& scratch)
+        {
+            StrandArrays& strandArrays = scratch.strandArrays;
+            strandArrays.vertexCount = vertexCountsPerStrand[layout.strand];
+            removeDuplicatePoints(curveArrays, strandArrays, layout.pointOffset);
+            uint32_t uniquePointCount = (uint32_t)strandArrays.controlPoints.size();
+
+            const CubicSpline<float3>& splinePoints = scratch.splineCache.splinePoints.setup(strandArrays.controlPoints.data(), uniquePointCount);
+            const CubicSpline<float>& splineWidths = scratch.splineCache.splineWidths.setup(strandArrays.widths.data(), uniquePointCount);
+
+            // Tessellated points are written to the first vertex of each cross-section and expanded to tubes below.
+            // Widths are kept in the radii array until then.
+            const uint32_t meshVertexOffset = pointCountPerCrossSection * layout.outputOffset;
+            float3* vertices = result.vertices.data() + meshVertexOffset;
+            float* radii = result.radii.data() + meshVertexOffset;
+            sampleSpline(splinePoints, uniquePointCount, segmentTs, keepOneEveryXVerticesPerStrand, [&](uint32_t index, const float3& p) { vertices[index * pointCountPerCrossSection] = p; });
+            sampleSpline(splineWidths, uniquePointCount, segmentTs, keepOneEveryXVerticesPerStrand, [&](uint32_t index, float w) { radii[index * pointCountPerCrossSection] = sanitizeWidth(kMeshCompensationScale * widthScale * w); });
 
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+            // Texture coordinates.
+            if (UVs)
+            {
+                const CubicSpline<float2>& splineUVs = scratch.splineCache.splineUVs.setup(strandArrays.UVs.data(), uniquePointCount);
+                float2* texCrds = result.texCrds.data() + meshVertexOffset;
+                sampleSpline(splineUVs, uniquePointCount, segmentTs, keepOneEveryXVerticesPerStrand, [&](uint32_t index, const float2& uv) { texCrds[index * pointCountPerCrossSection] = uv; });
+            }
 
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
+            // Gather the tessellated points, which are needed for the frame updates.
+            fast_vector<float3>& points = strandArrays.controlPoints;
+            points.resize(layout.outputCount);
+            for (uint32_t j = 0; j < layout.outputCount; j++) points[j] = vertices[j * pointCountPerCrossSection];
 
             // Build the initial frame.
             float3 fwd, s, t;
-            fwd = normalize(optimizedStrandArrays.controlPoints[1] - optimizedStrandArrays.controlPoints[0]);
+            fwd = normalize(points[1] - points[0]);
             FALCOR_ASSERT_LT(std::abs(length(fwd) - 1.f), 1e-3f);
             buildFrame(fwd, s, t);
 
             // Create mesh.
-            for (uint32_t j = 0; j < optimizedStrandArrays.controlPoints.size(); j++)
+            for (uint32_t j = 0; j < layout.outputCount; j++)
             {
                 // Update the curve's frame vectors: [fwd, s, t]
-                updateCurveFrame(optimizedStrandArrays, fwd, s, t, j);
+                updateCurveFrame(points.data(), layout.outputCount, fwd, s, t, j);
 
                 // Mesh vertices, normals, tangents, and texCrds (if any).
-                updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, j);
-
-                // Mesh faces.
-                if (j < optimizedStrandArrays.controlPoints.size() - 1)
+                const uint32_t crossSectionOffset = j * pointCountPerCrossSection;
+                const float curveRadius = 0.5f * radii[crossSectionOffset];
+                const float4 tangent = float4(fwd.x, fwd.y, fwd.z, 1);
+                for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
+                {
+                    float3 vNormal = cosPhi[k] * s + sinPhi[k] * t;
+                    vertices[crossSectionOffset + k] = points[j] + curveRadius * vNormal;
+                    result.normals[meshVertexOffset + crossSectionOffset + k] = vNormal;
+                    result.tangents[meshVertexOffset + crossSectionOffset + k] = tangent;
+                    radii[crossSectionOffset + k] = curveRadius;
+                }
+                if (UVs)
                 {
-                    uint32_t quadCountLimit = pointCountPerCrossSection;
-                    connectFaceVertices(result, meshVertexOffset, pointCountPerCrossSection, quadCountLimit, 1, 1, j);
+                    float2* texCrds = result.texCrds.data() + meshVertexOffset + crossSectionOffset;
+                    std::fill(texCrds + 1, texCrds + pointCountPerCrossSection, texCrds[0]);
                 }
             }
 
-            meshVertexOffset += pointCountPerCrossSection * (uint32_t)optimizedStrandArrays.controlPoints.size();
-        }
+            // Mesh faces.
+            uint32_t* faceVertexIndices = result.faceVertexIndices.data() + 6 * pointCountPerCrossSection * (layout.outputOffset - strandIndex);
+            for (uint32_t j = 0; j < layout.outputCount - 1; j++)
+            {
+                uint32_t current = meshVertexOffset + j * pointCountPerCrossSection;
+                uint32_t next = current + pointCountPerCrossSection;
+                for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
+                {
+                    uint32_t k1 = (k + 1) % pointCountPerCrossSection;
+                    *faceVertexIndices++ = current + k;
+                    *faceVertexIndices++ = current + k1;
+                    *faceVertexIndices++ = next + k1;
+
+                    *faceVertexIndices++ = current + k;
+                    *faceVertexIndices++ = next + k1;
+                    *faceVertexIndices++ = next + k;
+                }
+            }
+        });
 
         return result;
     }
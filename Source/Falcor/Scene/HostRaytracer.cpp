@@ -0,0 +1,653 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "HostRaytracer.h"
+#include "Scene.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Math/MatrixMath.h"
+#include "Utils/Math/VectorMath.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <algorithm>
+#include <atomic>
+#include <execution>
+#include <numeric>
+
+namespace Falcor
+{
+namespace
+{
+using Node = HostRaytracer::Node;
+
+constexpr uint32_t kBinCount = 16;
+constexpr uint32_t kMaxLeafSize = 4;
+constexpr uint32_t kParallelBuildThreshold = 4096; ///< Subtrees with at least this many primitives are built in parallel.
+constexpr float kTraversalCost = 1.f;
+constexpr float kIntersectionCost = 1.f;
+constexpr uint32_t kStackSize = 512;
+
+/// Node of the intermediate binary BVH.
+struct BinaryNode
+{
+    AABB bounds;
+    uint32_t left = 0;      ///< Left child for inner nodes, or first primitive for leaves.
+    uint32_t right = 0;     ///< Right child for inner nodes.
+    uint32_t primCount = 0; ///< Number of primitives for leaves, or zero for inner nodes.
+};
+
+/**
+ * Binned SAH builder for a binary BVH.
+ * The primitive order is permuted such that each leaf references a contiguous range of primitives.
+ */
+class BinaryBuilder
+{
+public:
+    BinaryBuilder(const std::vector<AABB>& primBounds, std::vector<uint32_t>& primOrder) : mPrimBounds(primBounds), mPrimOrder(primOrder)
+    {
+        const uint32_t primCount = (uint32_t)primBounds.size();
+        mPrimOrder.resize(primCount);
+        std::iota(mPrimOrder.begin(), mPrimOrder.end(), 0);
+        if (primCount == 0)
+            return;
+
+        mCentroids.resize(primCount);
+        for (uint32_t i = 0; i < primCount; ++i)
+            mCentroids[i] = primBounds[i].center();
+
+        // A binary tree with at least one primitive per leaf has at most 2N-1 nodes.
+        mNodes.resize(2 * (size_t)primCount - 1);
+        mNodeCount = 1;
+        buildNode(0, 0, primCount);
+        mNodes.resize(mNodeCount);
+    }
+
+    const std::vector<BinaryNode>& getNodes() const { return mNodes; }
+
+private:
+    void buildNode(uint32_t nodeIndex, uint32_t first, uint32_t count)
+    {
+        BinaryNode& node = mNodes[nodeIndex];
+
+        AABB centroidBounds;
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            node.bounds.include(mPrimBounds[mPrimOrder[i]]);
+            centroidBounds.include(mCentroids[mPrimOrder[i]]);
+        }
+
+        if (count == 1)
+        {
+            node.left = first;
+            node.primCount = count;
+            return;
+        }
+
+        // Find the best split plane over all axes by binning the primitive centroids.
+        const float3 extent = centroidBounds.extent();
+        float bestCost = std::numeric_limits<float>::infinity();
+        int bestAxis = -1;
+        uint32_t bestBin = 0;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (!(extent[axis] > 0.f))
+                continue;
+
+            const float scale = kBinCount / extent[axis];
+            AABB binBounds[kBinCount];
+            uint32_t binCounts[kBinCount] = {};
+            for (uint32_t i = first; i < first + count; ++i)
+            {
+                const uint32_t prim = mPrimOrder[i];
+                const uint32_t bin = getBin(mCentroids[prim][axis], centroidBounds.minPoint[axis], scale);
+                binBounds[bin].include(mPrimBounds[prim]);
+                binCounts[bin]++;
+            }
+
+            // Sweep from the right to compute the cost of all bins to the right of each plane.
+            float rightCosts[kBinCount] = {};
+            AABB rightBounds;
+            uint32_t rightCount = 0;
+            for (uint32_t bin = kBinCount - 1; bin > 0; --bin)
+            {
+                rightBounds.include(binBounds[bin]);
+                rightCount += binCounts[bin];
+                rightCosts[bin] = rightCount > 0 ? rightBounds.area() * rightCount : -1.f;
+            }
+
+            AABB leftBounds;
+            uint32_t leftCount = 0;
+            for (uint32_t bin = 0; bin < kBinCount - 1; ++bin)
+            {
+                leftBounds.include(binBounds[bin]);
+                leftCount += binCounts[bin];
+                if (leftCount == 0 || rightCosts[bin + 1] < 0.f)
+                    continue;
+                const float cost = leftBounds.area() * leftCount + rightCosts[bin + 1];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = bin;
+                }
+            }
+        }
+
+        const float area = node.bounds.area();
+        const float leafCost = kIntersectionCost * count;
+        const float splitCost = kTraversalCost + kIntersectionCost * (area > 0.f ? bestCost / area : 0.f);
+
+        uint32_t mid = 0;
+        if (bestAxis >= 0 && (count > kMaxLeafSize || splitCost < leafCost))
+        {
+            const float scale = kBinCount / extent[bestAxis];
+            const float minPoint = centroidBounds.minPoint[bestAxis];
+            auto it = std::partition(
+                mPrimOrder.begin() + first,
+                mPrimOrder.begin() + first + count,
+                [&](uint32_t prim) { return getBin(mCentroids[prim][bestAxis], minPoint, scale) <= bestBin; }
+            );
+            mid = (uint32_t)(it - mPrimOrder.begin());
+        }
+        else if (count > kMaxLeafSize)
+        {
+            // All centroids coincide, split in the middle.
+            mid = first + count / 2;
+        }
+        else
+        {
+            node.left = first;
+            node.primCount = count;
+            return;
+        }
+        FALCOR_ASSERT(mid > first && mid < first + count);
+
+        const uint32_t left = mNodeCount.fetch_add(2);
+        node.left = left;
+        node.right = left + 1;
+
+        if (count >= kParallelBuildThreshold)
+        {
+            NumericRange<uint32_t> range(0, 2);
+            std::for_each(
+                std::execution::par,
+                range.begin(),
+                range.end(),
+                [&](uint32_t i)
+                {
+                    if (i == 0)
+                        buildNode(left, first, mid - first);
+                    else
+                        buildNode(left + 1, mid, first + count - mid);
+                }
+            );
+        }
+        else
+        {
+            buildNode(left, first, mid - first);
+            buildNode(left + 1, mid, first + count - mid);
+        }
+    }
+
+    static uint32_t getBin(float centroid, float minPoint, float scale)
+    {
+        return std::min((uint32_t)((centroid - minPoint) * scale), kBinCount - 1);
+    }
+
+    const std::vector<AABB>& mPrimBounds;
+    std::vector<uint32_t>& mPrimOrder;
+    std::vector<float3> mCentroids;
+    std::vector<BinaryNode> mNodes;
+    std::atomic<uint32_t> mNodeCount{0};
+};
+
+/// Collapse the binary BVH subtree at binaryIndex into the 8-wide node at nodeIndex.
+void collapseNode(const std::vector<BinaryNode>& binaryNodes, uint32_t binaryIndex, std::vector<Node>& nodes, uint32_t nodeIndex)
+{
+    uint32_t children[8];
+    uint32_t childCount = 0;
+
+    const BinaryNode& binaryNode = binaryNodes[binaryIndex];
+    if (binaryNode.primCount > 0)
+    {
+        // Only happens if the root is a leaf.
+        children[childCount++] = binaryIndex;
+    }
+    else
+    {
+        children[childCount++] = binaryNode.left;
+        children[childCount++] = binaryNode.right;
+    }
+
+    // Repeatedly open the inner child with the largest surface area until the node is full.
+    while (childCount < 8)
+    {
+        int bestChild = -1;
+        float bestArea = -1.f;
+        for (uint32_t i = 0; i < childCount; ++i)
+        {
+            const BinaryNode& child = binaryNodes[children[i]];
+            if (child.primCount == 0 && child.bounds.area() > bestArea)
+            {
+                bestArea = child.bounds.area();
+                bestChild = (int)i;
+            }
+        }
+        if (bestChild < 0)
+            break;
+        const BinaryNode& child = binaryNodes[children[bestChild]];
+        children[bestChild] = child.left;
+        children[childCount++] = child.right;
+    }
+
+    Node node;
+    std::fill_n(node.minX, 8, std::numeric_limits<float>::infinity());
+    std::fill_n(node.minY, 8, std::numeric_limits<float>::infinity());
+    std::fill_n(node.minZ, 8, std::numeric_limits<float>::infinity());
+    std::fill_n(node.maxX, 8, -std::numeric_limits<float>::infinity());
+    std::fill_n(node.maxY, 8, -std::numeric_limits<float>::infinity());
+    std::fill_n(node.maxZ, 8, -std::numeric_limits<float>::infinity());
+    std::fill_n(node.child, 8, HostRaytracer::kInvalidIndex);
+    std::fill_n(node.primCount, 8, 0);
+    node.childCount = childCount;
+
+    for (uint32_t i = 0; i < childCount; ++i)
+    {
+        const BinaryNode& child = binaryNodes[children[i]];
+        node.minX[i] = child.bounds.minPoint.x;
+        node.minY[i] = child.bounds.minPoint.y;
+        node.minZ[i] = child.bounds.minPoint.z;
+        node.maxX[i] = child.bounds.maxPoint.x;
+        node.maxY[i] = child.bounds.maxPoint.y;
+        node.maxZ[i] = child.bounds.maxPoint.z;
+
+        if (child.primCount > 0)
+        {
+            node.child[i] = child.left;
+            node.primCount[i] = child.primCount;
+        }
+        else
+        {
+            const uint32_t childIndex = (uint32_t)nodes.size();
+            nodes.emplace_back();
+            node.child[i] = childIndex;
+            collapseNode(binaryNodes, children[i], nodes, childIndex);
+        }
+    }
+
+    nodes[nodeIndex] = node;
+}
+
+/// Build an 8-wide BVH over primitive bounds. Returns the nodes and the primitive order of the leaves.
+std::vector<Node> buildBvh(const std::vector<AABB>& primBounds, std::vector<uint32_t>& primOrder)
+{
+    std::vector<Node> nodes;
+    BinaryBuilder builder(primBounds, primOrder);
+    if (builder.getNodes().empty())
+        return nodes;
+
+    nodes.reserve(builder.getNodes().size() / 4 + 1);
+    nodes.emplace_back();
+    collapseNode(builder.getNodes(), 0, nodes, 0);
+    return nodes;
+}
+
+/**
+ * Traverse an 8-wide BVH.
+ * The intersect function is called as intersect(primIndex, tMax) for all primitives in leaves that the ray
+ * overlaps. It returns true on a hit and updates tMax accordingly.
+ * @return True if anything was hit.
+ */
+template<bool AnyHit, typename IntersectFn>
+bool traverseBvh(const std::vector<Node>& nodes, const float3& origin, const float3& dir, float tMin, float& tMax, IntersectFn intersect)
+{
+    if (nodes.empty())
+        return false;
+
+    const float3 invDir = 1.f / dir;
+
+    struct StackEntry
+    {
+        uint32_t child;
+        uint32_t primCount;
+        float t;
+    };
+    StackEntry stack[kStackSize];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = {0, 0, tMin};
+
+    bool anyHit = false;
+    while (stackSize > 0)
+    {
+        const StackEntry entry = stack[--stackSize];
+        if (entry.t > tMax)
+            continue;
+
+        if (entry.primCount > 0)
+        {
+            for (uint32_t i = entry.child; i < entry.child + entry.primCount; ++i)
+            {
+                if (intersect(i, tMax))
+                {
+                    anyHit = true;
+                    if (AnyHit)
+                        return true;
+                }
+            }
+            continue;
+        }
+
+        // Test all eight children. This loop is written to be vectorized by the compiler.
+        const Node& node = nodes[entry.child];
+        float tNear[8];
+        bool childHit[8];
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            const float tx0 = (node.minX[i] - origin.x) * invDir.x;
+            const float tx1 = (node.maxX[i] - origin.x) * invDir.x;
+            const float ty0 = (node.minY[i] - origin.y) * invDir.y;
+            const float ty1 = (node.maxY[i] - origin.y) * invDir.y;
+            const float tz0 = (node.minZ[i] - origin.z) * invDir.z;
+            const float tz1 = (node.maxZ[i] - origin.z) * invDir.z;
+            const float t0 = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), tMin));
+            const float t1 = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), tMax));
+            tNear[i] = t0;
+            childHit[i] = t0 <= t1;
+        }
+
+        // Push the children that were hit sorted by distance, nearest last so that it is popped first.
+        const uint32_t stackBase = stackSize;
+        for (uint32_t i = 0; i < node.childCount; ++i)
+        {
+            if (!childHit[i])
+                continue;
+            FALCOR_ASSERT(stackSize < kStackSize);
+            uint32_t j = stackSize++;
+            while (j > stackBase && stack[j - 1].t < tNear[i])
+            {
+                stack[j] = stack[j - 1];
+                --j;
+            }
+            stack[j] = {node.child[i], node.primCount[i], tNear[i]};
+        }
+    }
+    return anyHit;
+}
+} // namespace
+
+HostRaytracer::HostRaytracer(const std::vector<BlasDesc>& blases, const std::vector<InstanceDesc>& instances)
+{
+    build(blases, instances);
+}
+
+HostRaytracer::HostRaytracer(const Scene& scene)
+{
+    const auto& meshGroups = scene.mMeshGroups;
+    const auto& globalMatrices = scene.mpAnimationController->getGlobalMatrices();
+
+    // Gather the triangles of each mesh group. This follows the geometry setup in Scene::initGeomDesc().
+    std::vector<BlasDesc> blases(meshGroups.size());
+    NumericRange<size_t> range(0, meshGroups.size());
+    std::for_each(
+        std::execution::par,
+        range.begin(),
+        range.end(),
+        [&](size_t groupIndex)
+        {
+            if (meshGroups[groupIndex].isDisplaced)
+                return;
+
+            const auto& meshList = meshGroups[groupIndex].meshList;
+            BlasDesc& blas = blases[groupIndex];
+            blas.resize(meshList.size());
+            for (size_t geometryIndex = 0; geometryIndex < meshList.size(); ++geometryIndex)
+            {
+                const MeshDesc& mesh = scene.mMeshDesc[meshList[geometryIndex].get()];
+                Geometry& geometry = blas[geometryIndex];
+
+                geometry.positions.resize(mesh.vertexCount);
+                for (uint32_t i = 0; i < mesh.vertexCount; ++i)
+                    geometry.positions[i] = scene.mMeshStaticData[mesh.vbOffset + i].position;
+
+                const uint32_t indexCount = mesh.getTriangleCount() * 3;
+                geometry.indices.resize(indexCount);
+                if (mesh.useVertexIndices())
+                {
+                    const uint32_t* pIndexData = &scene.mMeshIndexData[mesh.ibOffset];
+                    if (mesh.use16BitIndices())
+                        std::copy_n(reinterpret_cast<const uint16_t*>(pIndexData), indexCount, geometry.indices.begin());
+                    else
+                        std::copy_n(pIndexData, indexCount, geometry.indices.begin());
+                }
+                else
+                {
+                    std::iota(geometry.indices.begin(), geometry.indices.end(), 0);
+                }
+            }
+        }
+    );
+
+    // Create one instance per TLAS instance. This follows the instance setup in Scene::fillInstanceDesc().
+    std::vector<InstanceDesc> instances;
+    uint32_t instanceID = 0;
+    for (size_t groupIndex = 0; groupIndex < meshGroups.size(); ++groupIndex)
+    {
+        const auto& meshList = meshGroups[groupIndex].meshList;
+        const size_t instanceCount = scene.mMeshIdToInstanceIds[meshList[0].get()].size();
+        for (size_t instanceIdx = 0; instanceIdx < instanceCount; ++instanceIdx)
+        {
+            InstanceDesc desc;
+            desc.blasIndex = (uint32_t)groupIndex;
+            desc.instanceID = instanceID;
+            if (!meshGroups[groupIndex].isStatic)
+                desc.transform = globalMatrices[scene.mGeometryInstanceData[instanceID].globalMatrixID];
+            instanceID += (uint32_t)meshList.size();
+
+            if (!meshGroups[groupIndex].isDisplaced)
+                instances.push_back(desc);
+        }
+    }
+
+    build(blases, instances);
+}
+
+void HostRaytracer::build(const std::vector<BlasDesc>& blases, const std::vector<InstanceDesc>& instances)
+{
+    auto startTime = CpuTimer::getCurrentTimePoint();
+
+    // Validate the input before building in parallel.
+    for (const BlasDesc& blas : blases)
+    {
+        for (const Geometry& geometry : blas)
+        {
+            FALCOR_CHECK(geometry.indices.size() % 3 == 0, "Index count must be a multiple of three.");
+            for (uint32_t index : geometry.indices)
+                FALCOR_CHECK(index < geometry.positions.size(), "Vertex index {} is out of range.", index);
+        }
+    }
+    for (const InstanceDesc& instance : instances)
+        FALCOR_CHECK(instance.blasIndex < blases.size(), "BLAS index {} is out of range.", instance.blasIndex);
+
+    // Build the bottom-level BVHs.
+    mBlases.clear();
+    mBlases.resize(blases.size());
+    NumericRange<size_t> blasRange(0, blases.size());
+    std::for_each(
+        std::execution::par,
+        blasRange.begin(),
+        blasRange.end(),
+        [&](size_t blasIndex)
+        {
+            const BlasDesc& desc = blases[blasIndex];
+            Blas& blas = mBlases[blasIndex];
+
+            std::vector<Triangle> triangles;
+            std::vector<AABB> primBounds;
+            for (uint32_t geometryIndex = 0; geometryIndex < (uint32_t)desc.size(); ++geometryIndex)
+            {
+                const Geometry& geometry = desc[geometryIndex];
+                const uint32_t triangleCount = (uint32_t)(geometry.indices.size() / 3);
+                for (uint32_t i = 0; i < triangleCount; ++i)
+                {
+                    const float3 v0 = geometry.positions[geometry.indices[i * 3]];
+                    const float3 v1 = geometry.positions[geometry.indices[i * 3 + 1]];
+                    const float3 v2 = geometry.positions[geometry.indices[i * 3 + 2]];
+                    triangles.push_back({v0, v1 - v0, v2 - v0, geometryIndex, i});
+                    primBounds.push_back(AABB(v0).include(v1).include(v2));
+                    blas.bounds.include(primBounds.back());
+                }
+            }
+
+            std::vector<uint32_t> primOrder;
+            blas.nodes = buildBvh(primBounds, primOrder);
+            blas.triangles.resize(triangles.size());
+            for (size_t i = 0; i < primOrder.size(); ++i)
+                blas.triangles[i] = triangles[primOrder[i]];
+        }
+    );
+
+    // Build the top-level BVH. Instances of empty BLASes are skipped.
+    std::vector<Instance> validInstances;
+    std::vector<AABB> instanceBounds;
+    mBounds = AABB();
+    for (const InstanceDesc& desc : instances)
+    {
+        const AABB bounds = mBlases[desc.blasIndex].bounds.transform(desc.transform);
+        if (!bounds.valid())
+            continue;
+        validInstances.push_back({desc.blasIndex, desc.instanceID, inverse(desc.transform)});
+        instanceBounds.push_back(bounds);
+        mBounds.include(bounds);
+    }
+
+    std::vector<uint32_t> instanceOrder;
+    mTlasNodes = buildBvh(instanceBounds, instanceOrder);
+    mInstances.resize(validInstances.size());
+    for (size_t i = 0; i < instanceOrder.size(); ++i)
+        mInstances[i] = validInstances[instanceOrder[i]];
+
+    mStats = {};
+    mStats.blasCount = (uint32_t)mBlases.size();
+    mStats.instanceCount = (uint32_t)mInstances.size();
+    mStats.nodeCount = mTlasNodes.size();
+    for (const Blas& blas : mBlases)
+    {
+        mStats.triangleCount += blas.triangles.size();
+        mStats.nodeCount += blas.nodes.size();
+    }
+    mStats.buildTime = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+
+    logDebug(
+        "HostRaytracer: Built {} BLASes with {} triangles and {} instances ({} nodes) in {:.1f} ms.",
+        mStats.blasCount,
+        mStats.triangleCount,
+        mStats.instanceCount,
+        mStats.nodeCount,
+        mStats.buildTime * 1e3
+    );
+}
+
+template<bool AnyHit>
+bool HostRaytracer::trace(const Ray& ray, TriangleHit& hit) const
+{
+    float tMax = ray.tMax;
+
+    auto intersectInstance = [&](uint32_t instanceIndex, float& tMaxWorld)
+    {
+        const Instance& instance = mInstances[instanceIndex];
+        const Blas& blas = mBlases[instance.blasIndex];
+
+        // Transform the ray to object space. The direction is not normalized so that distances are preserved.
+        const float3 origin = transformPoint(instance.worldToObject, ray.origin);
+        const float3 dir = transformVector(instance.worldToObject, ray.dir);
+
+        auto intersectTriangle = [&](uint32_t triangleIndex, float& tMaxObject)
+        {
+            // Moller-Trumbore ray-triangle intersection without backface culling.
+            const Triangle& tri = blas.triangles[triangleIndex];
+            const float3 p = cross(dir, tri.e2);
+            const float det = dot(tri.e1, p);
+            if (det == 0.f)
+                return false;
+            const float invDet = 1.f / det;
+            const float3 s = origin - tri.v0;
+            const float u = dot(s, p) * invDet;
+            if (u < 0.f || u > 1.f)
+                return false;
+            const float3 q = cross(s, tri.e1);
+            const float v = dot(dir, q) * invDet;
+            if (v < 0.f || u + v > 1.f)
+                return false;
+            const float t = dot(tri.e2, q) * invDet;
+            if (t < ray.tMin || t >= tMaxObject)
+                return false;
+
+            tMaxObject = t;
+            if (!AnyHit)
+            {
+                hit.instanceID = instance.instanceID + tri.geometryIndex;
+                hit.primitiveIndex = tri.primitiveIndex;
+                hit.barycentrics = float2(u, v);
+                hit.t = t;
+            }
+            return true;
+        };
+
+        return traverseBvh<AnyHit>(blas.nodes, origin, dir, ray.tMin, tMaxWorld, intersectTriangle);
+    };
+
+    return traverseBvh<AnyHit>(mTlasNodes, ray.origin, ray.dir, ray.tMin, tMax, intersectInstance);
+}
+
+HostRaytracer::TriangleHit HostRaytracer::traceClosest(const Ray& ray) const
+{
+    TriangleHit hit;
+    trace<false>(ray, hit);
+    return hit;
+}
+
+bool HostRaytracer::traceAny(const Ray& ray) const
+{
+    TriangleHit hit;
+    return trace<true>(ray, hit);
+}
+
+void HostRaytracer::traceClosest(const std::vector<Ray>& rays, std::vector<TriangleHit>& hits) const
+{
+    hits.resize(rays.size());
+    NumericRange<size_t> range(0, rays.size());
+    std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { hits[i] = traceClosest(rays[i]); });
+}
+
+void HostRaytracer::traceAny(const std::vector<Ray>& rays, std::vector<uint8_t>& hits) const
+{
+    hits.resize(rays.size());
+    NumericRange<size_t> range(0, rays.size());
+    std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { hits[i] = traceAny(rays[i]) ? 1 : 0; });
+}
+} // namespace Falcor
@@ -0,0 +1,203 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+class Scene;
+
+/**
+ * Host-side ray tracer for triangle meshes.
+ *
+ * The acceleration structure mirrors the one built for DXR: there is one bottom-level BVH per mesh group and
+ * a top-level BVH over the instances of the mesh groups. Hits report the same instance ID, primitive index and
+ * barycentrics as TriangleHit in HitInfo.slang, so they can be used directly with the Scene API
+ * (e.g. Scene::getGeometryInstance()).
+ *
+ * The BVHs are built with binned SAH into a binary tree, which is then collapsed into an 8-wide tree.
+ * The child bounds of each node are stored in SoA layout so that the eight ray-box tests vectorize.
+ * Large subtrees and independent BVHs are built in parallel. Batches of rays are traced in parallel.
+ *
+ * Limitations: All geometry is treated as opaque. Displaced meshes are skipped and skinned or vertex-animated
+ * meshes are traced in their bind pose. Curves, SDF grids and custom primitives are ignored.
+ */
+class FALCOR_API HostRaytracer
+{
+public:
+    static constexpr uint32_t kInvalidIndex = 0xffffffff;
+
+    /// Ray description. Matches RayDesc in HLSL.
+    struct Ray
+    {
+        float3 origin = float3(0.f);
+        float tMin = 0.f;
+        float3 dir = float3(0.f, 0.f, 1.f);
+        float tMax = std::numeric_limits<float>::infinity();
+    };
+
+    /// Triangle hit. The fields match TriangleHit in HitInfo.slang.
+    struct TriangleHit
+    {
+        uint32_t instanceID = kInvalidIndex; ///< Geometry instance ID.
+        uint32_t primitiveIndex = 0;         ///< Triangle index within the mesh.
+        float2 barycentrics = float2(0.f);   ///< Barycentrics of the second and third vertex.
+        float t = 0.f;                       ///< Hit distance along the ray.
+
+        bool isValid() const { return instanceID != kInvalidIndex; }
+    };
+
+    /// Triangle mesh in object space.
+    struct Geometry
+    {
+        std::vector<float3> positions;
+        std::vector<uint32_t> indices; ///< Triangle list indices.
+    };
+
+    /// Bottom-level acceleration structure description. The geometries are indexed in order.
+    using BlasDesc = std::vector<Geometry>;
+
+    /// Instance of a bottom-level acceleration structure.
+    struct InstanceDesc
+    {
+        uint32_t blasIndex = 0;
+        uint32_t instanceID = 0; ///< Instance ID of the first geometry. A hit reports instanceID + geometry index.
+        float4x4 transform = float4x4::identity();
+    };
+
+    struct Stats
+    {
+        uint32_t blasCount = 0;
+        uint32_t instanceCount = 0;
+        uint64_t triangleCount = 0; ///< Number of unique triangles.
+        uint64_t nodeCount = 0;     ///< Number of BVH nodes in all acceleration structures.
+        double buildTime = 0.0;     ///< Build time in seconds.
+    };
+
+    /**
+     * Build the acceleration structures.
+     * @param[in] blases List of bottom-level acceleration structures.
+     * @param[in] instances List of instances.
+     */
+    HostRaytracer(const std::vector<BlasDesc>& blases, const std::vector<InstanceDesc>& instances);
+
+    /**
+     * Build the acceleration structures from the mesh groups and instance transforms of a scene.
+     * The transforms are taken from the current state of the animation controller.
+     * @param[in] scene Scene.
+     */
+    explicit HostRaytracer(const Scene& scene);
+
+    /**
+     * Find the closest hit along a ray.
+     * @param[in] ray Ray.
+     * @return Closest hit, or an invalid hit on a miss.
+     */
+    TriangleHit traceClosest(const Ray& ray) const;
+
+    /**
+     * Check if there is any hit along a ray.
+     * @param[in] ray Ray.
+     * @return True if the ray hits anything within [tMin, tMax].
+     */
+    bool traceAny(const Ray& ray) const;
+
+    /**
+     * Find the closest hits for a batch of rays. The rays are traced in parallel.
+     * @param[in] rays Rays.
+     * @param[out] hits Closest hits, one per ray.
+     */
+    void traceClosest(const std::vector<Ray>& rays, std::vector<TriangleHit>& hits) const;
+
+    /**
+     * Check for any hits for a batch of rays. The rays are traced in parallel.
+     * @param[in] rays Rays.
+     * @param[out] hits Set to 1 for rays that hit anything, 0 otherwise.
+     */
+    void traceAny(const std::vector<Ray>& rays, std::vector<uint8_t>& hits) const;
+
+    /// Get the bounds of all instances.
+    const AABB& getBounds() const { return mBounds; }
+
+    const Stats& getStats() const { return mStats; }
+
+    /// 8-wide BVH node. The child bounds are stored in SoA layout.
+    struct Node
+    {
+        float minX[8];
+        float minY[8];
+        float minZ[8];
+        float maxX[8];
+        float maxY[8];
+        float maxZ[8];
+        uint32_t child[8];     ///< Child node index for inner children, or first primitive for leaves.
+        uint32_t primCount[8]; ///< Number of primitives for leaves, or zero for inner children.
+        uint32_t childCount;
+    };
+
+private:
+    struct Triangle
+    {
+        float3 v0;
+        float3 e1; ///< v1 - v0.
+        float3 e2; ///< v2 - v0.
+        uint32_t geometryIndex;
+        uint32_t primitiveIndex;
+    };
+
+    struct Blas
+    {
+        std::vector<Node> nodes;
+        std::vector<Triangle> triangles; ///< Triangles in leaf order.
+        AABB bounds;
+    };
+
+    struct Instance
+    {
+        uint32_t blasIndex;
+        uint32_t instanceID;
+        float4x4 worldToObject;
+    };
+
+    void build(const std::vector<BlasDesc>& blases, const std::vector<InstanceDesc>& instances);
+    template<bool AnyHit>
+    bool trace(const Ray& ray, TriangleHit& hit) const;
+
+    std::vector<Blas> mBlases;
+    std::vector<Node> mTlasNodes;
+    std::vector<Instance> mInstances; ///< Instances in leaf order.
+    AABB mBounds;
+    Stats mStats;
+};
+} // namespace Falcor
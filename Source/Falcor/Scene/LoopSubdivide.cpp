@@ -0,0 +1,608 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+
+// This code is based on pbrt:
+// pbrt is Copyright(c) 1998-2020 Matt Pharr, Wenzel Jakob, and Greg Humphreys.
+// The pbrt source code is licensed under the Apache License, Version 2.0.
+// SPDX: Apache-2.0
+
+#include "LoopSubdivide.h"
+#include "Core/Error.h"
+#include "Utils/JobSystem.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <cmath>
+
+namespace Falcor
+{
+
+// The subdivision mesh is stored as flat arrays per level. Faces reference vertices and
+// neighboring faces by index. Children are implicit: vertex i of a level is the even child of
+// vertex i of the previous level, odd (edge) vertices are appended after the even vertices, and
+// face i has the children 4 * i + k (k = 0..3). Vertex and face ordering as well as the order of
+// all floating-point operations match the original pbrt-v3 implementation, so results are identical.
+
+#define NEXT(i) (((i) + 1) % 3)
+#define PREV(i) (((i) + 2) % 3)
+
+namespace
+{
+constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+struct SDVertex
+{
+    uint32_t startFace = kInvalidIndex;
+    bool regular = false;
+    bool boundary = false;
+};
+
+struct SDFace
+{
+    uint32_t v[3];
+    uint32_t f[3];
+};
+
+struct SDMesh
+{
+    std::vector<float3> positions;
+    std::vector<SDVertex> vertices;
+    std::vector<SDFace> faces;
+
+    uint32_t vnum(uint32_t face, uint32_t vert) const
+    {
+        const SDFace& f = faces[face];
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            if (f.v[i] == vert)
+                return i;
+        }
+        FALCOR_THROW("Basic logic error in SDMesh::vnum().");
+    }
+
+    uint32_t nextFace(uint32_t face, uint32_t vert) const { return faces[face].f[vnum(face, vert)]; }
+    uint32_t prevFace(uint32_t face, uint32_t vert) const { return faces[face].f[PREV(vnum(face, vert))]; }
+    uint32_t nextVert(uint32_t face, uint32_t vert) const { return faces[face].v[NEXT(vnum(face, vert))]; }
+    uint32_t prevVert(uint32_t face, uint32_t vert) const { return faces[face].v[PREV(vnum(face, vert))]; }
+    uint32_t otherVert(uint32_t face, uint32_t v0, uint32_t v1) const
+    {
+        const SDFace& f = faces[face];
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            if (f.v[i] != v0 && f.v[i] != v1)
+                return f.v[i];
+        }
+        FALCOR_THROW("Basic logic error in SDMesh::otherVert()");
+    }
+
+    uint32_t valence(uint32_t vert) const
+    {
+        const SDVertex& v = vertices[vert];
+        uint32_t f = v.startFace;
+        if (!v.boundary)
+        {
+            // Compute valence of interior vertex.
+            uint32_t nf = 1;
+            while ((f = nextFace(f, vert)) != v.startFace)
+                ++nf;
+            return nf;
+        }
+        else
+        {
+            // Compute valence of boundary vertex
+            uint32_t nf = 1;
+            while ((f = nextFace(f, vert)) != kInvalidIndex)
+                ++nf;
+            f = v.startFace;
+            while ((f = prevFace(f, vert)) != kInvalidIndex)
+                ++nf;
+            return nf + 1;
+        }
+    }
+
+    void oneRing(uint32_t vert, float3* p) const
+    {
+        const SDVertex& v = vertices[vert];
+        if (!v.boundary)
+        {
+            // Get one-ring vertices for interior vertex.
+            uint32_t face = v.startFace;
+            do
+            {
+                *p++ = positions[nextVert(face, vert)];
+                face = nextFace(face, vert);
+            } while (face != v.startFace);
+        }
+        else
+        {
+            // Get one-ring vertices for boundary vertex.
+            uint32_t face = v.startFace;
+            uint32_t f2;
+            while ((f2 = nextFace(face, vert)) != kInvalidIndex)
+            {
+                face = f2;
+            }
+            *p++ = positions[nextVert(face, vert)];
+            do
+            {
+                *p++ = positions[prevVert(face, vert)];
+                face = prevFace(face, vert);
+            } while (face != kInvalidIndex);
+        }
+    }
+};
+
+/**
+ * Storage for the one-ring of a vertex.
+ * Uses inline storage for common valences and only allocates for very high valence vertices.
+ */
+class OneRing
+{
+public:
+    float3* get(uint32_t valence)
+    {
+        if (valence <= kInlineSize)
+            return mInline;
+        mHeap.resize(valence);
+        return mHeap.data();
+    }
+
+private:
+    static constexpr uint32_t kInlineSize = 16;
+    float3 mInline[kInlineSize];
+    std::vector<float3> mHeap;
+};
+
+/**
+ * Open addressing hash table mapping undirected edges (vertex index pairs) to a 32-bit value.
+ */
+class EdgeTable
+{
+public:
+    EdgeTable(size_t maxEdgeCount)
+    {
+        size_t capacity = 16;
+        uint32_t bits = 4;
+        while (capacity < maxEdgeCount + maxEdgeCount / 2)
+        {
+            capacity <<= 1;
+            ++bits;
+        }
+        mKeys.assign(capacity, kEmptyKey);
+        mValues.resize(capacity);
+        mMask = capacity - 1;
+        mShift = 64 - bits;
+    }
+
+    /**
+     * Find the entry of an edge and insert it if it does not exist yet.
+     * @param[in] v0 First vertex of the edge.
+     * @param[in] v1 Second vertex of the edge.
+     * @param[out] inserted True if the entry was newly inserted.
+     * @return Reference to the value of the entry.
+     */
+    uint32_t& findOrInsert(uint32_t v0, uint32_t v1, bool& inserted)
+    {
+        const uint64_t key = (uint64_t(std::min(v0, v1)) << 32) | uint64_t(std::max(v0, v1));
+        size_t slot = size_t((key * 0x9e3779b97f4a7c15ull) >> mShift);
+        while (true)
+        {
+            if (mKeys[slot] == key)
+            {
+                inserted = false;
+                return mValues[slot];
+            }
+            if (mKeys[slot] == kEmptyKey)
+            {
+                mKeys[slot] = key;
+                inserted = true;
+                return mValues[slot];
+            }
+            slot = (slot + 1) & mMask;
+        }
+    }
+
+private:
+    static constexpr uint64_t kEmptyKey = std::numeric_limits<uint64_t>::max();
+
+    std::vector<uint64_t> mKeys;
+    std::vector<uint32_t> mValues;
+    size_t mMask;
+    uint32_t mShift;
+};
+
+inline float beta(uint32_t valence)
+{
+    if (valence == 3)
+        return 3.f / 16.f;
+    else
+        return 3.f / (8.f * valence);
+}
+
+inline float loopGamma(uint32_t valence)
+{
+    return 1.f / (valence + 3.f / (8.f * beta(valence)));
+}
+
+float3 weightOneRing(const SDMesh& mesh, uint32_t vert, uint32_t valence, float beta, OneRing& ring)
+{
+    // Put vert one-ring in pRing.
+    float3* pRing = ring.get(valence);
+    mesh.oneRing(vert, pRing);
+
+    float3 p = (1 - valence * beta) * mesh.positions[vert];
+    for (uint32_t i = 0; i < valence; ++i)
+    {
+        p += beta * pRing[i];
+    }
+    return p;
+}
+
+float3 weightBoundary(const SDMesh& mesh, uint32_t vert, uint32_t valence, float beta, OneRing& ring)
+{
+    // Put vert one-ring in pRing.
+    float3* pRing = ring.get(valence);
+    mesh.oneRing(vert, pRing);
+
+    float3 p = (1 - 2 * beta) * mesh.positions[vert];
+    p += beta * pRing[0];
+    p += beta * pRing[valence - 1];
+    return p;
+}
+
+template<typename Func>
+void parallelFor(size_t count, Func func)
+{
+    JobSystem::getGlobal().parallelFor(0, count, func);
+}
+
+SDMesh createBaseMesh(fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+{
+    FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+    FALCOR_CHECK(positions.size() < kInvalidIndex && indices.size() / 3 < kInvalidIndex, "Mesh is too large.");
+
+    SDMesh mesh;
+    mesh.positions.assign(positions.begin(), positions.end());
+    mesh.vertices.resize(positions.size());
+    size_t faceCount = indices.size() / 3;
+    mesh.faces.resize(faceCount);
+
+    // Set face to vertex pointers.
+    for (size_t i = 0; i < faceCount; ++i)
+    {
+        SDFace& f = mesh.faces[i];
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            uint32_t v = indices[3 * i + j];
+            FALCOR_CHECK(v < positions.size(), "Vertex index {} is out of range.", v);
+            f.v[j] = v;
+            f.f[j] = kInvalidIndex;
+            mesh.vertices[v].startFace = (uint32_t)i;
+        }
+    }
+    for (size_t i = 0; i < mesh.vertices.size(); ++i)
+        FALCOR_CHECK(mesh.vertices[i].startFace != kInvalidIndex, "Vertex {} is not referenced by any face.", i);
+
+    // Set neighbor pointers in faces.
+    // Each edge table entry holds the face edge (3 * face + edgeNum) that first saw the edge,
+    // or kInvalidIndex once the edge has been matched with a second face.
+    EdgeTable edges(3 * faceCount);
+    for (uint32_t i = 0; i < faceCount; ++i)
+    {
+        SDFace& f = mesh.faces[i];
+        for (uint32_t edgeNum = 0; edgeNum < 3; ++edgeNum)
+        {
+            // Update neighbor pointer for edgeNum.
+            bool inserted;
+            uint32_t& entry = edges.findOrInsert(f.v[edgeNum], f.v[NEXT(edgeNum)], inserted);
+            if (inserted || entry == kInvalidIndex)
+            {
+                // Handle new edge.
+                entry = 3 * i + edgeNum;
+            }
+            else
+            {
+                // Handle previously seen edge.
+                mesh.faces[entry / 3].f[entry % 3] = i;
+                f.f[edgeNum] = entry / 3;
+                entry = kInvalidIndex;
+            }
+        }
+    }
+
+    // Finish vertex initialization.
+    parallelFor(
+        mesh.vertices.size(),
+        [&](size_t i)
+        {
+            uint32_t vi = (uint32_t)i;
+            SDVertex& v = mesh.vertices[vi];
+            uint32_t f = v.startFace;
+            do
+            {
+                f = mesh.nextFace(f, vi);
+            } while ((f != kInvalidIndex) && f != v.startFace);
+            v.boundary = (f == kInvalidIndex);
+            if (!v.boundary && mesh.valence(vi) == 6)
+                v.regular = true;
+            else if (v.boundary && mesh.valence(vi) == 4)
+                v.regular = true;
+            else
+                v.regular = false;
+        }
+    );
+
+    return mesh;
+}
+
+SDMesh subdivideLevel(const SDMesh& mesh)
+{
+    const uint32_t vertexCount = (uint32_t)mesh.vertices.size();
+    const uint32_t faceCount = (uint32_t)mesh.faces.size();
+    FALCOR_CHECK(faceCount <= kInvalidIndex / 4, "Subdivided mesh is too large.");
+
+    // Enumerate unique edges in order of first occurrence. These become the new odd vertices.
+    std::vector<uint32_t> faceEdges(3 * (size_t)faceCount);
+    std::vector<uint32_t> edgeOwners; // Face edge (3 * face + k) that first saw the edge.
+    edgeOwners.reserve(3 * (size_t)faceCount / 2 + 1);
+    {
+        EdgeTable edgeVerts(3 * (size_t)faceCount);
+        for (uint32_t i = 0; i < faceCount; ++i)
+        {
+            const SDFace& face = mesh.faces[i];
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                bool inserted;
+                uint32_t& entry = edgeVerts.findOrInsert(face.v[k], face.v[NEXT(k)], inserted);
+                if (inserted)
+                {
+                    entry = (uint32_t)edgeOwners.size();
+                    edgeOwners.push_back(3 * i + k);
+                }
+                faceEdges[3 * i + k] = entry;
+            }
+        }
+    }
+    FALCOR_CHECK(edgeOwners.size() < kInvalidIndex - vertexCount, "Subdivided mesh is too large.");
+
+    SDMesh child;
+    child.positions.resize(vertexCount + edgeOwners.size());
+    child.vertices.resize(vertexCount + edgeOwners.size());
+    child.faces.resize(4 * (size_t)faceCount);
+
+    // Update vertex positions and create new edge vertices.
+
+    // Update vertex positions for even vertices.
+    parallelFor(
+        vertexCount,
+        [&](size_t i)
+        {
+            OneRing ring;
+            uint32_t vi = (uint32_t)i;
+            const SDVertex& vertex = mesh.vertices[vi];
+            SDVertex& vertexChild = child.vertices[vi];
+            vertexChild.regular = vertex.regular;
+            vertexChild.boundary = vertex.boundary;
+            vertexChild.startFace = 4 * vertex.startFace + mesh.vnum(vertex.startFace, vi);
+
+            uint32_t valence = mesh.valence(vi);
+            if (!vertex.boundary)
+            {
+                // Apply one-ring rule for even vertex.
+                if (vertex.regular)
+                    child.positions[vi] = weightOneRing(mesh, vi, valence, 1.f / 16.f, ring);
+                else
+                    child.positions[vi] = weightOneRing(mesh, vi, valence, beta(valence), ring);
+            }
+            else
+            {
+                // Apply boundary rule for even vertex.
+                child.positions[vi] = weightBoundary(mesh, vi, valence, 1.f / 8.f, ring);
+            }
+        }
+    );
+
+    // Compute new odd edge vertices.
+    parallelFor(
+        edgeOwners.size(),
+        [&](size_t e)
+        {
+            uint32_t faceIndex = edgeOwners[e] / 3;
+            uint32_t k = edgeOwners[e] % 3;
+            const SDFace& face = mesh.faces[faceIndex];
+            uint32_t v0 = face.v[k];
+            uint32_t v1 = face.v[NEXT(k)];
+
+            // Initialize new odd vertex.
+            SDVertex& vert = child.vertices[vertexCount + e];
+            vert.regular = true;
+            vert.boundary = (face.f[k] == kInvalidIndex);
+            vert.startFace = 4 * faceIndex + 3;
+
+            // Apply edge rules to compute new vertex position.
+            float3& p = child.positions[vertexCount + e];
+            if (vert.boundary)
+            {
+                p = 0.5f * mesh.positions[v0];
+                p += 0.5f * mesh.positions[v1];
+            }
+            else
+            {
+                p = 3.f / 8.f * mesh.positions[v0];
+                p += 3.f / 8.f * mesh.positions[v1];
+                p += 1.f / 8.f * mesh.positions[mesh.otherVert(faceIndex, v0, v1)];
+                p += 1.f / 8.f * mesh.positions[mesh.otherVert(face.f[k], v0, v1)];
+            }
+        }
+    );
+
+    // Update new mesh topology.
+    parallelFor(
+        faceCount,
+        [&](size_t i)
+        {
+            const SDFace& face = mesh.faces[i];
+            SDFace* children = &child.faces[4 * i];
+            const uint32_t firstChild = 4 * (uint32_t)i;
+
+            for (uint32_t j = 0; j < 3; ++j)
+            {
+                // Update children f pointers for siblings.
+                children[3].f[j] = firstChild + NEXT(j);
+                children[j].f[NEXT(j)] = firstChild + 3;
+
+                // Update children f pointers for neighbor children.
+                uint32_t f2 = face.f[j];
+                children[j].f[j] = f2 != kInvalidIndex ? 4 * f2 + mesh.vnum(f2, face.v[j]) : kInvalidIndex;
+                f2 = face.f[PREV(j)];
+                children[j].f[PREV(j)] = f2 != kInvalidIndex ? 4 * f2 + mesh.vnum(f2, face.v[j]) : kInvalidIndex;
+            }
+
+            for (uint32_t j = 0; j < 3; ++j)
+            {
+                // Update child vertex pointer to new even vertex.
+                children[j].v[j] = face.v[j];
+
+                // Update child vertex pointer to new odd vertex.
+                uint32_t vert = vertexCount + faceEdges[3 * i + j];
+                children[j].v[NEXT(j)] = vert;
+                children[NEXT(j)].v[j] = vert;
+                children[3].v[j] = vert;
+            }
+        }
+    );
+
+    return child;
+}
+
+} // namespace
+
+LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+{
+    SDMesh mesh = createBaseMesh(positions, indices);
+
+    // Refine LoopSubdiv into triangles.
+    for (uint32_t i = 0; i < levels; ++i)
+        mesh = subdivideLevel(mesh);
+
+    const size_t vertexCount = mesh.vertices.size();
+
+    // Push vertices to limit surface.
+    std::vector<float3> pLimit(vertexCount);
+    parallelFor(
+        vertexCount,
+        [&](size_t i)
+        {
+            OneRing ring;
+            uint32_t vi = (uint32_t)i;
+            uint32_t valence = mesh.valence(vi);
+            if (mesh.vertices[vi].boundary)
+                pLimit[i] = weightBoundary(mesh, vi, valence, 1.f / 5.f, ring);
+            else
+                pLimit[i] = weightOneRing(mesh, vi, valence, loopGamma(valence), ring);
+        }
+    );
+    mesh.positions = std::move(pLimit);
+
+    // Compute vertex tangents on limit surface.
+    std::vector<float3> Ns(vertexCount);
+    parallelFor(
+        vertexCount,
+        [&](size_t i)
+        {
+            OneRing ring;
+            uint32_t vi = (uint32_t)i;
+            const float3& p = mesh.positions[vi];
+            float3 S(0.f);
+            float3 T(0.f);
+            uint32_t valence = mesh.valence(vi);
+            float3* pRing = ring.get(valence);
+            mesh.oneRing(vi, pRing);
+            if (!mesh.vertices[vi].boundary)
+            {
+                // Compute tangents of interior face
+                for (uint32_t j = 0; j < valence; ++j)
+                {
+                    S += std::cos(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                    T += std::sin(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                }
+            }
+            else
+            {
+                // Compute tangents of boundary face
+                S = pRing[valence - 1] - pRing[0];
+                if (valence == 2)
+                {
+                    T = float3(pRing[0] + pRing[1] - 2.f * p);
+                }
+                else if (valence == 3)
+                {
+                    T = pRing[1] - p;
+                }
+                else if (valence == 4) // regular
+                {
+                    T = float3(-1.f * pRing[0] + 2.f * pRing[1] + 2.f * pRing[2] + -1.f * pRing[3] + -2.f * p);
+                }
+                else
+                {
+                    float theta = float(M_PI) / float(valence - 1);
+                    T = float3(std::sin(theta) * (pRing[0] + pRing[valence - 1]));
+                    for (uint32_t k = 1; k < valence - 1; ++k)
+                    {
+                        float wt = (2 * std::cos(theta) - 2) * std::sin((k)*theta);
+                        T += float3(wt * pRing[k]);
+                    }
+                    T = -T;
+                }
+            }
+            Ns[i] = cross(S, T);
+        }
+    );
+
+    // Create triangle mesh from subdivision mesh.
+    // Vertices are already stored in output order, so faces map directly to indices.
+    std::vector<uint32_t> verts(3 * mesh.faces.size());
+    parallelFor(
+        mesh.faces.size(),
+        [&](size_t i)
+        {
+            for (uint32_t j = 0; j < 3; ++j)
+                verts[3 * i + j] = mesh.faces[i].v[j];
+        }
+    );
+
+    LoopSubdivideResult result;
+    result.positions = std::move(mesh.positions);
+    result.normals = std::move(Ns);
+    result.indices = std::move(verts);
+    return result;
+}
+
+} // namespace Falcor
@@ -32,11 +32,12 @@
 // SPDX: Apache-2.0
 
 #pragma once
+#include "Core/Macros.h"
 #include "Utils/Math/Vector.h"
 #include <fstd/span.h> // TODO C++20: Replace with <span>
 #include <vector>
 
-namespace Falcor::pbrt
+namespace Falcor
 {
 
 struct LoopSubdivideResult
@@ -46,6 +47,14 @@ struct LoopSubdivideResult
     std::vector<uint32_t> indices;
 };
 
-LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> vertices);
+/**
+ * Subdivide a triangle mesh using Loop subdivision, as done for the "loopsubdiv" shape of pbrt.
+ * Boundary edges and vertices use the boundary rules, so open meshes are supported.
+ * @param[in] levels Number of subdivision levels.
+ * @param[in] positions Vertex positions.
+ * @param[in] vertices Triangle vertex indices.
+ * @return Positions, normals and triangle indices of the subdivided mesh.
+ */
+FALCOR_API LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> vertices);
 
-} // namespace Falcor::pbrt
+} // namespace Falcor
@@ -611,6 +611,33 @@ namespace Falcor
         return true;
     }
 
+    uint64_t BasicMaterial::getContentHash() const
+    {
+        // Hash the same data as operator==.
+        MaterialHasher hasher;
+        hashBaseContent(hasher);
+
+        hasher.insert(mData.flags);
+        hasher.insert(mData.displacementScale);
+        hasher.insert(mData.displacementOffset);
+        hasher.insert(mData.baseColor);
+        hasher.insert(mData.specular);
+        hasher.insert(mData.emissive);
+        hasher.insert(mData.emissiveFactor);
+        hasher.insert(mData.diffuseTransmission);
+        hasher.insert(mData.specularTransmission);
+        hasher.insert(mData.transmission);
+        hasher.insert(mData.volumeAbsorption);
+        hasher.insert(mData.volumeAnisotropy);
+        hasher.insert(mData.volumeScattering);
+
+        hasher.insert(mpDefaultSampler->getDesc());
+        hasher.insert(mpDisplacementMinSampler->getDesc());
+        hasher.insert(mpDisplacementMaxSampler->getDesc());
+
+        return hasher.get();
+    }
+
     void BasicMaterial::updateAlphaMode()
     {
         if (!isAlphaSupported())
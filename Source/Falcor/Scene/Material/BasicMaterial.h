@@ -66,6 +66,10 @@ namespace Falcor
         */
         bool isEqual(const ref<Material>& pOther) const override;
 
+        /** Compute a hash of all material properties *except* the name, consistent with isEqual().
+        */
+        uint64_t getContentHash() const override;
+
         /** Set the alpha mode.
         */
         void setAlphaMode(AlphaMode alphaMode) override;
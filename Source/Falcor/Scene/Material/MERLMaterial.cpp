@@ -141,6 +141,14 @@ namespace Falcor
         return true;
     }
 
+    uint64_t MERLMaterial::getContentHash() const
+    {
+        MaterialHasher hasher;
+        hashBaseContent(hasher);
+        hasher.insert(mPath);
+        return hasher.get();
+    }
+
     ProgramDesc::ShaderModuleList MERLMaterial::getShaderModules() const
     {
         return { ProgramDesc::ShaderModule::fromFile(kShaderFile) };
@@ -328,6 +328,27 @@ namespace Falcor
         return true;
     }
 
+    void Material::hashBaseContent(MaterialHasher& hasher) const
+    {
+        // This function hashes all data compared by isBaseEqual().
+
+        hasher.insert(mHeader.packedData);
+        hasher.insert(mTextureTransform);
+
+        for (size_t i = 0; i < mTextureSlotInfo.size(); i++)
+        {
+            auto slot = (TextureSlot)i;
+            hasher.insert(hasTextureSlot(slot));
+            if (hasTextureSlot(slot))
+            {
+                hasher.insert(mTextureSlotInfo[i].name);
+                hasher.insert(mTextureSlotInfo[i].mask);
+                hasher.insert(mTextureSlotInfo[i].srgb);
+                hasher.insert(mTextureSlotData[i].pTexture);
+            }
+        }
+    }
+
     NormalMapType Material::detectNormalMapType(const ref<Texture>& pNormalMap)
     {
         NormalMapType type = NormalMapType::None;
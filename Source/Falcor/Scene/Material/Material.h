@@ -38,6 +38,7 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Sampler.h"
 #include "Utils/Image/TextureAnalyzer.h"
+#include "Utils/Math/FNVHash.h"
 #include "Utils/UI/Gui.h"
 #include "Scene/Transform.h"
 #include "MaterialTypeRegistry.h"
@@ -46,12 +47,79 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <type_traits>
 
 namespace Falcor
 {
     class MaterialSystem;
     class BasicMaterial;
 
+    /** Accumulates a material content hash, see Material::getContentHash().
+        Values that compare equal insert identical data, e.g. floating-point zeros of either sign.
+    */
+    class MaterialHasher
+    {
+    public:
+        template<typename T>
+        void insert(const T& value)
+        {
+            static_assert(std::is_integral_v<T> || std::is_enum_v<T>, "Unsupported type");
+            mHash.insert(value);
+        }
+
+        void insert(float value) { mHash.insert(value == 0.f ? 0.f : value); }
+        void insert(float16_t value) { insert((float)value); }
+
+        template<typename T, int N>
+        void insert(const math::vector<T, N>& value)
+        {
+            for (int i = 0; i < N; i++) insert(value[i]);
+        }
+
+        void insert(const quatf& value) { insert(float4(value.x, value.y, value.z, value.w)); }
+
+        void insert(const std::string& value)
+        {
+            insert(value.size());
+            mHash.insert(value.data(), value.size());
+        }
+
+        void insert(const std::filesystem::path& value) { insert(value.string()); }
+
+        void insert(const Transform& value)
+        {
+            insert(value.getTranslation());
+            insert(value.getScaling());
+            insert(value.getRotation());
+        }
+
+        void insert(const Sampler::Desc& desc)
+        {
+            insert(desc.magFilter);
+            insert(desc.minFilter);
+            insert(desc.mipFilter);
+            insert(desc.maxAnisotropy);
+            insert(desc.maxLod);
+            insert(desc.minLod);
+            insert(desc.lodBias);
+            insert(desc.comparisonFunc);
+            insert(desc.reductionMode);
+            insert(desc.addressModeU);
+            insert(desc.addressModeV);
+            insert(desc.addressModeW);
+            insert(desc.borderColor);
+        }
+
+        /** Insert the identity of a texture. Materials compare their textures by object.
+        */
+        void insert(const ref<Texture>& pTexture) { mHash.insert(reinterpret_cast<uintptr_t>(pTexture.get())); }
+
+        uint64_t get() const { return mHash.get(); }
+
+    private:
+        FNVHash64 mHash;
+    };
+
     /** Abstract base class for materials.
     */
     class FALCOR_API Material : public Object
@@ -163,6 +231,12 @@ namespace Falcor
         */
         virtual bool isEqual(const ref<Material>& pOther) const = 0;
 
+        /** Compute a hash of the material properties *except* the name.
+            Materials for which isEqual() returns true have identical hashes, which allows finding duplicates with a hash map.
+            \return Content hash.
+        */
+        virtual uint64_t getContentHash() const = 0;
+
         /** Set the double-sided flag. This flag doesn't affect the cull state, just the shading.
         */
         virtual void setDoubleSided(bool doubleSided);
@@ -360,6 +434,7 @@ namespace Falcor
         void updateTextureHandle(MaterialSystem* pOwner, const TextureSlot slot, TextureHandle& handle);
         void updateDefaultTextureSamplerID(MaterialSystem* pOwner, const ref<Sampler>& pSampler);
         bool isBaseEqual(const Material& other) const;
+        void hashBaseContent(MaterialHasher& hasher) const;
 
         static NormalMapType detectNormalMapType(const ref<Texture>& pNormalMap);
 
@@ -33,6 +33,7 @@
 #include "MaterialTypeRegistry.h"
 #include "Scene/Lights/LightProfile.h"
 #include <numeric>
+#include <unordered_map>
 
 namespace Falcor
 {
@@ -226,9 +227,9 @@ namespace Falcor
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
 
         // Reuse previously added materials.
-        if (auto it = std::find(mMaterials.begin(), mMaterials.end(), pMaterial); it != mMaterials.end())
+        if (auto it = mMaterialIDs.find(pMaterial.get()); it != mMaterialIDs.end())
         {
-            return MaterialID{(size_t)std::distance(mMaterials.begin(), it) };
+            return it->second;
         }
 
         // Add material.
@@ -245,6 +246,7 @@ namespace Falcor
 
         pMaterial->registerUpdateCallback([this](auto flags) { mMaterialUpdates |= flags; });
         mMaterials.push_back(pMaterial);
+        mMaterialIDs[pMaterial.get()] = materialID;
         mMaterialsChanged = true;
 
         return materialID;
@@ -265,6 +267,7 @@ namespace Falcor
         mpTextureManager->removeTextures(material.get());
 
         // Remove the material.
+        mMaterialIDs.erase(material.get());
         mMaterials[materialID.get()] = nullptr;
         mMaterialsChanged = true;
     }
@@ -286,6 +289,7 @@ namespace Falcor
 
         // Replace the material.
         mMaterials[materialID.get()] = pReplacement;
+        mMaterialIDs[pReplacement.get()] = materialID;
         mMaterialsChanged = true;
     }
 
@@ -294,10 +298,9 @@ namespace Falcor
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
 
         // Find material to replace.
-        if (auto it = std::find(mMaterials.begin(), mMaterials.end(), pMaterial); it != mMaterials.end())
+        if (auto it = mMaterialIDs.find(pMaterial.get()); it != mMaterialIDs.end())
         {
-            auto materialID = MaterialID{ (size_t)std::distance(mMaterials.begin(), it) };
-            replaceMaterial(materialID, pReplacement);
+            replaceMaterial(it->second, pReplacement);
         }
         else
         {
@@ -351,19 +354,27 @@ namespace Falcor
         idMap.resize(mMaterials.size());
 
         // Find unique set of materials.
+        // Unique materials are bucketed by content hash, only materials with the same hash are compared.
+        std::unordered_multimap<uint64_t, MaterialID> uniqueIDs;
+        uniqueIDs.reserve(mMaterials.size());
+
         for (MaterialID id{ 0 }; id.get() < mMaterials.size(); ++id)
         {
             const auto& pMaterial = mMaterials[id.get()];
-            auto it = std::find_if(uniqueMaterials.begin(), uniqueMaterials.end(), [&pMaterial](const auto& m) { return m->isEqual(pMaterial); });
-            if (it == uniqueMaterials.end())
+            const uint64_t hash = pMaterial->getContentHash();
+            auto [begin, end] = uniqueIDs.equal_range(hash);
+            auto it = std::find_if(begin, end, [&](const auto& entry) { return uniqueMaterials[entry.second.get()]->isEqual(pMaterial); });
+            if (it == end)
             {
                 idMap[id.get()] = MaterialID{ uniqueMaterials.size() };
+                uniqueIDs.emplace(hash, idMap[id.get()]);
                 uniqueMaterials.push_back(pMaterial);
             }
             else
             {
-                logInfo("Removing duplicate material '{}' (duplicate of '{}').", pMaterial->getName(), (*it)->getName());
-                idMap[id.get()] = MaterialID{ (size_t)std::distance(uniqueMaterials.begin(), it) };
+                const auto& pUnique = uniqueMaterials[it->second.get()];
+                logInfo("Removing duplicate material '{}' (duplicate of '{}').", pMaterial->getName(), pUnique->getName());
+                idMap[id.get()] = it->second;
             }
         }
 
@@ -371,12 +382,57 @@ namespace Falcor
         if (removed > 0)
         {
             mMaterials = uniqueMaterials;
+            mMaterialIDs.clear();
+            for (MaterialID id{ 0 }; id.get() < mMaterials.size(); ++id)
+                mMaterialIDs[mMaterials[id.get()].get()] = id;
             mMaterialsChanged = true;
         }
 
         return removed;
     }
 
+    size_t MaterialSystem::removeDuplicateTextures()
+    {
+        // Textures loaded from different files can hold identical texels, e.g. copies of the same image in imported CAD scenes.
+        // They are replaced by the first texture with the same desc and content hash. The hash is 64 bits wide,
+        // collisions between textures with identical descs are unlikely enough to not read back the texels for comparison.
+        std::unordered_multimap<uint64_t, ref<Texture>> uniqueTextures;
+        std::unordered_map<const Texture*, ref<Texture>> replacements;
+        size_t replaced = 0;
+
+        for (const auto& pMaterial : mMaterials)
+        {
+            for (uint32_t i = 0; i < (uint32_t)Material::TextureSlot::Count; i++)
+            {
+                auto slot = (Material::TextureSlot)i;
+                auto pTexture = pMaterial->getTexture(slot);
+                if (!pTexture || !pTexture->getContentHash()) continue;
+
+                auto replacement = replacements.find(pTexture.get());
+                if (replacement == replacements.end())
+                {
+                    const uint64_t hash = *pTexture->getContentHash();
+                    auto [begin, end] = uniqueTextures.equal_range(hash);
+                    auto it = std::find_if(begin, end, [&](const auto& entry) { return entry.second->compareDesc(pTexture.get()); });
+                    if (it == end)
+                        it = uniqueTextures.emplace(hash, pTexture);
+                    else
+                        logDebug("Replacing texture '{}' by identical texture '{}'.", pTexture->getSourcePath(), it->second->getSourcePath());
+                    replacement = replacements.emplace(pTexture.get(), it->second).first;
+                }
+
+                if (replacement->second != pTexture)
+                {
+                    pMaterial->setTexture(slot, replacement->second);
+                    replaced++;
+                }
+            }
+        }
+
+        if (replaced > 0) logInfo("Replaced {} material textures by identical textures.", replaced);
+        return replaced;
+    }
+
     void MaterialSystem::optimizeMaterials()
     {
         // Gather a list of all textures to analyze.
@@ -39,6 +39,7 @@
 #include <memory>
 #include <vector>
 #include <set>
+#include <unordered_map>
 
 namespace Falcor
 {
@@ -234,11 +235,19 @@ namespace Falcor
         ref<Material> getMaterialByName(const std::string& name) const;
 
         /** Remove all duplicate materials.
+            Materials are bucketed by content hash, see Material::getContentHash(), and compared with Material::isEqual().
             \param[in] idMap Vector that holds for each material the ID of the material that replaces it.
             \return The number of materials removed.
         */
         size_t removeDuplicateMaterials(std::vector<MaterialID>& idMap);
 
+        /** Replace material textures holding identical texels by a single texture.
+            Textures are identified by the hash of the image data they were loaded from, see Texture::getContentHash().
+            This should run before removeDuplicateMaterials() since materials with different but identical textures are merged then.
+            \return The number of textures replaced.
+        */
+        size_t removeDuplicateTextures();
+
         /** Optimize materials.
             This function analyzes textures and replaces constant textures by uniform material parameters.
         */
@@ -265,6 +274,7 @@ namespace Falcor
         ref<Device> mpDevice;
 
         std::vector<ref<Material>> mMaterials;                      ///< List of all materials.
+        std::unordered_map<const Material*, MaterialID> mMaterialIDs; ///< Material IDs by material, for fast lookups of added materials.
         std::vector<Material::UpdateFlags> mMaterialsUpdateFlags;   ///< List of all material update flags, after the update() calls
         std::unique_ptr<TextureManager> mpTextureManager;           ///< Texture manager holding all material textures.
         ProgramDesc::ShaderModuleList mShaderModules;                   ///< Shader modules for all materials in use.
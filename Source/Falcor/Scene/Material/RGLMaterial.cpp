@@ -135,6 +135,14 @@ namespace Falcor
         return true;
     }
 
+    uint64_t RGLMaterial::getContentHash() const
+    {
+        MaterialHasher hasher;
+        hashBaseContent(hasher);
+        hasher.insert(mPath);
+        return hasher.get();
+    }
+
     ProgramDesc::ShaderModuleList RGLMaterial::getShaderModules() const
     {
         return { ProgramDesc::ShaderModule::fromFile(kShaderFile) };
@@ -0,0 +1,1258 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "NativeMeshLoader.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/JobSystem.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <execution>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+namespace Falcor
+{
+namespace
+{
+// Text parsing helpers.
+// The input buffers are memory-mapped files and are not null-terminated, so all helpers take an explicit end pointer.
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline const char* skipSpaces(const char* p, const char* end)
+{
+    while (p < end && isSpace(*p))
+        ++p;
+    return p;
+}
+
+inline const char* skipLine(const char* p, const char* end)
+{
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return eol ? eol + 1 : end;
+}
+
+inline const char* findLineEnd(const char* p, const char* end)
+{
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return eol ? eol : end;
+}
+
+/**
+ * Fallback float parser for the forms not handled by parseFloat() (inf, nan, hex, very long mantissas).
+ * Copies the token into a null-terminated buffer and calls strtod.
+ */
+bool parseFloatSlow(const char*& p, const char* end, float& value)
+{
+    char buf[64];
+    size_t len = 0;
+    while (p + len < end && len < sizeof(buf) - 1 && !isSpace(p[len]) && p[len] != '\n' && p[len] != '/')
+    {
+        buf[len] = p[len];
+        ++len;
+    }
+    buf[len] = '\0';
+    char* parsedEnd = nullptr;
+    double d = std::strtod(buf, &parsedEnd);
+    if (parsedEnd == buf)
+        return false;
+    p += parsedEnd - buf;
+    value = (float)d;
+    return true;
+}
+
+/**
+ * Parse a decimal floating point number.
+ * The mantissa is accumulated as an integer and scaled by an exact power of ten, which is exact for the typical
+ * short mantissas found in mesh files. Unusual forms are handled by parseFloatSlow().
+ * @return True if a number was parsed. On success p is advanced past the number.
+ */
+bool parseFloat(const char*& p, const char* end, float& value)
+{
+    static constexpr double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char* s = p;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+'))
+    {
+        negative = *s == '-';
+        ++s;
+    }
+
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+
+    while (s < end && isDigit(*s))
+    {
+        hasDigits = true;
+        if (significantDigits < 19)
+        {
+            mantissa = mantissa * 10 + (*s - '0');
+            if (mantissa != 0)
+                ++significantDigits;
+        }
+        else
+        {
+            ++exponent;
+        }
+        ++s;
+    }
+    if (s < end && *s == '.')
+    {
+        ++s;
+        while (s < end && isDigit(*s))
+        {
+            hasDigits = true;
+            if (significantDigits < 19)
+            {
+                mantissa = mantissa * 10 + (*s - '0');
+                if (mantissa != 0)
+                    ++significantDigits;
+                --exponent;
+            }
+            ++s;
+        }
+    }
+    if (!hasDigits)
+        return parseFloatSlow(p, end, value);
+
+    if (s < end && (*s == 'e' || *s == 'E'))
+    {
+        const char* e = s + 1;
+        bool negativeExponent = false;
+        if (e < end && (*e == '-' || *e == '+'))
+        {
+            negativeExponent = *e == '-';
+            ++e;
+        }
+        if (e < end && isDigit(*e))
+        {
+            int exp = 0;
+            while (e < end && isDigit(*e))
+            {
+                if (exp < 100000)
+                    exp = exp * 10 + (*e - '0');
+                ++e;
+            }
+            exponent += negativeExponent ? -exp : exp;
+            s = e;
+        }
+    }
+
+    double d = (double)mantissa;
+    if (mantissa != 0)
+    {
+        if (exponent >= -22 && exponent <= 22)
+            d = exponent < 0 ? d / kPow10[-exponent] : d * kPow10[exponent];
+        else
+            d *= std::pow(10.0, (double)exponent);
+    }
+    value = (float)(negative ? -d : d);
+    p = s;
+    return true;
+}
+
+/// Parse a decimal integer. Returns true if a number was parsed. On success p is advanced past the number.
+bool parseInt(const char*& p, const char* end, int64_t& value)
+{
+    const char* s = p;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+'))
+    {
+        negative = *s == '-';
+        ++s;
+    }
+    if (s >= end || !isDigit(*s))
+        return false;
+    int64_t v = 0;
+    while (s < end && isDigit(*s))
+    {
+        v = v * 10 + (*s - '0');
+        ++s;
+    }
+    value = negative ? -v : v;
+    p = s;
+    return true;
+}
+
+std::vector<std::string_view> splitTokens(std::string_view line)
+{
+    std::vector<std::string_view> tokens;
+    size_t i = 0;
+    while (i < line.size())
+    {
+        while (i < line.size() && isSpace(line[i]))
+            ++i;
+        size_t start = i;
+        while (i < line.size() && !isSpace(line[i]))
+            ++i;
+        if (i > start)
+            tokens.push_back(line.substr(start, i - start));
+    }
+    return tokens;
+}
+
+void openMappedFile(const std::filesystem::path& path, MemoryMappedFile& file)
+{
+    if (!file.open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan))
+        FALCOR_THROW("Failed to open mesh file '{}'.", path);
+}
+
+void validateIndices(const std::filesystem::path& path, const std::vector<uint32_t>& indices, size_t vertexCount)
+{
+    bool outOfRange = std::any_of(
+        std::execution::par_unseq, indices.begin(), indices.end(), [vertexCount](uint32_t index) { return index >= vertexCount; }
+    );
+    if (outOfRange)
+        FALCOR_THROW("Mesh file '{}' has vertex indices out of range.", path);
+}
+
+void flipTexCrds(std::vector<float2>& texCrds)
+{
+    std::for_each(std::execution::par_unseq, texCrds.begin(), texCrds.end(), [](float2& uv) { uv.y = 1.f - uv.y; });
+}
+
+// PLY
+
+enum class PlyFormat
+{
+    Ascii,
+    BinaryLittleEndian,
+    BinaryBigEndian,
+};
+
+enum class PlyType
+{
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64,
+};
+
+struct PlyProperty
+{
+    std::string name;
+    PlyType type = PlyType::Float32;
+    bool isList = false;
+    PlyType countType = PlyType::UInt8;
+    size_t offset = 0; ///< Byte offset within the element. Only valid for elements without list properties.
+};
+
+struct PlyElement
+{
+    std::string name;
+    uint64_t count = 0;
+    std::vector<PlyProperty> properties;
+    bool isFixedSize = true; ///< True if the element has no list properties.
+    size_t stride = 0;       ///< Size of the element in bytes. Only valid if isFixedSize is true.
+};
+
+struct PlyHeader
+{
+    PlyFormat format = PlyFormat::Ascii;
+    std::vector<PlyElement> elements;
+    size_t dataOffset = 0;
+};
+
+size_t getPlyTypeSize(PlyType type)
+{
+    switch (type)
+    {
+    case PlyType::Int8:
+    case PlyType::UInt8:
+        return 1;
+    case PlyType::Int16:
+    case PlyType::UInt16:
+        return 2;
+    case PlyType::Int32:
+    case PlyType::UInt32:
+    case PlyType::Float32:
+        return 4;
+    case PlyType::Float64:
+        return 8;
+    }
+    FALCOR_UNREACHABLE();
+}
+
+bool parsePlyType(std::string_view name, PlyType& type)
+{
+    static const std::pair<std::string_view, PlyType> kTypes[] = {
+        {"char", PlyType::Int8},     {"int8", PlyType::Int8},       {"uchar", PlyType::UInt8},    {"uint8", PlyType::UInt8},
+        {"short", PlyType::Int16},   {"int16", PlyType::Int16},     {"ushort", PlyType::UInt16},  {"uint16", PlyType::UInt16},
+        {"int", PlyType::Int32},     {"int32", PlyType::Int32},     {"uint", PlyType::UInt32},    {"uint32", PlyType::UInt32},
+        {"float", PlyType::Float32}, {"float32", PlyType::Float32}, {"double", PlyType::Float64}, {"float64", PlyType::Float64},
+    };
+    for (const auto& [typeName, t] : kTypes)
+    {
+        if (typeName == name)
+        {
+            type = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename T>
+T loadBinary(const uint8_t* p, bool swapBytes)
+{
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, p, sizeof(T));
+    if (swapBytes)
+        std::reverse(bytes, bytes + sizeof(T));
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+/// Read a binary PLY scalar of the given type and convert it to T.
+template<typename T>
+T readPlyScalar(const uint8_t* p, PlyType type, bool swapBytes)
+{
+    switch (type)
+    {
+    case PlyType::Int8:
+        return (T)loadBinary<int8_t>(p, false);
+    case PlyType::UInt8:
+        return (T)loadBinary<uint8_t>(p, false);
+    case PlyType::Int16:
+        return (T)loadBinary<int16_t>(p, swapBytes);
+    case PlyType::UInt16:
+        return (T)loadBinary<uint16_t>(p, swapBytes);
+    case PlyType::Int32:
+        return (T)loadBinary<int32_t>(p, swapBytes);
+    case PlyType::UInt32:
+        return (T)loadBinary<uint32_t>(p, swapBytes);
+    case PlyType::Float32:
+        return (T)loadBinary<float>(p, swapBytes);
+    case PlyType::Float64:
+        return (T)loadBinary<double>(p, swapBytes);
+    }
+    FALCOR_UNREACHABLE();
+}
+
+PlyHeader parsePlyHeader(const std::filesystem::path& path, const char* data, size_t size)
+{
+    const char* p = data;
+    const char* end = data + size;
+
+    auto nextLine = [&]() -> std::string_view
+    {
+        if (p >= end)
+            FALCOR_THROW("PLY file '{}' has an incomplete header.", path);
+        const char* lineEnd = findLineEnd(p, end);
+        std::string_view line(p, lineEnd - p);
+        p = lineEnd < end ? lineEnd + 1 : end;
+        return line;
+    };
+
+    auto magic = splitTokens(nextLine());
+    if (magic.size() != 1 || magic[0] != "ply")
+        FALCOR_THROW("File '{}' is not a PLY file.", path);
+
+    PlyHeader header;
+    bool hasFormat = false;
+    while (true)
+    {
+        auto tokens = splitTokens(nextLine());
+        if (tokens.empty() || tokens[0] == "comment" || tokens[0] == "obj_info")
+            continue;
+
+        if (tokens[0] == "end_header")
+            break;
+
+        if (tokens[0] == "format" && tokens.size() >= 2)
+        {
+            if (tokens[1] == "ascii")
+                header.format = PlyFormat::Ascii;
+            else if (tokens[1] == "binary_little_endian")
+                header.format = PlyFormat::BinaryLittleEndian;
+            else if (tokens[1] == "binary_big_endian")
+                header.format = PlyFormat::BinaryBigEndian;
+            else
+                FALCOR_THROW("PLY file '{}' has unknown format '{}'.", path, tokens[1]);
+            hasFormat = true;
+        }
+        else if (tokens[0] == "element" && tokens.size() == 3)
+        {
+            PlyElement element;
+            element.name = tokens[1];
+            const char* countStr = tokens[2].data();
+            int64_t count = 0;
+            if (!parseInt(countStr, tokens[2].data() + tokens[2].size(), count) || count < 0)
+                FALCOR_THROW("PLY file '{}' has invalid element count '{}'.", path, tokens[2]);
+            element.count = (uint64_t)count;
+            header.elements.push_back(std::move(element));
+        }
+        else if (tokens[0] == "property" && !header.elements.empty())
+        {
+            PlyElement& element = header.elements.back();
+            PlyProperty property;
+            bool valid = false;
+            if (tokens.size() == 5 && tokens[1] == "list")
+            {
+                property.isList = true;
+                property.name = tokens[4];
+                valid = parsePlyType(tokens[2], property.countType) && parsePlyType(tokens[3], property.type);
+                element.isFixedSize = false;
+            }
+            else if (tokens.size() == 3)
+            {
+                property.name = tokens[2];
+                valid = parsePlyType(tokens[1], property.type);
+                property.offset = element.stride;
+                element.stride += getPlyTypeSize(property.type);
+            }
+            if (!valid)
+                FALCOR_THROW("PLY file '{}' has invalid property declaration.", path);
+            element.properties.push_back(std::move(property));
+        }
+        else
+        {
+            FALCOR_THROW("PLY file '{}' has invalid header line starting with '{}'.", path, tokens[0]);
+        }
+    }
+
+    if (!hasFormat)
+        FALCOR_THROW("PLY file '{}' is missing the format declaration.", path);
+
+    header.dataOffset = p - data;
+    return header;
+}
+
+/// Maps PLY vertex property names to vertex attribute slots.
+enum VertexSlot : int
+{
+    kSlotIgnored = -1,
+    kSlotPositionX = 0,
+    kSlotPositionY,
+    kSlotPositionZ,
+    kSlotNormalX,
+    kSlotNormalY,
+    kSlotNormalZ,
+    kSlotTexCrdU,
+    kSlotTexCrdV,
+    kSlotCount,
+};
+
+int getVertexSlot(const std::string& name)
+{
+    if (name == "x")
+        return kSlotPositionX;
+    if (name == "y")
+        return kSlotPositionY;
+    if (name == "z")
+        return kSlotPositionZ;
+    if (name == "nx")
+        return kSlotNormalX;
+    if (name == "ny")
+        return kSlotNormalY;
+    if (name == "nz")
+        return kSlotNormalZ;
+    if (name == "u" || name == "s" || name == "texture_u" || name == "texture_s")
+        return kSlotTexCrdU;
+    if (name == "v" || name == "t" || name == "texture_v" || name == "texture_t")
+        return kSlotTexCrdV;
+    return kSlotIgnored;
+}
+
+bool isFaceIndexProperty(const PlyProperty& property)
+{
+    return property.isList && (property.name == "vertex_indices" || property.name == "vertex_index");
+}
+
+/// Sets up the vertex attribute arrays of the mesh for the given PLY vertex element. Returns the slot of each property.
+std::vector<int> setupPlyVertices(const std::filesystem::path& path, const PlyElement& element, NativeMeshLoader::MeshData& mesh)
+{
+    if (element.count > std::numeric_limits<uint32_t>::max())
+        FALCOR_THROW("PLY file '{}' has too many vertices.", path);
+
+    std::vector<int> slots;
+    bool hasSlot[kSlotCount] = {};
+    for (const auto& property : element.properties)
+    {
+        int slot = property.isList ? kSlotIgnored : getVertexSlot(property.name);
+        slots.push_back(slot);
+        if (slot != kSlotIgnored)
+            hasSlot[slot] = true;
+    }
+    if (!hasSlot[kSlotPositionX] || !hasSlot[kSlotPositionY] || !hasSlot[kSlotPositionZ])
+        FALCOR_THROW("PLY file '{}' has no vertex positions.", path);
+
+    // Only use normals and texture coordinates if all components are present.
+    bool hasNormals = hasSlot[kSlotNormalX] && hasSlot[kSlotNormalY] && hasSlot[kSlotNormalZ];
+    bool hasTexCrds = hasSlot[kSlotTexCrdU] && hasSlot[kSlotTexCrdV];
+    for (int& slot : slots)
+    {
+        if ((!hasNormals && slot >= kSlotNormalX && slot <= kSlotNormalZ) || (!hasTexCrds && slot >= kSlotTexCrdU))
+            slot = kSlotIgnored;
+    }
+
+    mesh.positions.resize(element.count);
+    if (hasNormals)
+        mesh.normals.resize(element.count);
+    if (hasTexCrds)
+        mesh.texCrds.resize(element.count);
+    return slots;
+}
+
+void storeVertex(NativeMeshLoader::MeshData& mesh, size_t i, const float (&values)[kSlotCount])
+{
+    mesh.positions[i] = float3(values[kSlotPositionX], values[kSlotPositionY], values[kSlotPositionZ]);
+    if (!mesh.normals.empty())
+        mesh.normals[i] = float3(values[kSlotNormalX], values[kSlotNormalY], values[kSlotNormalZ]);
+    if (!mesh.texCrds.empty())
+        mesh.texCrds[i] = float2(values[kSlotTexCrdU], values[kSlotTexCrdV]);
+}
+
+/// Appends the fan triangulation of a polygon to the index list.
+template<typename GetIndex>
+void triangulatePolygon(std::vector<uint32_t>& indices, uint64_t cornerCount, GetIndex getIndex)
+{
+    for (uint64_t k = 1; k + 1 < cornerCount; ++k)
+    {
+        indices.push_back(getIndex(0));
+        indices.push_back(getIndex(k));
+        indices.push_back(getIndex(k + 1));
+    }
+}
+
+/**
+ * Reads the binary PLY data of all elements.
+ * Vertices always have a fixed size and are decoded in parallel. Faces are decoded in parallel if the face element
+ * only holds the index list and all faces are triangles, which is the common case for scanned meshes.
+ */
+void readPlyBinary(const std::filesystem::path& path, const PlyHeader& header, const uint8_t* data, size_t size, NativeMeshLoader::MeshData& mesh)
+{
+    const bool swapBytes = header.format == PlyFormat::BinaryBigEndian;
+    const uint8_t* p = data + header.dataOffset;
+    const uint8_t* end = data + size;
+
+    auto checkAvailable = [&](const uint8_t* ptr, uint64_t byteCount)
+    {
+        if (byteCount > (uint64_t)(end - ptr))
+            FALCOR_THROW("PLY file '{}' is truncated.", path);
+    };
+
+    // Advances past a single element of variable size, calling onList for every list property.
+    auto readVariableElement = [&](const PlyElement& element, auto&& onList)
+    {
+        for (const auto& property : element.properties)
+        {
+            if (!property.isList)
+            {
+                checkAvailable(p, getPlyTypeSize(property.type));
+                p += getPlyTypeSize(property.type);
+                continue;
+            }
+            checkAvailable(p, getPlyTypeSize(property.countType));
+            uint64_t count = readPlyScalar<uint64_t>(p, property.countType, swapBytes);
+            p += getPlyTypeSize(property.countType);
+            checkAvailable(p, count * getPlyTypeSize(property.type));
+            onList(property, p, count);
+            p += count * getPlyTypeSize(property.type);
+        }
+    };
+
+    for (const auto& element : header.elements)
+    {
+        if (element.name == "vertex")
+        {
+            if (!element.isFixedSize)
+                FALCOR_THROW("PLY file '{}' has list properties in the vertex element, which is not supported.", path);
+            std::vector<int> slots = setupPlyVertices(path, element, mesh);
+            checkAvailable(p, element.count * element.stride);
+
+            auto range = NumericRange<size_t>(0, element.count);
+            std::for_each(
+                std::execution::par_unseq,
+                range.begin(),
+                range.end(),
+                [&, base = p](size_t i)
+                {
+                    const uint8_t* vertex = base + i * element.stride;
+                    float values[kSlotCount] = {};
+                    for (size_t j = 0; j < element.properties.size(); ++j)
+                    {
+                        if (slots[j] != kSlotIgnored)
+                            values[slots[j]] = readPlyScalar<float>(vertex + element.properties[j].offset, element.properties[j].type, swapBytes);
+                    }
+                    storeVertex(mesh, i, values);
+                }
+            );
+            p += element.count * element.stride;
+        }
+        else if (element.name == "face")
+        {
+            const PlyProperty* pIndexProperty = nullptr;
+            for (const auto& property : element.properties)
+            {
+                if (isFaceIndexProperty(property))
+                    pIndexProperty = &property;
+            }
+            if (!pIndexProperty)
+                FALCOR_THROW("PLY file '{}' has no face vertex indices.", path);
+
+            // Fast path: the face element only holds the index list and all faces are triangles.
+            const size_t countSize = getPlyTypeSize(pIndexProperty->countType);
+            const size_t indexSize = getPlyTypeSize(pIndexProperty->type);
+            const size_t triangleStride = countSize + 3 * indexSize;
+            bool allTriangles = element.properties.size() == 1 && element.count * triangleStride <= (uint64_t)(end - p);
+            if (allTriangles)
+            {
+                std::atomic<bool> hasPolygons = false;
+                auto range = NumericRange<size_t>(0, element.count);
+                std::for_each(
+                    std::execution::par_unseq,
+                    range.begin(),
+                    range.end(),
+                    [&, base = p](size_t i)
+                    {
+                        if (readPlyScalar<uint64_t>(base + i * triangleStride, pIndexProperty->countType, swapBytes) != 3)
+                            hasPolygons.store(true, std::memory_order_relaxed);
+                    }
+                );
+                allTriangles = !hasPolygons;
+            }
+
+            if (allTriangles)
+            {
+                mesh.indices.resize(element.count * 3);
+                auto range = NumericRange<size_t>(0, element.count);
+                std::for_each(
+                    std::execution::par_unseq,
+                    range.begin(),
+                    range.end(),
+                    [&, base = p](size_t i)
+                    {
+                        const uint8_t* face = base + i * triangleStride + countSize;
+                        for (size_t k = 0; k < 3; ++k)
+                            mesh.indices[i * 3 + k] = readPlyScalar<uint32_t>(face + k * indexSize, pIndexProperty->type, swapBytes);
+                    }
+                );
+                p += element.count * triangleStride;
+            }
+            else
+            {
+                mesh.indices.reserve(element.count * 3);
+                for (uint64_t i = 0; i < element.count; ++i)
+                {
+                    readVariableElement(
+                        element,
+                        [&](const PlyProperty& property, const uint8_t* list, uint64_t count)
+                        {
+                            if (&property != pIndexProperty)
+                                return;
+                            triangulatePolygon(
+                                mesh.indices,
+                                count,
+                                [&](uint64_t k) { return readPlyScalar<uint32_t>(list + k * indexSize, property.type, swapBytes); }
+                            );
+                        }
+                    );
+                }
+            }
+        }
+        else if (element.isFixedSize)
+        {
+            checkAvailable(p, element.count * element.stride);
+            p += element.count * element.stride;
+        }
+        else
+        {
+            for (uint64_t i = 0; i < element.count; ++i)
+                readVariableElement(element, [](const PlyProperty&, const uint8_t*, uint64_t) {});
+        }
+    }
+}
+
+void readPlyAscii(const std::filesystem::path& path, const PlyHeader& header, const char* data, size_t size, NativeMeshLoader::MeshData& mesh)
+{
+    const char* p = data + header.dataOffset;
+    const char* end = data + size;
+
+    auto skipWhitespace = [&]()
+    {
+        while (p < end && (isSpace(*p) || *p == '\n'))
+            ++p;
+    };
+    auto readFloat = [&]()
+    {
+        skipWhitespace();
+        float value;
+        if (!parseFloat(p, end, value))
+            FALCOR_THROW("PLY file '{}' has invalid ASCII data.", path);
+        return value;
+    };
+    auto readInt = [&]()
+    {
+        skipWhitespace();
+        int64_t value;
+        if (!parseInt(p, end, value))
+            FALCOR_THROW("PLY file '{}' has invalid ASCII data.", path);
+        return value;
+    };
+
+    for (const auto& element : header.elements)
+    {
+        if (element.name == "vertex")
+        {
+            std::vector<int> slots = setupPlyVertices(path, element, mesh);
+            for (uint64_t i = 0; i < element.count; ++i)
+            {
+                float values[kSlotCount] = {};
+                for (size_t j = 0; j < element.properties.size(); ++j)
+                {
+                    const auto& property = element.properties[j];
+                    int64_t count = property.isList ? readInt() : 1;
+                    for (int64_t k = 0; k < count; ++k)
+                    {
+                        float value = readFloat();
+                        if (slots[j] != kSlotIgnored)
+                            values[slots[j]] = value;
+                    }
+                }
+                storeVertex(mesh, i, values);
+            }
+        }
+        else
+        {
+            const bool isFace = element.name == "face";
+            std::vector<uint32_t> polygon;
+            if (isFace)
+                mesh.indices.reserve(element.count * 3);
+            for (uint64_t i = 0; i < element.count; ++i)
+            {
+                for (const auto& property : element.properties)
+                {
+                    if (!property.isList)
+                    {
+                        readFloat();
+                        continue;
+                    }
+                    int64_t count = readInt();
+                    if (count < 0)
+                        FALCOR_THROW("PLY file '{}' has invalid ASCII data.", path);
+                    const bool isIndexList = isFace && isFaceIndexProperty(property);
+                    polygon.clear();
+                    for (int64_t k = 0; k < count; ++k)
+                    {
+                        if (isIndexList)
+                        {
+                            int64_t index = readInt();
+                            if (index < 0 || index > std::numeric_limits<uint32_t>::max())
+                                FALCOR_THROW("PLY file '{}' has vertex indices out of range.", path);
+                            polygon.push_back((uint32_t)index);
+                        }
+                        else
+                        {
+                            readFloat();
+                        }
+                    }
+                    if (isIndexList)
+                        triangulatePolygon(mesh.indices, polygon.size(), [&](uint64_t k) { return polygon[k]; });
+                }
+            }
+        }
+    }
+}
+
+// OBJ
+
+/// Corner indices are stored as int64. Absolute indices (from positive OBJ indices) are stored as is (>= 0).
+/// Relative indices (from negative OBJ indices) are stored relative to the start of the chunk, offset by kRelativeBias
+/// so they can be told apart. They are resolved once the attribute counts of all preceding chunks are known.
+constexpr int64_t kMissingIndex = std::numeric_limits<int64_t>::min();
+constexpr int64_t kRelativeBias = -(int64_t(1) << 62);
+
+struct ObjChunk
+{
+    const char* begin = nullptr;
+    const char* end = nullptr;
+
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float2> texCrds;
+    std::vector<int64_t> corners;    ///< Position, texture coordinate and normal index per polygon corner.
+    std::vector<uint32_t> faceSizes; ///< Number of corners per polygon.
+    bool error = false;
+
+    // Attribute offsets of this chunk, computed after parsing.
+    size_t positionOffset = 0;
+    size_t normalOffset = 0;
+    size_t texCrdOffset = 0;
+    size_t cornerOffset = 0;
+};
+
+inline int64_t encodeObjIndex(int64_t index, size_t localCount)
+{
+    if (index > 0)
+        return index - 1;
+    return kRelativeBias + (int64_t)localCount + index;
+}
+
+/// Resolves an encoded corner index to an absolute index. Returns -1 if the index is out of range.
+inline int64_t resolveObjIndex(int64_t encoded, size_t chunkOffset, size_t totalCount)
+{
+    int64_t index = encoded >= 0 ? encoded : (int64_t)chunkOffset + (encoded - kRelativeBias);
+    return index >= 0 && index < (int64_t)totalCount ? index : -1;
+}
+
+void parseObjChunk(ObjChunk& chunk)
+{
+    const char* p = chunk.begin;
+    const char* end = chunk.end;
+
+    auto readFloats = [&](float* values, int requiredCount, int maxCount)
+    {
+        int count = 0;
+        while (count < maxCount)
+        {
+            p = skipSpaces(p, end);
+            if (p >= end || *p == '\n' || !parseFloat(p, end, values[count]))
+                break;
+            ++count;
+        }
+        return count >= requiredCount;
+    };
+
+    while (p < end && !chunk.error)
+    {
+        p = skipSpaces(p, end);
+        if (p + 1 >= end)
+            break;
+
+        if (p[0] == 'v' && isSpace(p[1]))
+        {
+            p += 2;
+            float v[3];
+            chunk.error = !readFloats(v, 3, 3);
+            chunk.positions.push_back(float3(v[0], v[1], v[2]));
+        }
+        else if (p[0] == 'v' && p[1] == 'n' && p + 2 < end && isSpace(p[2]))
+        {
+            p += 3;
+            float v[3];
+            chunk.error = !readFloats(v, 3, 3);
+            chunk.normals.push_back(float3(v[0], v[1], v[2]));
+        }
+        else if (p[0] == 'v' && p[1] == 't' && p + 2 < end && isSpace(p[2]))
+        {
+            p += 3;
+            float v[2] = {0.f, 0.f};
+            chunk.error = !readFloats(v, 1, 2);
+            chunk.texCrds.push_back(float2(v[0], v[1]));
+        }
+        else if (p[0] == 'f' && isSpace(p[1]))
+        {
+            p += 2;
+            uint32_t cornerCount = 0;
+            while (true)
+            {
+                p = skipSpaces(p, end);
+                if (p >= end || *p == '\n' || *p == '#')
+                    break;
+
+                int64_t v = 0, vt = 0, vn = 0;
+                if (!parseInt(p, end, v) || v == 0)
+                {
+                    chunk.error = true;
+                    break;
+                }
+                if (p < end && *p == '/')
+                {
+                    ++p;
+                    if (p < end && *p != '/' && (!parseInt(p, end, vt) || vt == 0))
+                    {
+                        chunk.error = true;
+                        break;
+                    }
+                    if (p < end && *p == '/')
+                    {
+                        ++p;
+                        if (!parseInt(p, end, vn) || vn == 0)
+                        {
+                            chunk.error = true;
+                            break;
+                        }
+                    }
+                }
+                chunk.corners.push_back(encodeObjIndex(v, chunk.positions.size()));
+                chunk.corners.push_back(vt != 0 ? encodeObjIndex(vt, chunk.texCrds.size()) : kMissingIndex);
+                chunk.corners.push_back(vn != 0 ? encodeObjIndex(vn, chunk.normals.size()) : kMissingIndex);
+                ++cornerCount;
+            }
+            if (cornerCount < 3)
+                chunk.error = true;
+            chunk.faceSizes.push_back(cornerCount);
+        }
+        p = skipLine(p, end);
+    }
+}
+
+/// Splits the file into chunks at line boundaries.
+std::vector<ObjChunk> splitObjChunks(const char* data, size_t size)
+{
+    constexpr size_t kChunkSize = 1 << 20;
+    const size_t chunkCount = std::max<size_t>(1, size / kChunkSize);
+
+    std::vector<ObjChunk> chunks(chunkCount);
+    const char* end = data + size;
+    const char* begin = data;
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        const char* chunkEnd = i + 1 == chunkCount ? end : std::max(begin, data + size * (i + 1) / chunkCount);
+        if (chunkEnd < end)
+            chunkEnd = skipLine(chunkEnd, end);
+        chunks[i].begin = begin;
+        chunks[i].end = chunkEnd;
+        begin = chunkEnd;
+    }
+    return chunks;
+}
+
+struct ObjVertexKey
+{
+    uint32_t position;
+    uint32_t texCrd;
+    uint32_t normal;
+
+    bool operator==(const ObjVertexKey& other) const
+    {
+        return position == other.position && texCrd == other.texCrd && normal == other.normal;
+    }
+};
+
+struct ObjVertexKeyHash
+{
+    size_t operator()(const ObjVertexKey& key) const
+    {
+        uint64_t h = (uint64_t)key.position * 0x9E3779B97F4A7C15ull;
+        h ^= ((uint64_t)key.texCrd + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2)) * 0xC2B2AE3D27D4EB4Full;
+        h ^= ((uint64_t)key.normal + 0x85EBCA77C2B2AE63ull + (h << 6) + (h >> 2)) * 0x165667B19E3779F9ull;
+        return (size_t)(h ^ (h >> 32));
+    }
+};
+
+} // namespace
+
+void NativeMeshLoader::MeshData::generateSmoothNormals()
+{
+    normals.assign(positions.size(), float3(0.f));
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const uint32_t i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+        // The cross product length is twice the triangle area, which weights the face normal by area.
+        float3 n = cross(positions[i1] - positions[i0], positions[i2] - positions[i0]);
+        normals[i0] += n;
+        normals[i1] += n;
+        normals[i2] += n;
+    }
+    std::for_each(
+        std::execution::par_unseq,
+        normals.begin(),
+        normals.end(),
+        [](float3& n)
+        {
+            float len = length(n);
+            n = len > 0.f ? n / len : float3(0.f, 0.f, 1.f);
+        }
+    );
+}
+
+void NativeMeshLoader::MeshData::generateFlatNormals()
+{
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<float3> newPositions(triangleCount * 3);
+    std::vector<float3> newNormals(triangleCount * 3);
+    std::vector<float2> newTexCrds(texCrds.empty() ? 0 : triangleCount * 3);
+
+    auto range = NumericRange<size_t>(0, triangleCount);
+    std::for_each(
+        std::execution::par_unseq,
+        range.begin(),
+        range.end(),
+        [&](size_t t)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                newPositions[t * 3 + k] = positions[indices[t * 3 + k]];
+                if (!newTexCrds.empty())
+                    newTexCrds[t * 3 + k] = texCrds[indices[t * 3 + k]];
+            }
+            float3 n = cross(newPositions[t * 3 + 1] - newPositions[t * 3], newPositions[t * 3 + 2] - newPositions[t * 3]);
+            float len = length(n);
+            n = len > 0.f ? n / len : float3(0.f, 0.f, 1.f);
+            for (size_t k = 0; k < 3; ++k)
+                newNormals[t * 3 + k] = n;
+        }
+    );
+
+    positions = std::move(newPositions);
+    normals = std::move(newNormals);
+    texCrds = std::move(newTexCrds);
+    for (size_t i = 0; i < indices.size(); ++i)
+        indices[i] = (uint32_t)i;
+}
+
+SceneBuilder::Mesh NativeMeshLoader::MeshData::getSceneBuilderMesh(const std::string& name, const ref<Material>& pMaterial) const
+{
+    FALCOR_CHECK(!normals.empty(), "Mesh '{}' has no normals.", name);
+
+    SceneBuilder::Mesh mesh;
+    mesh.name = name;
+    mesh.faceCount = getTriangleCount();
+    mesh.vertexCount = getVertexCount();
+    mesh.indexCount = (uint32_t)indices.size();
+    mesh.pIndices = indices.data();
+    mesh.topology = Vao::Topology::TriangleList;
+    mesh.pMaterial = pMaterial;
+    mesh.positions.pData = positions.data();
+    mesh.positions.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    mesh.normals.pData = normals.data();
+    mesh.normals.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    if (!texCrds.empty())
+    {
+        mesh.texCrds.pData = texCrds.data();
+        mesh.texCrds.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    }
+    return mesh;
+}
+
+bool NativeMeshLoader::isSupported(const std::filesystem::path& path)
+{
+    return hasExtension(path, "ply") || hasExtension(path, "obj");
+}
+
+NativeMeshLoader::MeshData NativeMeshLoader::load(const std::filesystem::path& path)
+{
+    if (hasExtension(path, "ply"))
+        return loadPLY(path);
+    if (hasExtension(path, "obj"))
+        return loadOBJ(path);
+    FALCOR_THROW("Mesh file '{}' has an unsupported extension.", path);
+}
+
+NativeMeshLoader::MeshData NativeMeshLoader::loadPLY(const std::filesystem::path& path)
+{
+    MemoryMappedFile file;
+    openMappedFile(path, file);
+    const char* data = static_cast<const char*>(file.getData());
+    const size_t size = file.getMappedSize();
+
+    PlyHeader header = parsePlyHeader(path, data, size);
+
+    MeshData mesh;
+    if (header.format == PlyFormat::Ascii)
+        readPlyAscii(path, header, data, size, mesh);
+    else
+        readPlyBinary(path, header, reinterpret_cast<const uint8_t*>(data), size, mesh);
+
+    if (mesh.positions.empty())
+        FALCOR_THROW("PLY file '{}' has no vertices.", path);
+    validateIndices(path, mesh.indices, mesh.positions.size());
+    flipTexCrds(mesh.texCrds);
+    return mesh;
+}
+
+NativeMeshLoader::MeshData NativeMeshLoader::loadOBJ(const std::filesystem::path& path)
+{
+    MemoryMappedFile file;
+    openMappedFile(path, file);
+    const char* data = static_cast<const char*>(file.getData());
+    const size_t size = file.getMappedSize();
+
+    // Parse chunks in parallel.
+    std::vector<ObjChunk> chunks = splitObjChunks(data, size);
+    // Chunks are large, so each one is a separate task.
+    JobSystem::getGlobal().parallelFor(0, chunks.size(), [&](size_t i) { parseObjChunk(chunks[i]); }, 1);
+
+    // Compute attribute offsets of each chunk.
+    size_t positionCount = 0, normalCount = 0, texCrdCount = 0, cornerCount = 0, triangleCount = 0;
+    for (auto& chunk : chunks)
+    {
+        if (chunk.error)
+            FALCOR_THROW("OBJ file '{}' is malformed.", path);
+        chunk.positionOffset = positionCount;
+        chunk.normalOffset = normalCount;
+        chunk.texCrdOffset = texCrdCount;
+        chunk.cornerOffset = cornerCount;
+        positionCount += chunk.positions.size();
+        normalCount += chunk.normals.size();
+        texCrdCount += chunk.texCrds.size();
+        cornerCount += chunk.corners.size() / 3;
+        for (uint32_t faceSize : chunk.faceSizes)
+            triangleCount += faceSize - 2;
+    }
+    if (positionCount > std::numeric_limits<uint32_t>::max() || cornerCount > std::numeric_limits<uint32_t>::max())
+        FALCOR_THROW("OBJ file '{}' is too large.", path);
+
+    // Resolve corner indices to absolute indices in parallel.
+    // A normal or texture coordinate index of -1 means the corner does not reference one.
+    std::vector<ObjVertexKey> corners(cornerCount);
+    std::atomic<bool> outOfRange = false;
+    bool allHaveNormals = normalCount > 0;
+    bool allHaveTexCrds = texCrdCount > 0;
+    std::atomic<bool> missingNormals = false;
+    std::atomic<bool> missingTexCrds = false;
+    std::atomic<bool> hasSeparateIndices = false;
+    JobSystem::getGlobal().parallelFor(
+        0,
+        chunks.size(),
+        [&](size_t chunkIndex)
+        {
+            const ObjChunk& chunk = chunks[chunkIndex];
+            for (size_t i = 0; i < chunk.corners.size() / 3; ++i)
+            {
+                const int64_t* c = &chunk.corners[i * 3];
+                int64_t position = resolveObjIndex(c[0], chunk.positionOffset, positionCount);
+                int64_t texCrd = c[1] == kMissingIndex ? -1 : resolveObjIndex(c[1], chunk.texCrdOffset, texCrdCount);
+                int64_t normal = c[2] == kMissingIndex ? -1 : resolveObjIndex(c[2], chunk.normalOffset, normalCount);
+                if (position < 0 || (c[1] != kMissingIndex && texCrd < 0) || (c[2] != kMissingIndex && normal < 0))
+                    outOfRange = true;
+                if (c[1] == kMissingIndex)
+                    missingTexCrds = true;
+                if (c[2] == kMissingIndex)
+                    missingNormals = true;
+                if ((texCrd >= 0 && texCrd != position) || (normal >= 0 && normal != position))
+                    hasSeparateIndices = true;
+                corners[chunk.cornerOffset + i] = {(uint32_t)position, (uint32_t)texCrd, (uint32_t)normal};
+            }
+        },
+        1
+    );
+    if (outOfRange)
+        FALCOR_THROW("OBJ file '{}' has vertex indices out of range.", path);
+
+    // Only use normals and texture coordinates if every corner references one.
+    allHaveNormals = allHaveNormals && !missingNormals;
+    allHaveTexCrds = allHaveTexCrds && !missingTexCrds;
+
+    // Gather attributes of all chunks.
+    std::vector<float3> positions(positionCount);
+    std::vector<float3> normals(allHaveNormals ? normalCount : 0);
+    std::vector<float2> texCrds(allHaveTexCrds ? texCrdCount : 0);
+    JobSystem::getGlobal().parallelFor(
+        0,
+        chunks.size(),
+        [&](size_t chunkIndex)
+        {
+            const ObjChunk& chunk = chunks[chunkIndex];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.positionOffset);
+            if (!normals.empty())
+                std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.normalOffset);
+            if (!texCrds.empty())
+                std::copy(chunk.texCrds.begin(), chunk.texCrds.end(), texCrds.begin() + chunk.texCrdOffset);
+        },
+        1
+    );
+
+    MeshData mesh;
+    mesh.indices.reserve(triangleCount * 3);
+
+    // Use the position indices directly if there are no other attributes, or if all attributes use the same index.
+    const bool useOriginalVertices = (normals.empty() || normals.size() == positions.size()) &&
+                                     (texCrds.empty() || texCrds.size() == positions.size()) && !hasSeparateIndices;
+    if ((normals.empty() && texCrds.empty()) || useOriginalVertices)
+    {
+        mesh.positions = std::move(positions);
+        mesh.normals = std::move(normals);
+        mesh.texCrds = std::move(texCrds);
+        size_t corner = 0;
+        for (const auto& chunk : chunks)
+        {
+            for (uint32_t faceSize : chunk.faceSizes)
+            {
+                triangulatePolygon(mesh.indices, faceSize, [&](uint64_t k) { return corners[corner + k].position; });
+                corner += faceSize;
+            }
+        }
+    }
+    else
+    {
+        // Create a vertex for each unique combination of attribute indices.
+        std::unordered_map<ObjVertexKey, uint32_t, ObjVertexKeyHash> vertexMap;
+        vertexMap.reserve(std::min<size_t>(cornerCount, positionCount * 2));
+        std::vector<uint32_t> cornerVertices(cornerCount);
+        for (size_t i = 0; i < cornerCount; ++i)
+        {
+            ObjVertexKey key = corners[i];
+            if (normals.empty())
+                key.normal = 0;
+            if (texCrds.empty())
+                key.texCrd = 0;
+            auto [it, inserted] = vertexMap.try_emplace(key, (uint32_t)mesh.positions.size());
+            if (inserted)
+            {
+                mesh.positions.push_back(positions[key.position]);
+                if (!normals.empty())
+                    mesh.normals.push_back(normals[key.normal]);
+                if (!texCrds.empty())
+                    mesh.texCrds.push_back(texCrds[key.texCrd]);
+            }
+            cornerVertices[i] = it->second;
+        }
+
+        size_t corner = 0;
+        for (const auto& chunk : chunks)
+        {
+            for (uint32_t faceSize : chunk.faceSizes)
+            {
+                triangulatePolygon(mesh.indices, faceSize, [&](uint64_t k) { return cornerVertices[corner + k]; });
+                corner += faceSize;
+            }
+        }
+    }
+
+    if (mesh.positions.empty())
+        FALCOR_THROW("OBJ file '{}' has no vertices.", path);
+    flipTexCrds(mesh.texCrds);
+    return mesh;
+}
+} // namespace Falcor
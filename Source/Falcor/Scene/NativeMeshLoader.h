@@ -0,0 +1,104 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneBuilder.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Native loaders for PLY and OBJ triangle meshes.
+ *
+ * These bypass Assimp and its post-processing passes for the common case of loading plain geometry.
+ * PLY files are read through a memory-mapped file, binary vertex and triangle data is decoded in parallel.
+ * OBJ files are split into chunks at line boundaries and the chunks are parsed in parallel.
+ *
+ * Polygons are triangulated as fans. OBJ normals and texture coordinates are only used if every face corner references one. Texture coordinates are flipped vertically (v' = 1 - v), matching
+ * the aiProcess_FlipUVs convention used by the Assimp-based import paths.
+ * Materials, vertex colors and other attributes are ignored.
+ */
+class FALCOR_API NativeMeshLoader
+{
+public:
+    /**
+     * Triangle mesh data with a single index buffer shared by all vertex attributes.
+     */
+    struct MeshData
+    {
+        std::vector<float3> positions;
+        std::vector<float3> normals; ///< Vertex normals. Empty if the file has no normals.
+        std::vector<float2> texCrds; ///< Vertex texture coordinates. Empty if the file has no texture coordinates.
+        std::vector<uint32_t> indices;
+
+        uint32_t getVertexCount() const { return (uint32_t)positions.size(); }
+        uint32_t getTriangleCount() const { return (uint32_t)(indices.size() / 3); }
+
+        /// Generate area-weighted smooth vertex normals, replacing existing normals.
+        void generateSmoothNormals();
+
+        /// Generate facet normals, replacing existing normals. Vertices are unshared so that each triangle has its own three vertices.
+        void generateFlatNormals();
+
+        /**
+         * Get a SceneBuilder mesh description referencing this data.
+         * The mesh data must outlive the returned description. Normals are required, see generateSmoothNormals().
+         * @param[in] name Mesh name.
+         * @param[in] pMaterial Mesh material.
+         * @return The mesh description.
+         */
+        SceneBuilder::Mesh getSceneBuilderMesh(const std::string& name, const ref<Material>& pMaterial) const;
+    };
+
+    /// Returns true if the file has an extension handled by the native loaders (.ply or .obj).
+    static bool isSupported(const std::filesystem::path& path);
+
+    /**
+     * Load a mesh file. The format is determined by the file extension.
+     * Throws a RuntimeError if the file cannot be opened or is malformed.
+     * @param[in] path File path.
+     * @return The loaded mesh data.
+     */
+    static MeshData load(const std::filesystem::path& path);
+
+    /**
+     * Load a PLY file (ASCII, binary little endian or binary big endian).
+     * Throws a RuntimeError if the file cannot be opened or is malformed.
+     */
+    static MeshData loadPLY(const std::filesystem::path& path);
+
+    /**
+     * Load a Wavefront OBJ file. All objects and groups are merged into a single mesh.
+     * Throws a RuntimeError if the file cannot be opened or is malformed.
+     */
+    static MeshData loadOBJ(const std::filesystem::path& path);
+};
+} // namespace Falcor
@@ -47,6 +47,7 @@
 #include "Utils/Timing/Profiler.h"
 #include "Utils/UI/InputTypes.h"
 #include "Utils/Scripting/ScriptWriter.h"
+#include "Utils/JobSystem.h"
 #include "Utils/NumericRange.h"
 
 #include <fstream>
@@ -853,44 +854,107 @@ namespace Falcor
             getCamera()->bindShaderData(mpSceneBlock->getRootVar()[kCamera]);
     }
 
-    void Scene::updateBounds()
+    void Scene::createInstanceMatrixIndex()
     {
-        const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
+        // Build a reverse index from global matrix ID to geometry instances in CSR layout.
+        // This allows the per-frame update to only visit the instances whose matrices changed.
+        const size_t matrixCount = mpAnimationController->getGlobalMatrices().size();
+        mMatrixInstanceOffsets.assign(matrixCount + 1, 0);
+        for (const auto& inst : mGeometryInstanceData)
+        {
+            FALCOR_ASSERT(inst.globalMatrixID < matrixCount);
+            mMatrixInstanceOffsets[inst.globalMatrixID + 1]++;
+        }
+        std::partial_sum(mMatrixInstanceOffsets.begin(), mMatrixInstanceOffsets.end(), mMatrixInstanceOffsets.begin());
 
-        mSceneBB = AABB();
+        mMatrixInstanceIDs.resize(mGeometryInstanceData.size());
+        std::vector<uint32_t> offsets(mMatrixInstanceOffsets.begin(), mMatrixInstanceOffsets.end() - 1);
+        for (uint32_t instanceID = 0; instanceID < (uint32_t)mGeometryInstanceData.size(); instanceID++)
+        {
+            mMatrixInstanceIDs[offsets[mGeometryInstanceData[instanceID].globalMatrixID]++] = instanceID;
+        }
+    }
 
-        for (const auto& inst : mGeometryInstanceData)
+    AABB Scene::computeGeometryInstanceBounds(uint32_t instanceID) const
+    {
+        const GeometryInstanceData& inst = mGeometryInstanceData[instanceID];
+        const float4x4& transform = mpAnimationController->getGlobalMatrices()[inst.globalMatrixID];
+        switch (inst.getType())
+        {
+        case GeometryType::TriangleMesh:
+        case GeometryType::DisplacedTriangleMesh:
+            return mMeshBBs[inst.geometryID].transform(transform);
+        case GeometryType::Curve:
+            return mCurveBBs[inst.geometryID].transform(transform);
+        case GeometryType::SDFGrid:
+        {
+            float3x3 transform3x3 = float3x3(transform);
+            transform3x3[0] = abs(transform3x3[0]);
+            transform3x3[1] = abs(transform3x3[1]);
+            transform3x3[2] = abs(transform3x3[2]);
+            float3 center = transform.getCol(3).xyz();
+            float3 halfExtent = transformVector(transform3x3, float3(0.5f));
+            return AABB(center - halfExtent, center + halfExtent);
+        }
+        default:
+            return AABB();
+        }
+    }
+
+    void Scene::updateBounds(bool forceUpdate)
+    {
+        // The instance bounds are kept per instance and reduced per block of instances.
+        // When only a few instances move, only their bounds and the blocks containing them are recomputed.
+        const uint32_t instanceCount = (uint32_t)mGeometryInstanceData.size();
+        const uint32_t blockCount = div_round_up(instanceCount, kInstanceBoundsBlockSize);
+
+        std::vector<uint32_t> dirtyBlocks;
+        if (forceUpdate || mGeometryInstanceBBs.size() != instanceCount)
         {
-            const float4x4& transform = globalMatrices[inst.globalMatrixID];
-            switch (inst.getType())
-            {
-            case GeometryType::TriangleMesh:
-            case GeometryType::DisplacedTriangleMesh:
+            mGeometryInstanceBBs.resize(instanceCount);
+            mGeometryInstanceBlockBBs.resize(blockCount);
+
+            JobSystem::getGlobal().parallelFor(0, instanceCount, [&](size_t instanceID)
             {
-                const AABB& meshBB = mMeshBBs[inst.geometryID];
-                mSceneBB |= meshBB.transform(transform);
-                break;
-            }
-            case GeometryType::Curve:
+                mGeometryInstanceBBs[instanceID] = computeGeometryInstanceBounds((uint32_t)instanceID);
+            });
+
+            dirtyBlocks.resize(blockCount);
+            std::iota(dirtyBlocks.begin(), dirtyBlocks.end(), 0);
+        }
+        else
+        {
+            JobSystem::getGlobal().parallelFor(0, mChangedGeometryInstances.size(), [&](size_t i)
             {
-                const AABB& curveBB = mCurveBBs[inst.geometryID];
-                mSceneBB |= curveBB.transform(transform);
-                break;
-            }
-            case GeometryType::SDFGrid:
+                const uint32_t instanceID = mChangedGeometryInstances[i];
+                mGeometryInstanceBBs[instanceID] = computeGeometryInstanceBounds(instanceID);
+            });
+
+            // The changed instances are sorted, so the dirty blocks are sorted too.
+            for (uint32_t instanceID : mChangedGeometryInstances)
             {
-                float3x3 transform3x3 = float3x3(transform);
-                transform3x3[0] = abs(transform3x3[0]);
-                transform3x3[1] = abs(transform3x3[1]);
-                transform3x3[2] = abs(transform3x3[2]);
-                float3 center = transform.getCol(3).xyz();
-                float3 halfExtent = transformVector(transform3x3, float3(0.5f));
-                mSceneBB |= AABB(center - halfExtent, center + halfExtent);
-                break;
-            }
+                const uint32_t block = instanceID / kInstanceBoundsBlockSize;
+                if (dirtyBlocks.empty() || dirtyBlocks.back() != block) dirtyBlocks.push_back(block);
             }
         }
 
+        JobSystem::getGlobal().parallelFor(0, dirtyBlocks.size(), [&](size_t i)
+        {
+            const uint32_t block = dirtyBlocks[i];
+            const uint32_t first = block * kInstanceBoundsBlockSize;
+            const uint32_t last = std::min(first + kInstanceBoundsBlockSize, instanceCount);
+            AABB blockBB;
+            for (uint32_t instanceID = first; instanceID < last; instanceID++) blockBB |= mGeometryInstanceBBs[instanceID];
+            mGeometryInstanceBlockBBs[block] = blockBB;
+        });
+
+        mSceneBB = AABB();
+
+        for (const auto& aabb : mGeometryInstanceBlockBBs)
+        {
+            mSceneBB |= aabb;
+        }
+
         for (const auto& aabb : mCustomPrimitiveAABBs)
         {
             mSceneBB |= aabb;
@@ -906,38 +970,65 @@ namespace Falcor
     {
         if (mGeometryInstanceData.empty()) return;
 
-        bool dataChanged = false;
         const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
 
-        for (auto& inst : mGeometryInstanceData)
+        // Update the triangle winding flags of an instance. Returns true if the flags changed.
+        auto updateInstanceFlags = [&](uint32_t instanceID)
         {
-            if (inst.getType() == GeometryType::TriangleMesh || inst.getType() == GeometryType::DisplacedTriangleMesh)
-            {
-                uint32_t prevFlags = inst.flags;
+            auto& inst = mGeometryInstanceData[instanceID];
+            if (inst.getType() != GeometryType::TriangleMesh && inst.getType() != GeometryType::DisplacedTriangleMesh) return false;
 
-                FALCOR_ASSERT(inst.globalMatrixID < globalMatrices.size());
-                const float4x4& transform = globalMatrices[inst.globalMatrixID];
-                bool isTransformFlipped = doesTransformFlip(transform);
-                bool isObjectFrontFaceCW = getMesh(MeshID::fromSlang(inst.geometryID)).isFrontFaceCW();
-                bool isWorldFrontFaceCW = isObjectFrontFaceCW ^ isTransformFlipped;
+            uint32_t prevFlags = inst.flags;
 
-                if (isTransformFlipped) inst.flags |= (uint32_t)GeometryInstanceFlags::TransformFlipped;
-                else inst.flags &= ~(uint32_t)GeometryInstanceFlags::TransformFlipped;
+            FALCOR_ASSERT(inst.globalMatrixID < globalMatrices.size());
+            const float4x4& transform = globalMatrices[inst.globalMatrixID];
+            bool isTransformFlipped = doesTransformFlip(transform);
+            bool isObjectFrontFaceCW = getMesh(MeshID::fromSlang(inst.geometryID)).isFrontFaceCW();
+            bool isWorldFrontFaceCW = isObjectFrontFaceCW ^ isTransformFlipped;
 
-                if (isObjectFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
-                else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
+            if (isTransformFlipped) inst.flags |= (uint32_t)GeometryInstanceFlags::TransformFlipped;
+            else inst.flags &= ~(uint32_t)GeometryInstanceFlags::TransformFlipped;
 
-                if (isWorldFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
-                else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+            if (isObjectFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
+            else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
 
-                dataChanged |= (inst.flags != prevFlags);
-            }
-        }
+            if (isWorldFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+            else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+
+            return inst.flags != prevFlags;
+        };
 
-        if (forceUpdate || dataChanged)
+        if (forceUpdate)
         {
+            JobSystem::getGlobal().parallelFor(0, mGeometryInstanceData.size(), [&](size_t instanceID) { updateInstanceFlags((uint32_t)instanceID); });
+
             uint32_t byteSize = (uint32_t)(mGeometryInstanceData.size() * sizeof(GeometryInstanceData));
             mpGeometryInstancesBuffer->setBlob(mGeometryInstanceData.data(), 0, byteSize);
+            return;
+        }
+
+        // Only instances with changed transforms can change flags.
+        const size_t changedCount = mChangedGeometryInstances.size();
+        std::vector<uint8_t> flagsChanged(changedCount);
+        JobSystem::getGlobal().parallelFor(0, changedCount, [&](size_t i)
+        {
+            flagsChanged[i] = updateInstanceFlags(mChangedGeometryInstances[i]) ? 1 : 0;
+        });
+
+        // Upload ranges of consecutive instances with changed flags.
+        for (size_t i = 0; i < changedCount;)
+        {
+            if (!flagsChanged[i])
+            {
+                ++i;
+                continue;
+            }
+
+            const uint32_t first = mChangedGeometryInstances[i];
+            uint32_t count = 1;
+            for (++i; i < changedCount && flagsChanged[i] && mChangedGeometryInstances[i] == first + count; ++i) ++count;
+
+            mpGeometryInstancesBuffer->setBlob(&mGeometryInstanceData[first], first * sizeof(GeometryInstanceData), count * sizeof(GeometryInstanceData));
         }
     }
 
@@ -1255,9 +1346,10 @@ namespace Falcor
 
         mpAnimationController->animate(pRenderContext, 0); // Requires Scene block to exist
         updateGeometry(pRenderContext, true); // Requires scene defines
+        createInstanceMatrixIndex();
         updateGeometryInstances(true);
 
-        updateBounds();
+        updateBounds(true);
         createDrawList();
         if (mCameras.size() == 0)
         {
@@ -1869,13 +1961,17 @@ namespace Falcor
             mUpdates |= IScene::UpdateFlags::SceneGraphChanged;
             if (mpAnimationController->hasSkinnedMeshes()) mUpdates |= IScene::UpdateFlags::MeshesChanged;
 
-            for (const auto& inst : mGeometryInstanceData)
+            // Collect the geometry instances whose matrices changed using the reverse index.
+            mChangedGeometryInstances.clear();
+            for (uint32_t matrixID = 0; matrixID + 1 < (uint32_t)mMatrixInstanceOffsets.size(); matrixID++)
             {
-                if (mpAnimationController->isMatrixChanged(NodeID{ inst.globalMatrixID }))
-                {
-                    mUpdates |= IScene::UpdateFlags::GeometryMoved;
-                }
+                if (!mpAnimationController->isMatrixChanged(NodeID{ matrixID })) continue;
+                mChangedGeometryInstances.insert(mChangedGeometryInstances.end(),
+                    mMatrixInstanceIDs.begin() + mMatrixInstanceOffsets[matrixID], mMatrixInstanceIDs.begin() + mMatrixInstanceOffsets[matrixID + 1]);
             }
+            std::sort(mChangedGeometryInstances.begin(), mChangedGeometryInstances.end());
+
+            if (!mChangedGeometryInstances.empty()) mUpdates |= IScene::UpdateFlags::GeometryMoved;
 
             // We might end up setting the flag even if curves haven't changed (if looping is disabled for example).
             if (mpAnimationController->hasAnimatedCurveCaches()) mUpdates |= IScene::UpdateFlags::CurvesMoved;
@@ -1901,6 +1997,15 @@ namespace Falcor
             updateGeometryInstances(false);
         }
 
+        // Update the scene bounds. Only the bounds of moved instances are recomputed.
+        const auto boundsChangedFlags = IScene::UpdateFlags::GeometryMoved | IScene::UpdateFlags::GeometryChanged | IScene::UpdateFlags::CustomPrimitivesMoved |
+            IScene::UpdateFlags::GridVolumesMoved | IScene::UpdateFlags::GridVolumeBoundsChanged;
+        if (is_set(mUpdates, boundsChangedFlags))
+        {
+            updateBounds(false);
+        }
+        mChangedGeometryInstances.clear();
+
         // Update existing BLASes if skinned animation and/or procedural primitives moved.
         bool updateProcedural = is_set(mUpdates, IScene::UpdateFlags::CurvesMoved) || is_set(mUpdates, IScene::UpdateFlags::CustomPrimitivesMoved);
         bool blasUpdateRequired = is_set(mUpdates, IScene::UpdateFlags::MeshesChanged) || updateProcedural;
@@ -3106,33 +3211,41 @@ namespace Falcor
     void Scene::computeBlasGroups()
     {
         mBlasGroups.clear();
-        uint64_t groupSize = 0;
 
+        // Plan the groups from the prebuild sizes. The final sizes are predicted from previous builds.
+        std::vector<BlasGroupPlanner::BlasDesc> blasDescs(mBlasData.size());
         for (uint32_t blasId = 0; blasId < mBlasData.size(); blasId++)
         {
-            auto& blas = mBlasData[blasId];
-            size_t blasSize = blas.resultByteSize + blas.scratchByteSize;
-
-            // Start new BLAS group on first iteration or if group size would exceed the target.
-            if (groupSize == 0 || groupSize + blasSize > kMaxBLASBuildMemory)
-            {
-                mBlasGroups.push_back({});
-                groupSize = 0;
-            }
+            const auto& blas = mBlasData[blasId];
+            auto& desc = blasDescs[blasId];
+            desc.resultByteSize = blas.resultByteSize;
+            desc.scratchByteSize = blas.scratchByteSize;
+            desc.predictedFinalByteSize = mBlasCompactionHistory.predictFinalByteSize(blasId, blas.resultByteSize, blas.useCompaction);
+        }
 
-            // Add BLAS to current group.
-            FALCOR_ASSERT(mBlasGroups.size() > 0);
-            auto& group = mBlasGroups.back();
-            group.blasIndices.push_back(blasId);
-            blas.blasGroupIndex = (uint32_t)mBlasGroups.size() - 1;
+        auto plan = BlasGroupPlanner::plan(blasDescs, kMaxBLASBuildMemory);
+        auto sequentialPlan = BlasGroupPlanner::planSequential(blasDescs, kMaxBLASBuildMemory);
+        logInfo("BLAS build plan: {} groups, predicted peak memory {} (packing in ID order: {} groups, predicted peak memory {})",
+            plan.groups.size(), formatByteSize(plan.getPeakByteSize()),
+            sequentialPlan.groups.size(), formatByteSize(sequentialPlan.getPeakByteSize()));
 
-            // Update data offsets and sizes.
-            blas.resultByteOffset = group.resultByteSize;
-            blas.scratchByteOffset = group.scratchByteSize;
-            group.resultByteSize += blas.resultByteSize;
-            group.scratchByteSize += blas.scratchByteSize;
+        mBlasGroups.resize(plan.groups.size());
+        for (uint32_t blasGroupIndex = 0; blasGroupIndex < mBlasGroups.size(); blasGroupIndex++)
+        {
+            auto& group = mBlasGroups[blasGroupIndex];
+            group.blasIndices = std::move(plan.groups[blasGroupIndex].blasIndices);
 
-            groupSize += blasSize;
+            for (uint32_t blasId : group.blasIndices)
+            {
+                auto& blas = mBlasData[blasId];
+                blas.blasGroupIndex = blasGroupIndex;
+
+                // Update data offsets and sizes.
+                blas.resultByteOffset = group.resultByteSize;
+                blas.scratchByteOffset = group.scratchByteSize;
+                group.resultByteSize += blas.resultByteSize;
+                group.scratchByteSize += blas.scratchByteSize;
+            }
         }
 
         // Validation that all offsets and sizes are correct.
@@ -3255,6 +3368,7 @@ namespace Falcor
 
                 // Compute pre-build info per BLAS and organize the BLASes into groups
                 // in order to limit GPU memory usage during BLAS build.
+                // The groups are planned with bin packing, see BlasGroupPlanner.
                 preparePrebuildInfo(pRenderContext);
                 computeBlasGroups();
 
@@ -3389,6 +3503,8 @@ namespace Falcor
                         blas.blasByteSize = align_to(kAccelerationStructureByteAlignment, byteSize);
                         blas.blasByteOffset = group.finalByteSize;
                         group.finalByteSize += blas.blasByteSize;
+
+                        mBlasCompactionHistory.record(blasId, blas.resultByteSize, blas.blasByteSize, blas.useCompaction);
                     }
                     FALCOR_ASSERT(group.finalByteSize > 0);
 
@@ -3432,6 +3548,10 @@ namespace Falcor
                     pRenderContext->uavBarrier(pBlas.get());
                 }
 
+                uint64_t finalByteSize = 0;
+                for (const auto& group : mBlasGroups) finalByteSize += group.finalByteSize;
+                logInfo("BLAS build peak memory: {}", formatByteSize(resultByteSize + scratchByteSize + finalByteSize));
+
                 // Release scratch buffer if there is no animated content. We will not need it.
                 if (!hasDynamicGeometry && !hasProceduralPrimitives) mpBlasScratch.reset();
             }
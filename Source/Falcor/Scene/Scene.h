@@ -29,6 +29,7 @@
 #include "SceneIDs.h"
 #include "SceneTypes.slang"
 #include "HitInfo.h"
+#include "BlasGroupPlanner.h"
 #include "IScene.h"
 #include "Animation/Animation.h"
 #include "Animation/AnimationController.h"
@@ -1101,11 +1102,14 @@ namespace Falcor
     private:
         friend class AnimationController;
         friend class AnimatedVertexCache;
+        friend class HostRaytracer;
 
         static constexpr uint32_t kStaticDataBufferIndex = 0;
         static constexpr uint32_t kDrawIdBufferIndex = kStaticDataBufferIndex + 1;
         static constexpr uint32_t kVertexBufferCount = kDrawIdBufferIndex + 1;
 
+        static constexpr uint32_t kInstanceBoundsBlockSize = 1024;  ///< Number of geometry instances per block of the incrementally updated scene bounds.
+
         void createMeshVao(uint32_t drawCount, const std::vector<SkinningVertexData>& skinningData);
         void createCurveVao(const std::vector<uint32_t>& indexData, const std::vector<StaticCurveVertexData>& staticData);
         void createMeshUVTiles(const std::vector<MeshDesc>& meshDesc);
@@ -1129,11 +1133,21 @@ namespace Falcor
         */
         void uploadGeometry();
 
+        /** Create the reverse index from global matrix ID to the geometry instances using the matrix.
+        */
+        void createInstanceMatrixIndex();
+
+        /** Compute the world-space bounding box of a geometry instance.
+        */
+        AABB computeGeometryInstanceBounds(uint32_t instanceID) const;
+
         /** Update the scene's global bounding box.
+            \param[in] forceUpdate Recompute the bounds of all instances. Otherwise only the instances in mChangedGeometryInstances are updated.
         */
-        void updateBounds();
+        void updateBounds(bool forceUpdate);
 
         /** Update geometry instances.
+            \param[in] forceUpdate Update and upload all instances. Otherwise only the instances in mChangedGeometryInstances are updated.
         */
         void updateGeometryInstances(bool forceUpdate);
 
@@ -1238,6 +1252,9 @@ namespace Falcor
         GeometryTypeFlags mGeometryTypes;                           ///< Set of geometry types that exist in the scene.
 
         std::vector<GeometryInstanceData> mGeometryInstanceData;    ///< Geometry instance data (for all types of geometry).
+        std::vector<uint32_t> mMatrixInstanceOffsets;               ///< Offset into mMatrixInstanceIDs for each global matrix ID, plus one past the end.
+        std::vector<uint32_t> mMatrixInstanceIDs;                   ///< Geometry instance IDs sorted by global matrix ID.
+        std::vector<uint32_t> mChangedGeometryInstances;            ///< Sorted list of geometry instances whose transform changed in the current update.
 
         bool mUseCompressedHitInfo = false;                         ///< True if scene should used compressed HitInfo (on scenes with triangles meshes only).
         bool mHas16BitIndices = false;                              ///< True if any meshes use 16-bit indices.
@@ -1314,6 +1331,8 @@ namespace Falcor
         std::vector<std::vector<uint32_t>> mCurveIdToInstanceIds;   ///< Mapping of what instances belong to which curve.
         HitInfo mHitInfo;                                           ///< Geometry hit info requirements.
         AABB mSceneBB;                                              ///< Bounding boxes of the entire scene in world space.
+        std::vector<AABB> mGeometryInstanceBBs;                     ///< Bounding box of each geometry instance in world space.
+        std::vector<AABB> mGeometryInstanceBlockBBs;                ///< Union of the instance bounding boxes for each block of kInstanceBoundsBlockSize instances.
         SceneStats mSceneStats;                                     ///< Scene statistics.
         Metadata mMetadata;                                         ///< Importer-provided metadata.
         RenderSettings mRenderSettings;                             ///< Render settings.
@@ -1427,6 +1446,7 @@ namespace Falcor
         std::vector<ref<RtAccelerationStructure>> mBlasObjects; ///< BLAS API objects.
         std::vector<BlasData> mBlasData;                    ///< All data related to the scene's BLASes.
         std::vector<BlasGroup> mBlasGroups;                 ///< BLAS group data.
+        BlasCompactionHistory mBlasCompactionHistory;       ///< Final BLAS sizes of previous builds, used to predict the memory use of BLAS builds.
         ref<Buffer> mpBlasScratch;                          ///< Scratch buffer used for BLAS builds.
         ref<Buffer> mpBlasStaticWorldMatrices;              ///< Object-to-world transform matrices in row-major format. Only valid for static meshes.
         bool mBlasDataValid = false;                        ///< Flag to indicate if the BLAS data is valid. This will be reset when geometry is changed.
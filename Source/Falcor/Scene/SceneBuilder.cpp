@@ -30,10 +30,12 @@
 #include "Importer.h"
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
+#include "Utils/JobSystem.h"
 #include "Utils/Logger.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Timing/TimeReport.h"
+#include "Utils/Timing/Tracer.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/ObjectIDPython.h"
@@ -221,6 +223,8 @@ namespace Falcor
             throw ImporterError(path, "Can't find scene file '{}'.", path);
         }
 
+        FALCOR_TRACE_SCOPE_DETAIL("SceneBuilder::import", resolvedPath.filename().string());
+
         // Compute scene cache key based on absolute scene path and build flags.
         mSceneCacheKey = computeSceneCacheKey(resolvedPath, flags);
 
@@ -270,9 +274,13 @@ namespace Falcor
     }
 
     void SceneBuilder::import(const std::filesystem::path& path, const pybind11::dict& dict)
+    {
+        importFile(path, convertDictToMap(dict));
+    }
+
+    void SceneBuilder::importFile(const std::filesystem::path& path, const Scene::SceneData::ImportDict& materialToShortName)
     {
         logInfo("Importing scene: {}", path);
-        std::map<std::string, std::string> materialToShortName = convertDictToMap(dict);
 
         std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path, AssetCategory::Scene);
         if (resolvedPath.empty())
@@ -296,6 +304,7 @@ namespace Falcor
     void SceneBuilder::importFromMemory(const void* buffer, size_t byteSize, std::string_view extension, const pybind11::dict& dict)
     {
         logInfo("Importing scene from memory");
+        FALCOR_TRACE_SCOPE("SceneBuilder::importFromMemory");
         std::map<std::string, std::string> materialToShortName = convertDictToMap(dict);
 
         mSceneData.importPaths.push_back("<memory>");
@@ -311,6 +320,223 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::importParallel(const std::vector<std::filesystem::path>& paths, const std::vector<pybind11::dict>& dicts)
+    {
+        FALCOR_CHECK(
+            dicts.empty() || dicts.size() == paths.size(),
+            "Expected one dictionary per path ({} dictionaries for {} paths).", dicts.size(), paths.size()
+        );
+        FALCOR_TRACE_SCOPE("SceneBuilder::importParallel");
+
+        // Convert the dictionaries and fork the builders on the calling thread, the jobs don't access Python objects.
+        // The importers running in the jobs create materials, textures and buffers on the shared device. Each forked builder
+        // has its own MaterialSystem and TextureManager, but resource creation on the device and the texture loading of
+        // the TextureManagers (AsyncTextureLoader, Texture::createFromFile) must be thread-safe.
+        std::vector<Scene::SceneData::ImportDict> importDicts(paths.size());
+        std::vector<std::unique_ptr<SceneBuilder>> builders(paths.size());
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            if (!dicts.empty()) importDicts[i] = convertDictToMap(dicts[i]);
+            builders[i] = fork();
+        }
+
+        // Python scene files are imported on the calling thread while the jobs import the other files.
+        auto isPythonScene = [](const std::filesystem::path& path) { return getExtensionFromPath(path) == "pyscene"; };
+
+        auto& jobSystem = JobSystem::getGlobal();
+        std::vector<JobSystem::JobHandle> jobs;
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            if (isPythonScene(paths[i])) continue;
+            jobs.push_back(jobSystem.submit([&, i]() { builders[i]->importFile(paths[i], importDicts[i]); }));
+        }
+
+        std::exception_ptr exception;
+        try
+        {
+            for (size_t i = 0; i < paths.size(); i++)
+            {
+                if (isPythonScene(paths[i])) builders[i]->importFile(paths[i], importDicts[i]);
+            }
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        // Wait for all jobs before rethrowing, they reference the builders.
+        jobSystem.wait(jobs);
+        if (exception) std::rethrow_exception(exception);
+
+        for (auto& pBuilder : builders) merge(*pBuilder);
+    }
+
+    std::unique_ptr<SceneBuilder> SceneBuilder::fork() const
+    {
+        auto pBuilder = std::make_unique<SceneBuilder>(mpDevice, mSettings, mFlags);
+        pBuilder->mAssetResolver = mAssetResolver;
+        pBuilder->mIsFork = true;
+        return pBuilder;
+    }
+
+    void SceneBuilder::merge(SceneBuilder& builder)
+    {
+        FALCOR_CHECK(builder.mIsFork && builder.mpDevice == mpDevice, "Only forked builders of the same device can be merged.");
+        FALCOR_CHECK(&builder != this, "A builder can't be merged into itself.");
+        FALCOR_TRACE_SCOPE("SceneBuilder::merge");
+
+        // Assign the textures loaded by the forked builder to its materials.
+        builder.waitForMaterialTextureLoading();
+
+        auto& src = builder.mSceneData;
+
+        if (mSceneGraph.size() + builder.mSceneGraph.size() >= std::numeric_limits<NodeID::IntType>::max())
+            FALCOR_THROW("Scene graph is too large");
+        if (mMeshes.size() + builder.mMeshes.size() > std::numeric_limits<uint32_t>::max())
+            FALCOR_THROW("Trying to build a scene that exceeds supported number of meshes");
+        if (mCurves.size() + builder.mCurves.size() > std::numeric_limits<uint32_t>::max())
+            FALCOR_THROW("Trying to build a scene that exceeds supported number of curves.");
+
+        const uint32_t nodeOffset = (uint32_t)mSceneGraph.size();
+        const uint32_t meshOffset = (uint32_t)mMeshes.size();
+        const uint32_t curveOffset = (uint32_t)mCurves.size();
+        const uint32_t sdfGridOffset = (uint32_t)mSceneData.sdfGrids.size();
+        const uint32_t aabbOffset = (uint32_t)mSceneData.customPrimitiveAABBs.size();
+
+        auto remapNode = [nodeOffset](NodeID nodeID) { return nodeID.isValid() ? NodeID{ nodeID.get() + nodeOffset } : nodeID; };
+        auto remapAnimatable = [&](Animatable& animatable) { animatable.setNodeID(remapNode(animatable.getNodeID())); };
+
+        // Materials are added in the order of the forked builder, as if the assets were imported into this builder.
+        std::vector<MaterialID> materialIDs;
+        materialIDs.reserve(src.pMaterials->getMaterialCount());
+        for (const auto& pMaterial : src.pMaterials->getMaterials())
+        {
+            materialIDs.push_back(pMaterial ? addMaterial(pMaterial) : MaterialID::Invalid());
+        }
+
+        // Scene graph.
+        mSceneGraph.reserve(mSceneGraph.size() + builder.mSceneGraph.size());
+        for (auto& node : builder.mSceneGraph)
+        {
+            node.parent = remapNode(node.parent);
+            for (auto& childID : node.children) childID = remapNode(childID);
+            for (auto& meshID : node.meshes) meshID = MeshID{ meshID.get() + meshOffset };
+            for (auto& curveID : node.curves) curveID = CurveID{ curveID.get() + curveOffset };
+            for (auto& sdfGridID : node.sdfGrids) sdfGridID = SdfGridID{ sdfGridID.get() + sdfGridOffset };
+            mSceneGraph.push_back(std::move(node));
+        }
+
+        auto remapInstances = [&](std::set<NodeID>& instances)
+        {
+            std::set<NodeID> remapped;
+            for (NodeID nodeID : instances) remapped.insert(remapNode(nodeID));
+            instances = std::move(remapped);
+        };
+
+        // Meshes and curves.
+        mMeshes.reserve(mMeshes.size() + builder.mMeshes.size());
+        for (auto& mesh : builder.mMeshes)
+        {
+            mesh.materialId = materialIDs[mesh.materialId.get()];
+            mesh.skeletonNodeID = remapNode(mesh.skeletonNodeID);
+            for (auto& vertex : mesh.skinningData)
+            {
+                // Bone IDs are scene graph node IDs, unused bones are invalid.
+                for (uint32_t i = 0; i < 4; i++)
+                {
+                    if (vertex.boneID[i] != NodeID::kInvalidID) vertex.boneID[i] += nodeOffset;
+                }
+            }
+            remapInstances(mesh.instances);
+            mMeshes.push_back(std::move(mesh));
+        }
+
+        mCurves.reserve(mCurves.size() + builder.mCurves.size());
+        for (auto& curve : builder.mCurves)
+        {
+            curve.materialId = materialIDs[curve.materialId.get()];
+            remapInstances(curve.instances);
+            mCurves.push_back(std::move(curve));
+        }
+
+        for (auto& cachedMesh : src.cachedMeshes)
+        {
+            cachedMesh.meshID = MeshID{ cachedMesh.meshID.get() + meshOffset };
+            mSceneData.cachedMeshes.push_back(std::move(cachedMesh));
+        }
+
+        for (auto& cachedCurve : src.cachedCurves)
+        {
+            // Curves tessellated into poly-tubes are animated as meshes.
+            const uint32_t offset = cachedCurve.tessellationMode == CurveTessellationMode::PolyTube ? meshOffset : curveOffset;
+            cachedCurve.geometryID = CurveOrMeshID{ cachedCurve.geometryID.get() + offset };
+            mSceneData.cachedCurves.push_back(std::move(cachedCurve));
+        }
+
+        // SDF grids.
+        mSceneData.sdfGrids.insert(mSceneData.sdfGrids.end(), src.sdfGrids.begin(), src.sdfGrids.end());
+        for (auto& desc : src.sdfGridDesc)
+        {
+            desc.sdfGridID = SdfGridID{ desc.sdfGridID.get() + sdfGridOffset };
+            desc.materialID = materialIDs[desc.materialID.get()];
+            for (auto& nodeID : desc.instances) nodeID = remapNode(nodeID);
+            mSceneData.sdfGridDesc.push_back(std::move(desc));
+        }
+        for (auto instance : src.sdfGridInstances)
+        {
+            instance.geometryID += sdfGridOffset;
+            instance.materialID = materialIDs[instance.materialID].getSlang();
+            instance.globalMatrixID += nodeOffset;
+            mSceneData.sdfGridInstances.push_back(instance);
+        }
+        mSceneData.sdfGridMaxLODCount = std::max(mSceneData.sdfGridMaxLODCount, src.sdfGridMaxLODCount);
+
+        // Custom primitives.
+        for (auto desc : src.customPrimitiveDesc)
+        {
+            desc.aabbOffset += aabbOffset;
+            mSceneData.customPrimitiveDesc.push_back(desc);
+        }
+        auto& aabbs = mSceneData.customPrimitiveAABBs;
+        aabbs.insert(aabbs.end(), src.customPrimitiveAABBs.begin(), src.customPrimitiveAABBs.end());
+
+        // Animatable objects and animations.
+        for (const auto& pLight : src.lights)
+        {
+            remapAnimatable(*pLight);
+            mSceneData.lights.push_back(pLight);
+        }
+        for (const auto& pGridVolume : src.gridVolumes)
+        {
+            remapAnimatable(*pGridVolume);
+            mSceneData.gridVolumes.push_back(pGridVolume);
+        }
+        if (mSceneData.cameras.empty()) mSceneData.selectedCamera = src.selectedCamera;
+        for (const auto& pCamera : src.cameras)
+        {
+            remapAnimatable(*pCamera);
+            mSceneData.cameras.push_back(pCamera);
+        }
+        for (const auto& pAnimation : src.animations)
+        {
+            pAnimation->setNodeID(remapNode(pAnimation->getNodeID()));
+            mSceneData.animations.push_back(pAnimation);
+        }
+
+        if (!mSceneData.pEnvMap) mSceneData.pEnvMap = src.pEnvMap;
+        if (builder.mLightProfile) loadLightProfile(builder.mLightProfile->first.string(), builder.mLightProfile->second);
+
+        mSceneData.importPaths.insert(mSceneData.importPaths.end(), src.importPaths.begin(), src.importPaths.end());
+        mSceneData.importDicts.insert(mSceneData.importDicts.end(), src.importDicts.begin(), src.importDicts.end());
+
+        mVertexCacheStatsBefore += builder.mVertexCacheStatsBefore;
+        mVertexCacheStatsAfter += builder.mVertexCacheStatsAfter;
+
+        builder.mSceneGraph.clear();
+        builder.mMeshes.clear();
+        builder.mCurves.clear();
+    }
+
     void SceneBuilder::pushAssetResolver()
     {
         mAssetResolverStack.push_back(AssetResolver(mAssetResolver));
@@ -327,8 +553,13 @@ namespace Falcor
     {
         if (mpScene) return mpScene;
 
+        FALCOR_TRACE_SCOPE("SceneBuilder::getScene");
+
         // Finish loading textures. This blocks until all textures are loaded and assigned.
-        mpMaterialTextureLoader.reset();
+        {
+            FALCOR_TRACE_SCOPE("SceneBuilder::finishTextureLoading");
+            mpMaterialTextureLoader.reset();
+        }
 
         // If no meshes were added, we create a dummy mesh to keep the scene generation working.
         // Scenes with no meshes can be useful for example when using volumes in isolation.
@@ -344,6 +575,12 @@ namespace Falcor
             addMeshInstance(nodeID, meshID);
         }
 
+        if (is_set(mFlags, Flags::OptimizeVertexCache) && mVertexCacheStatsBefore.triangleCount > 0)
+        {
+            logInfo("Optimized {} triangles for vertex cache: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}.", mVertexCacheStatsAfter.triangleCount,
+                mVertexCacheStatsBefore.getACMR(), mVertexCacheStatsAfter.getACMR(), mVertexCacheStatsBefore.getATVR(), mVertexCacheStatsAfter.getATVR());
+        }
+
         // Post-process the scene data.
         TimeReport timeReport;
 
@@ -457,6 +694,7 @@ namespace Falcor
         //  - Compute tangent space if needed
         //  - Merge identical vertices, compute new indices (optional)
         //  - Validate final vertex data
+        //  - Optimize triangle and vertex order (optional)
         //  - Compact vertices/indices into runtime format
 
         // Copy the mesh desc so we can update it. The caller retains the ownership of the data.
@@ -650,6 +888,39 @@ namespace Falcor
 
         // If the non-indexed vertices build flag is set, we will de-index the data below.
         const bool isIndexed = !is_set(mFlags, Flags::NonIndexedVertices);
+
+        // Optimize the triangle and vertex order. The attribute indices are per vertex and are permuted along with
+        // the vertices. If they don't map one-to-one to the vertices, the mesh is left as is.
+        if (isIndexed && is_set(mFlags, Flags::OptimizeVertexCache) && mesh.topology == Vao::Topology::TriangleList &&
+            (!pAttributeIndices || pAttributeIndices->size() == vertices.size()))
+        {
+            const uint32_t optimizedVertexCount = (uint32_t)vertices.size();
+            processedMesh.vertexCacheStatsBefore = VertexCacheOptimizer::computeStats(indices, optimizedVertexCount);
+
+            std::vector<float3> positions(optimizedVertexCount);
+            for (uint32_t i = 0; i < optimizedVertexCount; i++) positions[i] = vertices[i].first.position;
+
+            VertexCacheOptimizer::optimizeTriangleOrder(indices, optimizedVertexCount);
+            VertexCacheOptimizer::optimizeOverdraw(indices, positions);
+            std::vector<uint32_t> vertexOrder = VertexCacheOptimizer::optimizeVertexOrder(indices, optimizedVertexCount);
+
+            std::vector<std::pair<Mesh::Vertex, uint32_t>> optimizedVertices(optimizedVertexCount);
+            for (uint32_t i = 0; i < optimizedVertexCount; i++) optimizedVertices[i] = { vertices[vertexOrder[i]].first, invalidIndex };
+            vertices = std::move(optimizedVertices);
+
+            if (pAttributeIndices)
+            {
+                MeshAttributeIndices optimizedAttributeIndices(optimizedVertexCount);
+                for (uint32_t i = 0; i < optimizedVertexCount; i++) optimizedAttributeIndices[i] = (*pAttributeIndices)[vertexOrder[i]];
+                *pAttributeIndices = std::move(optimizedAttributeIndices);
+            }
+
+            processedMesh.vertexCacheStatsAfter = VertexCacheOptimizer::computeStats(indices, optimizedVertexCount);
+            logDebug("Mesh with name '{}' optimized for vertex cache: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}.", mesh.name,
+                processedMesh.vertexCacheStatsBefore.getACMR(), processedMesh.vertexCacheStatsAfter.getACMR(),
+                processedMesh.vertexCacheStatsBefore.getATVR(), processedMesh.vertexCacheStatsAfter.getATVR());
+        }
+
         const uint32_t vertexCount = isIndexed ? (uint32_t)vertices.size() : mesh.indexCount;
 
         // Copy indices into processed mesh.
@@ -737,6 +1008,9 @@ namespace Falcor
 
         MeshSpec spec;
 
+        mVertexCacheStatsBefore += mesh.vertexCacheStatsBefore;
+        mVertexCacheStatsAfter += mesh.vertexCacheStatsAfter;
+
         // Add the mesh to the scene.
         spec.name = mesh.name;
         spec.topology = mesh.topology;
@@ -1001,7 +1275,16 @@ namespace Falcor
 
     void SceneBuilder::loadLightProfile(const std::string& filename, bool normalize)
     {
-        mSceneData.pMaterials->loadLightProfile(mAssetResolver.resolvePath(std::filesystem::path(filename)), normalize);
+        std::filesystem::path resolvedPath = mAssetResolver.resolvePath(std::filesystem::path(filename));
+
+        // The light profile is global to the scene, forked builders pass it on when merged.
+        if (mIsFork)
+        {
+            mLightProfile = std::make_pair(resolvedPath, normalize);
+            return;
+        }
+
+        mSceneData.pMaterials->loadLightProfile(resolvedPath, normalize);
     }
 
     // Cameras
@@ -2550,9 +2833,13 @@ namespace Falcor
         // It should run after optimizeMaterials() as materials with different
         // textures may be reduced to identical materials after optimization,
         // increasing the likelihood of finding duplicates here.
+        // Textures holding identical texels are merged first, so that materials
+        // referencing copies of the same image are identified as duplicates too.
 
         if (is_set(mFlags, Flags::DontMergeMaterials)) return;
 
+        mSceneData.pMaterials->removeDuplicateTextures();
+
         std::vector<MaterialID> idMap;
         size_t removed = mSceneData.pMaterials->removeDuplicateMaterials(idMap);
 
@@ -2962,6 +3249,8 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("OptimizeVertexCache", SceneBuilder::Flags::OptimizeVertexCache);
+        flags.value("UseNativeMeshLoader", SceneBuilder::Flags::UseNativeMeshLoader);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
         ScriptBindings::addEnumBinaryOperators(flags);
@@ -2979,6 +3268,7 @@ namespace Falcor
         sceneBuilder.def_property("selectedCamera", &SceneBuilder::getSelectedCamera, &SceneBuilder::setSelectedCamera);
         sceneBuilder.def_property("cameraSpeed", &SceneBuilder::getCameraSpeed, &SceneBuilder::setCameraSpeed);
         sceneBuilder.def("importScene", &SceneBuilder::import, "path"_a, "dict"_a = pybind11::dict());
+        sceneBuilder.def("importScenes", &SceneBuilder::importParallel, "paths"_a, "dicts"_a = std::vector<pybind11::dict>());
         sceneBuilder.def("addTriangleMesh", &SceneBuilder::addTriangleMesh, "triangleMesh"_a, "material"_a, "isAnimated"_a = false);
         sceneBuilder.def("addSDFGrid", &SceneBuilder::addSDFGrid, "sdfGrid"_a, "material"_a);
         sceneBuilder.def("addMaterial", &SceneBuilder::addMaterial, "material"_a);
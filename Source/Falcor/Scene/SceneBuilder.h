@@ -31,6 +31,7 @@
 #include "SceneIDs.h"
 #include "Transform.h"
 #include "TriangleMesh.h"
+#include "VertexCacheOptimizer.h"
 #include "VertexAttrib.slangh"
 #include "SceneTypes.slang"
 #include "Material/MaterialTextureLoader.h"
@@ -47,7 +48,9 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Falcor
@@ -77,6 +80,8 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            OptimizeVertexCache             = 0x20000,  ///< Reorder triangles and vertices of indexed triangle meshes for vertex cache efficiency and reduced overdraw.
+            UseNativeMeshLoader             = 0x40000,  ///< Load PLY files with the native mesh loader instead of ASSIMP. This is faster for large meshes, but the import flags of 'AssimpImporter' don't apply and a default material is used.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
@@ -278,6 +283,9 @@ namespace Falcor
             std::vector<uint32_t> indexData;    ///< Vertex indices in either 32-bit or 16-bit format packed tightly, or empty if non-indexed.
             std::vector<StaticVertexData> staticData;
             std::vector<SkinningVertexData> skinningData;
+
+            VertexCacheOptimizer::Stats vertexCacheStatsBefore; ///< Simulated vertex cache statistics before optimization (only if Flags::OptimizeVertexCache is set).
+            VertexCacheOptimizer::Stats vertexCacheStatsAfter;  ///< Simulated vertex cache statistics after optimization (only if Flags::OptimizeVertexCache is set).
         };
 
         using MeshAttributeIndices = std::vector<Mesh::VertexAttributeIndices>;
@@ -358,6 +366,32 @@ namespace Falcor
         */
         void importFromMemory(const void* buffer, size_t byteSize, std::string_view extension, const pybind11::dict& dict = pybind11::dict());
 
+        /** Import multiple scene/model files concurrently.
+            Each file is imported into a forked builder (see fork()) on the job system. The forked builders are merged
+            in the order of the paths, so the IDs of the imported objects don't depend on the order the imports finish in.
+            Python scene files run scripts and are imported on the calling thread.
+            \param[in] paths The file paths to load.
+            \param[in] dicts Optional dictionaries, either empty or one per path.
+            Throws an ImporterError if something went wrong.
+        */
+        void importParallel(const std::vector<std::filesystem::path>& paths, const std::vector<pybind11::dict>& dicts = {});
+
+        /** Create a builder for importing assets concurrently with this builder.
+            The forked builder uses the device, settings, flags and current asset resolver of this builder
+            but holds its own scene objects, so it can be filled on another thread. Use merge() to add its content to this builder.
+            \return A new empty builder.
+        */
+        std::unique_ptr<SceneBuilder> fork() const;
+
+        /** Merge the content of a forked builder into this builder.
+            Nodes, meshes, curves, SDF grids, custom primitives, lights, cameras, grid volumes and animations are appended
+            and all IDs referencing them are remapped. Materials are added to the material system of this builder.
+            The environment map and selected camera are only taken if this builder has none.
+            Render settings, metadata and camera speed of the forked builder are ignored.
+            \param[in] builder The forked builder. Its content is moved, it must not be used afterwards.
+        */
+        void merge(SceneBuilder& builder);
+
         /// Access the current asset resolver (on top of the stack).
         AssetResolver& getAssetResolver() { return mAssetResolver; }
         const AssetResolver& getAssetResolver() const { return mAssetResolver; }
@@ -773,6 +807,9 @@ namespace Falcor
         AssetResolver mAssetResolver;
         std::vector<AssetResolver> mAssetResolverStack;
 
+        bool mIsFork = false;   ///< True if the builder was created by fork().
+        std::optional<std::pair<std::filesystem::path, bool>> mLightProfile; ///< Light profile (path, normalize) of a forked builder.
+
         Scene::SceneData mSceneData;
         ref<Scene> mpScene;
         SceneCache::Key mSceneCacheKey;
@@ -785,9 +822,13 @@ namespace Falcor
 
         CurveList mCurves;
 
+        VertexCacheOptimizer::Stats mVertexCacheStatsBefore; ///< Accumulated vertex cache statistics of all processed meshes before optimization.
+        VertexCacheOptimizer::Stats mVertexCacheStatsAfter;  ///< Accumulated vertex cache statistics of all processed meshes after optimization.
+
         std::unique_ptr<MaterialTextureLoader> mpMaterialTextureLoader;
 
         // Helpers
+        void importFile(const std::filesystem::path& path, const Scene::SceneData::ImportDict& dict);
         bool doesNodeHaveAnimation(NodeID nodeID) const;
         void updateLinkedObjects(NodeID oldNodeID, NodeID newNodeID);
         bool collapseNodes(NodeID parentNodeID, NodeID childNodeID);
@@ -25,6 +25,7 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
+#include "Core/Macros.h"
 #include <map>
 #include <string>
 
@@ -34,7 +35,7 @@ namespace Falcor
 class SceneBuilder;
 
 /// Used to dump content of SceneBuilder for debugging purposes.
-class SceneBuilderDump
+class FALCOR_API SceneBuilderDump
 {
 public:
     /// Returns pairs of geometry and its serialization to text used for debugging.
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TriangleMesh.h"
+#include "NativeMeshLoader.h"
 #include "GlobalState.h"
 #include "Core/Error.h"
 #include "Core/Platform/OS.h"
@@ -201,6 +202,30 @@ namespace Falcor
             return nullptr;
         }
 
+        if (is_set(importFlags, ImportFlags::UseNativeLoader) && NativeMeshLoader::isSupported(path))
+        {
+            try
+            {
+                auto data = NativeMeshLoader::load(path);
+                if (data.normals.empty())
+                {
+                    if (is_set(importFlags, ImportFlags::GenSmoothNormals)) data.generateSmoothNormals();
+                    else data.generateFlatNormals();
+                }
+
+                VertexList vertices(data.positions.size());
+                for (size_t i = 0; i < vertices.size(); ++i)
+                {
+                    vertices[i] = Vertex{data.positions[i], data.normals[i], data.texCrds.empty() ? float2(0.f) : data.texCrds[i]};
+                }
+                return create(vertices, data.indices);
+            }
+            catch (const RuntimeError& e)
+            {
+                logWarning("Native mesh loader failed, falling back to ASSIMP: {}", e.what());
+            }
+        }
+
         Assimp::Importer importer;
 
         unsigned int flags =
@@ -330,6 +355,7 @@ namespace Falcor
         flags.value("Default", TriangleMesh::ImportFlags::Default);
         flags.value("GenSmoothNormals", TriangleMesh::ImportFlags::GenSmoothNormals);
         flags.value("JoinIdenticalVertices", TriangleMesh::ImportFlags::JoinIdenticalVertices);
+        flags.value("UseNativeLoader", TriangleMesh::ImportFlags::UseNativeLoader);
         ScriptBindings::addEnumBinaryOperators(flags);
 
         pybind11::class_<TriangleMesh, ref<TriangleMesh>> triangleMesh(m, "TriangleMesh");
@@ -51,6 +51,7 @@ namespace Falcor
             None = 0x0,
             GenSmoothNormals = 0x1,
             JoinIdenticalVertices = 0x2,
+            UseNativeLoader = 0x4,  ///< Load PLY and OBJ files with NativeMeshLoader instead of ASSIMP. Generated normals are area-weighted and differ from ASSIMP.
 
             Default = None
         };
@@ -111,6 +112,7 @@ namespace Falcor
 
         /** Creates a triangle mesh from a file.
             This is using ASSIMP to support a wide variety of asset formats.
+            PLY and OBJ files are loaded with NativeMeshLoader instead if ImportFlags::UseNativeLoader is set.
             All geometry found in the asset is pre-transformed and merged into the same triangle mesh.
             \param[in] path File path to load mesh from (absolute or relative to working directory).
             \param[in] flags Flags controlling ASSIMP mesh import options.
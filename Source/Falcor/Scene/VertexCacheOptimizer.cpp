@@ -0,0 +1,363 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VertexCacheOptimizer.h"
+#include "Core/Error.h"
+#include "Utils/Math/VectorMath.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Falcor
+{
+namespace
+{
+constexpr uint32_t kInvalidIndex = 0xffffffff;
+
+// Scoring parameters from Forsyth's article.
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kValenceBoostScale = 2.f;
+constexpr float kValenceBoostPower = 0.5f;
+constexpr uint32_t kValenceTableSize = 32;
+
+/// Precomputed vertex scores for each cache position and each remaining valence.
+struct ScoreTables
+{
+    float cachePosition[VertexCacheOptimizer::kOptimizeCacheSize];
+    float valence[kValenceTableSize];
+
+    ScoreTables()
+    {
+        const uint32_t cacheSize = VertexCacheOptimizer::kOptimizeCacheSize;
+        for (uint32_t i = 0; i < cacheSize; ++i)
+        {
+            // The three vertices of the last triangle get a fixed score so that the same triangle is not
+            // immediately favored again. The score of the other cache positions decays with the position.
+            if (i < 3)
+                cachePosition[i] = kLastTriangleScore;
+            else
+                cachePosition[i] = std::pow(1.f - float(i - 3) / float(cacheSize - 3), kCacheDecayPower);
+        }
+        for (uint32_t i = 0; i < kValenceTableSize; ++i)
+            valence[i] = computeValenceScore(i);
+    }
+
+    static float computeValenceScore(uint32_t remainingValence)
+    {
+        // Boost vertices with few remaining triangles to get rid of lone triangles early.
+        return remainingValence > 0 ? kValenceBoostScale * std::pow(float(remainingValence), -kValenceBoostPower) : 0.f;
+    }
+
+    float computeVertexScore(int32_t position, uint32_t remainingValence) const
+    {
+        // Vertices without remaining triangles are never used again.
+        if (remainingValence == 0)
+            return -1.f;
+        float score = position >= 0 ? cachePosition[position] : 0.f;
+        score += remainingValence < kValenceTableSize ? valence[remainingValence] : computeValenceScore(remainingValence);
+        return score;
+    }
+};
+
+/// Simulated FIFO post-transform vertex cache.
+/// A vertex is in the cache if less than cacheSize misses happened since it was last inserted.
+class FifoCache
+{
+public:
+    FifoCache(uint32_t vertexCount, uint32_t cacheSize) : mTimestamps(vertexCount, 0), mCacheSize(cacheSize), mTime(cacheSize + 1) {}
+
+    /// Access a vertex. Returns true on a cache miss.
+    bool access(uint32_t vertex)
+    {
+        if (mTime - mTimestamps[vertex] <= mCacheSize)
+            return false;
+        mTimestamps[vertex] = mTime++;
+        return true;
+    }
+
+private:
+    std::vector<uint64_t> mTimestamps;
+    uint64_t mCacheSize;
+    uint64_t mTime;
+};
+} // namespace
+
+VertexCacheOptimizer::Stats VertexCacheOptimizer::computeStats(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+    FALCOR_CHECK(cacheSize > 0, "Cache size must be larger than zero.");
+
+    Stats stats;
+    stats.triangleCount = indices.size() / 3;
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    for (size_t i = 0; i < stats.triangleCount * 3; ++i)
+    {
+        const uint32_t vertex = indices[i];
+        FALCOR_ASSERT(vertex < vertexCount);
+        if (!referenced[vertex])
+        {
+            referenced[vertex] = true;
+            stats.vertexCount++;
+        }
+        if (cache.access(vertex))
+            stats.cacheMisses++;
+    }
+    return stats;
+}
+
+void VertexCacheOptimizer::optimizeTriangleOrder(std::vector<uint32_t>& indices, uint32_t vertexCount)
+{
+    const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+    if (triangleCount < 2)
+        return;
+
+    static const ScoreTables kScores;
+
+    // Build the vertex-to-triangle adjacency. The first 'valence[v]' entries of each list are the
+    // triangles of vertex v that have not been emitted yet.
+    std::vector<uint32_t> valence(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+    {
+        FALCOR_ASSERT(indices[i] < vertexCount);
+        valence[indices[i]]++;
+    }
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + valence[v];
+
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t t = 0; t < triangleCount; ++t)
+        {
+            for (uint32_t k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = t;
+        }
+    }
+
+    // Initial scores.
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        vertexScores[v] = kScores.computeVertexScore(-1, valence[v]);
+
+    std::vector<float> triangleScores(triangleCount);
+    uint32_t bestTriangle = 0;
+    for (uint32_t t = 0; t < triangleCount; ++t)
+    {
+        const uint32_t* tri = &indices[t * 3];
+        triangleScores[t] = vertexScores[tri[0]] + vertexScores[tri[1]] + vertexScores[tri[2]];
+        if (triangleScores[t] > triangleScores[bestTriangle])
+            bestTriangle = t;
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+
+    // LRU cache, with room for the vertices of the new triangle before the oldest entries are evicted.
+    uint32_t cache[kOptimizeCacheSize + 3];
+    uint32_t newCache[kOptimizeCacheSize + 3];
+    uint32_t cacheCount = 0;
+    uint32_t nextCandidate = 0;
+
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        if (bestTriangle == kInvalidIndex)
+        {
+            // No candidate triangle in the cache, continue with the next triangle that has not been emitted.
+            while (emitted[nextCandidate])
+                ++nextCandidate;
+            bestTriangle = nextCandidate;
+        }
+
+        const uint32_t t = bestTriangle;
+        const uint32_t tri[3] = {indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]};
+        emitted[t] = true;
+        output.insert(output.end(), tri, tri + 3);
+
+        // Remove the triangle from the adjacency lists of its vertices.
+        for (uint32_t v : tri)
+        {
+            auto begin = adjacency.begin() + adjacencyOffsets[v];
+            auto end = begin + valence[v];
+            auto it = std::find(begin, end, t);
+            FALCOR_ASSERT(it != end);
+            std::iter_swap(it, end - 1);
+            valence[v]--;
+        }
+
+        // Move the triangle's vertices to the front of the cache.
+        uint32_t newCacheCount = 0;
+        for (uint32_t v : tri)
+        {
+            if (std::find(newCache, newCache + newCacheCount, v) == newCache + newCacheCount)
+                newCache[newCacheCount++] = v;
+        }
+        for (uint32_t j = 0; j < cacheCount; ++j)
+        {
+            const uint32_t v = cache[j];
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                newCache[newCacheCount++] = v;
+        }
+
+        // Update the scores of all vertices in the cache, including the ones that were just evicted,
+        // and propagate the changes to their remaining triangles.
+        for (uint32_t j = 0; j < newCacheCount; ++j)
+        {
+            const uint32_t v = newCache[j];
+            cachePosition[v] = j < kOptimizeCacheSize ? (int32_t)j : -1;
+            const float score = kScores.computeVertexScore(cachePosition[v], valence[v]);
+            const float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+            for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v] + valence[v]; ++a)
+                triangleScores[adjacency[a]] += delta;
+        }
+
+        // The next triangle is the best scoring triangle that uses a vertex in the cache.
+        bestTriangle = kInvalidIndex;
+        float bestScore = -std::numeric_limits<float>::infinity();
+        cacheCount = std::min(newCacheCount, kOptimizeCacheSize);
+        for (uint32_t j = 0; j < cacheCount; ++j)
+        {
+            const uint32_t v = newCache[j];
+            cache[j] = v;
+            for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v] + valence[v]; ++a)
+            {
+                if (triangleScores[adjacency[a]] > bestScore)
+                {
+                    bestScore = triangleScores[adjacency[a]];
+                    bestTriangle = adjacency[a];
+                }
+            }
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void VertexCacheOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<float3>& positions)
+{
+    const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+    if (triangleCount < 2)
+        return;
+
+    // Split the triangles into clusters at hard boundaries, where all three vertices of a triangle miss the cache.
+    // Reordering whole clusters does not change the number of cache misses at the boundaries.
+    std::vector<uint32_t> clusterStarts;
+    {
+        FifoCache cache((uint32_t)positions.size(), kStatsCacheSize);
+        for (uint32_t t = 0; t < triangleCount; ++t)
+        {
+            uint32_t misses = 0;
+            for (uint32_t k = 0; k < 3; ++k)
+                misses += cache.access(indices[t * 3 + k]) ? 1 : 0;
+            if (misses == 3 || t == 0)
+                clusterStarts.push_back(t);
+        }
+    }
+    const uint32_t clusterCount = (uint32_t)clusterStarts.size();
+    if (clusterCount < 2)
+        return;
+    clusterStarts.push_back(triangleCount);
+
+    // Compute the area-weighted centroid and normal of each cluster and of the whole mesh.
+    std::vector<float3> clusterCentroids(clusterCount, float3(0.f));
+    std::vector<float3> clusterNormals(clusterCount, float3(0.f));
+    float3 meshCentroid(0.f);
+    float meshArea = 0.f;
+    for (uint32_t c = 0; c < clusterCount; ++c)
+    {
+        float clusterArea = 0.f;
+        for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t)
+        {
+            const float3& p0 = positions[indices[t * 3]];
+            const float3& p1 = positions[indices[t * 3 + 1]];
+            const float3& p2 = positions[indices[t * 3 + 2]];
+            const float3 n = cross(p1 - p0, p2 - p0);
+            const float area = length(n);
+            clusterCentroids[c] += (p0 + p1 + p2) * (area / 3.f);
+            clusterNormals[c] += n;
+            clusterArea += area;
+        }
+        meshCentroid += clusterCentroids[c];
+        meshArea += clusterArea;
+        if (clusterArea > 0.f)
+            clusterCentroids[c] /= clusterArea;
+    }
+    if (meshArea <= 0.f)
+        return;
+    meshCentroid /= meshArea;
+
+    // Sort the clusters so that clusters facing away from the mesh center are drawn first.
+    std::vector<float> sortKeys(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; ++c)
+    {
+        const float len = length(clusterNormals[c]);
+        sortKeys[c] = len > 0.f ? dot(clusterCentroids[c] - meshCentroid, clusterNormals[c] / len) : 0.f;
+    }
+    std::vector<uint32_t> clusterOrder(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; ++c)
+        clusterOrder[c] = c;
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    for (uint32_t c : clusterOrder)
+        output.insert(output.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+std::vector<uint32_t> VertexCacheOptimizer::optimizeVertexOrder(std::vector<uint32_t>& indices, uint32_t vertexCount)
+{
+    std::vector<uint32_t> remap(vertexCount, kInvalidIndex);
+    std::vector<uint32_t> order;
+    order.reserve(vertexCount);
+
+    for (uint32_t& index : indices)
+    {
+        FALCOR_ASSERT(index < vertexCount);
+        if (remap[index] == kInvalidIndex)
+        {
+            remap[index] = (uint32_t)order.size();
+            order.push_back(index);
+        }
+        index = remap[index];
+    }
+
+    for (uint32_t v = 0; v < vertexCount; ++v)
+    {
+        if (remap[v] == kInvalidIndex)
+            order.push_back(v);
+    }
+
+    return order;
+}
+} // namespace Falcor
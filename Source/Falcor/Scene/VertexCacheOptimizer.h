@@ -0,0 +1,104 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Reorders indexed triangle meshes for GPU efficiency.
+ *
+ * - optimizeTriangleOrder() reorders triangles for post-transform vertex cache efficiency using Tom Forsyth's
+ *   "Linear-Speed Vertex Cache Optimisation" algorithm.
+ * - optimizeOverdraw() sorts clusters of triangles so that outward facing clusters are drawn first, following
+ *   Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw". Clusters are split at
+ *   hard cache boundaries so the vertex cache efficiency is preserved.
+ * - optimizeVertexOrder() reorders vertices in order of first use for vertex fetch locality.
+ *
+ * The quality is measured by the average cache miss ratio (ACMR, vertex shader invocations per triangle) and
+ * the average transform to vertex ratio (ATVR, vertex shader invocations per vertex) of a simulated FIFO cache.
+ */
+class FALCOR_API VertexCacheOptimizer
+{
+public:
+    static constexpr uint32_t kOptimizeCacheSize = 32; ///< LRU cache size assumed by optimizeTriangleOrder().
+    static constexpr uint32_t kStatsCacheSize = 16;    ///< Default FIFO cache size used by computeStats().
+
+    struct Stats
+    {
+        uint64_t triangleCount = 0;
+        uint64_t vertexCount = 0; ///< Number of vertices referenced by the triangles.
+        uint64_t cacheMisses = 0; ///< Number of simulated vertex shader invocations.
+
+        float getACMR() const { return triangleCount > 0 ? (float)cacheMisses / triangleCount : 0.f; }
+        float getATVR() const { return vertexCount > 0 ? (float)cacheMisses / vertexCount : 0.f; }
+
+        Stats& operator+=(const Stats& other)
+        {
+            triangleCount += other.triangleCount;
+            vertexCount += other.vertexCount;
+            cacheMisses += other.cacheMisses;
+            return *this;
+        }
+    };
+
+    /**
+     * Simulate a FIFO post-transform vertex cache.
+     * @param[in] indices Triangle list indices.
+     * @param[in] vertexCount Number of vertices.
+     * @param[in] cacheSize Cache size in vertices.
+     * @return Cache statistics.
+     */
+    static Stats computeStats(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kStatsCacheSize);
+
+    /**
+     * Reorder triangles for post-transform vertex cache efficiency.
+     * @param[in,out] indices Triangle list indices.
+     * @param[in] vertexCount Number of vertices.
+     */
+    static void optimizeTriangleOrder(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+    /**
+     * Reorder clusters of triangles to reduce overdraw. Should be called after optimizeTriangleOrder().
+     * @param[in,out] indices Triangle list indices.
+     * @param[in] positions Vertex positions.
+     */
+    static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<float3>& positions);
+
+    /**
+     * Reorder vertices in order of first use. Unreferenced vertices are moved to the end.
+     * @param[in,out] indices Triangle list indices. Updated to reference the new vertex order.
+     * @param[in] vertexCount Number of vertices.
+     * @return List of old vertex indices in the new order, i.e. new vertex i is old vertex result[i].
+     */
+    static std::vector<uint32_t> optimizeVertexOrder(std::vector<uint32_t>& indices, uint32_t vertexCount);
+};
+} // namespace Falcor
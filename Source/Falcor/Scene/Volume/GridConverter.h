@@ -32,7 +32,7 @@
 #include "Core/API/Formats.h"
 #include "Utils/Logger.h"
 #include "Utils/HostDeviceShared.slangh"
-#include "Utils/NumericRange.h"
+#include "Utils/JobSystem.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Timing/CpuTimer.h"
 
@@ -47,7 +47,6 @@
 
 #include <algorithm>
 #include <atomic>
-#include <execution>
 #include <vector>
 
 namespace Falcor
@@ -287,8 +286,7 @@ namespace Falcor
     BrickedGrid NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::convert(ref<Device> pDevice)
     {
         auto t0 = CpuTimer::getCurrentTimePoint();
-        auto range = NumericRange<int>(0, mLeafDim[0].z);
-        std::for_each(std::execution::par, range.begin(), range.end(), [&](int z) { convertSlice(z); });
+        JobSystem::getGlobal().parallelFor(0, mLeafDim[0].z, [&](size_t z) { convertSlice((int)z); });
         for (int mip = 1; mip < 4; ++mip) computeMip(mip);
 
         BrickedGrid bricks;
@@ -0,0 +1,593 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Benchmark.h"
+#include "Core/Version.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Scripting/Scripting.h"
+#include "Utils/Threading.h"
+#include "Utils/StringUtils.h"
+#include "Utils/Logger.h"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <regex>
+
+namespace Falcor
+{
+namespace unittest
+{
+
+struct BenchmarkDesc
+{
+    std::filesystem::path path;
+    std::string name;
+    BenchmarkOptions options;
+    BenchmarkFunc func;
+};
+
+static std::vector<BenchmarkDesc>& getBenchmarkRegistry()
+{
+    static std::vector<BenchmarkDesc> registry;
+    return registry;
+}
+
+namespace
+{
+/// Prints a report line to the console and the log.
+template<typename... Args>
+void reportLine(fmt::format_string<Args...> format, Args&&... args)
+{
+    std::string report = fmt::format(format, std::forward<Args>(args)...);
+    std::cout << report << std::endl;
+    logInfo(report);
+}
+
+/// Format a time in nanoseconds with a suitable unit.
+std::string formatTime(double ns)
+{
+    if (ns < 1e3)
+        return fmt::format("{:.1f} ns", ns);
+    if (ns < 1e6)
+        return fmt::format("{:.2f} us", ns * 1e-3);
+    if (ns < 1e9)
+        return fmt::format("{:.2f} ms", ns * 1e-6);
+    return fmt::format("{:.2f} s", ns * 1e-9);
+}
+
+/// Linearly interpolated percentile of sorted values.
+double percentile(const std::vector<double>& sorted, double p)
+{
+    const double rank = p * (sorted.size() - 1);
+    const size_t lo = (size_t)std::floor(rank);
+    const size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - lo);
+}
+
+std::string getKey(const std::string& suiteName, const std::string& name)
+{
+    return suiteName + ":" + name;
+}
+} // namespace
+
+BenchmarkStats computeBenchmarkStats(std::vector<double> samples)
+{
+    BenchmarkStats stats;
+    if (samples.empty())
+        return stats;
+
+    std::sort(samples.begin(), samples.end());
+    stats.sampleCount = samples.size();
+    stats.min = samples.front();
+    stats.max = samples.back();
+    double sum = 0.0;
+    for (double sample : samples)
+        sum += sample;
+    stats.mean = sum / samples.size();
+    stats.median = percentile(samples, 0.5);
+    stats.p10 = percentile(samples, 0.1);
+    stats.p90 = percentile(samples, 0.9);
+    stats.p99 = percentile(samples, 0.99);
+
+    std::vector<double> deviations(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i)
+        deviations[i] = std::abs(samples[i] - stats.median);
+    std::sort(deviations.begin(), deviations.end());
+    stats.mad = percentile(deviations, 0.5);
+
+    return stats;
+}
+
+void registerBenchmark(std::filesystem::path path, std::string name, BenchmarkOptions options, BenchmarkFunc func)
+{
+    BenchmarkDesc desc;
+    desc.path = std::move(path);
+    desc.name = std::move(name);
+    desc.options = std::move(options);
+    desc.func = std::move(func);
+    getBenchmarkRegistry().push_back(desc);
+}
+
+std::vector<Benchmark> enumerateBenchmarks()
+{
+    std::vector<Benchmark> benchmarks;
+
+    for (auto& desc : getBenchmarkRegistry())
+    {
+        // Enumerate the cartesian product of all parameter values.
+        const auto& params = desc.options.params;
+        std::vector<size_t> indices(params.size(), 0);
+        bool done = std::any_of(params.begin(), params.end(), [](const BenchmarkParam& param) { return param.values.empty(); });
+        while (!done)
+        {
+            Benchmark benchmark;
+            benchmark.suiteName = desc.path.filename().string();
+            benchmark.name = desc.name;
+            benchmark.tags = desc.options.tags;
+            benchmark.skipMessage = desc.options.skipMessage;
+            benchmark.func = desc.func;
+            for (size_t i = 0; i < params.size(); ++i)
+            {
+                int64_t value = params[i].values[indices[i]];
+                benchmark.params[params[i].name] = value;
+                benchmark.name += fmt::format("/{}={}", params[i].name, value);
+            }
+            benchmarks.push_back(benchmark);
+
+            // Advance to the next combination, the last parameter varies fastest.
+            done = true;
+            for (size_t i = params.size(); i-- > 0;)
+            {
+                if (++indices[i] < params[i].values.size())
+                {
+                    done = false;
+                    break;
+                }
+                indices[i] = 0;
+            }
+        }
+    }
+
+    // Sort by suite name first, followed by benchmark name. Parameter combinations keep their declaration order.
+    std::stable_sort(
+        benchmarks.begin(),
+        benchmarks.end(),
+        [](const Benchmark& a, const Benchmark& b)
+        {
+            if (a.suiteName == b.suiteName)
+                return a.name.substr(0, a.name.find('/')) < b.name.substr(0, b.name.find('/'));
+            return a.suiteName < b.suiteName;
+        }
+    );
+
+    return benchmarks;
+}
+
+std::vector<Benchmark> filterBenchmarks(std::vector<Benchmark> benchmarks, std::string suiteFilter, std::string nameFilter, std::string tagFilter)
+{
+    std::vector<Benchmark> filtered;
+
+    std::regex suiteFilterRegex(suiteFilter, std::regex::icase | std::regex::basic);
+    std::regex nameFilterRegex(nameFilter, std::regex::icase | std::regex::basic);
+
+    std::set<std::string> includeTags;
+    std::set<std::string> excludeTags;
+    for (const auto& token : splitString(tagFilter, ","))
+    {
+        if (token.empty())
+            continue;
+        if (token[0] == '-' || token[0] == '!' || token[0] == '~')
+            excludeTags.insert(token.substr(1));
+        else if (token[0] == '+')
+            includeTags.insert(token.substr(1));
+        else
+            includeTags.insert(token);
+    }
+
+    for (auto&& benchmark : benchmarks)
+    {
+        if (!suiteFilter.empty() && !std::regex_search(benchmark.suiteName, suiteFilterRegex))
+            continue;
+        if (!nameFilter.empty() && !std::regex_search(benchmark.name, nameFilterRegex))
+            continue;
+        bool include = includeTags.empty();
+        bool exclude = false;
+        for (const auto& tag : benchmark.tags)
+        {
+            include |= includeTags.count(tag) == 1;
+            exclude |= excludeTags.count(tag) == 1;
+        }
+        if (!include || exclude)
+            continue;
+        filtered.push_back(benchmark);
+    }
+
+    return filtered;
+}
+
+std::vector<BenchmarkComparison> compareBenchmarkResults(
+    const std::vector<BenchmarkResult>& results,
+    const std::vector<BenchmarkResult>& baseline,
+    double threshold
+)
+{
+    std::map<std::string, const BenchmarkResult*> baselineByKey;
+    for (const auto& result : baseline)
+        baselineByKey[getKey(result.suiteName, result.name)] = &result;
+
+    std::vector<BenchmarkComparison> comparisons;
+    for (const auto& result : results)
+    {
+        if (result.skipped || !result.messages.empty())
+            continue;
+
+        BenchmarkComparison comparison;
+        comparison.suiteName = result.suiteName;
+        comparison.name = result.name;
+        comparison.median = result.stats.median;
+
+        auto it = baselineByKey.find(getKey(result.suiteName, result.name));
+        if (it != baselineByKey.end() && it->second->stats.median > 0.0)
+        {
+            const BenchmarkStats& base = it->second->stats;
+            const double delta = result.stats.median - base.median;
+            const double noise = result.stats.mad + base.mad;
+            comparison.baselineMedian = base.median;
+            comparison.change = delta / base.median;
+            if (std::abs(comparison.change) > threshold && std::abs(delta) > noise)
+                comparison.status = delta > 0.0 ? BenchmarkComparison::Status::Regressed : BenchmarkComparison::Status::Improved;
+            else
+                comparison.status = BenchmarkComparison::Status::Unchanged;
+        }
+
+        comparisons.push_back(comparison);
+    }
+
+    return comparisons;
+}
+
+void writeBenchmarkResults(const std::filesystem::path& path, const std::vector<BenchmarkResult>& results)
+{
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for (const auto& result : results)
+    {
+        if (result.skipped || !result.messages.empty())
+            continue;
+        const BenchmarkStats& stats = result.stats;
+        benchmarks.push_back({
+            {"suite", result.suiteName},
+            {"name", result.name},
+            {"params", result.params},
+            {"iterations", result.iterations},
+            {"items_per_iteration", result.itemsPerIteration},
+            {"samples", stats.sampleCount},
+            {"min_ns", stats.min},
+            {"max_ns", stats.max},
+            {"mean_ns", stats.mean},
+            {"median_ns", stats.median},
+            {"mad_ns", stats.mad},
+            {"p10_ns", stats.p10},
+            {"p90_ns", stats.p90},
+            {"p99_ns", stats.p99},
+        });
+    }
+
+    nlohmann::json json = {
+        {"version", getLongVersionString()},
+        {"benchmarks", benchmarks},
+    };
+
+    std::ofstream ofs(path);
+    if (!ofs)
+        FALCOR_THROW("Failed to open '{}' for writing.", path);
+    ofs << json.dump(4) << std::endl;
+}
+
+std::vector<BenchmarkResult> readBenchmarkResults(const std::filesystem::path& path)
+{
+    std::ifstream ifs(path);
+    if (!ifs)
+        FALCOR_THROW("Failed to open '{}' for reading.", path);
+
+    std::vector<BenchmarkResult> results;
+    try
+    {
+        nlohmann::json json = nlohmann::json::parse(ifs);
+        for (const auto& item : json.at("benchmarks"))
+        {
+            BenchmarkResult result;
+            result.suiteName = item.at("suite").get<std::string>();
+            result.name = item.at("name").get<std::string>();
+            result.params = item.value("params", std::map<std::string, int64_t>{});
+            result.iterations = item.value("iterations", uint64_t(0));
+            result.itemsPerIteration = item.value("items_per_iteration", uint64_t(0));
+            result.stats.sampleCount = item.value("samples", size_t(0));
+            result.stats.min = item.value("min_ns", 0.0);
+            result.stats.max = item.value("max_ns", 0.0);
+            result.stats.mean = item.value("mean_ns", 0.0);
+            result.stats.median = item.at("median_ns").get<double>();
+            result.stats.mad = item.value("mad_ns", 0.0);
+            result.stats.p10 = item.value("p10_ns", 0.0);
+            result.stats.p90 = item.value("p90_ns", 0.0);
+            result.stats.p99 = item.value("p99_ns", 0.0);
+            results.push_back(result);
+        }
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        FALCOR_THROW("Failed to parse benchmark results '{}': {}", path, e.what());
+    }
+
+    return results;
+}
+
+int64_t BenchmarkContext::getParam(std::string_view name) const
+{
+    auto it = mParams.find(std::string(name));
+    if (it == mParams.end())
+        throw ErrorRunningTestException(fmt::format("Benchmark parameter '{}' does not exist.", name));
+    return it->second;
+}
+
+void BenchmarkContext::measure(const std::function<void(uint64_t)>& runIterations)
+{
+    if (mResult.iterations != 0)
+        throw ErrorRunningTestException("BenchmarkContext::run() can only be called once per benchmark.");
+
+    auto runTimed = [&](uint64_t iterations)
+    {
+        auto startTime = Clock::now();
+        runIterations(iterations);
+        return std::chrono::duration<double>(Clock::now() - startTime).count();
+    };
+
+    // Warm up and find the iteration count for which a sample takes at least the minimum sample time.
+    // The iteration count is grown geometrically, using the measured time to skip ahead once it is meaningful.
+    uint64_t iterations = 1;
+    double warmupTime = 0.0;
+    while (true)
+    {
+        double time = runTimed(iterations);
+        warmupTime += time;
+        if (time >= mOptions.minSampleTime)
+        {
+            if (warmupTime >= mOptions.warmupTime)
+                break;
+            continue;
+        }
+        uint64_t next = iterations * 10;
+        if (time > mOptions.minSampleTime * 0.01)
+            next = (uint64_t)std::ceil(iterations * mOptions.minSampleTime * 1.2 / time);
+        iterations = std::max(iterations + 1, std::min(next, iterations * 100));
+    }
+
+    // Take samples.
+    std::vector<double> samples;
+    samples.reserve(mOptions.sampleCount);
+    double totalTime = 0.0;
+    for (uint32_t i = 0; i < std::max(mOptions.sampleCount, 1u); ++i)
+    {
+        double time = runTimed(iterations);
+        samples.push_back(time * 1e9 / iterations);
+        totalTime += time;
+        if (totalTime >= mOptions.maxTime)
+            break;
+    }
+
+    mResult.iterations = iterations;
+    mResult.stats = computeBenchmarkStats(std::move(samples));
+}
+
+inline BenchmarkResult runBenchmark(const Benchmark& benchmark, const BenchmarkRunOptions& options)
+{
+    BenchmarkResult result;
+
+    if (!benchmark.skipMessage.empty())
+    {
+        result.skipped = true;
+        result.messages.push_back(benchmark.skipMessage);
+    }
+    else
+    {
+        BenchmarkContext ctx(options, benchmark.params);
+        try
+        {
+            benchmark.func(ctx);
+            result = ctx.getResult();
+            result.messages = ctx.getFailureMessages();
+            if (result.iterations == 0 && result.messages.empty())
+                result.messages.push_back("Benchmark did not call BenchmarkContext::run().");
+        }
+        catch (const SkippingTestException& e)
+        {
+            result.skipped = true;
+            result.messages.push_back(e.what());
+        }
+        catch (const TooManyFailedTestsException&)
+        {
+            result.messages.push_back("Gave up after " + std::to_string(kMaxTestFailures) + " failures.");
+        }
+        catch (const std::exception& e)
+        {
+            result.messages = ctx.getFailureMessages();
+            result.messages.push_back(e.what());
+        }
+    }
+
+    result.suiteName = benchmark.suiteName;
+    result.name = benchmark.name;
+    result.params = benchmark.params;
+    return result;
+}
+
+int32_t runBenchmarks(const BenchmarkRunOptions& options)
+{
+    // Disable logging to console, we don't want to clutter the benchmark output with log messages.
+    Logger::setOutputs(Logger::OutputFlags::File | Logger::OutputFlags::DebugWindow);
+
+    logInfo("Falcor {}", getLongVersionString());
+
+    // Load the baseline first to fail early if it is missing.
+    std::vector<BenchmarkResult> baseline;
+    if (!options.baselinePath.empty())
+        baseline = readBenchmarkResults(options.baselinePath);
+
+    OSServices::start();
+    Threading::start();
+    Scripting::start();
+
+    std::vector<Benchmark> benchmarks = enumerateBenchmarks();
+    benchmarks = filterBenchmarks(benchmarks, options.suiteFilter, options.nameFilter, options.tagFilter);
+
+    // Abort on Ctrl-C.
+    std::atomic<bool> abort{false};
+    setKeyboardInterruptHandler(
+        [&abort]()
+        {
+            reportLine("\nDetected Ctrl-C, aborting ...\n");
+            abort = true;
+        }
+    );
+
+    reportLine("[==========] Running {} benchmark{}.", benchmarks.size(), benchmarks.size() == 1 ? "" : "s");
+
+    std::vector<BenchmarkResult> results;
+    int32_t failureCount = 0;
+    for (const auto& benchmark : benchmarks)
+    {
+        if (abort)
+            break;
+
+        reportLine("[ RUN      ] {}:{}", benchmark.suiteName, benchmark.name);
+        BenchmarkResult result = runBenchmark(benchmark, options);
+
+        if (result.skipped)
+        {
+            reportLine("[  SKIPPED ] {}:{}", benchmark.suiteName, benchmark.name);
+        }
+        else if (!result.messages.empty())
+        {
+            for (const auto& message : result.messages)
+                reportLine("{}", message);
+            reportLine("[  FAILED  ] {}:{}", benchmark.suiteName, benchmark.name);
+            ++failureCount;
+        }
+        else
+        {
+            const BenchmarkStats& stats = result.stats;
+            std::string throughput;
+            if (result.itemsPerIteration > 0 && stats.median > 0.0)
+                throughput = fmt::format(", {:.3g} items/s", result.itemsPerIteration * 1e9 / stats.median);
+            reportLine(
+                "[       OK ] {}:{} median {} (MAD {:.1f}%, p10 {}, p90 {}), {} x {} iterations{}",
+                benchmark.suiteName,
+                benchmark.name,
+                formatTime(stats.median),
+                stats.median > 0.0 ? 100.0 * stats.mad / stats.median : 0.0,
+                formatTime(stats.p10),
+                formatTime(stats.p90),
+                stats.sampleCount,
+                result.iterations,
+                throughput
+            );
+        }
+
+        results.push_back(std::move(result));
+    }
+
+    if (abort)
+    {
+        reportLine("[ ABORTED  ]");
+        Scripting::shutdown();
+        Threading::shutdown();
+        OSServices::stop();
+        return 1;
+    }
+
+    if (!options.jsonReportPath.empty())
+        writeBenchmarkResults(options.jsonReportPath, results);
+
+    int32_t regressionCount = 0;
+    if (!options.baselinePath.empty())
+    {
+        reportLine("[----------] Comparing against baseline '{}' (threshold {:.1f}%)", options.baselinePath, options.regressionThreshold * 100.0);
+        for (const auto& comparison : compareBenchmarkResults(results, baseline, options.regressionThreshold))
+        {
+            switch (comparison.status)
+            {
+            case BenchmarkComparison::Status::Regressed:
+                ++regressionCount;
+                reportLine(
+                    "[ REGRESSED] {}:{} {} -> {} ({:+.1f}%)",
+                    comparison.suiteName,
+                    comparison.name,
+                    formatTime(comparison.baselineMedian),
+                    formatTime(comparison.median),
+                    comparison.change * 100.0
+                );
+                break;
+            case BenchmarkComparison::Status::Improved:
+                reportLine(
+                    "[ IMPROVED ] {}:{} {} -> {} ({:+.1f}%)",
+                    comparison.suiteName,
+                    comparison.name,
+                    formatTime(comparison.baselineMedian),
+                    formatTime(comparison.median),
+                    comparison.change * 100.0
+                );
+                break;
+            case BenchmarkComparison::Status::Missing:
+                reportLine("[ NEW      ] {}:{} (not in baseline)", comparison.suiteName, comparison.name);
+                break;
+            case BenchmarkComparison::Status::Unchanged:
+                break;
+            }
+        }
+    }
+
+    reportLine("[==========] {} benchmark{} ran.", results.size(), results.size() == 1 ? "" : "s");
+    if (failureCount > 0)
+        reportLine("[  FAILED  ] {} benchmark{}.", failureCount, failureCount == 1 ? "" : "s");
+    if (regressionCount > 0)
+        reportLine("[ REGRESSED] {} benchmark{}.", regressionCount, regressionCount == 1 ? "" : "s");
+
+    Scripting::shutdown();
+    Threading::shutdown();
+    OSServices::stop();
+
+    return failureCount + regressionCount;
+}
+
+} // namespace unittest
+
+} // namespace Falcor
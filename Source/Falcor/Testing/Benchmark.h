@@ -0,0 +1,341 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "UnitTest.h"
+#include "Core/Macros.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if FALCOR_MSVC
+#include <intrin.h>
+#endif
+
+/**
+ * This file defines the micro-benchmark framework built on top of the unit testing framework.
+ *
+ * Benchmarks are registered with CPU_BENCHMARK and run by FalcorTest when the --benchmark flag is given.
+ * Each benchmark is warmed up, its iteration count is scaled so that a sample takes a minimum amount of time,
+ * and robust statistics (median, MAD, percentiles) are computed over the samples. Results can be written
+ * to a JSON file and compared against a stored baseline to detect performance regressions.
+ */
+
+namespace Falcor
+{
+namespace unittest
+{
+
+/// Benchmark parameter with the list of values to sweep over.
+struct BenchmarkParam
+{
+    BenchmarkParam(std::string name_, std::initializer_list<int64_t> values_) : name(std::move(name_)), values(values_) {}
+
+    std::string name;
+    std::vector<int64_t> values;
+};
+
+struct BenchmarkOptions
+{
+    std::set<std::string> tags;
+    std::string skipMessage;
+    std::vector<BenchmarkParam> params;
+};
+
+inline void applyArg(BenchmarkOptions& options, Tags&& arg)
+{
+    options.tags.insert(arg.tags.begin(), arg.tags.end());
+}
+
+inline void applyArg(BenchmarkOptions& options, Skip&& arg)
+{
+    options.skipMessage = std::move(arg.msg);
+}
+
+inline void applyArg(BenchmarkOptions& options, BenchmarkParam&& arg)
+{
+    options.params.push_back(std::move(arg));
+}
+
+template<size_t N>
+inline void applyArg(BenchmarkOptions& options, const char (&skipMsg)[N])
+{
+    options.skipMessage = std::string(skipMsg, N - 1);
+}
+
+template<typename... Args>
+void applyArgs(BenchmarkOptions& options, Args&&... args)
+{
+    (applyArg(options, std::forward<Args>(args)), ...);
+}
+
+/// Statistics over the benchmark samples. All times are in nanoseconds per iteration.
+struct BenchmarkStats
+{
+    size_t sampleCount = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double median = 0.0;
+    double mad = 0.0; ///< Median absolute deviation from the median.
+    double p10 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+};
+
+/**
+ * Compute statistics over a list of samples.
+ * Percentiles are computed by linear interpolation between the closest ranks.
+ * @param[in] samples Sample values (time per iteration in nanoseconds).
+ * @return The statistics, or all zeros if there are no samples.
+ */
+FALCOR_API BenchmarkStats computeBenchmarkStats(std::vector<double> samples);
+
+class BenchmarkContext;
+
+using BenchmarkFunc = std::function<void(BenchmarkContext& ctx)>;
+
+FALCOR_API void registerBenchmark(std::filesystem::path path, std::string name, BenchmarkOptions options, BenchmarkFunc func);
+
+struct Benchmark
+{
+    std::string suiteName;
+    std::string name; ///< Benchmark name including parameter values, e.g. "SplitBuffer_Insert/count=1000".
+    std::set<std::string> tags;
+    std::string skipMessage;
+    std::map<std::string, int64_t> params;
+
+    BenchmarkFunc func;
+};
+
+/// Enumerate all benchmarks, with one entry per combination of parameter values.
+FALCOR_API std::vector<Benchmark> enumerateBenchmarks();
+
+/// Filter benchmarks by suite and benchmark name and tags (same syntax as filterTests()).
+FALCOR_API std::vector<Benchmark> filterBenchmarks(
+    std::vector<Benchmark> benchmarks,
+    std::string suiteFilter,
+    std::string nameFilter,
+    std::string tagFilter
+);
+
+struct BenchmarkRunOptions
+{
+    std::string suiteFilter;
+    std::string nameFilter;
+    std::string tagFilter;
+    std::filesystem::path jsonReportPath; ///< Write results to this JSON file if not empty.
+    std::filesystem::path baselinePath;   ///< Compare results against this JSON file if not empty.
+    double regressionThreshold = 0.1;     ///< Relative slowdown of the median reported as a regression.
+    double warmupTime = 0.1;              ///< Minimum warmup time in seconds.
+    double minSampleTime = 0.01;          ///< Minimum time per sample in seconds (determines the iteration count).
+    uint32_t sampleCount = 30;            ///< Number of samples to take.
+    double maxTime = 10.0;                ///< Stop taking samples after this many seconds (at least one sample is taken).
+};
+
+struct BenchmarkResult
+{
+    std::string suiteName;
+    std::string name;
+    std::map<std::string, int64_t> params;
+    uint64_t iterations = 0;         ///< Iterations per sample.
+    uint64_t itemsPerIteration = 0;  ///< Items processed per iteration (0 if not set).
+    BenchmarkStats stats;
+    bool skipped = false;
+    std::vector<std::string> messages;
+};
+
+struct BenchmarkComparison
+{
+    enum class Status
+    {
+        Unchanged,
+        Improved,
+        Regressed,
+        Missing, ///< Benchmark does not exist in the baseline.
+    };
+
+    std::string suiteName;
+    std::string name;
+    Status status = Status::Missing;
+    double baselineMedian = 0.0;
+    double median = 0.0;
+    double change = 0.0; ///< Relative change of the median (positive if slower).
+};
+
+/**
+ * Compare benchmark results against a baseline. Skipped and failed benchmarks are ignored.
+ * A benchmark is reported as regressed (or improved) if its median changed by more than the threshold and the
+ * change exceeds the combined median absolute deviation of both runs, to avoid reporting noisy benchmarks.
+ * @param[in] results Benchmark results.
+ * @param[in] baseline Baseline results.
+ * @param[in] threshold Relative change of the median to report.
+ * @return The comparison for each of the results.
+ */
+FALCOR_API std::vector<BenchmarkComparison> compareBenchmarkResults(
+    const std::vector<BenchmarkResult>& results,
+    const std::vector<BenchmarkResult>& baseline,
+    double threshold
+);
+
+/// Write benchmark results to a JSON file.
+FALCOR_API void writeBenchmarkResults(const std::filesystem::path& path, const std::vector<BenchmarkResult>& results);
+
+/// Read benchmark results from a JSON file written by writeBenchmarkResults().
+FALCOR_API std::vector<BenchmarkResult> readBenchmarkResults(const std::filesystem::path& path);
+
+/**
+ * Run all benchmarks matching the filters.
+ * @return Number of failed or regressed benchmarks.
+ */
+FALCOR_API int32_t runBenchmarks(const BenchmarkRunOptions& options);
+
+class FALCOR_API BenchmarkContext : public UnitTestContext
+{
+public:
+    BenchmarkContext(const BenchmarkRunOptions& options, const std::map<std::string, int64_t>& params)
+        : mOptions(options), mParams(params)
+    {}
+
+    /**
+     * Get the value of a benchmark parameter for the current run.
+     * Throws if the benchmark does not declare the parameter.
+     */
+    int64_t getParam(std::string_view name) const;
+
+    /**
+     * Set the number of items processed per iteration. Used to report throughput.
+     */
+    void setItemsPerIteration(uint64_t count) { mResult.itemsPerIteration = count; }
+
+    /**
+     * Measure the given function. Setup code placed before the call to run() is not measured.
+     * The function is called repeatedly; use doNotOptimize() on its results to keep the compiler from eliminating it.
+     * run() can only be called once per benchmark.
+     */
+    template<typename Func>
+    void run(Func&& func)
+    {
+        measure(
+            [&func](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    func();
+            }
+        );
+    }
+
+    const BenchmarkResult& getResult() const { return mResult; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void measure(const std::function<void(uint64_t)>& runIterations);
+
+    const BenchmarkRunOptions& mOptions;
+    std::map<std::string, int64_t> mParams;
+    BenchmarkResult mResult;
+};
+
+} // namespace unittest
+
+using BenchmarkContext = unittest::BenchmarkContext;
+
+/**
+ * Prevent the compiler from optimizing away the computation of a value in a benchmark.
+ */
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if FALCOR_MSVC
+    // MSVC does not support inline assembly on x64, read the value through a volatile pointer instead.
+    const volatile char* p = reinterpret_cast<const volatile char*>(&value);
+    (void)*p;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/**
+ * Macro to define a CPU benchmark. The optional arguments include:
+ *
+ * - SKIP(msg): Skip the benchmark with the given message.
+ * - TAGS(...): A list of tags to associate with the benchmark.
+ * - BENCHMARK_PARAM(name, values...): A parameter to sweep over. The benchmark is run once per combination of values.
+ *
+ * The benchmark body is called once per parameter combination. It performs setup and then calls ctx.run()
+ * with the code to measure:
+ *
+ * CPU_BENCHMARK(Vector_PushBack, BENCHMARK_PARAM("count", 100, 10000))
+ * {
+ *     const int64_t count = ctx.getParam("count");
+ *     ctx.setItemsPerIteration(count);
+ *     ctx.run(
+ *         [&]()
+ *         {
+ *             std::vector<int> v;
+ *             for (int64_t i = 0; i < count; ++i)
+ *                 v.push_back((int)i);
+ *             doNotOptimize(v.data());
+ *         }
+ *     );
+ * }
+ *
+ * The EXPECT/ASSERT macros can be used in benchmarks to validate the results. All benchmarks are tagged with "benchmark".
+ */
+#define CPU_BENCHMARK(name, ...)                                                   \
+    static void Benchmark##name(BenchmarkContext& ctx);                            \
+    struct BenchmarkRegisterer##name                                               \
+    {                                                                              \
+        BenchmarkRegisterer##name()                                                \
+        {                                                                          \
+            std::filesystem::path path = __FILE__;                                 \
+            unittest::BenchmarkOptions options;                                    \
+            applyArgs(options, ##__VA_ARGS__);                                     \
+            options.tags.insert("benchmark");                                      \
+            unittest::registerBenchmark(path, #name, options, Benchmark##name);    \
+        }                                                                          \
+    } RegisterBenchmark##name;                                                     \
+    static void Benchmark##name(BenchmarkContext& ctx) /* over to the user for the braces */
+
+// clang-format off
+
+/// Used as an argument of CPU_BENCHMARK to sweep over a list of parameter values.
+#define BENCHMARK_PARAM(name, ...) ::Falcor::unittest::BenchmarkParam{name, {__VA_ARGS__}}
+
+// clang-format on
+
+} // namespace Falcor
@@ -27,10 +27,26 @@
  **************************************************************************/
 #include "BufferAllocator.h"
 #include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
 #include "Utils/Math/Common.h"
 
 namespace Falcor
 {
+namespace
+{
+/// Maximum number of free blocks inspected per size class when searching for a block to reuse.
+const size_t kMaxFreeListScan = 16;
+
+size_t getSizeClass(size_t byteSize)
+{
+    FALCOR_ASSERT(byteSize > 0);
+    size_t sizeClass = 0;
+    while (byteSize >>= 1)
+        sizeClass++;
+    return sizeClass;
+}
+} // namespace
+
 BufferAllocator::BufferAllocator(size_t alignment, size_t elementSize, size_t cacheLineSize, ResourceBindFlags bindFlags)
     : mAlignment(alignment), mElementSize(elementSize), mCacheLineSize(cacheLineSize), mBindFlags(bindFlags)
 {
@@ -52,10 +68,63 @@ BufferAllocator::BufferAllocator(size_t alignment, size_t elementSize, size_t ca
 
 size_t BufferAllocator::allocate(size_t byteSize)
 {
+    size_t byteOffset = 0;
+    if (byteSize > 0 && allocFromFreeList(byteSize, byteOffset))
+        return byteOffset;
+
     computeAndAllocatePadding(byteSize);
     return allocInternal(byteSize);
 }
 
+void BufferAllocator::free(size_t byteOffset, size_t byteSize)
+{
+    FALCOR_CHECK(byteSize > 0, "Memory region is empty.");
+    FALCOR_CHECK(byteOffset + byteSize <= mBuffer.size(), "Memory region is out of range.");
+
+    size_t start = byteOffset;
+    size_t end = byteOffset + byteSize;
+
+    // Coalesce with the adjacent free blocks. Overlapping blocks indicate a double free.
+    auto next = mFreeBlocks.lower_bound(start);
+    if (next != mFreeBlocks.begin())
+    {
+        auto prev = std::prev(next);
+        FALCOR_CHECK(prev->first + prev->second <= start, "Memory region is already free.");
+        if (prev->first + prev->second == start)
+        {
+            start = prev->first;
+            removeFreeBlock(prev->first, prev->second);
+        }
+    }
+    if (next != mFreeBlocks.end())
+    {
+        FALCOR_CHECK(end <= next->first, "Memory region is already free.");
+        if (end == next->first)
+        {
+            end = next->first + next->second;
+            removeFreeBlock(next->first, next->second);
+        }
+    }
+
+    if (end == mBuffer.size())
+    {
+        // Release free memory at the end of the buffer.
+        mBuffer.resize(start);
+        while (!mDirtyRanges.empty() && mDirtyRanges.rbegin()->second > start)
+        {
+            auto last = std::prev(mDirtyRanges.end());
+            size_t dirtyStart = last->first;
+            mDirtyRanges.erase(last);
+            if (dirtyStart < start)
+                mDirtyRanges.emplace(dirtyStart, start);
+        }
+    }
+    else
+    {
+        insertFreeBlock(start, end - start);
+    }
+}
+
 void BufferAllocator::setBlob(const void* pData, size_t byteOffset, size_t byteSize)
 {
     FALCOR_CHECK(pData != nullptr, "Invalid pointer.");
@@ -70,10 +139,22 @@ void BufferAllocator::modified(size_t byteOffset, size_t byteSize)
     markAsDirty(byteOffset, byteSize);
 }
 
+size_t BufferAllocator::getDirtyByteSize() const
+{
+    size_t byteSize = 0;
+    for (const auto& [start, end] : mDirtyRanges)
+        byteSize += end - start;
+    return byteSize;
+}
+
 void BufferAllocator::clear()
 {
     mBuffer.clear();
-    mDirty = {};
+    mDirtyRanges.clear();
+    mFreeBlocks.clear();
+    for (auto& freeList : mFreeLists)
+        freeList.clear();
+    mFreeByteSize = 0;
 }
 
 ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
@@ -104,19 +185,24 @@ ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
             mpGpuBuffer = pDevice->createBuffer(bufSize, mBindFlags, MemoryType::DeviceLocal, nullptr);
         }
 
-        mDirty = Range(0, mBuffer.size()); // Mark entire buffer as dirty so the data gets uploaded.
+        // Mark entire buffer as dirty so the data gets uploaded.
+        mDirtyRanges.clear();
+        mDirtyRanges.emplace(0, mBuffer.size());
     }
 
     // If any range is dirty, upload the data from the CPU to the GPU.
-    if (mDirty.start < mDirty.end)
+    if (!mDirtyRanges.empty())
     {
-        size_t byteSize = mDirty.end - mDirty.start;
-        size_t byteOffset = mDirty.start;
-        FALCOR_ASSERT(byteOffset + byteSize <= mBuffer.size());
+        FALCOR_ASSERT(mDirtyRanges.rbegin()->second <= mBuffer.size());
         FALCOR_ASSERT(mBuffer.size() <= mpGpuBuffer->getSize());
-        mpGpuBuffer->setBlob(mBuffer.data() + byteOffset, byteOffset, byteSize);
 
-        mDirty = {mBuffer.size(), 0}; // Reset dirty range to inverted range. Any min/max operation on it will work.
+        std::vector<std::pair<size_t, size_t>> regions;
+        regions.reserve(mDirtyRanges.size());
+        for (const auto& [start, end] : mDirtyRanges)
+            regions.emplace_back(start, end - start);
+        pDevice->getRenderContext()->updateBufferRegions(mpGpuBuffer.get(), mBuffer.data(), regions);
+
+        mDirtyRanges.clear();
     }
 
     return mpGpuBuffer;
@@ -124,9 +210,9 @@ ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
 
 // Private
 
-void BufferAllocator::computeAndAllocatePadding(size_t byteSize)
+size_t BufferAllocator::computeAlignedOffset(size_t byteOffset, size_t byteSize) const
 {
-    size_t currentOffset = mBuffer.size();
+    size_t currentOffset = byteOffset;
 
     if (mAlignment > 0 && currentOffset % mAlignment > 0)
     {
@@ -145,6 +231,12 @@ void BufferAllocator::computeAndAllocatePadding(size_t byteSize)
         }
     }
 
+    return currentOffset;
+}
+
+void BufferAllocator::computeAndAllocatePadding(size_t byteSize)
+{
+    size_t currentOffset = computeAlignedOffset(mBuffer.size(), byteSize);
     size_t pad = currentOffset - mBuffer.size();
     if (pad > 0)
     {
@@ -157,13 +249,91 @@ size_t BufferAllocator::allocInternal(size_t byteSize)
 {
     size_t byteOffset = mBuffer.size();
     mBuffer.insert(mBuffer.end(), byteSize, {});
+    // Memory appended within the existing GPU buffer is not uploaded by a reallocation. It may hold
+    // the contents of blocks freed at the end of the buffer, so the zeros are uploaded instead.
+    if (mpGpuBuffer && byteOffset < mpGpuBuffer->getSize())
+        markAsDirty(byteOffset, std::min<size_t>(byteSize, mpGpuBuffer->getSize() - byteOffset));
     return byteOffset;
 }
 
-void BufferAllocator::markAsDirty(const Range& range)
+bool BufferAllocator::allocFromFreeList(size_t byteSize, size_t& byteOffset)
+{
+    // Search the size classes from the one the allocation falls into and upwards. Blocks in the first class
+    // may be too small, and alignment padding may make any block too small, so each candidate is checked.
+    for (size_t sizeClass = getSizeClass(byteSize); sizeClass < kSizeClassCount; sizeClass++)
+    {
+        size_t scanCount = 0;
+        for (const auto& block : mFreeLists[sizeClass])
+        {
+            if (++scanCount > kMaxFreeListScan)
+                break;
+
+            // Copy the block since it is removed below.
+            const auto [blockOffset, blockSize] = block;
+
+            const size_t offset = computeAlignedOffset(blockOffset, byteSize);
+            const size_t blockEnd = blockOffset + blockSize;
+            if (offset + byteSize > blockEnd)
+                continue;
+
+            // Split the block. The remaining memory before and after the allocation stays free.
+            removeFreeBlock(blockOffset, blockSize);
+            if (offset > blockOffset)
+                insertFreeBlock(blockOffset, offset - blockOffset);
+            if (offset + byteSize < blockEnd)
+                insertFreeBlock(offset + byteSize, blockEnd - offset - byteSize);
+
+            // Reused memory is cleared like newly allocated memory.
+            std::memset(mBuffer.data() + offset, 0, byteSize);
+            markAsDirty(offset, byteSize);
+
+            byteOffset = offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+void BufferAllocator::insertFreeBlock(size_t byteOffset, size_t byteSize)
+{
+    FALCOR_ASSERT(byteSize > 0);
+    mFreeBlocks.emplace(byteOffset, byteSize);
+    mFreeLists[getSizeClass(byteSize)].emplace(byteOffset, byteSize);
+    mFreeByteSize += byteSize;
+}
+
+void BufferAllocator::removeFreeBlock(size_t byteOffset, size_t byteSize)
+{
+    mFreeBlocks.erase(byteOffset);
+    mFreeLists[getSizeClass(byteSize)].erase({byteOffset, byteSize});
+    mFreeByteSize -= byteSize;
+}
+
+void BufferAllocator::markAsDirty(size_t byteOffset, size_t byteSize)
 {
-    FALCOR_ASSERT(range.start < range.end);
-    mDirty.start = std::min(mDirty.start, range.start);
-    mDirty.end = std::max(mDirty.end, range.end);
+    if (byteSize == 0)
+        return;
+
+    size_t start = byteOffset;
+    size_t end = byteOffset + byteSize;
+
+    // Find the first range that may be merged with the new range, which is either the last
+    // range starting at or before it or the first range starting after it.
+    auto it = mDirtyRanges.upper_bound(start);
+    if (it != mDirtyRanges.begin())
+    {
+        auto prev = std::prev(it);
+        if (prev->second >= start || start - prev->second <= mDirtyMergeGap)
+            it = prev;
+    }
+
+    // Merge all ranges that overlap or are within the merge gap of the new range.
+    while (it != mDirtyRanges.end() && (it->first <= end || it->first - end <= mDirtyMergeGap))
+    {
+        start = std::min(start, it->first);
+        end = std::max(end, it->second);
+        it = mDirtyRanges.erase(it);
+    }
+    mDirtyRanges.emplace_hint(it, start, end);
 }
 } // namespace Falcor
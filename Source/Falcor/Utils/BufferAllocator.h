@@ -30,6 +30,10 @@
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
 
+#include <array>
+#include <map>
+#include <set>
+#include <utility>
 #include <vector>
 
 namespace Falcor
@@ -49,10 +53,23 @@ namespace Falcor
  * It is assumed that the base pointer of the GPU buffer starts at a
  * cache line. The implementation doesn't provide any alignment
  * guarantees for the CPU side buffer (where it doesn't matter anyway).
+ *
+ * Freed memory regions are kept in free lists bucketed by power-of-two size
+ * classes and are reused by later allocations, subject to the same alignment
+ * requirements. Adjacent free regions are coalesced, and free memory at the
+ * end of the buffer is released.
+ *
+ * Modified memory is tracked as a set of disjoint dirty ranges. Ranges that
+ * are closer than the merge gap are coalesced, trading some redundant upload
+ * for fewer copies. Only the dirty ranges are uploaded to the GPU, batched
+ * into a single staging allocation.
  */
 class FALCOR_API BufferAllocator
 {
 public:
+    /// Default maximum distance in bytes between dirty ranges for them to be merged.
+    static constexpr size_t kDefaultDirtyMergeGap = 1024;
+
     /**
      * Create a buffer allocator.
      * @param[in] alignment Minimum alignment in bytes for any allocation.
@@ -85,6 +102,25 @@ public:
         return allocate(count * sizeof(T));
     }
 
+    /**
+     * Frees a memory region so that it can be reused by later allocations.
+     * The region must have been previously allocated and not already freed.
+     * @param[in] byteOffset Offset in bytes to the memory region as returned by the allocation.
+     * @param[in] byteSize Size in bytes of the memory region.
+     */
+    void free(size_t byteOffset, size_t byteSize);
+
+    /**
+     * Frees memory holding an array of the given type.
+     * @param[in] byteOffset Offset in bytes to the memory as returned by the allocation.
+     * @param[in] count Number of array elements.
+     */
+    template<typename T>
+    void free(size_t byteOffset, size_t count = 1)
+    {
+        free(byteOffset, count * sizeof(T));
+    }
+
     /**
      * Allocates an object of given type and copies the data.
      * @param[in] obj The object to copy.
@@ -94,8 +130,7 @@ public:
     size_t pushBack(const T& obj)
     {
         const size_t byteSize = sizeof(T);
-        computeAndAllocatePadding(byteSize);
-        size_t byteOffset = allocInternal(byteSize);
+        size_t byteOffset = allocate(byteSize);
         T* ptr = reinterpret_cast<T*>(mBuffer.data() + byteOffset);
         *ptr = obj;
         markAsDirty(byteOffset, byteSize);
@@ -111,8 +146,7 @@ public:
     size_t emplaceBack(Args&&... args)
     {
         const size_t byteSize = sizeof(T);
-        computeAndAllocatePadding(byteSize);
-        size_t byteOffset = allocInternal(byteSize);
+        size_t byteOffset = allocate(byteSize);
         void* ptr = mBuffer.data() + byteOffset;
         new (ptr) T(std::forward<Args>(args)...);
         markAsDirty(byteOffset, byteSize);
@@ -186,6 +220,36 @@ public:
      */
     size_t getSize() const { return mBuffer.size(); }
 
+    /**
+     * Get the total size of the free memory regions available for reuse.
+     * @return Size in bytes.
+     */
+    size_t getFreeByteSize() const { return mFreeByteSize; }
+
+    /**
+     * Set the maximum distance between dirty ranges for them to be merged into one upload.
+     * @param[in] byteSize Distance in bytes. Zero only merges overlapping and adjacent ranges.
+     */
+    void setDirtyMergeGap(size_t byteSize) { mDirtyMergeGap = byteSize; }
+
+    /**
+     * Get the maximum distance between dirty ranges for them to be merged into one upload.
+     * @return Distance in bytes.
+     */
+    size_t getDirtyMergeGap() const { return mDirtyMergeGap; }
+
+    /**
+     * Get the number of dirty ranges that will be uploaded on the next call to getGPUBuffer().
+     * @return Number of ranges.
+     */
+    size_t getDirtyRangeCount() const { return mDirtyRanges.size(); }
+
+    /**
+     * Get the total size of the dirty ranges that will be uploaded on the next call to getGPUBuffer().
+     * @return Size in bytes.
+     */
+    size_t getDirtyByteSize() const;
+
     /**
      * Clear buffer. This removes all allocations.
      */
@@ -198,19 +262,17 @@ public:
     ref<Buffer> getGPUBuffer(ref<Device> pDevice);
 
 private:
+    /// Number of free list size classes. Size class i holds free blocks of size [2^i, 2^(i+1)).
+    static constexpr size_t kSizeClassCount = 64;
+
+    size_t computeAlignedOffset(size_t byteOffset, size_t byteSize) const;
     void computeAndAllocatePadding(size_t byteSize);
     size_t allocInternal(size_t byteSize);
+    bool allocFromFreeList(size_t byteSize, size_t& byteOffset);
+    void insertFreeBlock(size_t byteOffset, size_t byteSize);
+    void removeFreeBlock(size_t byteOffset, size_t byteSize);
 
-    struct Range
-    {
-        size_t start = 0;
-        size_t end = 0;
-        Range(){};
-        Range(size_t s, size_t e) : start(s), end(e) {}
-    };
-
-    void markAsDirty(const Range& range);
-    void markAsDirty(size_t byteOffset, size_t byteSize) { markAsDirty(Range(byteOffset, byteOffset + byteSize)); }
+    void markAsDirty(size_t byteOffset, size_t byteSize);
 
     /// Minimum alignment for allocations from base address. A value of zero means no aligment is performed.
     const size_t mAlignment;
@@ -224,9 +286,20 @@ private:
     /// Bind flags for the GPU buffer.
     const ResourceBindFlags mBindFlags;
 
-    /// Range of buffer that is dirty and needs to be updatd on the GPU. We track a single dirty range for now to minimize the number of
-    /// uploads, but this could be changed.
-    Range mDirty;
+    /// Disjoint ranges of the buffer that are dirty and need to be updated on the GPU. Maps start offset to end offset.
+    std::map<size_t, size_t> mDirtyRanges;
+
+    /// Maximum distance in bytes between dirty ranges for them to be merged.
+    size_t mDirtyMergeGap = kDefaultDirtyMergeGap;
+
+    /// Free memory blocks available for reuse. Maps offset to size. Adjacent blocks are always coalesced.
+    std::map<size_t, size_t> mFreeBlocks;
+
+    /// Free memory blocks bucketed by size class. Each entry is a pair of offset and size.
+    std::array<std::set<std::pair<size_t, size_t>>, kSizeClassCount> mFreeLists;
+
+    /// Total size in bytes of all free memory blocks.
+    size_t mFreeByteSize = 0;
 
     std::vector<uint8_t> mBuffer; ///< CPU buffer holding a copy of the data.
     ref<Buffer> mpGpuBuffer;      ///< GPU buffer holding the data.
@@ -0,0 +1,305 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AsyncFrameCapture.h"
+#include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
+#include "Core/API/Texture.h"
+#include "Utils/Logger.h"
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+/// Header of raw capture files. The texel data of the first subresource follows with tightly packed rows.
+struct RawImageHeader
+{
+    char magic[4] = {'F', 'R', 'A', 'W'};
+    uint32_t version = 1;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t resourceFormat = 0; ///< ResourceFormat value.
+    uint32_t rowPitch = 0;       ///< Size of a row in bytes.
+};
+} // namespace
+
+AsyncFrameCapture::AsyncFrameCapture(ref<Device> pDevice, const Options& options)
+    : mpDevice(pDevice), mOptions(options), mEncodeMode(options.encodeMode)
+{
+    FALCOR_CHECK(mOptions.readbackCount > 0, "Readback count must be non-zero.");
+
+    size_t threadCount = mOptions.threadCount > 0 ? mOptions.threadCount : std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < threadCount; ++i)
+        mThreads.emplace_back(&AsyncFrameCapture::runWorker, this);
+}
+
+AsyncFrameCapture::~AsyncFrameCapture()
+{
+    flush();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTerminate = true;
+    }
+    mCondition.notify_all();
+
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+void AsyncFrameCapture::capture(
+    RenderContext* pRenderContext,
+    const ref<Texture>& pTexture,
+    uint64_t frameID,
+    const std::filesystem::path& path,
+    Bitmap::FileFormat fileFormat,
+    Bitmap::ExportFlags exportFlags
+)
+{
+    FALCOR_CHECK(pTexture, "Texture must not be nullptr.");
+    FALCOR_CHECK(pTexture->getType() == Texture::Type::Texture2D, "Only 2D textures can be captured.");
+    FALCOR_CHECK(fileFormat != Bitmap::FileFormat::DdsFile, "Capturing to DDS files is not supported.");
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mHasStartTime)
+        {
+            mStartTime = CpuTimer::getCurrentTimePoint();
+            mHasStartTime = true;
+        }
+        if (frameID != mLastFrameID)
+        {
+            mStats.frameCount++;
+            mLastFrameID = frameID;
+        }
+    }
+
+    // Hand off the readbacks that have finished, in submission order.
+    while (!mReadbacks.empty() && mReadbacks.front().pTask->isReady())
+        retireReadback();
+
+    // If all readback buffers are in use, wait for the oldest readback.
+    if (mReadbacks.size() >= mOptions.readbackCount)
+        retireReadback();
+
+    // Handle the special case where we have an HDR texture with less than 3 channels (see Texture::captureToFile()).
+    // The temporary texture is released by the device once the readback has executed.
+    ref<Texture> pSource = pTexture;
+    ResourceFormat resourceFormat = pTexture->getFormat();
+    const uint32_t width = pTexture->getWidth();
+    const uint32_t height = pTexture->getHeight();
+
+    if (getFormatType(resourceFormat) == FormatType::Float && getFormatChannelCount(resourceFormat) < 3)
+    {
+        pSource = mpDevice->createTexture2D(
+            width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::RenderTarget | ResourceBindFlags::ShaderResource
+        );
+        pRenderContext->blit(pTexture->getSRV(0, 1, 0, 1), pSource->getRTV(0, 0, 1));
+        resourceFormat = ResourceFormat::RGBA32Float;
+    }
+
+    // Reuse a readback buffer that is large enough for the texel data with aligned rows, if available.
+    const uint64_t byteSize = CopyContext::ReadTextureTask::getBufferSize(pSource.get(), pSource->getSubresourceIndex(0, 0));
+    ref<Buffer> pReadbackBuffer;
+    for (auto it = mFreeReadbackBuffers.begin(); it != mFreeReadbackBuffers.end(); ++it)
+    {
+        if ((*it)->getSize() >= byteSize)
+        {
+            pReadbackBuffer = std::move(*it);
+            mFreeReadbackBuffers.erase(it);
+            break;
+        }
+    }
+
+    PendingReadback readback;
+    readback.pTask = pRenderContext->asyncReadTextureSubresource(pSource.get(), pSource->getSubresourceIndex(0, 0), std::move(pReadbackBuffer));
+    readback.request = {path, fileFormat, exportFlags, mEncodeMode, resourceFormat, width, height, {}};
+    mReadbacks.push_back(std::move(readback));
+}
+
+void AsyncFrameCapture::flush()
+{
+    while (!mReadbacks.empty())
+        retireReadback();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCondition.wait(lock, [&]() { return mEncodeQueue.empty() && mActiveCount == 0; });
+}
+
+AsyncFrameCapture::Stats AsyncFrameCapture::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+void AsyncFrameCapture::resetStats()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats = {};
+    mHasStartTime = false;
+    mLastFrameID = uint64_t(-1);
+}
+
+void AsyncFrameCapture::retireReadback()
+{
+    FALCOR_ASSERT(!mReadbacks.empty());
+    PendingReadback readback = std::move(mReadbacks.front());
+    mReadbacks.pop_front();
+
+    // Read back the data. This blocks if the readback has not finished on the GPU yet.
+    const bool ready = readback.pTask->isReady();
+    auto startTime = CpuTimer::getCurrentTimePoint();
+    readback.request.data = readback.pTask->getData();
+    if (!ready)
+    {
+        double stallTime = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStats.readbackStallTime += stallTime;
+    }
+
+    if (mFreeReadbackBuffers.size() < mOptions.readbackCount)
+        mFreeReadbackBuffers.push_back(readback.pTask->getBuffer());
+
+    enqueueEncode(std::move(readback.request));
+}
+
+void AsyncFrameCapture::enqueueEncode(EncodeRequest request)
+{
+    const size_t byteSize = request.data.size();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    // Wait for the workers to catch up if the pending data would exceed the limit.
+    // A single request larger than the limit is accepted when nothing else is pending.
+    auto hasSpace = [&]() { return mPendingByteSize == 0 || mPendingByteSize + byteSize <= mOptions.maxPendingByteSize; };
+    if (!hasSpace())
+    {
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        mDoneCondition.wait(lock, hasSpace);
+        mStats.backpressureStallTime += CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+    }
+
+    mPendingByteSize += byteSize;
+    mEncodeQueue.push(std::move(request));
+    mCondition.notify_one();
+}
+
+void AsyncFrameCapture::runWorker()
+{
+    // This function is the entry point for worker threads.
+    // The workers wait on the encode request queue and encode an image when woken up.
+
+    while (true)
+    {
+        // Wait on condition until more work is ready.
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [&]() { return mTerminate || !mEncodeQueue.empty(); });
+
+        // Terminate thread unless there is more work to do.
+        if (mEncodeQueue.empty())
+        {
+            if (mTerminate)
+                break;
+            continue;
+        }
+
+        // Pop next encode request from queue.
+        auto request = std::move(mEncodeQueue.front());
+        mEncodeQueue.pop();
+        mActiveCount++;
+
+        lock.unlock();
+
+        // Encode and write the image (this part is running in parallel).
+        const size_t byteSize = request.data.size();
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        bool success = true;
+        try
+        {
+            encode(request);
+        }
+        catch (const std::exception& e)
+        {
+            logError("Failed to write captured image '{}': {}", request.path.string(), e.what());
+            success = false;
+        }
+        auto endTime = CpuTimer::getCurrentTimePoint();
+
+        lock.lock();
+
+        mActiveCount--;
+        mPendingByteSize -= byteSize;
+        if (success)
+        {
+            mStats.imageCount++;
+            mStats.byteCount += byteSize;
+        }
+        else
+        {
+            mStats.failedCount++;
+        }
+        mStats.encodeTime += CpuTimer::calcDuration(startTime, endTime);
+        mStats.elapsedTime = CpuTimer::calcDuration(mStartTime, endTime) * 1e-3;
+
+        mDoneCondition.notify_all();
+    }
+}
+
+void AsyncFrameCapture::encode(EncodeRequest& request)
+{
+    if (request.encodeMode == EncodeMode::Raw)
+    {
+        RawImageHeader header;
+        header.width = request.width;
+        header.height = request.height;
+        header.resourceFormat = (uint32_t)request.resourceFormat;
+        header.rowPitch = request.width * getFormatBytesPerBlock(request.resourceFormat);
+
+        std::filesystem::path path = request.path;
+        path.replace_extension(".raw");
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(request.data.data()), request.data.size());
+        if (!file)
+            FALCOR_THROW("Failed to write file.");
+        return;
+    }
+
+    Bitmap::ExportFlags exportFlags = request.exportFlags;
+    if (request.encodeMode == EncodeMode::Fast &&
+        (request.fileFormat == Bitmap::FileFormat::PngFile || request.fileFormat == Bitmap::FileFormat::ExrFile))
+    {
+        exportFlags &= ~Bitmap::ExportFlags::Lossy;
+        exportFlags |= Bitmap::ExportFlags::Uncompressed;
+    }
+
+    Bitmap::saveImage(
+        request.path, request.width, request.height, request.fileFormat, exportFlags, request.resourceFormat, true, request.data.data()
+    );
+}
+} // namespace Falcor
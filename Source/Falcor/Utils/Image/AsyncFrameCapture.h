@@ -0,0 +1,197 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include "Core/API/fwd.h"
+#include "Core/API/CopyContext.h"
+#include "Core/API/Formats.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Pipelined capture of textures to image files.
+ *
+ * Captures are read back into a ring of readback buffers, so that several frames can be in flight
+ * on the GPU without stalling the renderer. Finished readbacks are handed to a pool of worker threads
+ * that encode and write the image files in parallel.
+ *
+ * The amount of image data waiting to be encoded is bounded. When the limit is reached, capture() blocks
+ * until the workers have caught up (back-pressure). Similarly, capture() blocks on the oldest readback
+ * when all readback buffers are in use.
+ */
+class FALCOR_API AsyncFrameCapture
+{
+public:
+    enum class EncodeMode
+    {
+        Default, ///< Encode with the requested file format and export flags.
+        Fast,    ///< Encode without compression (uncompressed PNG and EXR). Other formats are encoded as in the default mode.
+        Raw,     ///< Write the raw texel data with a small header instead of encoding. The file extension is replaced by ".raw".
+    };
+    FALCOR_ENUM_INFO(
+        EncodeMode,
+        {
+            {EncodeMode::Default, "Default"},
+            {EncodeMode::Fast, "Fast"},
+            {EncodeMode::Raw, "Raw"},
+        }
+    );
+
+    struct Options
+    {
+        uint32_t readbackCount = 8;                 ///< Number of readback buffers, i.e. the maximum number of captures in flight on the GPU.
+        uint32_t threadCount = 0;                   ///< Number of encoding threads. Zero uses one thread per hardware thread.
+        size_t maxPendingByteSize = 1ull << 30;     ///< Maximum size of the image data waiting to be encoded.
+        EncodeMode encodeMode = EncodeMode::Default;
+    };
+
+    struct Stats
+    {
+        uint64_t frameCount = 0;            ///< Number of captured frames, counted by distinct frame IDs.
+        uint64_t imageCount = 0;            ///< Number of images written.
+        uint64_t byteCount = 0;             ///< Size of the image data written, before encoding.
+        uint64_t failedCount = 0;           ///< Number of images that failed to be written.
+        double readbackStallTime = 0.0;     ///< Time in ms the caller was blocked waiting for readbacks.
+        double backpressureStallTime = 0.0; ///< Time in ms the caller was blocked waiting for the encoders.
+        double encodeTime = 0.0;            ///< Time in ms spent encoding and writing, summed over all threads.
+        double elapsedTime = 0.0;           ///< Time in seconds from the first capture until the last image was written.
+
+        double getFramesPerSecond() const { return elapsedTime > 0.0 ? frameCount / elapsedTime : 0.0; }
+        double getImagesPerSecond() const { return elapsedTime > 0.0 ? imageCount / elapsedTime : 0.0; }
+    };
+
+    /**
+     * Constructor.
+     * @param[in] pDevice GPU device.
+     * @param[in] options Capture options.
+     */
+    AsyncFrameCapture(ref<Device> pDevice, const Options& options = {});
+
+    /**
+     * Destructor.
+     * Blocks until all pending captures have been written.
+     */
+    ~AsyncFrameCapture();
+
+    /**
+     * Capture the first mip level and array slice of a 2D texture to an image file.
+     * The texture can be modified or released as soon as the call returns.
+     * @param[in] pRenderContext Render context used for the readback.
+     * @param[in] pTexture The texture to capture.
+     * @param[in] frameID ID of the frame the texture belongs to. Only used for statistics.
+     * @param[in] path Path of the file to write.
+     * @param[in] fileFormat Destination image file format.
+     * @param[in] exportFlags Export flags, see Bitmap::ExportFlags.
+     */
+    void capture(
+        RenderContext* pRenderContext,
+        const ref<Texture>& pTexture,
+        uint64_t frameID,
+        const std::filesystem::path& path,
+        Bitmap::FileFormat fileFormat,
+        Bitmap::ExportFlags exportFlags = Bitmap::ExportFlags::None
+    );
+
+    /**
+     * Block until all pending captures have been written.
+     */
+    void flush();
+
+    void setEncodeMode(EncodeMode encodeMode) { mEncodeMode = encodeMode; }
+    EncodeMode getEncodeMode() const { return mEncodeMode; }
+
+    /**
+     * Get capture statistics.
+     */
+    Stats getStats() const;
+
+    /**
+     * Reset capture statistics.
+     */
+    void resetStats();
+
+private:
+    struct EncodeRequest
+    {
+        std::filesystem::path path;
+        Bitmap::FileFormat fileFormat;
+        Bitmap::ExportFlags exportFlags;
+        EncodeMode encodeMode;
+        ResourceFormat resourceFormat;
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> data;
+    };
+
+    struct PendingReadback
+    {
+        CopyContext::ReadTextureTask::SharedPtr pTask;
+        EncodeRequest request;
+    };
+
+    void retireReadback();
+    void enqueueEncode(EncodeRequest request);
+    void runWorker();
+    static void encode(EncodeRequest& request);
+
+    ref<Device> mpDevice;
+    Options mOptions;
+    EncodeMode mEncodeMode;
+
+    // State owned by the capturing thread.
+    std::deque<PendingReadback> mReadbacks;         ///< Readbacks in flight in submission order.
+    std::vector<ref<Buffer>> mFreeReadbackBuffers;  ///< Readback buffers available for reuse.
+    uint64_t mLastFrameID = uint64_t(-1);
+
+    mutable std::mutex mMutex;              ///< Mutex for synchronizing access to shared resources.
+    std::condition_variable mCondition;     ///< Condition variable for workers to wait on.
+    std::condition_variable mDoneCondition; ///< Condition variable for the capturing thread to wait on.
+    std::vector<std::thread> mThreads;      ///< Worker threads.
+
+    // Internal state. Do not access outside of critical section.
+    std::queue<EncodeRequest> mEncodeQueue; ///< Encode request queue.
+    size_t mPendingByteSize = 0;            ///< Size of the image data queued or being encoded.
+    uint32_t mActiveCount = 0;              ///< Number of requests currently being encoded.
+    bool mTerminate = false;                ///< Flag to terminate worker threads.
+    Stats mStats;
+    bool mHasStartTime = false;
+    CpuTimer::TimePoint mStartTime;
+};
+
+FALCOR_ENUM_REGISTER(AsyncFrameCapture::EncodeMode);
+} // namespace Falcor
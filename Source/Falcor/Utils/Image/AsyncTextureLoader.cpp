@@ -27,7 +27,9 @@
  **************************************************************************/
 #include "AsyncTextureLoader.h"
 #include "Core/API/Device.h"
-#include "Utils/Threading.h"
+#include "Utils/Logger.h"
+#include "Utils/JobSystem.h"
+#include "Utils/Timing/Tracer.h"
 
 namespace Falcor
 {
@@ -36,14 +38,17 @@ namespace
 constexpr size_t kUploadsPerFlush = 16; ///< Number of texture uploads before issuing a flush (to keep upload heap from growing).
 }
 
-AsyncTextureLoader::AsyncTextureLoader(ref<Device> pDevice, size_t threadCount) : mpDevice(pDevice)
-{
-    runWorkers(threadCount);
-}
+AsyncTextureLoader::AsyncTextureLoader(ref<Device> pDevice, size_t threadCount)
+    : mpDevice(pDevice), mMaxActiveLoads(std::max<size_t>(threadCount, 1))
+{}
 
 AsyncTextureLoader::~AsyncTextureLoader()
 {
-    terminateWorkers();
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mTerminate = true;
+        mCondition.wait(lock, [&]() { return mLoadRequestQueue.empty() && mActiveLoads == 0; });
+    }
 
     mpDevice->wait();
 }
@@ -58,8 +63,9 @@ std::future<ref<Texture>> AsyncTextureLoader::loadMippedFromFiles(
 {
     std::lock_guard<std::mutex> lock(mMutex);
     mLoadRequestQueue.push(LoadRequest{{paths.begin(), paths.end()}, false, loadAsSrgb, bindFlags, importFlags, callback});
-    mCondition.notify_one();
-    return mLoadRequestQueue.back().promise.get_future();
+    auto future = mLoadRequestQueue.back().promise.get_future();
+    scheduleLoads();
+    return future;
 }
 
 std::future<ref<Texture>> AsyncTextureLoader::loadFromFile(
@@ -73,67 +79,32 @@ std::future<ref<Texture>> AsyncTextureLoader::loadFromFile(
 {
     std::lock_guard<std::mutex> lock(mMutex);
     mLoadRequestQueue.push(LoadRequest{{path}, generateMipLevels, loadAsSrgb, bindFlags, importFlags, callback});
-    mCondition.notify_one();
-    return mLoadRequestQueue.back().promise.get_future();
+    auto future = mLoadRequestQueue.back().promise.get_future();
+    scheduleLoads();
+    return future;
 }
 
-void AsyncTextureLoader::runWorkers(size_t threadCount)
+void AsyncTextureLoader::scheduleLoads()
 {
-    // Create a barrier to synchronize worker threads before issuing a global flush.
-    mFlushBarrier = std::make_shared<Barrier>(
-        threadCount,
-        [&]()
-        {
-            mpDevice->wait();
-            mFlushPending = false;
-            mUploadCounter = 0;
-        }
-    );
-
-    for (size_t i = 0; i < threadCount; ++i)
+    // Requests are loaded by jobs on the global job system. The number of loads in flight is limited to keep the
+    // memory footprint in check and to leave workers for other tasks.
+    while (!mFlushPending && mActiveLoads < mMaxActiveLoads && !mLoadRequestQueue.empty())
     {
-        mThreads.emplace_back(&AsyncTextureLoader::runWorker, this);
+        // Job functions must be copyable, the request holds a promise so it is shared.
+        auto pRequest = std::make_shared<LoadRequest>(std::move(mLoadRequestQueue.front()));
+        mLoadRequestQueue.pop();
+        ++mActiveLoads;
+        JobSystem::getGlobal().submit([this, pRequest]() { runLoad(*pRequest); });
     }
 }
 
-void AsyncTextureLoader::runWorker()
+void AsyncTextureLoader::runLoad(LoadRequest& request)
 {
-    // This function is the entry point for worker threads.
-    // The workers wait on the load request queue and load a texture when woken up.
-    // To avoid the upload heap growing too large, we synchronize the threads and
-    // issue a global GPU flush at regular intervals.
-
-    while (true)
+    // Load the textures (this part is running in parallel).
+    ref<Texture> pTexture;
+    try
     {
-        // Wait on condition until more work is ready.
-        std::unique_lock<std::mutex> lock(mMutex);
-        mCondition.wait(lock, [&]() { return mTerminate || !mLoadRequestQueue.empty() || mFlushPending; });
-
-        // Sync thread if a flush is pending.
-        if (mFlushPending)
-        {
-            lock.unlock();
-            mFlushBarrier->wait();
-            mCondition.notify_one();
-            continue;
-        }
-
-        // Terminate thread unless there is more work to do.
-        if (mTerminate && mLoadRequestQueue.empty() && !mFlushPending)
-            break;
-
-        // Go back waiting if queue is currently empty.
-        if (mLoadRequestQueue.empty())
-            continue;
-
-        // Pop next load request from queue.
-        auto request = std::move(mLoadRequestQueue.front());
-        mLoadRequestQueue.pop();
-
-        lock.unlock();
-
-        // Load the textures (this part is running in parallel).
-        ref<Texture> pTexture;
+        FALCOR_TRACE_SCOPE_DETAIL("AsyncTextureLoader::load", request.paths[0].filename().string());
         if (request.paths.size() == 1)
         {
             pTexture = Texture::createFromFile(
@@ -144,38 +115,49 @@ void AsyncTextureLoader::runWorker()
         {
             pTexture = Texture::createMippedFromFiles(mpDevice, request.paths, request.loadAsSRGB, request.bindFlags, request.importFlags);
         }
-
         request.promise.set_value(pTexture);
+    }
+    catch (...)
+    {
+        request.promise.set_exception(std::current_exception());
+    }
 
-        if (request.callback)
+    // The callback must not skip the bookkeeping below, otherwise the destructor waits forever for this load.
+    if (request.callback)
+    {
+        try
         {
             request.callback(pTexture);
         }
-
-        lock.lock();
-
-        // Issue a global flush if necessary.
-        // TODO: It would be better to check the size of the upload heap instead.
-        if (!mTerminate && pTexture != nullptr && ++mUploadCounter >= kUploadsPerFlush)
+        catch (const std::exception& e)
         {
-            mFlushPending = true;
-            mCondition.notify_all();
+            logError("AsyncTextureLoader: Texture load callback failed: {}", e.what());
+        }
+        catch (...)
+        {
+            logError("AsyncTextureLoader: Texture load callback failed.");
         }
-
-        mCondition.notify_one();
     }
-}
 
-void AsyncTextureLoader::terminateWorkers()
-{
+    std::unique_lock<std::mutex> lock(mMutex);
+    --mActiveLoads;
+
+    // Issue a global flush if necessary. To avoid the upload heap growing too large, no new loads are started once
+    // a flush is pending and the last load in flight issues it.
+    // TODO: It would be better to check the size of the upload heap instead.
+    if (!mTerminate && pTexture != nullptr && ++mUploadCounter >= kUploadsPerFlush)
+        mFlushPending = true;
+
+    if (mFlushPending && mActiveLoads == 0)
     {
-        std::lock_guard<std::mutex> lock(mMutex);
-        mTerminate = true;
+        lock.unlock();
+        mpDevice->wait();
+        lock.lock();
+        mFlushPending = false;
+        mUploadCounter = 0;
     }
 
+    scheduleLoads();
     mCondition.notify_all();
-
-    for (auto& thread : mThreads)
-        thread.join();
 }
 } // namespace Falcor
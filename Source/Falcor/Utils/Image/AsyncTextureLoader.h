@@ -42,10 +42,8 @@
 
 namespace Falcor
 {
-class Barrier;
-
 /**
- * Utility class to load textures asynchronously using multiple worker threads.
+ * Utility class to load textures asynchronously on the global job system.
  */
 class FALCOR_API AsyncTextureLoader
 {
@@ -54,13 +52,13 @@ public:
 
     /**
      * Constructor.
-     * @param[in] threadCount Number of worker threads.
+     * @param[in] threadCount Maximum number of textures loaded concurrently.
      */
     AsyncTextureLoader(ref<Device> pDevice, size_t threadCount = std::thread::hardware_concurrency());
 
     /**
      * Destructor.
-     * Blocks until all threads have terminated.
+     * Blocks until all pending loads have finished.
      */
     ~AsyncTextureLoader();
 
@@ -101,10 +99,6 @@ public:
     );
 
 private:
-    void runWorkers(size_t threadCount);
-    void runWorker();
-    void terminateWorkers();
-
     struct LoadRequest
     {
         std::vector<std::filesystem::path> paths;
@@ -116,18 +110,24 @@ private:
         std::promise<ref<Texture>> promise;
     };
 
+    /// Submits load jobs for queued requests, up to the maximum number of concurrent loads. Must be called with the mutex held.
+    void scheduleLoads();
+    /// Entry point of the load jobs.
+    void runLoad(LoadRequest& request);
+
     ref<Device> mpDevice;
 
-    std::mutex mMutex;                      ///< Mutex for synchronizing access to shared resources.
-    std::condition_variable mCondition;     ///< Condition variable for workers to wait on.
-    std::shared_ptr<Barrier> mFlushBarrier; ///< Barrier for flushing the GPU to upload textures.
-    std::vector<std::thread> mThreads;      ///< Worker threads.
+    size_t mMaxActiveLoads; ///< Maximum number of load jobs in flight.
+
+    std::mutex mMutex;                  ///< Mutex for synchronizing access to shared resources.
+    std::condition_variable mCondition; ///< Condition variable for the destructor to wait on pending loads.
 
     // Internal state. Do not access outside of critical section.
     std::queue<LoadRequest> mLoadRequestQueue; ///< Texture loading request queue.
 
-    bool mTerminate = false;     ///< Flag to terminate worker threads.
-    bool mFlushPending = false;  ///< Flag to indicate a GPU flush is pending.
+    size_t mActiveLoads = 0;     ///< Number of load jobs in flight.
+    bool mTerminate = false;     ///< Flag to indicate the loader is being destroyed.
+    bool mFlushPending = false;  ///< Flag to indicate a GPU flush is pending. No new loads are started until it is issued.
     uint32_t mUploadCounter = 0; ///< Counter to issue a flush every few uploads.
 };
 } // namespace Falcor
@@ -30,6 +30,7 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/NumericRange.h"
+#include "Utils/Timing/Tracer.h"
 
 #include <execution>
 
@@ -417,6 +418,7 @@ void TextureManager::endDeferredLoading()
         [&](size_t i)
         {
             const auto& job = jobs[i];
+            FALCOR_TRACE_SCOPE_DETAIL("TextureManager::loadTexture", job.key.fullPaths[0].filename().string());
             auto& desc = getDesc(job.handle);
             if (job.key.fullPaths.size() == 1)
             {
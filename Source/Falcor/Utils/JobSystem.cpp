@@ -0,0 +1,365 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "JobSystem.h"
+#include "Core/Error.h"
+#include "Utils/Timing/Tracer.h"
+#include <fmt/format.h>
+#include <deque>
+
+namespace Falcor
+{
+namespace
+{
+constexpr size_t kPriorityCount = (size_t)JobSystem::Priority::Count;
+
+// Number of chunks per thread for automatic grain sizes, to balance uneven work.
+constexpr size_t kChunksPerThread = 4;
+
+// Worker identity of the calling thread.
+thread_local const JobSystem* tlsJobSystem = nullptr;
+thread_local uint32_t tlsWorkerIndex = 0;
+} // namespace
+
+struct JobSystem::Job
+{
+    std::function<void()> func;
+    Priority priority;
+    std::atomic<uint32_t> pendingDependencyCount{1}; ///< Starts at 1 to hold the job until submit() has registered all dependencies.
+    std::atomic<bool> done{false};
+    std::exception_ptr exception;
+
+    std::mutex mutex;                              ///< Protects the dependents and the done flag transition.
+    std::vector<std::shared_ptr<Job>> dependents; ///< Jobs to release when this job is done.
+};
+
+struct JobSystem::Queue
+{
+    std::mutex mutex;
+    std::deque<std::shared_ptr<Job>> jobs[kPriorityCount];
+};
+
+bool JobSystem::JobHandle::isDone() const
+{
+    return !mpJob || mpJob->done.load(std::memory_order_acquire);
+}
+
+JobSystem::JobSystem(uint32_t threadCount)
+{
+    FALCOR_CHECK(threadCount > 0, "Job system needs at least one worker thread.");
+
+    for (uint32_t i = 0; i < threadCount + 1; ++i)
+        mQueues.push_back(std::make_unique<Queue>());
+
+    for (uint32_t i = 0; i < threadCount; ++i)
+        mThreads.emplace_back(&JobSystem::runWorker, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mTerminate = true;
+    }
+    mWakeCondition.notify_all();
+
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+JobSystem::JobHandle JobSystem::submit(std::function<void()> func, Priority priority, fstd::span<const JobHandle> dependencies)
+{
+    FALCOR_CHECK(priority < Priority::Count, "Invalid job priority.");
+
+    auto pJob = std::make_shared<Job>();
+    pJob->func = std::move(func);
+    pJob->priority = priority;
+
+    for (const JobHandle& dependency : dependencies)
+    {
+        if (!dependency.mpJob)
+            continue;
+
+        std::lock_guard<std::mutex> lock(dependency.mpJob->mutex);
+        if (!dependency.mpJob->done.load(std::memory_order_acquire))
+        {
+            pJob->pendingDependencyCount.fetch_add(1);
+            dependency.mpJob->dependents.push_back(pJob);
+        }
+    }
+
+    // Release the submit() hold, the job is queued now unless it still waits on dependencies.
+    if (pJob->pendingDependencyCount.fetch_sub(1) == 1)
+        enqueue(pJob);
+
+    return JobHandle(pJob);
+}
+
+void JobSystem::wait(const JobHandle& handle)
+{
+    if (!handle.mpJob)
+        return;
+
+    waitUntilDone(*handle.mpJob);
+
+    if (handle.mpJob->exception)
+        std::rethrow_exception(handle.mpJob->exception);
+}
+
+void JobSystem::wait(fstd::span<const JobHandle> handles)
+{
+    std::exception_ptr exception;
+    for (const JobHandle& handle : handles)
+    {
+        if (!handle.mpJob)
+            continue;
+
+        waitUntilDone(*handle.mpJob);
+
+        if (!exception)
+            exception = handle.mpJob->exception;
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+bool JobSystem::isWorkerThread() const
+{
+    return tlsJobSystem == this;
+}
+
+uint32_t JobSystem::getDefaultThreadCount()
+{
+    return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+}
+
+JobSystem& JobSystem::getGlobal()
+{
+    static JobSystem sJobSystem;
+    return sJobSystem;
+}
+
+size_t JobSystem::getGrainSize(size_t count, size_t grainSize) const
+{
+    if (grainSize > 0)
+        return grainSize;
+
+    const size_t chunkCount = (getThreadCount() + 1) * kChunksPerThread;
+    return std::max<size_t>((count + chunkCount - 1) / chunkCount, 1);
+}
+
+void JobSystem::parallelForChunks(size_t chunkCount, const std::function<void(size_t)>& func, Priority priority)
+{
+    if (chunkCount == 1)
+    {
+        func(0);
+        return;
+    }
+
+    // Chunks are handed out dynamically to the calling thread and up to one helper job per worker.
+    // Helpers that start after all chunks are taken return immediately.
+    std::atomic<size_t> nextChunk{0};
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+
+    auto processChunks = [&]()
+    {
+        for (size_t chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1))
+        {
+            try
+            {
+                func(chunk);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+    };
+
+    const size_t helperCount = std::min<size_t>(chunkCount - 1, getThreadCount());
+    std::vector<JobHandle> helpers;
+    helpers.reserve(helperCount);
+    for (size_t i = 0; i < helperCount; ++i)
+        helpers.push_back(submit(processChunks, priority));
+
+    processChunks();
+
+    // The helpers reference the stack of this call, they must all finish before returning.
+    for (const JobHandle& helper : helpers)
+        waitUntilDone(*helper.mpJob);
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void JobSystem::enqueue(std::shared_ptr<Job> pJob)
+{
+    // Workers push to their own queue, other threads to the injection queue.
+    Queue& queue = *mQueues[isWorkerThread() ? tlsWorkerIndex : mThreads.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs[(size_t)pJob->priority].push_back(std::move(pJob));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mPendingJobCount.fetch_add(1);
+    }
+
+    if (mWaiterCount.load() > 0)
+        mWakeCondition.notify_all();
+    else
+        mWakeCondition.notify_one();
+}
+
+std::shared_ptr<JobSystem::Job> JobSystem::popJob()
+{
+    if (mPendingJobCount.load() == 0)
+        return nullptr;
+
+    const size_t queueCount = mQueues.size();
+    const bool isWorker = isWorkerThread();
+    const size_t ownIndex = isWorker ? tlsWorkerIndex : queueCount - 1;
+
+    for (size_t priority = 0; priority < kPriorityCount; ++priority)
+    {
+        // Own queue first, newest job first.
+        if (isWorker)
+        {
+            Queue& queue = *mQueues[ownIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& jobs = queue.jobs[priority];
+            if (!jobs.empty())
+            {
+                auto pJob = std::move(jobs.back());
+                jobs.pop_back();
+                mPendingJobCount.fetch_sub(1);
+                return pJob;
+            }
+        }
+
+        // Then steal the oldest job of the other queues, starting with the injection queue.
+        for (size_t i = 0; i < queueCount; ++i)
+        {
+            const size_t index = (queueCount - 1 + ownIndex + i) % queueCount;
+            if (isWorker && index == ownIndex)
+                continue;
+
+            Queue& queue = *mQueues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& jobs = queue.jobs[priority];
+            if (!jobs.empty())
+            {
+                auto pJob = std::move(jobs.front());
+                jobs.pop_front();
+                mPendingJobCount.fetch_sub(1);
+                return pJob;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+void JobSystem::execute(const std::shared_ptr<Job>& pJob)
+{
+    try
+    {
+        pJob->func();
+    }
+    catch (...)
+    {
+        pJob->exception = std::current_exception();
+    }
+
+    // Release the captures now, they may hold resources the waiters expect to be freed.
+    pJob->func = nullptr;
+
+    std::vector<std::shared_ptr<Job>> dependents;
+    {
+        std::lock_guard<std::mutex> lock(pJob->mutex);
+        pJob->done.store(true, std::memory_order_release);
+        dependents.swap(pJob->dependents);
+    }
+
+    for (auto& pDependent : dependents)
+    {
+        if (pDependent->pendingDependencyCount.fetch_sub(1) == 1)
+            enqueue(std::move(pDependent));
+    }
+
+    if (mWaiterCount.load() > 0)
+    {
+        // Lock to not miss a waiter between its check and its sleep.
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mWakeCondition.notify_all();
+    }
+}
+
+void JobSystem::waitUntilDone(Job& job)
+{
+    while (!job.done.load(std::memory_order_acquire))
+    {
+        if (auto pJob = popJob())
+        {
+            execute(pJob);
+            continue;
+        }
+
+        // Nothing to run: the job is running on another thread or waits on dependencies running elsewhere.
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        mWaiterCount.fetch_add(1);
+        mWakeCondition.wait(lock, [&]() { return job.done.load(std::memory_order_acquire) || mPendingJobCount.load() > 0; });
+        mWaiterCount.fetch_sub(1);
+    }
+}
+
+void JobSystem::runWorker(uint32_t workerIndex)
+{
+    tlsJobSystem = this;
+    tlsWorkerIndex = workerIndex;
+    Tracer::setThreadName(fmt::format("JobSystem worker {}", workerIndex));
+
+    while (true)
+    {
+        if (auto pJob = popJob())
+        {
+            execute(pJob);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        if (mTerminate && mPendingJobCount.load() == 0)
+            break;
+        mWakeCondition.wait(lock, [&]() { return mTerminate || mPendingJobCount.load() > 0; });
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,225 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <fstd/span.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Work-stealing job system.
+ *
+ * Each worker thread owns a queue per priority. Jobs submitted from a worker go to its own queue and are
+ * popped in LIFO order, so nested work stays on the thread that created it, while idle workers steal the
+ * oldest jobs of other workers. Jobs submitted from other threads go to a shared injection queue.
+ * Higher priority jobs are always taken first.
+ *
+ * Waiting on a job never parks a thread that could do work: wait() runs pending jobs until the awaited job
+ * is finished. Jobs can therefore wait on other jobs and nest parallelFor() calls without fibers and
+ * without deadlocking, as long as the awaited jobs don't wait on their waiter.
+ *
+ * All Falcor subsystems share the global instance returned by getGlobal(), so concurrent workloads
+ * (e.g. scene import and texture loading) don't oversubscribe the CPU.
+ */
+class FALCOR_API JobSystem
+{
+public:
+    enum class Priority : uint32_t
+    {
+        High,
+        Normal,
+        Low,
+
+        Count,
+    };
+
+    struct Job;
+
+    /**
+     * Handle to a submitted job. An empty handle is considered finished.
+     */
+    class FALCOR_API JobHandle
+    {
+    public:
+        JobHandle() = default;
+
+        bool isValid() const { return mpJob != nullptr; }
+
+        /// Check if the job has finished executing.
+        bool isDone() const;
+
+    private:
+        JobHandle(std::shared_ptr<Job> pJob) : mpJob(std::move(pJob)) {}
+
+        std::shared_ptr<Job> mpJob;
+        friend class JobSystem;
+    };
+
+    /**
+     * Create a job system.
+     * @param[in] threadCount Number of worker threads. Threads waiting on jobs execute jobs as well.
+     */
+    JobSystem(uint32_t threadCount = getDefaultThreadCount());
+
+    /**
+     * Destructor. Runs all pending jobs and joins the worker threads.
+     */
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * Submit a job.
+     * @param[in] func Function to execute. Exceptions are stored and rethrown by wait().
+     * @param[in] priority Job priority.
+     * @param[in] dependencies Jobs that must finish before this job starts. The job runs even if a dependency threw.
+     * @return Handle to the job.
+     */
+    JobHandle submit(std::function<void()> func, Priority priority = Priority::Normal, fstd::span<const JobHandle> dependencies = {});
+
+    /**
+     * Wait for a job to finish, executing other pending jobs meanwhile.
+     * Rethrows the exception thrown by the job, if any.
+     */
+    void wait(const JobHandle& handle);
+
+    /**
+     * Wait for a list of jobs to finish. Rethrows the first exception thrown by the jobs, after all of them finished.
+     */
+    void wait(fstd::span<const JobHandle> handles);
+
+    /**
+     * Run func(i) for all i in [begin, end) in parallel and wait for completion.
+     * The calling thread participates. Calls can be nested inside jobs and other parallelFor() calls.
+     * @param[in] grainSize Number of consecutive indices processed by a task, 0 to pick it automatically.
+     */
+    template<typename Func>
+    void parallelFor(size_t begin, size_t end, Func&& func, size_t grainSize = 0, Priority priority = Priority::Normal)
+    {
+        if (end <= begin)
+            return;
+
+        const size_t grain = getGrainSize(end - begin, grainSize);
+        parallelForChunks(
+            (end - begin + grain - 1) / grain,
+            [&](size_t chunk)
+            {
+                const size_t chunkBegin = begin + chunk * grain;
+                const size_t chunkEnd = std::min(chunkBegin + grain, end);
+                for (size_t i = chunkBegin; i < chunkEnd; ++i)
+                    func(i);
+            },
+            priority
+        );
+    }
+
+    /**
+     * Parallel reduction over [begin, end).
+     * Each chunk of indices is mapped to a value with map(chunkBegin, chunkEnd), and the chunk values are combined
+     * in index order with reduce(a, b), so the result is deterministic for a given grain size.
+     * @param[in] identity Result for an empty range.
+     * @param[in] grainSize Number of consecutive indices per chunk, 0 to pick it automatically.
+     */
+    template<typename T, typename MapFunc, typename ReduceFunc>
+    T parallelReduce(
+        size_t begin,
+        size_t end,
+        T identity,
+        MapFunc&& map,
+        ReduceFunc&& reduce,
+        size_t grainSize = 0,
+        Priority priority = Priority::Normal
+    )
+    {
+        if (end <= begin)
+            return identity;
+
+        const size_t grain = getGrainSize(end - begin, grainSize);
+        const size_t chunkCount = (end - begin + grain - 1) / grain;
+
+        std::vector<T> chunkResults(chunkCount, identity);
+        parallelForChunks(
+            chunkCount,
+            [&](size_t chunk)
+            {
+                const size_t chunkBegin = begin + chunk * grain;
+                chunkResults[chunk] = map(chunkBegin, std::min(chunkBegin + grain, end));
+            },
+            priority
+        );
+
+        T result = std::move(chunkResults[0]);
+        for (size_t i = 1; i < chunkCount; ++i)
+            result = reduce(std::move(result), std::move(chunkResults[i]));
+        return result;
+    }
+
+    uint32_t getThreadCount() const { return (uint32_t)mThreads.size(); }
+
+    /// Returns true if the calling thread is a worker of this job system.
+    bool isWorkerThread() const;
+
+    /// Default number of worker threads: one per logical core, minus the thread submitting the work.
+    static uint32_t getDefaultThreadCount();
+
+    /// Global job system shared by all Falcor subsystems, created on first use.
+    static JobSystem& getGlobal();
+
+private:
+    struct Queue;
+
+    size_t getGrainSize(size_t count, size_t grainSize) const;
+    void parallelForChunks(size_t chunkCount, const std::function<void(size_t)>& func, Priority priority);
+
+    void enqueue(std::shared_ptr<Job> pJob);
+    std::shared_ptr<Job> popJob();
+    void execute(const std::shared_ptr<Job>& pJob);
+    void waitUntilDone(Job& job);
+    void runWorker(uint32_t workerIndex);
+
+    std::vector<std::unique_ptr<Queue>> mQueues; ///< Worker queues followed by the injection queue.
+    std::vector<std::thread> mThreads;
+
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+    std::atomic<size_t> mPendingJobCount{0}; ///< Number of queued jobs.
+    std::atomic<uint32_t> mWaiterCount{0};   ///< Number of threads sleeping in wait().
+    bool mTerminate = false;
+};
+} // namespace Falcor
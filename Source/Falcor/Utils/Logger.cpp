@@ -29,22 +29,170 @@
 #include "Core/Error.h"
 #include "Core/Platform/OS.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <mutex>
 #include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace Falcor
 {
 namespace
 {
-std::mutex sMutex;
-Logger::Level sVerbosity = Logger::Level::Info;
-Logger::OutputFlags sOutputs = Logger::OutputFlags::Console | Logger::OutputFlags::File | Logger::OutputFlags::DebugWindow;
-std::filesystem::path sLogFilePath;
+/// Maximum number of pending messages per thread.
+constexpr size_t kQueueCapacity = 4096;
+/// Interval at which the writer thread checks the message queues when it is not woken up.
+constexpr auto kWriterInterval = std::chrono::milliseconds(5);
+/// Maximum number of times an identical message is written per rate limit window.
+constexpr uint32_t kMaxRepeatsPerWindow = 100;
+constexpr auto kRateLimitWindow = std::chrono::seconds(1);
 
-bool sInitialized = false;
-FILE* sLogFile = nullptr;
+using Clock = std::chrono::steady_clock;
+
+struct LogEntry
+{
+    uint64_t sequence = 0;
+    Logger::Level level = Logger::Level::Info;
+    Logger::Frequency frequency = Logger::Frequency::Always;
+    std::string msg; ///< Message, or format string of a deferred message.
+    std::optional<fmt::dynamic_format_arg_store<fmt::format_context>> args; ///< Format arguments of a deferred message.
+};
+
+/**
+ * Bounded lock-free single producer, single consumer queue.
+ * Each logging thread pushes to its own queue, the messages are popped while holding the output mutex.
+ */
+class MessageQueue
+{
+public:
+    MessageQueue() : mEntries(kQueueCapacity) {}
+
+    /// Push an entry. The entry is left untouched if the queue is full.
+    bool push(LogEntry&& entry)
+    {
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) == mEntries.size())
+            return false;
+        mEntries[tail % mEntries.size()] = std::move(entry);
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(LogEntry& entry)
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire))
+            return false;
+        entry = std::move(mEntries[head % mEntries.size()]);
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const { return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire); }
+
+    std::atomic<bool> threadExited{false};
+
+private:
+    std::vector<LogEntry> mEntries;
+    alignas(64) std::atomic<size_t> mHead{0};
+    alignas(64) std::atomic<size_t> mTail{0};
+};
+
+/**
+ * Filters messages logged with Frequency::Once and rate limits identical messages.
+ * Only accessed while holding the output mutex.
+ */
+class MessageDeduplicator
+{
+public:
+    bool isDuplicate(std::string_view msg)
+    {
+        auto it = mStrings.find(msg);
+        if (it != mStrings.end())
+            return true;
+        mStrings.insert(std::string(msg));
+        return false;
+    }
+
+    /// Returns true if the message was already written kMaxRepeatsPerWindow times in the current window.
+    bool isRateLimited(const std::string& msg)
+    {
+        uint32_t& count = mRepeatCounts[msg];
+        return ++count > kMaxRepeatsPerWindow;
+    }
+
+    /// Start a new rate limit window once the current one has expired, or unconditionally if forced.
+    /// The callback is called for each message that was suppressed in the finished window.
+    template<typename Callback>
+    void updateWindow(Clock::time_point now, bool force, Callback&& callback)
+    {
+        if (!force && now - mWindowStart < kRateLimitWindow)
+            return;
+
+        for (const auto& [msg, count] : mRepeatCounts)
+        {
+            if (count > kMaxRepeatsPerWindow)
+                callback(msg, count - kMaxRepeatsPerWindow);
+        }
+        mRepeatCounts.clear();
+        mWindowStart = now;
+    }
+
+private:
+    std::set<std::string, std::less<>> mStrings;
+    std::unordered_map<std::string, uint32_t> mRepeatCounts;
+    Clock::time_point mWindowStart = Clock::now();
+};
+
+struct LoggerState
+{
+    std::atomic<Logger::Level> verbosity{Logger::Level::Info};
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> droppedCount{0};
+    std::atomic<bool> writerActive{false};
+    std::atomic<bool> exiting{false};
+
+    // Message queues of all threads that logged.
+    std::mutex queuesMutex;
+    std::vector<std::shared_ptr<MessageQueue>> queues;
+
+    // Writer thread.
+    std::mutex writerMutex;
+    std::condition_variable writerCondition;
+    std::condition_variable flushCondition;
+    std::thread writer;
+    uint64_t writerGeneration = 0; ///< Incremented when the writer is started or stopped, a writer runs while it's unchanged.
+    uint64_t flushRequested = 0;
+    uint64_t flushCompleted = 0;
+
+    // Outputs. Only accessed while holding the output mutex.
+    std::mutex outputMutex;
+    Logger::OutputFlags outputs = Logger::OutputFlags::Console | Logger::OutputFlags::File | Logger::OutputFlags::DebugWindow;
+    std::filesystem::path logFilePath;
+    std::set<std::filesystem::path> openedLogFilePaths;
+    bool initialized = false;
+    FILE* logFile = nullptr;
+    MessageDeduplicator deduplicator;
+    uint64_t reportedDroppedCount = 0;
+    std::vector<LogEntry> batch;
+};
+
+/// The state is never destroyed so that messages can be logged during static destruction.
+LoggerState& getState()
+{
+    static LoggerState* pState = new LoggerState();
+    return *pState;
+}
+
+thread_local bool tlsIsWriterThread = false;
 
 std::filesystem::path generateLogFilePath()
 {
@@ -55,17 +203,21 @@ std::filesystem::path generateLogFilePath()
 
 FILE* openLogFile()
 {
+    auto& state = getState();
     FILE* pFile = nullptr;
 
-    if (sLogFilePath.empty())
+    if (state.logFilePath.empty())
     {
-        sLogFilePath = generateLogFilePath();
+        state.logFilePath = generateLogFilePath();
     }
 
-    pFile = std::fopen(sLogFilePath.string().c_str(), "w");
+    // Reopening a log file written earlier by this process appends to it.
+    const bool append = state.openedLogFilePaths.count(state.logFilePath) > 0;
+    pFile = std::fopen(state.logFilePath.string().c_str(), append ? "a" : "w");
     if (pFile != nullptr)
     {
         // Success
+        state.openedLogFilePaths.insert(state.logFilePath);
         return pFile;
     }
 
@@ -74,29 +226,29 @@ FILE* openLogFile()
     return pFile;
 }
 
-void printToLogFile(const std::string& s)
+void closeLogFile()
 {
-    if (!sInitialized)
+    auto& state = getState();
+    if (state.logFile)
     {
-        sLogFile = openLogFile();
-        sInitialized = true;
+        fclose(state.logFile);
+        state.logFile = nullptr;
+        state.initialized = false;
     }
+}
 
-    if (sLogFile)
+void printToLogFile(const std::string& s)
+{
+    auto& state = getState();
+    if (!state.initialized)
     {
-        std::fprintf(sLogFile, "%s", s.c_str());
-        std::fflush(sLogFile);
+        state.logFile = openLogFile();
+        state.initialized = true;
     }
-}
-} // namespace
 
-void Logger::shutdown()
-{
-    if (sLogFile)
+    if (state.logFile)
     {
-        fclose(sLogFile);
-        sLogFile = nullptr;
-        sInitialized = false;
+        std::fputs(s.c_str(), state.logFile);
     }
 }
 
@@ -120,104 +272,360 @@ inline const char* getLogLevelString(Logger::Level level)
     }
 }
 
-class MessageDeduplicator
+/// Write a formatted line to the outputs. Must be called with the output mutex held.
+void writeToOutputs(Logger::Level level, const std::string& s)
 {
-public:
-    static MessageDeduplicator& instance()
+    auto& state = getState();
+
+    // Write to console.
+    if (is_set(state.outputs, Logger::OutputFlags::Console))
     {
-        static MessageDeduplicator sInstance;
-        return sInstance;
+        auto& os = level > Logger::Level::Error ? std::cout : std::cerr;
+        os << s;
     }
 
-    bool isDuplicate(std::string_view msg)
+    // Write to file.
+    if (is_set(state.outputs, Logger::OutputFlags::File))
     {
-        std::lock_guard<std::mutex> lock(mMutex);
-        auto it = mStrings.find(msg);
-        if (it != mStrings.end())
-            return true;
-        mStrings.insert(std::string(msg));
-        return false;
+        printToLogFile(s);
     }
 
-private:
-    MessageDeduplicator() = default;
+    // Write to debug window if debugger is attached.
+    if (is_set(state.outputs, Logger::OutputFlags::DebugWindow) && isDebuggerPresent())
+    {
+        printToDebugWindow(s);
+    }
+}
 
-    std::mutex mMutex;
-    std::set<std::string, std::less<>> mStrings;
-};
+/// Format and write a message. Must be called with the output mutex held.
+void writeEntry(LogEntry& entry)
+{
+    auto& state = getState();
 
-void Logger::log(Level level, const std::string_view msg, Frequency frequency)
+    std::string msg;
+    if (entry.args)
+    {
+        try
+        {
+            msg = fmt::vformat(entry.msg, *entry.args);
+        }
+        catch (const fmt::format_error& e)
+        {
+            msg = fmt::format("{} (format error: {})", entry.msg, e.what());
+        }
+    }
+    else
+    {
+        msg = std::move(entry.msg);
+    }
+
+    std::string s = fmt::format("{} {}\n", getLogLevelString(entry.level), msg);
+
+    if (entry.frequency == Logger::Frequency::Once && state.deduplicator.isDuplicate(s))
+        return;
+    // Errors are never suppressed, like they are never dropped when the queue is full.
+    if (entry.frequency == Logger::Frequency::Always && entry.level > Logger::Level::Error && state.deduplicator.isRateLimited(s))
+        return;
+
+    writeToOutputs(entry.level, s);
+}
+
+/// Write the messages of all queues in the order they were logged. Must be called with the output mutex held.
+void writeQueuedMessages(bool forceReports)
 {
-    std::lock_guard<std::mutex> lock(sMutex);
-    if (level <= sVerbosity)
+    auto& state = getState();
+
     {
-        std::string s = fmt::format("{} {}\n", getLogLevelString(level), msg);
+        std::lock_guard<std::mutex> lock(state.queuesMutex);
+        for (auto it = state.queues.begin(); it != state.queues.end();)
+        {
+            // Check the exit flag first, the thread can't push after it is set.
+            auto& pQueue = *it;
+            if (pQueue->threadExited.load(std::memory_order_acquire) && pQueue->isEmpty())
+            {
+                it = state.queues.erase(it);
+                continue;
+            }
+
+            LogEntry entry;
+            while (pQueue->pop(entry))
+                state.batch.push_back(std::move(entry));
+            ++it;
+        }
+    }
 
-        if (frequency == Frequency::Once && MessageDeduplicator::instance().isDuplicate(s))
-            return;
+    std::sort(state.batch.begin(), state.batch.end(), [](const LogEntry& a, const LogEntry& b) { return a.sequence < b.sequence; });
+    for (auto& entry : state.batch)
+        writeEntry(entry);
+    state.batch.clear();
 
-        // Write to console.
-        if (is_set(sOutputs, OutputFlags::Console))
+    state.deduplicator.updateWindow(
+        Clock::now(),
+        forceReports,
+        [&](const std::string& s, uint32_t suppressedCount)
         {
-            auto& os = level > Logger::Level::Error ? std::cout : std::cerr;
-            os << s;
-            os.flush();
+            const std::string_view msg = std::string_view(s).substr(0, s.size() - 1);
+            writeToOutputs(
+                Logger::Level::Warning, fmt::format("{} Suppressed {} repeats of message: {}\n", getLogLevelString(Logger::Level::Warning), suppressedCount, msg)
+            );
         }
+    );
+
+    const uint64_t droppedCount = state.droppedCount.load(std::memory_order_relaxed);
+    if (droppedCount != state.reportedDroppedCount)
+    {
+        writeToOutputs(
+            Logger::Level::Warning,
+            fmt::format(
+                "{} Dropped {} log messages because the message queue was full.\n",
+                getLogLevelString(Logger::Level::Warning),
+                droppedCount - state.reportedDroppedCount
+            )
+        );
+        state.reportedDroppedCount = droppedCount;
+    }
+
+    // Flush once per batch instead of once per message.
+    std::cout.flush();
+    std::cerr.flush();
+    if (state.logFile)
+        std::fflush(state.logFile);
+}
+
+void runWriter(uint64_t generation)
+{
+    tlsIsWriterThread = true;
+    auto& state = getState();
+
+    std::unique_lock<std::mutex> lock(state.writerMutex);
+    while (true)
+    {
+        const uint64_t flushRequest = state.flushRequested;
+        const bool terminate = state.writerGeneration != generation;
+        lock.unlock();
 
-        // Write to file.
-        if (is_set(sOutputs, OutputFlags::File))
         {
-            printToLogFile(s);
+            std::lock_guard<std::mutex> outputLock(state.outputMutex);
+            writeQueuedMessages(false);
         }
 
-        // Write to debug window if debugger is attached.
-        if (is_set(sOutputs, OutputFlags::DebugWindow) && isDebuggerPresent())
+        lock.lock();
+        state.flushCompleted = flushRequest;
+        state.flushCondition.notify_all();
+        if (terminate)
+            break;
+        if (state.flushRequested == flushRequest && state.writerGeneration == generation)
+            state.writerCondition.wait_for(lock, kWriterInterval);
+    }
+}
+
+/// Start the writer thread if it's not running. Returns false if logging is synchronous.
+bool startWriter()
+{
+    auto& state = getState();
+    std::lock_guard<std::mutex> lock(state.writerMutex);
+    if (state.exiting.load())
+        return false;
+    if (!state.writer.joinable())
+    {
+        state.writer = std::thread(runWriter, ++state.writerGeneration);
+        state.writerActive.store(true, std::memory_order_release);
+    }
+    return true;
+}
+
+/// Stop the writer thread after it has written the pending messages.
+void stopWriter()
+{
+    auto& state = getState();
+    std::thread writer;
+    {
+        std::lock_guard<std::mutex> lock(state.writerMutex);
+        state.writerActive.store(false, std::memory_order_release);
+        ++state.writerGeneration;
+        writer = std::move(state.writer);
+    }
+    state.writerCondition.notify_all();
+    if (writer.joinable())
+        writer.join();
+}
+
+MessageQueue& getThreadQueue()
+{
+    // The queue is shared with the writer, which writes the remaining messages after the thread has exited.
+    struct ThreadQueue
+    {
+        std::shared_ptr<MessageQueue> pQueue;
+        ~ThreadQueue()
         {
-            printToDebugWindow(s);
+            if (pQueue)
+                pQueue->threadExited.store(true, std::memory_order_release);
         }
+    };
+    thread_local ThreadQueue tlsQueue;
+
+    if (!tlsQueue.pQueue)
+    {
+        tlsQueue.pQueue = std::make_shared<MessageQueue>();
+        auto& state = getState();
+        std::lock_guard<std::mutex> lock(state.queuesMutex);
+        state.queues.push_back(tlsQueue.pQueue);
     }
+    return *tlsQueue.pQueue;
+}
+
+void enqueue(LogEntry&& entry)
+{
+    auto& state = getState();
+    entry.sequence = state.sequence.fetch_add(1, std::memory_order_relaxed);
+
+    if (!state.writerActive.load(std::memory_order_acquire) && !startWriter())
+    {
+        // Logging is synchronous during static destruction.
+        std::lock_guard<std::mutex> lock(state.outputMutex);
+        writeQueuedMessages(false);
+        writeEntry(entry);
+        writeQueuedMessages(true);
+        return;
+    }
+
+    MessageQueue& queue = getThreadQueue();
+    const Logger::Level level = entry.level;
+    while (!queue.push(std::move(entry)))
+    {
+        // Drop debug and info messages when the queue is full, wait for the writer otherwise.
+        // The writer thread itself never waits on its own queue.
+        if (level > Logger::Level::Warning || tlsIsWriterThread)
+        {
+            state.droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        state.writerCondition.notify_one();
+        std::this_thread::yield();
+    }
+
+    // Make sure errors are written before returning, e.g. in case the application terminates.
+    if (level <= Logger::Level::Error)
+        Logger::flush();
+}
+
+/// Writes the pending messages and stops the writer thread at exit if shutdown() was not called.
+struct ExitGuard
+{
+    ~ExitGuard()
+    {
+        getState().exiting.store(true);
+        Logger::shutdown();
+    }
+} sExitGuard;
+} // namespace
+
+void Logger::shutdown()
+{
+    stopWriter();
+
+    auto& state = getState();
+    std::lock_guard<std::mutex> lock(state.outputMutex);
+    writeQueuedMessages(true);
+    closeLogFile();
+}
+
+bool Logger::isEnabled(Level level)
+{
+    return level <= getState().verbosity.load(std::memory_order_relaxed);
+}
+
+void Logger::log(Level level, const std::string_view msg, Frequency frequency)
+{
+    if (!isEnabled(level))
+        return;
+
+    LogEntry entry;
+    entry.level = level;
+    entry.frequency = frequency;
+    entry.msg = std::string(msg);
+    enqueue(std::move(entry));
+}
+
+void Logger::logDeferred(Level level, std::string format, fmt::dynamic_format_arg_store<fmt::format_context>&& args, Frequency frequency)
+{
+    if (!isEnabled(level))
+        return;
+
+    LogEntry entry;
+    entry.level = level;
+    entry.frequency = frequency;
+    entry.msg = std::move(format);
+    entry.args = std::move(args);
+    enqueue(std::move(entry));
+}
+
+void Logger::flush()
+{
+    auto& state = getState();
+    if (tlsIsWriterThread)
+        return;
+
+    std::unique_lock<std::mutex> lock(state.writerMutex);
+    if (!state.writer.joinable())
+    {
+        lock.unlock();
+        std::lock_guard<std::mutex> outputLock(state.outputMutex);
+        writeQueuedMessages(false);
+        return;
+    }
+
+    const uint64_t request = ++state.flushRequested;
+    state.writerCondition.notify_one();
+    state.flushCondition.wait(lock, [&]() { return state.flushCompleted >= request || !state.writer.joinable(); });
+}
+
+uint64_t Logger::getDroppedMessageCount()
+{
+    return getState().droppedCount.load(std::memory_order_relaxed);
 }
 
 void Logger::setVerbosity(Level level)
 {
-    std::lock_guard<std::mutex> lock(sMutex);
-    sVerbosity = level;
+    getState().verbosity.store(level, std::memory_order_relaxed);
 }
 
 Logger::Level Logger::getVerbosity()
 {
-    std::lock_guard<std::mutex> lock(sMutex);
-    return sVerbosity;
+    return getState().verbosity.load(std::memory_order_relaxed);
 }
 
 void Logger::setOutputs(OutputFlags outputs)
 {
-    std::lock_guard<std::mutex> lock(sMutex);
-    sOutputs = outputs;
+    // Write the pending messages to the previous outputs.
+    flush();
+    auto& state = getState();
+    std::lock_guard<std::mutex> lock(state.outputMutex);
+    state.outputs = outputs;
 }
 
 Logger::OutputFlags Logger::getOutputs()
 {
-    std::lock_guard<std::mutex> lock(sMutex);
-    return sOutputs;
+    auto& state = getState();
+    std::lock_guard<std::mutex> lock(state.outputMutex);
+    return state.outputs;
 }
 
 void Logger::setLogFilePath(const std::filesystem::path& path)
 {
-    std::lock_guard<std::mutex> lock(sMutex);
-    if (sLogFile)
-    {
-        fclose(sLogFile);
-        sLogFile = nullptr;
-        sInitialized = false;
-    }
-    sLogFilePath = path;
+    // Write the pending messages to the previous log file.
+    flush();
+    auto& state = getState();
+    std::lock_guard<std::mutex> lock(state.outputMutex);
+    closeLogFile();
+    state.logFilePath = path;
 }
 
 std::filesystem::path Logger::getLogFilePath()
 {
-    std::lock_guard<std::mutex> lock(sMutex);
-    return sLogFilePath;
+    auto& state = getState();
+    std::lock_guard<std::mutex> lock(state.outputMutex);
+    return state.logFilePath;
 }
 
 FALCOR_SCRIPT_BINDING(Logger)
@@ -262,6 +670,7 @@ FALCOR_SCRIPT_BINDING(Logger)
         "level"_a,
         "msg"_a
     );
+    logger.def_static("flush", &Logger::flush);
 }
 
 } // namespace Falcor
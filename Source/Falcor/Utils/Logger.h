@@ -29,14 +29,23 @@
 #include "Core/Macros.h"
 #include "Utils/StringFormatters.h"
 #include <fmt/core.h>
+#include <fmt/args.h>
+#include <cstdint>
+#include <string>
 #include <string_view>
 #include <filesystem>
+#include <type_traits>
 
 namespace Falcor
 {
 /**
  * Container class for logging messages.
  * Messages are only printed to the selected outputs if they match the verbosity level.
+ *
+ * Logging is asynchronous. Each thread pushes its messages to its own lock-free queue and a background writer
+ * thread formats and writes them to the outputs. Fatal and error messages are flushed before returning.
+ * When a queue is full, debug and info messages are dropped while warnings and errors wait for the writer.
+ * Identical warning, info and debug messages repeated too often are suppressed and reported in a summary.
  */
 class FALCOR_API Logger
 {
@@ -69,7 +78,7 @@ public:
     };
 
     /**
-     * Shutdown the logger and close the log file.
+     * Shutdown the logger, write the pending messages and close the log file.
      */
     static void shutdown();
 
@@ -109,6 +118,13 @@ public:
      */
     static std::filesystem::path getLogFilePath();
 
+    /**
+     * Check if messages of a given level pass the verbosity level.
+     * @param[in] level Log level.
+     * @return Returns true if messages of this level are logged.
+     */
+    static bool isEnabled(Level level);
+
     /**
      * Log a message.
      * @param[in] level Log level.
@@ -116,15 +132,81 @@ public:
      */
     static void log(Level level, const std::string_view msg, Frequency frequency = Frequency::Always);
 
+    /**
+     * Log a message formatted on the writer thread.
+     * @param[in] level Log level.
+     * @param[in] format Format string.
+     * @param[in] args Format arguments. They must own their data as they are formatted after the call returns.
+     */
+    static void logDeferred(
+        Level level,
+        std::string format,
+        fmt::dynamic_format_arg_store<fmt::format_context>&& args,
+        Frequency frequency = Frequency::Always
+    );
+
+    /**
+     * Block until all messages logged before the call are written to the outputs.
+     */
+    static void flush();
+
+    /**
+     * Get the number of messages dropped because the message queue of their thread was full.
+     * @return Returns the number of dropped messages since startup.
+     */
+    static uint64_t getDroppedMessageCount();
+
 private:
     Logger() = delete;
 };
 
 FALCOR_ENUM_CLASS_OPERATORS(Logger::OutputFlags);
 
+namespace detail
+{
+/// Format arguments that can be copied into deferred log messages. Other types are formatted on the calling thread
+/// since they may reference data that changes before the writer thread formats the message.
+template<typename T>
+constexpr bool kIsDeferredLogArg = std::is_arithmetic_v<T> || std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+                                   std::is_same_v<T, const char*> || std::is_same_v<T, char*> || std::is_same_v<T, std::filesystem::path>;
+
+template<typename T>
+inline auto toDeferredLogArg(const T& arg)
+{
+    // The arg store doesn't copy string views, all strings are copied here.
+    if constexpr (std::is_arithmetic_v<T>)
+        return arg;
+    else if constexpr (std::is_same_v<T, std::filesystem::path>)
+        return arg.string();
+    else
+        return std::string(arg);
+}
+
+template<typename... Args>
+inline void logFormatted(Logger::Level level, Logger::Frequency frequency, fmt::format_string<Args...> format, Args&&... args)
+{
+    // Skip the formatting altogether for messages filtered by the verbosity level.
+    if (!Logger::isEnabled(level))
+        return;
+
+    if constexpr ((kIsDeferredLogArg<std::decay_t<Args>> && ...))
+    {
+        fmt::dynamic_format_arg_store<fmt::format_context> store;
+        (store.push_back(toDeferredLogArg<std::decay_t<Args>>(args)), ...);
+        const fmt::string_view formatView = format;
+        Logger::logDeferred(level, std::string(formatView.data(), formatView.size()), std::move(store), frequency);
+    }
+    else
+    {
+        Logger::log(level, fmt::format(format, std::forward<Args>(args)...), frequency);
+    }
+}
+} // namespace detail
+
 // We define two types of logging helpers, one taking raw strings,
 // the other taking formatted strings. We don't want string formatting and
 // errors being thrown due to missing arguments when passing raw strings.
+// Formatted messages are formatted on the writer thread when all their arguments can be copied.
 
 inline void logDebug(const std::string_view msg)
 {
@@ -134,7 +216,7 @@ inline void logDebug(const std::string_view msg)
 template<typename... Args>
 inline void logDebug(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Debug, fmt::format(format, std::forward<Args>(args)...));
+    detail::logFormatted(Logger::Level::Debug, Logger::Frequency::Always, format, std::forward<Args>(args)...);
 }
 
 inline void logInfo(const std::string_view msg)
@@ -145,7 +227,7 @@ inline void logInfo(const std::string_view msg)
 template<typename... Args>
 inline void logInfo(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Info, fmt::format(format, std::forward<Args>(args)...));
+    detail::logFormatted(Logger::Level::Info, Logger::Frequency::Always, format, std::forward<Args>(args)...);
 }
 
 inline void logWarning(const std::string_view msg)
@@ -156,7 +238,7 @@ inline void logWarning(const std::string_view msg)
 template<typename... Args>
 inline void logWarning(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Warning, fmt::format(format, std::forward<Args>(args)...));
+    detail::logFormatted(Logger::Level::Warning, Logger::Frequency::Always, format, std::forward<Args>(args)...);
 }
 
 inline void logWarningOnce(const std::string_view msg)
@@ -167,7 +249,7 @@ inline void logWarningOnce(const std::string_view msg)
 template<typename... Args>
 inline void logWarningOnce(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Warning, fmt::format(format, std::forward<Args>(args)...), Logger::Frequency::Once);
+    detail::logFormatted(Logger::Level::Warning, Logger::Frequency::Once, format, std::forward<Args>(args)...);
 }
 
 inline void logError(const std::string_view msg)
@@ -178,7 +260,7 @@ inline void logError(const std::string_view msg)
 template<typename... Args>
 inline void logError(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Error, fmt::format(format, std::forward<Args>(args)...));
+    detail::logFormatted(Logger::Level::Error, Logger::Frequency::Always, format, std::forward<Args>(args)...);
 }
 
 inline void logErrorOnce(const std::string_view msg)
@@ -189,7 +271,7 @@ inline void logErrorOnce(const std::string_view msg)
 template<typename... Args>
 inline void logErrorOnce(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Error, fmt::format(format, std::forward<Args>(args)...), Logger::Frequency::Once);
+    detail::logFormatted(Logger::Level::Error, Logger::Frequency::Once, format, std::forward<Args>(args)...);
 }
 
 inline void logFatal(const std::string_view msg)
@@ -200,7 +282,7 @@ inline void logFatal(const std::string_view msg)
 template<typename... Args>
 inline void logFatal(fmt::format_string<Args...> format, Args&&... args)
 {
-    Logger::log(Logger::Level::Fatal, fmt::format(format, std::forward<Args>(args)...));
+    detail::logFormatted(Logger::Level::Fatal, Logger::Frequency::Always, format, std::forward<Args>(args)...);
 }
 
 } // namespace Falcor
@@ -33,6 +33,41 @@
 namespace Falcor
 {
 
+///////////////////////////////////////////////////////////////////////////////
+//                              8-bit unorm
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Convert float value to 8-bit unorm.
+ * Values outside [0,1] are clamped and NaN is encoded as zero.
+ * @return 8-bit unorm in low bits, high bits all zeros.
+ */
+inline uint packUnorm8(float v)
+{
+    v = math::isnan(v) ? 0.f : math::min(math::max(v, 0.f), 1.f);
+    return (uint)math::trunc(v * 255.f + 0.5f);
+}
+
+/**
+ * Pack four floats into 8-bit unorm values.
+ * Values outside [0,1] are clamped and NaN is encoded as zero.
+ * @return Packed 8-bit unorm values.
+ */
+inline uint packUnorm4x8(float4 v)
+{
+    return (packUnorm8(v.w) << 24) | (packUnorm8(v.z) << 16) | (packUnorm8(v.y) << 8) | packUnorm8(v.x);
+}
+
+/**
+ * Unpack four 8-bit unorm values.
+ * @param[in] packed 8-bit unorm values.
+ * @return Four float values in [0,1].
+ */
+inline float4 unpackUnorm4x8(uint packed)
+{
+    return float4(float(packed & 0xff), float((packed >> 8) & 0xff), float((packed >> 16) & 0xff), float(packed >> 24)) * (1.f / 255);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //                              16-bit snorm
 ///////////////////////////////////////////////////////////////////////////////
@@ -90,4 +125,35 @@ inline uint packSnorm2x16(float2 v)
     return (floatToSnorm16(v.x) & 0x0000ffff) | (floatToSnorm16(v.y) << 16);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// 32-bit HDR color format
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Pack three positive floats into a dword.
+ * https://github.com/microsoft/DirectX-Graphics-Samples/blob/master/MiniEngine/Core/Shaders/PixelPacking_R11G11B10.hlsli
+ */
+inline uint packR11G11B10(float3 v)
+{
+    // Clamp upper bound so that it doesn't accidentally round up to INF
+    v = math::min(v, float3(math::asfloat(0x477C0000u)));
+    // Exponent=15, Mantissa=1.11111
+    uint r = ((math::f32tof16(v.x) + 8) >> 4) & 0x000007ff;
+    uint g = ((math::f32tof16(v.y) + 8) << 7) & 0x003ff800;
+    uint b = ((math::f32tof16(v.z) + 16) << 17) & 0xffc00000;
+    return r | g | b;
+}
+
+/**
+ * Unpack three positive floats from a dword.
+ * https://github.com/microsoft/DirectX-Graphics-Samples/blob/master/MiniEngine/Core/Shaders/PixelPacking_R11G11B10.hlsli
+ */
+inline float3 unpackR11G11B10(uint packed)
+{
+    float r = math::f16tof32((packed << 4) & 0x7FF0);
+    float g = math::f16tof32((packed >> 7) & 0x7FF0);
+    float b = math::f16tof32((packed >> 17) & 0x7FE0);
+    return float3(r, g, b);
+}
+
 } // namespace Falcor
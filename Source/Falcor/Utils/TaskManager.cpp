@@ -26,21 +26,26 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TaskManager.h"
+#include "Utils/Timing/Tracer.h"
 
 namespace Falcor
 {
 
-TaskManager::TaskManager(bool startPaused)
-{
-    if (startPaused)
-        mThreadPool.pause();
-}
+TaskManager::TaskManager(bool startPaused) : mPaused(startPaused) {}
 
 void TaskManager::addTask(CpuTask&& task)
 {
     std::lock_guard<std::mutex> l(mTaskMutex);
     ++mCurrentlyScheduled;
-    mThreadPool.push_task(
+    if (mPaused)
+        mPausedCpuTasks.push_back(std::move(task));
+    else
+        submitCpuTask(std::move(task));
+}
+
+void TaskManager::submitCpuTask(CpuTask&& task)
+{
+    auto job = JobSystem::getGlobal().submit(
         [task = std::move(task), this]() mutable
         {
             ++mCurrentlyRunning;
@@ -49,9 +54,14 @@ void TaskManager::addTask(CpuTask&& task)
             size_t running = --mCurrentlyRunning;
             // If nothing is running, lets wake up and try to exit.
             if (running == 0)
+            {
+                // Lock so that finish() can't miss the notification between its check and its wait.
+                std::lock_guard<std::mutex> l(mTaskMutex);
                 mGpuTaskCond.notify_all();
+            }
         }
     );
+    mCpuJobs.push_back(std::move(job));
 }
 
 void TaskManager::addTask(GpuTask&& task)
@@ -64,7 +74,14 @@ void TaskManager::addTask(GpuTask&& task)
 
 void TaskManager::finish(RenderContext* renderContext)
 {
-    mThreadPool.unpause();
+    {
+        std::lock_guard<std::mutex> l(mTaskMutex);
+        mPaused = false;
+        for (auto& task : mPausedCpuTasks)
+            submitCpuTask(std::move(task));
+        mPausedCpuTasks.clear();
+    }
+
     while (true)
     {
         while (true)
@@ -77,7 +94,10 @@ void TaskManager::finish(RenderContext* renderContext)
             l.unlock();
             ++mCurrentlyRunning;
             --mCurrentlyScheduled;
-            task(renderContext);
+            {
+                FALCOR_TRACE_SCOPE("TaskManager::gpuTask");
+                task(renderContext);
+            }
             --mCurrentlyRunning;
         }
 
@@ -97,6 +117,15 @@ void TaskManager::finish(RenderContext* renderContext)
         if (mCurrentlyRunning == 0 && mCurrentlyScheduled == 0)
             break;
     }
+
+    // The jobs may still be returning after their last notification.
+    std::vector<JobSystem::JobHandle> jobs;
+    {
+        std::lock_guard<std::mutex> l(mTaskMutex);
+        jobs.swap(mCpuJobs);
+    }
+    JobSystem::getGlobal().wait(jobs);
+
     rethrowException();
 }
 
@@ -115,6 +144,7 @@ void TaskManager::rethrowException()
 
 void TaskManager::executeCpuTask(CpuTask&& task)
 {
+    FALCOR_TRACE_SCOPE("TaskManager::cpuTask");
     try
     {
         task();
@@ -28,8 +28,7 @@
 #pragma once
 
 #include "Core/Macros.h"
-
-#include <BS_thread_pool/BS_thread_pool.hpp>
+#include "Utils/JobSystem.h"
 
 #include <functional>
 #include <mutex>
@@ -50,7 +49,7 @@ public:
 public:
     TaskManager(bool startPaused = false);
 
-    /// Adds a CPU only task to the manager, if unpaused, the task starts right away
+    /// Adds a CPU only task to the manager, if unpaused, the task starts right away on the global job system
     void addTask(CpuTask&& task);
     /// Adds a GPU task to the manager, GPU tasks only start in the finish call and are sequential
     void addTask(GpuTask&& task);
@@ -67,9 +66,13 @@ private:
     void rethrowException();
     /// CPU task execution wrapped so it stores exception if the task throws
     void executeCpuTask(CpuTask&& task);
+    /// Submits a CPU task to the global job system
+    void submitCpuTask(CpuTask&& task);
 
 private:
-    BS::thread_pool mThreadPool;
+    bool mPaused;
+    std::vector<CpuTask> mPausedCpuTasks; ///< CPU tasks added while paused, submitted by finish().
+    std::vector<JobSystem::JobHandle> mCpuJobs;
     std::atomic_size_t mCurrentlyRunning{0};
     std::atomic_size_t mCurrentlyScheduled{0};
 
@@ -27,6 +27,9 @@
  **************************************************************************/
 #include "Threading.h"
 #include "Core/Error.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <vector>
 
 namespace Falcor
 {
@@ -34,71 +37,81 @@ namespace
 {
 struct ThreadingData
 {
-    bool initialized = false;
-    std::vector<std::thread> threads;
-    uint32_t current;
+    std::mutex mutex;
+    uint32_t initCount = 0;
+    std::vector<JobSystem::JobHandle> tasks; ///< Dispatched tasks not known to be finished.
 } gData; // TODO: REMOVEGLOBAL
 } // namespace
 
-static std::mutex sThreadingInitMutex;
-static uint32_t sThreadingInitCount = 0;
-
-void Threading::start(uint32_t threadCount)
+void Threading::start()
 {
-    std::lock_guard<std::mutex> lock(sThreadingInitMutex);
-    if (sThreadingInitCount++ == 0)
-    {
-        gData.threads.resize(threadCount);
-        gData.initialized = true;
-    }
+    std::lock_guard<std::mutex> lock(gData.mutex);
+    if (gData.initCount++ == 0)
+        JobSystem::getGlobal(); // Create the worker threads up front.
 }
 
 void Threading::shutdown()
 {
-    std::lock_guard<std::mutex> lock(sThreadingInitMutex);
-    uint32_t count = sThreadingInitCount--;
-    if (count == 1)
+    uint32_t count;
     {
-        for (auto& t : gData.threads)
-            if (t.joinable())
-                t.join();
-        gData.initialized = false;
+        std::lock_guard<std::mutex> lock(gData.mutex);
+        count = gData.initCount;
+        if (count > 0)
+            --gData.initCount;
     }
+
+    if (count == 1)
+        finish();
     else if (count == 0)
-        FALCOR_THROW("Threading::stop() called more times than Threading::start().");
+        FALCOR_THROW("Threading::shutdown() called more times than Threading::start().");
 }
 
-Threading::Task Threading::dispatchTask(const std::function<void(void)>& func)
+Threading::Task Threading::dispatchTask(const std::function<void(void)>& func, JobSystem::Priority priority)
 {
-    FALCOR_ASSERT(gData.initialized);
+    JobSystem::JobHandle handle = JobSystem::getGlobal().submit(func, priority);
+
+    std::lock_guard<std::mutex> lock(gData.mutex);
+    FALCOR_ASSERT(gData.initCount > 0);
 
-    std::thread& t = gData.threads[gData.current];
-    if (t.joinable())
-        t.join();
-    t = std::thread(func);
-    gData.current = (gData.current + 1) % gData.threads.size();
+    // Drop the finished tasks so that the list doesn't grow with long running applications.
+    auto& tasks = gData.tasks;
+    tasks.erase(std::remove_if(tasks.begin(), tasks.end(), [](const JobSystem::JobHandle& task) { return task.isDone(); }), tasks.end());
+    tasks.push_back(handle);
 
-    return Task();
+    return Task(handle);
 }
 
 void Threading::finish()
 {
-    for (auto& t : gData.threads)
+    std::vector<JobSystem::JobHandle> tasks;
+    {
+        std::lock_guard<std::mutex> lock(gData.mutex);
+        tasks.swap(gData.tasks);
+    }
+
+    // Exceptions of fire-and-forget tasks are only reported through their handle.
+    for (const auto& task : tasks)
     {
-        if (t.joinable())
-            t.join();
+        try
+        {
+            JobSystem::getGlobal().wait(task);
+        }
+        catch (const std::exception& e)
+        {
+            logError("Threading task failed: {}", e.what());
+        }
     }
 }
 
-Threading::Task::Task() {}
+Threading::Task::Task(JobSystem::JobHandle handle) : mHandle(std::move(handle)) {}
 
 bool Threading::Task::isRunning()
 {
-    FALCOR_UNIMPLEMENTED();
+    return !mHandle.isDone();
 }
 
 void Threading::Task::finish()
 {
-    FALCOR_UNIMPLEMENTED();
+    JobSystem::getGlobal().wait(mHandle);
 }
 } // namespace Falcor
@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Core/Macros.h"
+#include "Utils/JobSystem.h"
 #include <condition_variable>
 #include <functional>
 #include <mutex>
@@ -35,43 +36,43 @@
 
 namespace Falcor
 {
+/**
+ * Fire-and-forget tasks on the global job system (see JobSystem::getGlobal()).
+ * start() and shutdown() are reference counted, the last shutdown() waits for all dispatched tasks.
+ */
 class FALCOR_API Threading
 {
 public:
-    const static uint32_t kDefaultThreadCount = 16;
-
     /**
      * Handle to a dispatched task
-     *
-     * TODO: Implementation
      */
-    class Task
+    class FALCOR_API Task
     {
     public:
         ///  Check if task is still executing
         bool isRunning();
 
-        /// Wait for task to finish executing
+        /// Wait for task to finish executing. Rethrows the exception thrown by the task, if any.
         void finish();
 
     private:
-        Task();
+        Task(JobSystem::JobHandle handle);
+        JobSystem::JobHandle mHandle;
         friend class Threading;
     };
 
     /**
-     * Initializes the global thread pool
-     * @param[in] threadCount Number of threads in the pool
+     * Starts using the global job system
      */
-    static void start(uint32_t threadCount = kDefaultThreadCount);
+    static void start();
 
     /**
-     * Waits for all currently executing threads to finish
+     * Waits for all dispatched tasks to finish
      */
     static void finish();
 
     /**
-     * Waits for all currently executing threads to finish and shuts down the thread pool
+     * Waits for all dispatched tasks to finish and stops using the global job system
      */
     static void shutdown();
 
@@ -81,10 +82,10 @@ public:
     static uint32_t getLogicalThreadCount() { return std::thread::hardware_concurrency(); }
 
     /**
-     * Starts a task on an available thread.
+     * Starts a task on the global job system.
      * @return Handle to the task
      */
-    static Task dispatchTask(const std::function<void(void)>& func);
+    static Task dispatchTask(const std::function<void(void)>& func, JobSystem::Priority priority = JobSystem::Priority::Low);
 };
 
 /**
@@ -0,0 +1,81 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FrameTimeController.h"
+#include "Core/Error.h"
+#include <algorithm>
+
+namespace Falcor
+{
+FrameTimeController::FrameTimeController() : FrameTimeController(Options()) {}
+
+FrameTimeController::FrameTimeController(const Options& options) : mOptions(options)
+{
+    FALCOR_CHECK(mOptions.targetTimeMs > 0.f, "Target frame time must be positive.");
+    FALCOR_CHECK(
+        mOptions.minScale > 0.f && mOptions.minScale <= mOptions.maxScale, "Invalid scale range [{}, {}].", mOptions.minScale, mOptions.maxScale
+    );
+    FALCOR_CHECK(mOptions.smoothing >= 0.f && mOptions.smoothing < 1.f, "Smoothing must be in [0,1).");
+
+    reset();
+}
+
+float FrameTimeController::update(float frameTimeMs)
+{
+    if (!(frameTimeMs > 0.f))
+        return mScale;
+
+    mFilteredTimeMs = mUpdateCount == 0 ? frameTimeMs : mOptions.smoothing * mFilteredTimeMs + (1.f - mOptions.smoothing) * frameTimeMs;
+
+    // Positive error means there is headroom to increase the workload.
+    const float error = (mOptions.targetTimeMs - mFilteredTimeMs) / mOptions.targetTimeMs;
+    const float derivative = mUpdateCount == 0 ? 0.f : error - mPrevError;
+    mPrevError = error;
+    mUpdateCount++;
+
+    auto computeOutput = [&](float integral)
+    { return mOptions.initialScale + mOptions.kp * error + mOptions.ki * integral + mOptions.kd * derivative; };
+
+    // Only integrate while the output is within bounds or when the error drives it back into bounds.
+    const float integral = mIntegral + error;
+    const float output = computeOutput(integral);
+    if ((output <= mOptions.maxScale || error < 0.f) && (output >= mOptions.minScale || error > 0.f))
+        mIntegral = integral;
+
+    mScale = std::clamp(computeOutput(mIntegral), mOptions.minScale, mOptions.maxScale);
+    return mScale;
+}
+
+void FrameTimeController::reset()
+{
+    mScale = std::clamp(mOptions.initialScale, mOptions.minScale, mOptions.maxScale);
+    mFilteredTimeMs = 0.f;
+    mIntegral = 0.f;
+    mPrevError = 0.f;
+    mUpdateCount = 0;
+}
+} // namespace Falcor
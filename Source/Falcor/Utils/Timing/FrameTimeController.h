@@ -0,0 +1,89 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * PID controller scaling a rendering workload to hit a target frame time.
+ *
+ * Each frame the measured frame time is compared to the target, and the controller outputs a scale for the
+ * workload (e.g. the number of samples per pixel). The error is normalized by the target, so the gains
+ * don't depend on the frame time range. The integral term is only accumulated while the output is not
+ * saturated (conditional integration), so the controller recovers as soon as the load changes after
+ * hitting a bound. The controller has no other state than its inputs, so replaying a recorded timing
+ * trace always produces the same outputs.
+ */
+class FALCOR_API FrameTimeController
+{
+public:
+    struct Options
+    {
+        float targetTimeMs = 16.6f;     ///< Frame time to converge to.
+        float kp = 0.4f;                ///< Proportional gain.
+        float ki = 0.1f;                ///< Integral gain.
+        float kd = 0.05f;               ///< Derivative gain.
+        float minScale = 0.25f;         ///< Lowest workload scale.
+        float maxScale = 2.f;           ///< Highest workload scale.
+        float initialScale = 1.f;       ///< Scale before the first measurement and bias of the controller.
+        float smoothing = 0.5f;         ///< Weight of the previous filtered frame time in [0,1), 0 disables filtering.
+    };
+
+    FrameTimeController();
+    FrameTimeController(const Options& options);
+
+    /**
+     * Update the controller with the frame time measured for the last frame.
+     * Non-positive frame times, e.g. while the profiler has no measurement yet, are ignored.
+     * @param[in] frameTimeMs Measured frame time in milliseconds.
+     * @return The workload scale for the next frame.
+     */
+    float update(float frameTimeMs);
+
+    /**
+     * Reset the controller to its initial state.
+     */
+    void reset();
+
+    float getScale() const { return mScale; }
+    float getFilteredTimeMs() const { return mFilteredTimeMs; }
+    uint32_t getUpdateCount() const { return mUpdateCount; }
+    const Options& getOptions() const { return mOptions; }
+
+private:
+    Options mOptions;
+
+    float mScale;
+    float mFilteredTimeMs = 0.f;
+    float mIntegral = 0.f;
+    float mPrevError = 0.f;
+    uint32_t mUpdateCount = 0;
+};
+} // namespace Falcor
@@ -0,0 +1,185 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "HdrHistogram.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+/// Number of bits needed to represent the value (0 for 0).
+int32_t getBitLength(uint64_t value)
+{
+    int32_t length = 0;
+    while (value != 0)
+    {
+        value >>= 1;
+        ++length;
+    }
+    return length;
+}
+} // namespace
+
+HdrHistogram::HdrHistogram(uint64_t lowestTrackableValue, uint64_t highestTrackableValue, uint32_t significantDigits)
+    : mLowestTrackableValue(lowestTrackableValue), mHighestTrackableValue(highestTrackableValue), mSignificantDigits(significantDigits)
+{
+    FALCOR_CHECK(lowestTrackableValue >= 1, "Lowest trackable value must be >= 1.");
+    FALCOR_CHECK(significantDigits >= 1 && significantDigits <= 5, "Significant digits must be in [1, 5].");
+    FALCOR_CHECK(
+        highestTrackableValue >= 2 * lowestTrackableValue, "Highest trackable value must be >= 2 * lowest trackable value."
+    );
+
+    // Each power-of-two bucket is split into enough linear sub-buckets to resolve the requested number of digits.
+    const uint64_t largestValueWithSingleUnitResolution = 2 * (uint64_t)std::pow(10.0, significantDigits);
+    const int32_t subBucketCountMagnitude = getBitLength(largestValueWithSingleUnitResolution - 1);
+    mSubBucketHalfCountMagnitude = std::max(subBucketCountMagnitude, 1) - 1;
+    mUnitMagnitude = getBitLength(lowestTrackableValue) - 1;
+    const uint64_t subBucketCount = uint64_t(1) << (mSubBucketHalfCountMagnitude + 1);
+    mSubBucketHalfCount = subBucketCount / 2;
+    mSubBucketMask = (subBucketCount - 1) << mUnitMagnitude;
+
+    FALCOR_CHECK(mUnitMagnitude + mSubBucketHalfCountMagnitude + 1 < 62, "Trackable range and precision are too large.");
+
+    // Determine the number of buckets needed to cover the highest trackable value.
+    uint64_t smallestUntrackableValue = subBucketCount << mUnitMagnitude;
+    size_t bucketCount = 1;
+    while (smallestUntrackableValue <= highestTrackableValue)
+    {
+        if (smallestUntrackableValue > (UINT64_MAX >> 1))
+        {
+            ++bucketCount;
+            break;
+        }
+        smallestUntrackableValue <<= 1;
+        ++bucketCount;
+    }
+
+    mCounts.resize((bucketCount + 1) * mSubBucketHalfCount, 0);
+}
+
+size_t HdrHistogram::getCountsIndex(uint64_t value) const
+{
+    const int32_t bucketIndex = getBitLength(value | mSubBucketMask) - (mUnitMagnitude + mSubBucketHalfCountMagnitude + 1);
+    const uint64_t subBucketIndex = value >> (bucketIndex + mUnitMagnitude);
+    return ((size_t)(bucketIndex + 1) << mSubBucketHalfCountMagnitude) + (size_t)(subBucketIndex - mSubBucketHalfCount);
+}
+
+uint64_t HdrHistogram::getValueFromIndex(size_t index) const
+{
+    int32_t bucketIndex = (int32_t)(index >> mSubBucketHalfCountMagnitude) - 1;
+    uint64_t subBucketIndex = (index & (mSubBucketHalfCount - 1)) + mSubBucketHalfCount;
+    if (bucketIndex < 0)
+    {
+        subBucketIndex -= mSubBucketHalfCount;
+        bucketIndex = 0;
+    }
+    return subBucketIndex << (bucketIndex + mUnitMagnitude);
+}
+
+uint64_t HdrHistogram::getLowestEquivalentValue(uint64_t value) const
+{
+    return getValueFromIndex(getCountsIndex(value));
+}
+
+uint64_t HdrHistogram::getHighestEquivalentValue(uint64_t value) const
+{
+    const size_t index = getCountsIndex(value);
+    return getValueFromIndex(index + 1) - 1;
+}
+
+void HdrHistogram::record(uint64_t value, uint64_t count)
+{
+    if (count == 0)
+        return;
+
+    mTotalCount += count;
+    mSum += (double)value * count;
+    mMin = std::min(mMin, value);
+    mMax = std::max(mMax, value);
+
+    if (value > mHighestTrackableValue)
+    {
+        mClampedCount += count;
+        value = mHighestTrackableValue;
+    }
+    mCounts[getCountsIndex(value)] += count;
+}
+
+void HdrHistogram::merge(const HdrHistogram& other)
+{
+    FALCOR_CHECK(
+        mLowestTrackableValue == other.mLowestTrackableValue && mHighestTrackableValue == other.mHighestTrackableValue &&
+            mSignificantDigits == other.mSignificantDigits,
+        "Histograms must have the same configuration to be merged."
+    );
+
+    for (size_t i = 0; i < mCounts.size(); ++i)
+        mCounts[i] += other.mCounts[i];
+    mTotalCount += other.mTotalCount;
+    mClampedCount += other.mClampedCount;
+    mSum += other.mSum;
+    mMin = std::min(mMin, other.mMin);
+    mMax = std::max(mMax, other.mMax);
+}
+
+void HdrHistogram::reset()
+{
+    std::fill(mCounts.begin(), mCounts.end(), 0);
+    mTotalCount = 0;
+    mClampedCount = 0;
+    mSum = 0.0;
+    mMin = UINT64_MAX;
+    mMax = 0;
+}
+
+uint64_t HdrHistogram::getValueAtPercentile(double percentile) const
+{
+    if (mTotalCount == 0)
+        return 0;
+
+    const double clampedPercentile = std::clamp(percentile, 0.0, 100.0);
+    const uint64_t countAtPercentile =
+        std::clamp<uint64_t>((uint64_t)std::llround(clampedPercentile / 100.0 * mTotalCount), 1, mTotalCount);
+
+    // Clamp the bucket value to the recorded range so that e.g. the 100th percentile is the maximum.
+    const uint64_t maxValue = std::min(mMax, mHighestTrackableValue);
+    const uint64_t minValue = std::min(mMin, maxValue);
+
+    uint64_t totalToCurrentIndex = 0;
+    for (size_t i = 0; i < mCounts.size(); ++i)
+    {
+        totalToCurrentIndex += mCounts[i];
+        if (totalToCurrentIndex >= countAtPercentile)
+            return std::clamp(getHighestEquivalentValue(getValueFromIndex(i)), minValue, maxValue);
+    }
+
+    return maxValue;
+}
+} // namespace Falcor
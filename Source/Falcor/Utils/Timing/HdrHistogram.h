@@ -0,0 +1,128 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * High dynamic range histogram for recording latency distributions in constant memory.
+ *
+ * Values are stored in log-linear buckets: each power-of-two range is divided into a fixed number of linear
+ * sub-buckets, so that all values in the trackable range are recorded with a relative error below
+ * 10^-significantDigits. Memory usage only depends on the trackable range and precision, not on the number
+ * of recorded values, which makes the histogram suitable for aggregating multi-hour runs.
+ * The layout follows the HdrHistogram algorithm by Gil Tene.
+ */
+class FALCOR_API HdrHistogram
+{
+public:
+    /**
+     * Constructor.
+     * @param[in] lowestTrackableValue Smallest value that can be distinguished from 0 (>= 1).
+     * @param[in] highestTrackableValue Largest value that can be recorded. Larger values are clamped.
+     * @param[in] significantDigits Number of significant decimal digits to preserve (1-5).
+     */
+    HdrHistogram(uint64_t lowestTrackableValue, uint64_t highestTrackableValue, uint32_t significantDigits = 3);
+
+    /**
+     * Record a value.
+     * @param[in] value Value to record.
+     * @param[in] count Number of times to record the value.
+     */
+    void record(uint64_t value, uint64_t count = 1);
+
+    /**
+     * Add the values recorded in another histogram with the same configuration.
+     */
+    void merge(const HdrHistogram& other);
+
+    /**
+     * Remove all recorded values.
+     */
+    void reset();
+
+    /**
+     * Get the value at the given percentile.
+     * The returned value is the highest value equivalent to the recorded values at the percentile,
+     * clamped to the maximum recorded value.
+     * @param[in] percentile Percentile in [0, 100].
+     * @return The value, or 0 if no values have been recorded.
+     */
+    uint64_t getValueAtPercentile(double percentile) const;
+
+    /// Get the number of recorded values.
+    uint64_t getTotalCount() const { return mTotalCount; }
+
+    /// Get the smallest recorded value (exact), or 0 if no values have been recorded.
+    uint64_t getMin() const { return mTotalCount > 0 ? mMin : 0; }
+
+    /// Get the largest recorded value (exact, before clamping), or 0 if no values have been recorded.
+    uint64_t getMax() const { return mMax; }
+
+    /// Get the mean of the recorded values (exact, before clamping).
+    double getMean() const { return mTotalCount > 0 ? mSum / mTotalCount : 0.0; }
+
+    /// Get the number of values that were clamped to the highest trackable value.
+    uint64_t getClampedCount() const { return mClampedCount; }
+
+    /// Get the memory used by the bucket counts in bytes.
+    size_t getMemorySize() const { return mCounts.size() * sizeof(uint64_t); }
+
+    /// Check if two values fall into the same bucket.
+    bool isEquivalent(uint64_t a, uint64_t b) const { return getLowestEquivalentValue(a) == getLowestEquivalentValue(b); }
+
+    uint64_t getLowestTrackableValue() const { return mLowestTrackableValue; }
+    uint64_t getHighestTrackableValue() const { return mHighestTrackableValue; }
+    uint32_t getSignificantDigits() const { return mSignificantDigits; }
+
+private:
+    size_t getCountsIndex(uint64_t value) const;
+    uint64_t getValueFromIndex(size_t index) const;
+    uint64_t getLowestEquivalentValue(uint64_t value) const;
+    uint64_t getHighestEquivalentValue(uint64_t value) const;
+
+    uint64_t mLowestTrackableValue;
+    uint64_t mHighestTrackableValue;
+    uint32_t mSignificantDigits;
+
+    int32_t mUnitMagnitude = 0;
+    int32_t mSubBucketHalfCountMagnitude = 0;
+    uint64_t mSubBucketHalfCount = 0;
+    uint64_t mSubBucketMask = 0;
+
+    std::vector<uint64_t> mCounts;
+    uint64_t mTotalCount = 0;
+    uint64_t mClampedCount = 0;
+    uint64_t mMin = UINT64_MAX;
+    uint64_t mMax = 0;
+    double mSum = 0.0;
+};
+} // namespace Falcor
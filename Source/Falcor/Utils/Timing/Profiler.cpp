@@ -31,6 +31,9 @@
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
 
+#include <algorithm>
+#include <cmath>
+#include <fmt/format.h>
 #include <fstream>
 
 namespace Falcor
@@ -53,6 +56,9 @@ pybind11::dict toPython(const Profiler::Stats& stats)
     d["max"] = stats.max;
     d["mean"] = stats.mean;
     d["std_dev"] = stats.stdDev;
+    d["median"] = stats.median;
+    d["p95"] = stats.p95;
+    d["p99"] = stats.p99;
     return d;
 }
 
@@ -126,7 +132,12 @@ Profiler::Stats Profiler::Stats::compute(const float* data, size_t len)
     double variance = len > 1 ? std::max(mean2 - mean * mean, 0.0) : 0.0;
     double stdDev = std::sqrt(variance);
 
-    return {min, max, (float)mean, (float)stdDev};
+    // Percentiles using the nearest-rank method.
+    std::vector<float> sorted(data, data + len);
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) { return sorted[std::min((size_t)std::ceil(p * sorted.size()), sorted.size()) - 1]; };
+
+    return {min, max, (float)mean, (float)stdDev, percentile(0.5), percentile(0.95), percentile(0.99)};
 }
 
 // Profiler::Event
@@ -257,6 +268,26 @@ void Profiler::Capture::writeToFile(const std::filesystem::path& path) const
     ofs.write(json.data(), json.size());
 }
 
+std::string Profiler::Capture::toCsvString() const
+{
+    std::string csv = "name,frame_count,min,max,mean,std_dev,median,p95,p99\n";
+    for (const auto& lane : mLanes)
+    {
+        const Stats& s = lane.stats;
+        csv += fmt::format(
+            "{},{},{},{},{},{},{},{},{}\n", lane.name, lane.records.size(), s.min, s.max, s.mean, s.stdDev, s.median, s.p95, s.p99
+        );
+    }
+    return csv;
+}
+
+void Profiler::Capture::writeCsvToFile(const std::filesystem::path& path) const
+{
+    auto csv = toCsvString();
+    std::ofstream ofs(path);
+    ofs.write(csv.data(), csv.size());
+}
+
 Profiler::Capture::Capture(size_t reservedEvents, size_t reservedFrames) : mReservedFrames(reservedFrames)
 {
     // Speculativly allocate event record storage.
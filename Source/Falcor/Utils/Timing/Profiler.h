@@ -65,6 +65,9 @@ public:
         float max;
         float mean;
         float stdDev;
+        float median;
+        float p95;
+        float p99;
 
         static Stats compute(const float* data, size_t len);
     };
@@ -141,6 +144,12 @@ public:
         std::string toJsonString() const;
         void writeToFile(const std::filesystem::path& path) const;
 
+        /**
+         * Summary of the capture with one line of stats per lane, without the individual records.
+         */
+        std::string toCsvString() const;
+        void writeCsvToFile(const std::filesystem::path& path) const;
+
     private:
         void captureEvents(const std::vector<Event*>& events);
         void finalize();
@@ -152,12 +152,15 @@ void ProfilerUI::render()
                     auto stats = eventData.pEvent->computeCpuTimeStats();
                     ImGui::BeginTooltip();
                     ImGui::Text(
-                        "%s\nMin: %.2f\nMax: %.2f\nMean: %.2f\nStdDev: %.2f",
+                        "%s\nMin: %.2f\nMax: %.2f\nMean: %.2f\nStdDev: %.2f\nMedian: %.2f\nP95: %.2f\nP99: %.2f",
                         eventData.name.c_str(),
                         stats.min,
                         stats.max,
                         stats.mean,
-                        stats.stdDev
+                        stats.stdDev,
+                        stats.median,
+                        stats.p95,
+                        stats.p99
                     );
                     ImGui::EndTooltip();
                 }
@@ -194,12 +197,15 @@ void ProfilerUI::render()
                     auto stats = eventData.pEvent->computeGpuTimeStats();
                     ImGui::BeginTooltip();
                     ImGui::Text(
-                        "%s\nMin: %.2f\nMax: %.2f\nMean: %.2f\nStdDev: %.2f",
+                        "%s\nMin: %.2f\nMax: %.2f\nMean: %.2f\nStdDev: %.2f\nMedian: %.2f\nP95: %.2f\nP99: %.2f",
                         eventData.name.c_str(),
                         stats.min,
                         stats.max,
                         stats.mean,
-                        stats.stdDev
+                        stats.stdDev,
+                        stats.median,
+                        stats.p95,
+                        stats.p99
                     );
                     ImGui::EndTooltip();
                 }
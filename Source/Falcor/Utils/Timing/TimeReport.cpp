@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TimeReport.h"
+#include "Tracer.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
 #include <numeric>
@@ -65,6 +66,10 @@ void TimeReport::measure(const std::string& name)
 {
     auto currentTime = CpuTimer::getCurrentTimePoint();
     std::chrono::duration<double> duration = currentTime - mLastMeasureTime;
+#if FALCOR_ENABLE_TRACING
+    if (Tracer::isEnabled())
+        Tracer::recordDynamicComplete(name, Tracer::toTimestamp(mLastMeasureTime), Tracer::toTimestamp(currentTime));
+#endif
     mLastMeasureTime = currentTime;
     mMeasurements.push_back({name, duration.count()});
 }
@@ -37,6 +37,7 @@ namespace Falcor
 /**
  * Utility class to record a number of timing measurements and print them afterwards.
  * This is mainly intended for measuring longer running tasks on the CPU.
+ * Measurements are also recorded as trace events while the Tracer is enabled.
  */
 class FALCOR_API TimeReport
 {
@@ -0,0 +1,355 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Tracer.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/Scripting/ScriptBindings.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/**
+ * Per-thread event ring buffer.
+ * Only the owning thread writes events. When the buffer is full, the oldest event is overwritten.
+ * Writes follow a sequence lock protocol: the claim index is advanced before a slot is written and the
+ * write index is published with release semantics after it. Readers copy the events up to the write index
+ * and then discard the ones whose slots may have been overwritten during the copy, according to the claim index.
+ */
+struct ThreadBuffer
+{
+    ThreadBuffer(uint32_t threadId, size_t capacity) : threadId(threadId), events(capacity) {}
+
+    const uint32_t threadId;
+    std::string threadName; ///< Protected by TracerState::mutex.
+    bool exited = false;    ///< True once the owning thread has exited. Protected by TracerState::mutex.
+    std::vector<Tracer::Event> events;
+    std::atomic<uint64_t> claimIndex{0}; ///< One past the index of the event being written.
+    std::atomic<uint64_t> writeIndex{0}; ///< Events before this index are complete.
+    std::atomic<uint64_t> readStart{0};  ///< Events before this index have been cleared.
+
+    /// Number of events recorded since the last clear that have been overwritten.
+    uint64_t getOverwrittenCount() const
+    {
+        const uint64_t count = writeIndex.load(std::memory_order_acquire) - readStart.load(std::memory_order_acquire);
+        return count > events.size() ? count - events.size() : 0;
+    }
+};
+
+struct TracerState
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers; ///< Buffers of exited threads are kept until their events are cleared.
+    size_t bufferCapacity = Tracer::kDefaultBufferCapacity;
+    uint32_t nextThreadId = 1;
+};
+
+TracerState& getState()
+{
+    // Never destroyed, threads may exit and release their buffers during static destruction.
+    static TracerState* pState = new TracerState();
+    return *pState;
+}
+
+/// Remove the buffers matching a predicate. Must be called with TracerState::mutex held.
+template<typename Pred>
+void removeBuffers(TracerState& state, Pred pred)
+{
+    auto it = std::remove_if(state.buffers.begin(), state.buffers.end(), [&](const auto& pBuffer) { return pred(*pBuffer); });
+    state.buffers.erase(it, state.buffers.end());
+}
+
+thread_local ThreadBuffer* tpThreadBuffer = nullptr;
+
+/// Releases the buffer of a thread when the thread exits.
+/// The buffer is kept while it holds events, so that they can still be exported.
+struct ThreadBufferOwner
+{
+    ThreadBuffer* pBuffer = nullptr;
+
+    ~ThreadBufferOwner()
+    {
+        if (!pBuffer)
+            return;
+        TracerState& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        pBuffer->exited = true;
+        if (pBuffer->writeIndex.load(std::memory_order_relaxed) == pBuffer->readStart.load(std::memory_order_relaxed))
+            removeBuffers(state, [this](const ThreadBuffer& buffer) { return &buffer == pBuffer; });
+        tpThreadBuffer = nullptr;
+    }
+};
+
+thread_local ThreadBufferOwner tThreadBufferOwner;
+thread_local std::string tThreadName;
+
+ThreadBuffer& getThreadBuffer()
+{
+    if (!tpThreadBuffer)
+    {
+        TracerState& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.buffers.push_back(std::make_unique<ThreadBuffer>(state.nextThreadId++, state.bufferCapacity));
+        tpThreadBuffer = state.buffers.back().get();
+        tpThreadBuffer->threadName = tThreadName;
+        // The owner is only accessed here, so recording events doesn't go through its thread-local initialization.
+        tThreadBufferOwner.pBuffer = tpThreadBuffer;
+    }
+    return *tpThreadBuffer;
+}
+
+void copyDetail(Tracer::Event& event, std::string_view detail)
+{
+    size_t length = std::min(detail.size(), Tracer::kMaxDetailLength);
+    std::copy_n(detail.data(), length, event.detail);
+    event.detail[length] = '\0';
+}
+
+/**
+ * Copy the events of a thread buffer. Must be called with TracerState::mutex held, which keeps the read start fixed.
+ * Events whose slots were overwritten by the owning thread while copying are discarded.
+ * @return Number of events since the last clear that were overwritten.
+ */
+uint64_t copyEvents(const ThreadBuffer& buffer, std::vector<Tracer::Event>& events)
+{
+    const uint64_t capacity = buffer.events.size();
+    const uint64_t readStart = buffer.readStart.load(std::memory_order_acquire);
+    const uint64_t end = buffer.writeIndex.load(std::memory_order_acquire);
+    const uint64_t begin = std::max(readStart, end > capacity ? end - capacity : 0);
+
+    events.clear();
+    for (uint64_t i = begin; i < end; ++i)
+        events.push_back(buffer.events[i % capacity]);
+
+    // Writing the event with index i overwrites the event with index i - capacity.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t claimed = buffer.claimIndex.load(std::memory_order_relaxed);
+    const uint64_t validBegin = std::min(end, std::max(begin, claimed > capacity ? claimed - capacity : 0));
+    events.erase(events.begin(), events.begin() + (validBegin - begin));
+
+    return validBegin - readStart;
+}
+} // namespace
+
+std::atomic<bool> Tracer::sEnabled{false};
+const std::chrono::high_resolution_clock::time_point Tracer::sEpoch = std::chrono::high_resolution_clock::now();
+
+void Tracer::start()
+{
+    sEnabled = true;
+}
+
+void Tracer::stop()
+{
+    sEnabled = false;
+}
+
+void Tracer::clear()
+{
+    TracerState& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (auto& pBuffer : state.buffers)
+        pBuffer->readStart.store(pBuffer->writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+
+    // Buffers of exited threads have no events left.
+    removeBuffers(state, [](const ThreadBuffer& buffer) { return buffer.exited; });
+}
+
+void Tracer::setBufferCapacity(size_t capacity)
+{
+    FALCOR_CHECK(capacity > 0, "Trace buffer capacity must be greater than zero.");
+    TracerState& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.bufferCapacity = capacity;
+}
+
+void Tracer::setThreadName(std::string_view name)
+{
+    // The name is applied when the thread records its first event, so naming threads does not allocate buffers.
+    tThreadName = name;
+    if (tpThreadBuffer)
+    {
+        std::lock_guard<std::mutex> lock(getState().mutex);
+        tpThreadBuffer->threadName = tThreadName;
+    }
+}
+
+void Tracer::recordComplete(const char* name, uint64_t startTime, uint64_t endTime, std::string_view detail)
+{
+    Event event;
+    event.name = name;
+    event.timestamp = startTime;
+    event.duration = endTime - startTime;
+    event.type = EventType::Complete;
+    copyDetail(event, detail);
+    record(event);
+}
+
+void Tracer::recordDynamicComplete(std::string_view name, uint64_t startTime, uint64_t endTime)
+{
+    Event event;
+    event.timestamp = startTime;
+    event.duration = endTime - startTime;
+    event.type = EventType::Complete;
+    copyDetail(event, name);
+    record(event);
+}
+
+void Tracer::recordInstant(const char* name, std::string_view detail)
+{
+    Event event;
+    event.name = name;
+    event.timestamp = getTimestamp();
+    event.type = EventType::Instant;
+    copyDetail(event, detail);
+    record(event);
+}
+
+void Tracer::recordCounter(const char* name, double value)
+{
+    Event event;
+    event.name = name;
+    event.timestamp = getTimestamp();
+    event.value = value;
+    event.type = EventType::Counter;
+    record(event);
+}
+
+void Tracer::record(const Event& event)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    const uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+    // Announce the write before touching the slot, so that a concurrent export discards the event it overwrites.
+    buffer.claimIndex.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    buffer.events[index % buffer.events.size()] = event;
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+uint64_t Tracer::getOverwrittenEventCount()
+{
+    TracerState& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    uint64_t overwrittenCount = 0;
+    for (const auto& pBuffer : state.buffers)
+        overwrittenCount += pBuffer->getOverwrittenCount();
+    return overwrittenCount;
+}
+
+std::string Tracer::toChromeTraceJson()
+{
+    TracerState& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    // Timestamps in the Chrome trace format are in microseconds.
+    auto toMicroseconds = [](uint64_t ns) { return double(ns) * 1e-3; };
+
+    nlohmann::json traceEvents = nlohmann::json::array();
+    std::vector<Event> events;
+    uint64_t overwrittenCount = 0;
+    for (const auto& pBuffer : state.buffers)
+    {
+        overwrittenCount += copyEvents(*pBuffer, events);
+        if (events.empty())
+            continue;
+
+        const std::string threadName = pBuffer->threadName.empty() ? fmt::format("Thread {}", pBuffer->threadId) : pBuffer->threadName;
+        traceEvents.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", 1},
+            {"tid", pBuffer->threadId},
+            {"args", {{"name", threadName}}},
+        });
+
+        for (const Event& event : events)
+        {
+            nlohmann::json json = {
+                {"name", event.name ? event.name : event.detail},
+                {"pid", 1},
+                {"tid", pBuffer->threadId},
+                {"ts", toMicroseconds(event.timestamp)},
+            };
+            switch (event.type)
+            {
+            case EventType::Complete:
+                json["ph"] = "X";
+                json["dur"] = toMicroseconds(event.duration);
+                break;
+            case EventType::Instant:
+                json["ph"] = "i";
+                json["s"] = "t";
+                break;
+            case EventType::Counter:
+                json["ph"] = "C";
+                json["args"] = {{"value", event.value}};
+                break;
+            }
+            if (event.name && event.detail[0] != '\0')
+                json["args"] = {{"detail", event.detail}};
+            traceEvents.push_back(std::move(json));
+        }
+    }
+
+    if (overwrittenCount > 0)
+        logWarning("Tracer: {} events were overwritten because the trace buffers overflowed.", overwrittenCount);
+
+    nlohmann::json trace = {
+        {"traceEvents", std::move(traceEvents)},
+        {"displayTimeUnit", "ns"},
+    };
+    return trace.dump();
+}
+
+void Tracer::writeChromeTrace(const std::filesystem::path& path)
+{
+    std::string json = toChromeTraceJson();
+    std::ofstream ofs(path);
+    if (!ofs)
+        FALCOR_THROW("Failed to open '{}' for writing.", path);
+    ofs.write(json.data(), json.size());
+}
+
+FALCOR_SCRIPT_BINDING(Tracer)
+{
+    using namespace pybind11::literals;
+
+    pybind11::class_<Tracer> tracer(m, "Tracer");
+    tracer.def_property_readonly_static("enabled", [](pybind11::object) { return Tracer::isEnabled(); });
+    tracer.def_static("start", &Tracer::start);
+    tracer.def_static("stop", &Tracer::stop);
+    tracer.def_static("clear", &Tracer::clear);
+    tracer.def_static("write_chrome_trace", &Tracer::writeChromeTrace, "path"_a);
+}
+} // namespace Falcor
@@ -0,0 +1,243 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace Falcor
+{
+/**
+ * Low-overhead CPU event tracer.
+ *
+ * Events are recorded into per-thread ring buffers with nanosecond timestamps. Recording is lock-free:
+ * each thread only writes to its own buffer, and buffers are registered once per thread on first use.
+ * When tracing is disabled, the tracing macros only perform a single relaxed atomic load.
+ * Recorded events can be exported in the Chrome trace event format, which can be viewed in
+ * chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Event names must point to strings with static storage duration (e.g. string literals). An optional
+ * detail string (e.g. an asset name) is copied into the event and truncated to kMaxDetailLength characters.
+ *
+ * Ring buffers have a fixed capacity. When a thread records more events than fit into its buffer,
+ * the oldest events are overwritten and reported as overwritten on export. Exports can run while other
+ * threads keep recording. The buffer of an exited thread is released once its events are cleared.
+ */
+class FALCOR_API Tracer
+{
+public:
+    static constexpr size_t kDefaultBufferCapacity = 16384;
+    static constexpr size_t kMaxDetailLength = 47;
+
+    enum class EventType : uint8_t
+    {
+        Complete, ///< Event with a start time and duration.
+        Instant,  ///< Event with a single timestamp.
+        Counter,  ///< Counter value sample.
+    };
+
+    struct Event
+    {
+        const char* name = nullptr; ///< Event name, or nullptr if the name is stored in detail.
+        uint64_t timestamp = 0; ///< Start time in nanoseconds since the tracer epoch.
+        uint64_t duration = 0;  ///< Duration in nanoseconds (complete events only).
+        double value = 0.0;     ///< Counter value (counter events only).
+        EventType type = EventType::Complete;
+        char detail[kMaxDetailLength + 1] = {};
+    };
+
+    /**
+     * Check if tracing is enabled.
+     */
+    static bool isEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Start tracing. Events recorded before are kept unless clear() is called.
+     */
+    static void start();
+
+    /**
+     * Stop tracing.
+     */
+    static void stop();
+
+    /**
+     * Discard all recorded events.
+     */
+    static void clear();
+
+    /**
+     * Set the ring buffer capacity (number of events) for threads that record their first event after this call.
+     */
+    static void setBufferCapacity(size_t capacity);
+
+    /**
+     * Set the name of the calling thread as shown in the exported trace.
+     */
+    static void setThreadName(std::string_view name);
+
+    /**
+     * Get the current timestamp in nanoseconds since the tracer epoch.
+     */
+    static uint64_t getTimestamp() { return toTimestamp(std::chrono::high_resolution_clock::now()); }
+
+    /**
+     * Convert a time point (e.g. from CpuTimer) to a timestamp in nanoseconds since the tracer epoch.
+     */
+    static uint64_t toTimestamp(std::chrono::high_resolution_clock::time_point timePoint)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint - sEpoch).count();
+    }
+
+    /**
+     * Record a complete event on the calling thread.
+     * @param[in] name Event name (static storage duration).
+     * @param[in] startTime Start timestamp (from getTimestamp()).
+     * @param[in] endTime End timestamp (from getTimestamp()).
+     * @param[in] detail Optional detail string.
+     */
+    static void recordComplete(const char* name, uint64_t startTime, uint64_t endTime, std::string_view detail = {});
+
+    /**
+     * Record a complete event with a name that does not have static storage duration.
+     * The name is copied into the event's detail storage and truncated to kMaxDetailLength characters.
+     */
+    static void recordDynamicComplete(std::string_view name, uint64_t startTime, uint64_t endTime);
+
+    /**
+     * Record an instant event on the calling thread.
+     */
+    static void recordInstant(const char* name, std::string_view detail = {});
+
+    /**
+     * Record a counter sample on the calling thread.
+     */
+    static void recordCounter(const char* name, double value);
+
+    /**
+     * Get the number of events recorded since the last clear() that were overwritten because the buffer of
+     * the recording thread was full.
+     */
+    static uint64_t getOverwrittenEventCount();
+
+    /**
+     * Export all recorded events in the Chrome trace event format.
+     * Can be called while tracing; events recorded during the export may not be included.
+     */
+    static std::string toChromeTraceJson();
+
+    /**
+     * Write all recorded events to a Chrome trace event file.
+     */
+    static void writeChromeTrace(const std::filesystem::path& path);
+
+private:
+    static void record(const Event& event);
+
+    static std::atomic<bool> sEnabled;
+    static const std::chrono::high_resolution_clock::time_point sEpoch;
+};
+
+/**
+ * Helper class for recording a complete trace event using RAII.
+ * Use the FALCOR_TRACE_SCOPE macros instead of creating objects of this class directly.
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name)
+    {
+        if (Tracer::isEnabled())
+        {
+            mName = name;
+            mStartTime = Tracer::getTimestamp();
+        }
+    }
+
+    /**
+     * Create a scope with a detail string. The detail function is only called when tracing is enabled.
+     */
+    template<typename DetailFunc>
+    TraceScope(const char* name, DetailFunc&& getDetail) : TraceScope(name)
+    {
+        if (mName)
+            mDetail = getDetail();
+    }
+
+    ~TraceScope()
+    {
+        if (mName)
+            Tracer::recordComplete(mName, mStartTime, Tracer::getTimestamp(), mDetail);
+    }
+
+    bool isActive() const { return mName != nullptr; }
+
+    void setDetail(std::string_view detail) { mDetail = detail; }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* mName = nullptr;
+    uint64_t mStartTime = 0;
+    std::string mDetail;
+};
+} // namespace Falcor
+
+#if FALCOR_ENABLE_TRACING
+#define FALCOR_TRACE_SCOPE(_name) Falcor::TraceScope FALCOR_CONCAT_STRINGS(_traceScope, __LINE__)(_name)
+/// Trace scope with a detail string. The detail expression is only evaluated when tracing is enabled.
+#define FALCOR_TRACE_SCOPE_DETAIL(_name, _detail) \
+    Falcor::TraceScope FALCOR_CONCAT_STRINGS(_traceScope, __LINE__)(_name, [&]() { return _detail; })
+#define FALCOR_TRACE_INSTANT(_name)               \
+    do                                            \
+    {                                             \
+        if (Falcor::Tracer::isEnabled())          \
+            Falcor::Tracer::recordInstant(_name); \
+    } while (0)
+#define FALCOR_TRACE_COUNTER(_name, _value)               \
+    do                                                    \
+    {                                                     \
+        if (Falcor::Tracer::isEnabled())                  \
+            Falcor::Tracer::recordCounter(_name, _value); \
+    } while (0)
+#else
+#define FALCOR_TRACE_SCOPE(_name)
+#define FALCOR_TRACE_SCOPE_DETAIL(_name, _detail)
+#define FALCOR_TRACE_INSTANT(_name) \
+    do                              \
+    {                               \
+    } while (0)
+#define FALCOR_TRACE_COUNTER(_name, _value) \
+    do                                      \
+    {                                       \
+    } while (0)
+#endif
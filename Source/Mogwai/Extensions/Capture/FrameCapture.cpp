@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Falcor.h"
 #include "FrameCapture.h"
+#include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Scripting/ScriptWriter.h"
 #include <filesystem>
 
@@ -41,6 +42,8 @@ namespace Mogwai
         const std::string kUI = "ui";
         const std::string kOutputs = "outputs";
         const std::string kCapture = "capture";
+        const std::string kFlush = "flush";
+        const std::string kEncodeMode = "encodeMode";
 
         template<typename T>
         std::vector<typename T::value_type::first_type> getFirstOfPair(const T& pair)
@@ -63,6 +66,7 @@ namespace Mogwai
         : CaptureTrigger(pRenderer, "Frame Capture")
     {
         mpImageProcessing = std::make_unique<ImageProcessing>(pRenderer->getDevice());
+        mpAsyncCapture = std::make_unique<AsyncFrameCapture>(pRenderer->getDevice());
     }
 
     void FrameCapture::renderUI(Gui* pGui)
@@ -76,7 +80,19 @@ namespace Mogwai
             w.checkbox("Capture All Outputs", mCaptureAllOutputs);
             w.tooltip("Capture all available outputs instead of the marked ones only.");
 
+            auto encodeMode = mpAsyncCapture->getEncodeMode();
+            if (w.dropdown("Encode Mode", encodeMode)) mpAsyncCapture->setEncodeMode(encodeMode);
+            w.tooltip("Default: Use the file format's default compression.\n"
+                      "Fast: Write PNG and EXR files without compression.\n"
+                      "Raw: Write the raw texel data with a small header.");
+
             if (w.button("Capture Current Frame")) capture();
+
+            const auto stats = mpAsyncCapture->getStats();
+            w.text(fmt::format("Captured {} frames, {} images ({:.1f} frames/s, {:.1f} images/s)",
+                stats.frameCount, stats.imageCount, stats.getFramesPerSecond(), stats.getImagesPerSecond()));
+            w.text(fmt::format("Readback stall: {:.1f} ms, encoder stall: {:.1f} ms", stats.readbackStallTime, stats.backpressureStallTime));
+            if (stats.failedCount > 0) w.text(fmt::format("Failed to write {} images", stats.failedCount));
         }
     }
 
@@ -95,6 +111,7 @@ namespace Mogwai
         auto printGraph = [](FrameCapture* pFC, RenderGraph* pGraph) { pybind11::print(pFC->graphFramesStr(pGraph)); };
         frameCapture.def(kPrintFrames.c_str(), printGraph, "graph"_a);
         frameCapture.def(kCapture.c_str(), &FrameCapture::capture);
+        frameCapture.def(kFlush.c_str(), [](FrameCapture* pFC) { pFC->mpAsyncCapture->flush(); });
         auto printAllGraphs = [](FrameCapture* pFC)
         {
             std::string s;
@@ -111,6 +128,11 @@ namespace Mogwai
         frameCapture.def_property("captureAllOutputs",
             [](FrameCapture* pFC){ return pFC->mCaptureAllOutputs;},
             [](FrameCapture* pFC, bool all){ pFC->mCaptureAllOutputs = all; });
+
+        pybind11::falcor_enum<AsyncFrameCapture::EncodeMode>(m, "CaptureEncodeMode");
+        frameCapture.def_property(kEncodeMode.c_str(),
+            [](FrameCapture* pFC){ return pFC->mpAsyncCapture->getEncodeMode(); },
+            [](FrameCapture* pFC, AsyncFrameCapture::EncodeMode mode){ pFC->mpAsyncCapture->setEncodeMode(mode); });
     }
 
     std::string FrameCapture::getScriptVar() const
@@ -248,7 +270,7 @@ namespace Mogwai
             Bitmap::ExportFlags flags = Bitmap::ExportFlags::None;
             if (mask == TextureChannelFlags::RGBA) flags |= Bitmap::ExportFlags::ExportAlpha;
 
-            pTex->captureToFile(0, 0, filename, fileformat, flags);
+            mpAsyncCapture->capture(pRenderContext, pTex, mpRenderer->getGlobalClock().getFrame(), filename, fileformat, flags);
         }
     }
 
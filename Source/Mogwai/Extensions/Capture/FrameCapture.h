@@ -28,6 +28,7 @@
 #pragma once
 #include "../../Mogwai.h"
 #include "CaptureTrigger.h"
+#include "Utils/Image/AsyncFrameCapture.h"
 #include "Utils/Image/ImageProcessing.h"
 
 namespace Mogwai
@@ -54,5 +55,6 @@ namespace Mogwai
 
         bool mCaptureAllOutputs = false;
         std::unique_ptr<ImageProcessing> mpImageProcessing;
+        std::unique_ptr<AsyncFrameCapture> mpAsyncCapture; ///< Reads back and writes the captured images asynchronously.
     };
 }
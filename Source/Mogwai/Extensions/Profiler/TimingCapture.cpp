@@ -27,6 +27,8 @@
  **************************************************************************/
 #include "Falcor.h"
 #include "TimingCapture.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
 
 namespace Mogwai
 {
@@ -34,6 +36,18 @@ namespace Mogwai
     {
         const std::string kScriptVar = "timingCapture";
         const std::string kCaptureFrameTime = "captureFrameTime";
+        const std::string kCaptureFrameTimeStats = "captureFrameTimeStats";
+        const std::string kWriteFrameTimeStats = "writeFrameTimeStats";
+        const std::string kHitchFactor = "hitchFactor";
+
+        // Frame times are recorded in microseconds from 1 us up to one hour with 3 significant digits.
+        const uint64_t kHistogramHighestValue = 3600ull * 1000 * 1000;
+        const uint32_t kHistogramSignificantDigits = 3;
+
+        const size_t kHitchWindowSize = 120;    ///< Number of preceding frames used to compute the median frame time.
+        const size_t kHitchMinFrameCount = 30;  ///< Minimum number of preceding frames before hitches are detected.
+        const size_t kMaxHitchCount = 32;       ///< Maximum number of hitches reported (the slowest ones are kept).
+        const size_t kMaxHitchEventCount = 5;   ///< Maximum number of profiler events attributed to a hitch.
     }
 
     MOGWAI_EXTENSION(TimingCapture);
@@ -43,6 +57,12 @@ namespace Mogwai
         return UniquePtr(new TimingCapture(pRenderer));
     }
 
+    TimingCapture::~TimingCapture()
+    {
+        // Write the statistics of a running collection, e.g. when a headless run exits.
+        captureFrameTimeStats({});
+    }
+
     void TimingCapture::registerScriptBindings(pybind11::module& m)
     {
         using namespace pybind11::literals;
@@ -51,6 +71,9 @@ namespace Mogwai
 
         // Members
         timingCapture.def(kCaptureFrameTime.c_str(), &TimingCapture::captureFrameTime, "path"_a);
+        timingCapture.def(kCaptureFrameTimeStats.c_str(), &TimingCapture::captureFrameTimeStats, "path"_a);
+        timingCapture.def(kWriteFrameTimeStats.c_str(), &TimingCapture::writeFrameTimeStats, "path"_a);
+        timingCapture.def_readwrite(kHitchFactor.c_str(), &TimingCapture::mHitchFactor);
     }
 
     std::string TimingCapture::getScriptVar() const
@@ -85,11 +108,178 @@ namespace Mogwai
 
     void TimingCapture::recordPreviousFrameTime()
     {
-        if (!mFrameTimeFile.is_open()) return;
+        if (!mFrameTimeFile.is_open() && !mpFrameTimeHistogram) return;
 
         // The FrameRate object is updated at the start of each frame, the first valid time is available on the second frame.
         auto& frameRate = mpRenderer->getFrameRate();
         if (frameRate.getFrameCount() > 1)
-            mFrameTimeFile << frameRate.getLastFrameTime() << std::endl;
+        {
+            if (mFrameTimeFile.is_open()) mFrameTimeFile << frameRate.getLastFrameTime() << std::endl;
+            if (mpFrameTimeHistogram) recordFrameTimeStats(frameRate.getLastFrameTime() * 1000.0);
+        }
+    }
+
+    void TimingCapture::captureFrameTimeStats(std::filesystem::path path)
+    {
+        if (mpFrameTimeHistogram)
+        {
+            writeFrameTimeStats(mStatsPath);
+            mpFrameTimeHistogram.reset();
+        }
+
+        mStatsPath = path;
+        mStatsFrameCount = 0;
+        mHitchCount = 0;
+        mHitches.clear();
+        mRecentFrameTimes.clear();
+
+        if (!path.empty())
+        {
+            mpFrameTimeHistogram = std::make_unique<HdrHistogram>(1, kHistogramHighestValue, kHistogramSignificantDigits);
+            mRecentFrameTimes.reserve(kHitchWindowSize);
+            mHitches.reserve(kMaxHitchCount);
+        }
+    }
+
+    void TimingCapture::recordFrameTimeStats(double frameTime)
+    {
+        // Detect hitches relative to the median of the preceding frames, so that slow scenes are not reported as one long hitch.
+        if (mRecentFrameTimes.size() >= kHitchMinFrameCount)
+        {
+            std::vector<double> sorted = mRecentFrameTimes;
+            auto median = sorted.begin() + sorted.size() / 2;
+            std::nth_element(sorted.begin(), median, sorted.end());
+            if (frameTime > mHitchFactor * *median) recordHitch(frameTime, *median);
+        }
+
+        if (mRecentFrameTimes.size() < kHitchWindowSize) mRecentFrameTimes.push_back(frameTime);
+        else mRecentFrameTimes[mStatsFrameCount % kHitchWindowSize] = frameTime;
+
+        mpFrameTimeHistogram->record(std::max<uint64_t>((uint64_t)std::llround(frameTime * 1000.0), 1));
+        mStatsFrameCount++;
+    }
+
+    void TimingCapture::recordHitch(double frameTime, double medianFrameTime)
+    {
+        mHitchCount++;
+
+        // Only keep the slowest hitches.
+        if (mHitches.size() == kMaxHitchCount)
+        {
+            if (frameTime <= mHitches.front().frameTime) return;
+            std::pop_heap(mHitches.begin(), mHitches.end(), isSlowerHitch);
+            mHitches.pop_back();
+        }
+
+        Hitch hitch;
+        hitch.frame = mpRenderer->getFrameRate().getFrameCount() - 1;
+        hitch.frameTime = frameTime;
+        hitch.medianFrameTime = medianFrameTime;
+
+        // Attribute the hitch to the profiler events that exceeded their moving average the most.
+        // Events whose excess time is mostly explained by one of their child events are skipped to report the most specific events.
+        Profiler* pProfiler = mpRenderer->getDevice()->getProfiler();
+        if (pProfiler && pProfiler->isEnabled())
+        {
+            struct Candidate
+            {
+                const Profiler::Event* pEvent;
+                float excess;
+            };
+            std::vector<Candidate> candidates;
+            for (const Profiler::Event* pEvent : pProfiler->getEvents())
+            {
+                float cpuExcess = pEvent->getCpuTimeAverage() >= 0.f ? pEvent->getCpuTime() - pEvent->getCpuTimeAverage() : 0.f;
+                float gpuExcess = pEvent->getGpuTimeAverage() >= 0.f ? pEvent->getGpuTime() - pEvent->getGpuTimeAverage() : 0.f;
+                float excess = std::max(cpuExcess, gpuExcess);
+                if (excess > 0.f) candidates.push_back({pEvent, excess});
+            }
+
+            std::vector<Candidate> unexplained;
+            for (const auto& candidate : candidates)
+            {
+                const std::string prefix = candidate.pEvent->getName() + "/";
+                bool explained = std::any_of(candidates.begin(), candidates.end(), [&](const Candidate& other) {
+                    return other.pEvent->getName().rfind(prefix, 0) == 0 && other.excess >= 0.5f * candidate.excess;
+                });
+                if (!explained) unexplained.push_back(candidate);
+            }
+
+            std::sort(unexplained.begin(), unexplained.end(), [](const Candidate& a, const Candidate& b) { return a.excess > b.excess; });
+            for (size_t i = 0; i < std::min(unexplained.size(), kMaxHitchEventCount); ++i)
+            {
+                const Profiler::Event* pEvent = unexplained[i].pEvent;
+                hitch.events.push_back(
+                    {pEvent->getName(), pEvent->getCpuTime(), pEvent->getGpuTime(), pEvent->getCpuTimeAverage(), pEvent->getGpuTimeAverage()}
+                );
+            }
+        }
+
+        mHitches.push_back(std::move(hitch));
+        std::push_heap(mHitches.begin(), mHitches.end(), isSlowerHitch);
+    }
+
+    void TimingCapture::writeFrameTimeStats(const std::filesystem::path& path) const
+    {
+        if (!mpFrameTimeHistogram)
+        {
+            logWarning("Frame time statistics are not being collected. Call '{}' first.", kCaptureFrameTimeStats);
+            return;
+        }
+
+        // Convert from microseconds to milliseconds.
+        const HdrHistogram& histogram = *mpFrameTimeHistogram;
+        auto toMs = [](uint64_t value) { return value / 1000.0; };
+
+        nlohmann::json frameTime = {
+            {"min", toMs(histogram.getMin())},
+            {"max", toMs(histogram.getMax())},
+            {"mean", histogram.getMean() / 1000.0},
+            {"p50", toMs(histogram.getValueAtPercentile(50.0))},
+            {"p90", toMs(histogram.getValueAtPercentile(90.0))},
+            {"p95", toMs(histogram.getValueAtPercentile(95.0))},
+            {"p99", toMs(histogram.getValueAtPercentile(99.0))},
+            {"p99.9", toMs(histogram.getValueAtPercentile(99.9))},
+        };
+
+        std::vector<Hitch> hitches = mHitches;
+        std::sort(hitches.begin(), hitches.end(), isSlowerHitch);
+        nlohmann::json jsonHitches = nlohmann::json::array();
+        for (const auto& hitch : hitches)
+        {
+            nlohmann::json events = nlohmann::json::array();
+            for (const auto& event : hitch.events)
+            {
+                events.push_back({
+                    {"name", event.name},
+                    {"cpu_time", event.cpuTime},
+                    {"gpu_time", event.gpuTime},
+                    {"cpu_time_average", event.cpuTimeAverage},
+                    {"gpu_time_average", event.gpuTimeAverage},
+                });
+            }
+            jsonHitches.push_back({
+                {"frame", hitch.frame},
+                {"frame_time", hitch.frameTime},
+                {"median_frame_time", hitch.medianFrameTime},
+                {"events", events},
+            });
+        }
+
+        nlohmann::json json = {
+            {"frame_count", mStatsFrameCount},
+            {"frame_time", frameTime},
+            {"hitch_factor", mHitchFactor},
+            {"hitch_count", mHitchCount},
+            {"hitches", jsonHitches},
+        };
+
+        std::ofstream ofs(path);
+        if (!ofs)
+        {
+            logError("Failed to open file '{}' for writing. Ignoring call.", path);
+            return;
+        }
+        ofs << json.dump(2) << std::endl;
     }
 }
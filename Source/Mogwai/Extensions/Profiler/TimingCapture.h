@@ -27,14 +27,18 @@
  **************************************************************************/
 #pragma once
 #include "../../Mogwai.h"
+#include "Utils/Timing/HdrHistogram.h"
 #include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace Mogwai
 {
     class TimingCapture : public Extension
     {
     public:
-        virtual ~TimingCapture() = default;
+        virtual ~TimingCapture();
         static UniquePtr create(Renderer* pRenderer);
 
         virtual void beginFrame(RenderContext* pRenderContext, const ref<Fbo>& pTargetFbo) override;
@@ -49,6 +53,48 @@ namespace Mogwai
         void captureFrameTime(std::filesystem::path path);
         void recordPreviousFrameTime();
 
+        /** Start collecting frame time statistics, or end collection if path is empty.
+            The statistics of a running collection are written to its path when it ends.
+        */
+        void captureFrameTimeStats(std::filesystem::path path);
+
+        /** Write the current frame time statistics to a JSON file without ending the collection.
+        */
+        void writeFrameTimeStats(const std::filesystem::path& path) const;
+
+        void recordFrameTimeStats(double frameTime);
+        void recordHitch(double frameTime, double medianFrameTime);
+
+        struct HitchEvent
+        {
+            std::string name;
+            float cpuTime = 0.f;        ///< CPU time in ms.
+            float gpuTime = 0.f;        ///< GPU time in ms.
+            float cpuTimeAverage = 0.f; ///< Average CPU time in ms.
+            float gpuTimeAverage = 0.f; ///< Average GPU time in ms.
+        };
+
+        struct Hitch
+        {
+            uint64_t frame = 0;
+            double frameTime = 0.0;         ///< Frame time in ms.
+            double medianFrameTime = 0.0;   ///< Median of the preceding frame times in ms.
+            std::vector<HitchEvent> events; ///< Profiler events that exceeded their average the most.
+        };
+
+        /** Hitch ordering used to keep the slowest hitches in a min-heap and to sort them for output.
+        */
+        static bool isSlowerHitch(const Hitch& a, const Hitch& b) { return a.frameTime > b.frameTime; }
+
         std::ofstream   mFrameTimeFile;     ///< Frame times are appended to this file when it's open.
+
+        // Frame time statistics. All state has a fixed size so that long runs use constant memory.
+        std::filesystem::path mStatsPath;                   ///< Statistics are written to this file when the collection ends.
+        std::unique_ptr<HdrHistogram> mpFrameTimeHistogram; ///< Frame times in microseconds, nullptr if not collecting.
+        std::vector<double> mRecentFrameTimes;              ///< Ring buffer of recent frame times in ms for hitch detection.
+        uint64_t mStatsFrameCount = 0;                      ///< Number of frames recorded since the collection started.
+        uint64_t mHitchCount = 0;                           ///< Number of detected hitches.
+        std::vector<Hitch> mHitches;                        ///< Slowest hitches (min-heap by frame time).
+        double mHitchFactor = 2.0;                          ///< A frame is a hitch if it takes longer than this factor times the median.
     };
 }
@@ -0,0 +1,81 @@
+#include "AdaptiveSamplingPass.h"
+#include "GBuffer.h"
+#include "SceneSettings.h"
+
+namespace Restir
+{
+using namespace Falcor;
+
+namespace
+{
+FrameTimeController::Options getControllerOptions()
+{
+    const SceneSettings& settings = *SceneSettingsSingleton::instance();
+
+    // The scale bounds map to the candidate count bounds.
+    FrameTimeController::Options options;
+    options.targetTimeMs = settings.adaptiveTargetFrameTimeMs;
+    options.minScale = (float)settings.adaptiveMinRISSamplesCount / (float)settings.RISSamplesCount;
+    options.maxScale = (float)settings.adaptiveMaxRISSamplesCount / (float)settings.RISSamplesCount;
+    options.initialScale = std::clamp(1.0f, options.minScale, options.maxScale);
+    return options;
+}
+} // namespace
+
+AdaptiveSamplingPass::AdaptiveSamplingPass(ref<Device> pDevice, uint32_t width, uint32_t height)
+    : mWidth(width), mHeight(height), mController(getControllerOptions())
+{
+    mpAdaptiveSamplingPass = ComputePass::create(pDevice, "Samples/Restir/AdaptiveSamplingPass.slang", "EntryPoint", GBufferSingleton::instance()->getDefines());
+
+    mpLuminanceMomentsTexture = pDevice->createTexture2D(
+        width, height, ResourceFormat::RG32Float, 1, 1, nullptr, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource
+    );
+    mpLuminanceMomentsTexture->setName("AdaptiveSamplingPass luminance moments texture");
+
+    // Start at full weight until the moments are known.
+    const std::vector<float> initialWeights(width * height, 1.0f);
+    mpCandidateWeightTexture = pDevice->createTexture2D(
+        width,
+        height,
+        ResourceFormat::R32Float,
+        1,
+        1,
+        initialWeights.data(),
+        ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource
+    );
+    mpCandidateWeightTexture->setName("AdaptiveSamplingPass candidate weight texture");
+}
+
+void AdaptiveSamplingPass::updateBudget(float frameTimeMs)
+{
+    mController.update(frameTimeMs);
+}
+
+void AdaptiveSamplingPass::render(Falcor::RenderContext* pRenderContext, const ref<Texture>& pShadingTexture)
+{
+    FALCOR_PROFILE(pRenderContext, "AdaptiveSamplingPass::render");
+
+    auto var = mpAdaptiveSamplingPass->getRootVar();
+
+    const uint2 renderDims = GBufferSingleton::instance()->getRenderDims();
+
+    var["PerFrameCB"]["viewportDims"] = renderDims;
+    var["PerFrameCB"]["momentsAlpha"] = SceneSettingsSingleton::instance()->adaptiveMomentsAlpha;
+    var["PerFrameCB"]["sensitivity"] = SceneSettingsSingleton::instance()->adaptiveSensitivity;
+    var["PerFrameCB"]["minWeight"] = SceneSettingsSingleton::instance()->adaptiveMinPixelWeight;
+
+    var["gShading"] = pShadingTexture;
+    var["gLuminanceMoments"] = mpLuminanceMomentsTexture;
+    var["gCandidateWeight"] = mpCandidateWeightTexture;
+
+    GBufferSingleton::instance()->bindGeometry(var["gGBuffer"]);
+
+    mpAdaptiveSamplingPass->execute(pRenderContext, renderDims.x, renderDims.y);
+}
+
+void AdaptiveSamplingPass::bindShaderData(const ShaderVar& var) const
+{
+    var["PerFrameCB"]["candidateBudgetScale"] = mController.getScale();
+    var["gCandidateWeight"] = mpCandidateWeightTexture;
+}
+} // namespace Restir
@@ -0,0 +1,37 @@
+#pragma once
+#include "Falcor.h"
+#include "Utils/Timing/FrameTimeController.h"
+
+namespace Restir
+{
+// Adaptive RIS candidate count.
+// A per-pixel weight in [minWeight, 1] is computed from the temporal variance and the change of the shaded luminance,
+// and a frame time controller scales the global candidate budget to hit the target frame time.
+// The RIS pass uses RISSamplesCount * budget scale * pixel weight candidates.
+class AdaptiveSamplingPass
+{
+public:
+    AdaptiveSamplingPass(Falcor::ref<Falcor::Device> pDevice, uint32_t width, uint32_t height);
+
+    // Update the global budget with the GPU time of the last measured frame.
+    void updateBudget(float frameTimeMs);
+
+    // Update the per-pixel weights from the shading output of this frame. They are used by the RIS pass of the next frame.
+    void render(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Texture>& pShadingTexture);
+
+    void bindShaderData(const Falcor::ShaderVar& var) const;
+
+    inline float getBudgetScale() const { return mController.getScale(); }
+    inline const Falcor::FrameTimeController& getController() const { return mController; }
+
+private:
+    uint32_t mWidth;
+    uint32_t mHeight;
+
+    Falcor::FrameTimeController mController;
+
+    Falcor::ref<Falcor::ComputePass> mpAdaptiveSamplingPass;
+    Falcor::ref<Falcor::Texture> mpLuminanceMomentsTexture;
+    Falcor::ref<Falcor::Texture> mpCandidateWeightTexture;
+};
+} // namespace Restir
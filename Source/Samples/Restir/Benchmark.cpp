@@ -0,0 +1,56 @@
+#include "Benchmark.h"
+
+namespace Restir
+{
+using namespace Falcor;
+
+Benchmark::Benchmark(const BenchmarkOptions& options) : mOptions(options)
+{
+    FALCOR_CHECK(mOptions.warmupFrames > 0, "The benchmark needs at least one warmup frame.");
+    FALCOR_CHECK(mOptions.measuredFrames > 0, "The benchmark needs at least one measured frame.");
+
+    mCameraPath = CameraPath::load(mOptions.cameraPathFile);
+    logInfo(
+        "Benchmark: {} keyframes, {} warmup and {} measured frames.",
+        mCameraPath.getKeyframeCount(),
+        mOptions.warmupFrames,
+        mOptions.measuredFrames
+    );
+}
+
+bool Benchmark::beginFrame(Profiler* pProfiler, const ref<Camera>& pCamera)
+{
+    const uint32_t frameCount = mOptions.warmupFrames + mOptions.measuredFrames;
+
+    if (mFrameIndex == frameCount)
+    {
+        std::shared_ptr<Profiler::Capture> pCapture = pProfiler->endCapture();
+        FALCOR_CHECK(pCapture, "Benchmark profiler capture is missing.");
+        writeResults(*pCapture);
+        ++mFrameIndex;
+        return false;
+    }
+
+    if (mFrameIndex > frameCount)
+        return false;
+
+    // The capture only records events from the frame after it is started on.
+    if (mFrameIndex + 1 == mOptions.warmupFrames)
+        pProfiler->startCapture(mOptions.measuredFrames);
+
+    mCameraPath.applyKeyframe(mFrameIndex % mCameraPath.getKeyframeCount(), pCamera);
+    ++mFrameIndex;
+    return true;
+}
+
+void Benchmark::writeResults(const Profiler::Capture& capture) const
+{
+    const std::filesystem::path jsonPath = std::filesystem::path(mOptions.outputPath).replace_extension(".json");
+    const std::filesystem::path csvPath = std::filesystem::path(mOptions.outputPath).replace_extension(".csv");
+
+    capture.writeToFile(jsonPath);
+    capture.writeCsvToFile(csvPath);
+
+    logInfo("Benchmark: {} frames captured, results written to '{}' and '{}'.", capture.getFrameCount(), jsonPath.string(), csvPath.string());
+}
+} // namespace Restir
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CameraPath.h"
+#include <filesystem>
+
+namespace Restir
+{
+struct BenchmarkOptions
+{
+    std::filesystem::path cameraPathFile; // Camera path replayed by the benchmark.
+    uint32_t warmupFrames = 60u;
+    uint32_t measuredFrames = 600u;
+    std::filesystem::path outputPath = "RestirBenchmark"; // Results are written to <outputPath>.json and <outputPath>.csv.
+};
+
+// Deterministic benchmark run.
+// Each frame replays the next keyframe of the camera path, looping if the path is shorter than the run.
+// The profiler events of the measured frames are captured and written as JSON (all records and stats) and CSV (stats only).
+class Benchmark
+{
+public:
+    Benchmark(const BenchmarkOptions& options);
+
+    // Set up the next frame. Returns false once all frames are rendered and the results are written.
+    bool beginFrame(Falcor::Profiler* pProfiler, const Falcor::ref<Falcor::Camera>& pCamera);
+
+    inline uint32_t getFrameIndex() const { return mFrameIndex; }
+    inline bool isFirstFrame() const { return mFrameIndex == 1u; }
+    inline bool isMeasuring() const { return mFrameIndex > mOptions.warmupFrames; }
+
+private:
+    void writeResults(const Falcor::Profiler::Capture& capture) const;
+
+    BenchmarkOptions mOptions;
+    CameraPath mCameraPath;
+    uint32_t mFrameIndex = 0u;
+};
+} // namespace Restir
@@ -0,0 +1,76 @@
+#include "CameraPath.h"
+#include <fstream>
+#include <sstream>
+
+namespace Restir
+{
+using namespace Falcor;
+
+void CameraPath::addKeyframe(const ref<Camera>& pCamera)
+{
+    mKeyframes.push_back({pCamera->getPosition(), pCamera->getTarget(), pCamera->getUpVector(), pCamera->getFocalLength()});
+}
+
+void CameraPath::applyKeyframe(size_t index, const ref<Camera>& pCamera) const
+{
+    FALCOR_CHECK(index < mKeyframes.size(), "Camera keyframe {} is out of range ({} keyframes).", index, mKeyframes.size());
+
+    const CameraKeyframe& keyframe = mKeyframes[index];
+    pCamera->setPosition(keyframe.mPosition);
+    pCamera->setTarget(keyframe.mTarget);
+    pCamera->setUpVector(keyframe.mUp);
+    pCamera->setFocalLength(keyframe.mFocalLength);
+}
+
+void CameraPath::save(const std::filesystem::path& path) const
+{
+    std::ofstream file(path);
+    FALCOR_CHECK(file.good(), "Failed to open camera path file '{}' for writing.", path.string());
+
+    file << "# position.xyz target.xyz up.xyz focalLength\n";
+
+    // 9 significant digits round-trip floats exactly.
+    for (const CameraKeyframe& k : mKeyframes)
+    {
+        file << fmt::format(
+            "{:.9g} {:.9g} {:.9g} {:.9g} {:.9g} {:.9g} {:.9g} {:.9g} {:.9g} {:.9g}\n",
+            k.mPosition.x,
+            k.mPosition.y,
+            k.mPosition.z,
+            k.mTarget.x,
+            k.mTarget.y,
+            k.mTarget.z,
+            k.mUp.x,
+            k.mUp.y,
+            k.mUp.z,
+            k.mFocalLength
+        );
+    }
+}
+
+CameraPath CameraPath::load(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    FALCOR_CHECK(file.good(), "Failed to open camera path file '{}'.", path.string());
+
+    CameraPath cameraPath;
+
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(file, line); ++lineNumber)
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        CameraKeyframe k;
+        std::istringstream stream(line);
+        stream >> k.mPosition.x >> k.mPosition.y >> k.mPosition.z >> k.mTarget.x >> k.mTarget.y >> k.mTarget.z >> k.mUp.x >> k.mUp.y >>
+            k.mUp.z >> k.mFocalLength;
+        FALCOR_CHECK(!stream.fail(), "Invalid camera keyframe in '{}' at line {}.", path.string(), lineNumber);
+
+        cameraPath.mKeyframes.push_back(k);
+    }
+
+    FALCOR_CHECK(cameraPath.getKeyframeCount() > 0, "Camera path file '{}' has no keyframes.", path.string());
+    return cameraPath;
+}
+} // namespace Restir
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Falcor.h"
+#include <filesystem>
+#include <vector>
+
+namespace Restir
+{
+struct CameraKeyframe
+{
+    Falcor::float3 mPosition;
+    Falcor::float3 mTarget;
+    Falcor::float3 mUp;
+    float mFocalLength;
+};
+
+// Sequence of camera viewpoints, one per frame.
+// Stored as a text file with one keyframe per line: position, target, up vector and focal length.
+// Empty lines and lines starting with '#' are ignored.
+class CameraPath
+{
+public:
+    void addKeyframe(const Falcor::ref<Falcor::Camera>& pCamera);
+    void applyKeyframe(size_t index, const Falcor::ref<Falcor::Camera>& pCamera) const;
+
+    inline size_t getKeyframeCount() const { return mKeyframes.size(); }
+    inline const std::vector<CameraKeyframe>& getKeyframes() const { return mKeyframes; }
+
+    void save(const std::filesystem::path& path) const;
+    static CameraPath load(const std::filesystem::path& path);
+
+private:
+    std::vector<CameraKeyframe> mKeyframes;
+};
+} // namespace Restir
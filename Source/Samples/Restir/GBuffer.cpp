@@ -1,4 +1,5 @@
 #include "GBuffer.h"
+#include "SceneSettings.h"
 
 namespace Restir
 {
@@ -12,6 +13,7 @@ void GBuffer::init(ref<Device> pDevice, ref<Scene> pScene, uint32_t width, uint3
     mpScene = pScene;
     mWidth = width;
     mHeight = height;
+    mPacked = SceneSettingsSingleton::instance()->packedGBuffer;
 
     createTextures();
     compilePrograms();
@@ -19,28 +21,38 @@ void GBuffer::init(ref<Device> pDevice, ref<Scene> pScene, uint32_t width, uint3
 
 void GBuffer::createTextures()
 {
-    mCurrentPositionWsTexture = mpDevice->createTexture2D(
-        mWidth, mHeight, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
-    );
+    const SceneSettings* pSettings = SceneSettingsSingleton::instance();
 
-    mPreviousPositionWsTexture = mpDevice->createTexture2D(
-        mWidth, mHeight, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
-    );
+    // The rings need at least the previous frame for temporal reuse.
+    const uint32_t historyDepth = std::max(pSettings->gBufferHistoryDepth, 2u);
 
-    mCurrentNormalWsTexture = mpDevice->createTexture2D(
-        mWidth, mHeight, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
-    );
+    auto createHistoryTexture = [&](ResourceFormat format)
+    {
+        return [this, format]()
+        {
+            return mpDevice->createTexture2D(
+                mWidth, mHeight, format, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
+            );
+        };
+    };
 
-    mPreviousNormalWsTexture = mpDevice->createTexture2D(
-        mWidth, mHeight, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
-    );
+    mPositionWsHistory.setValidationEnabled(pSettings->validateHistory);
+    mPositionWsHistory.init(historyDepth, createHistoryTexture(mPacked ? ResourceFormat::R32Float : pSettings->positionHistoryFormat));
+
+    mNormalWsHistory.setValidationEnabled(pSettings->validateHistory);
+    mNormalWsHistory.init(historyDepth, createHistoryTexture(mPacked ? ResourceFormat::R32Uint : pSettings->normalHistoryFormat));
+
+    mCameraHistory.assign(historyDepth, CameraData());
+    mRenderDimsHistory.assign(historyDepth, uint2(mWidth, mHeight));
+
+    const ResourceFormat materialFormat = mPacked ? ResourceFormat::R32Uint : ResourceFormat::RGBA32Float;
 
     mAlbedoTexture = mpDevice->createTexture2D(
-        mWidth, mHeight, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
+        mWidth, mHeight, materialFormat, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
     );
 
     mSpecularTexture = mpDevice->createTexture2D(
-        mWidth, mHeight, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
+        mWidth, mHeight, materialFormat, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
     );
 }
 
@@ -50,6 +62,7 @@ void GBuffer::compilePrograms()
     auto typeConformances = mpScene->getTypeConformances();
 
     auto defines = mpScene->getSceneDefines();
+    defines.add(getDefines());
 
     ProgramDesc rtProgDesc;
     rtProgDesc.addShaderModules(shaderModules);
@@ -70,22 +83,71 @@ void GBuffer::compilePrograms()
     mpRtVars = RtProgramVars::create(mpDevice, mpRaytraceProgram, sbt);
 }
 
+DefineList GBuffer::getDefines() const
+{
+    return {{"GBUFFER_PACKED", mPacked ? "1" : "0"}};
+}
+
+void GBuffer::setRenderDims(uint2 renderDims)
+{
+    FALCOR_CHECK(
+        all(renderDims > 0u) && all(renderDims <= uint2(mWidth, mHeight)),
+        "Render resolution {}x{} exceeds the GBuffer resolution {}x{}.",
+        renderDims.x,
+        renderDims.y,
+        mWidth,
+        mHeight
+    );
+    mRenderDimsHistory[getHistorySlot(0)] = renderDims;
+}
+
+void GBuffer::bindGeometry(const ShaderVar& var, uint32_t age) const
+{
+    var["viewportDims"] = mRenderDimsHistory[getHistorySlot(age)];
+    var["normalWs"] = mNormalWsHistory.get(age);
+
+    if (mPacked)
+    {
+        var["depth"] = mPositionWsHistory.get(age);
+        var["camera"]["data"].setBlob(mCameraHistory[getHistorySlot(age)]);
+    }
+    else
+    {
+        var["positionWs"] = mPositionWsHistory.get(age);
+    }
+}
+
+void GBuffer::bindMaterial(const ShaderVar& var) const
+{
+    var["albedo"] = mAlbedoTexture;
+    var["specular"] = mSpecularTexture;
+
+    // The packed layout stores the material ID with the current frame normal.
+    if (mPacked)
+        var["normalWs"] = mNormalWsHistory.get(0);
+}
+
 void GBuffer::render(RenderContext* pRenderContext)
 {
     FALCOR_PROFILE(pRenderContext, "GBuffer::render");
 
     auto var = mpRtVars->getRootVar();
 
-    var["PerFrameCB"]["viewportDims"] = float2(mWidth, mHeight);
+    const uint2 renderDims = getRenderDims();
+
+    var["PerFrameCB"]["viewportDims"] = float2(renderDims);
     var["PerFrameCB"]["sampleIndex"] = mSampleIndex++;
 
-    var["gPositionWs"] = mCurrentPositionWsTexture;
-    var["gNormalWs"] = mCurrentNormalWsTexture;
-    var["gAlbedo"] = mAlbedoTexture;
-    var["gSpecular"] = mSpecularTexture;
+    auto output = var["gOutput"];
+    output[mPacked ? "depth" : "positionWs"] = mPositionWsHistory.get(0);
+    output["normalWs"] = mNormalWsHistory.get(0);
+    output["albedo"] = mAlbedoTexture;
+    output["specular"] = mSpecularTexture;
+
+    // Keep the camera the frame is rendered with for the position reconstruction.
+    mCameraHistory[getHistorySlot(0)] = mpScene->getCamera()->getData();
 
-    mpScene->raytrace(pRenderContext, mpRaytraceProgram.get(), mpRtVars, uint3(mWidth, mHeight, 1));
+    mpScene->raytrace(pRenderContext, mpRaytraceProgram.get(), mpRtVars, uint3(renderDims, 1));
 }
 
 } // namespace Restir
-
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "HistoryRing.h"
 #include "Singleton.h"
 
 namespace Restir
@@ -13,40 +14,67 @@ public:
 
     void render(Falcor::RenderContext* pRenderContext);
 
-    inline const Falcor::ref<Falcor::Texture>& getCurrentPositionWsTexture() const { return mCurrentPositionWsTexture; }
-    inline const Falcor::ref<Falcor::Texture>& getPreviousPositionWsTexture() const { return mPreviousPositionWsTexture; }
+    // Size of the resources. Frames are rendered in the top-left sub-rectangle of getRenderDims() pixels.
+    inline Falcor::uint2 getMaxDims() const { return Falcor::uint2(mWidth, mHeight); }
 
-    inline const Falcor::ref<Falcor::Texture>& getCurrentNormalWsTexture() const { return mCurrentNormalWsTexture; }
-    inline const Falcor::ref<Falcor::Texture>& getPreviousNormalWsTexture() const { return mPreviousNormalWsTexture; }
+    // Resolution of the frame with the given age. All the passes of a frame dispatch and index the per-pixel resources with it.
+    inline Falcor::uint2 getRenderDims(uint32_t age = 0) const { return mRenderDimsHistory[getHistorySlot(age)]; }
+    void setRenderDims(Falcor::uint2 renderDims);
 
-    inline const Falcor::ref<Falcor::Texture>& getAlbedoTexture() const { return mAlbedoTexture; }
-    inline const Falcor::ref<Falcor::Texture>& getSpecularTexture() const { return mSpecularTexture; }
+    // Defines selecting the GBuffer layout, to be added to all programs reading the GBuffer (see GBufferData.slangh).
+    Falcor::DefineList getDefines() const;
+
+    // Binds the geometry of the frame with the given age, age 0 being the current frame, to a GBufferGeometry shader variable.
+    void bindGeometry(const Falcor::ShaderVar& var, uint32_t age = 0) const;
+
+    // Binds the material properties of the current frame to a GBufferMaterial shader variable.
+    void bindMaterial(const Falcor::ShaderVar& var) const;
+
+    inline bool isPacked() const { return mPacked; }
+
+    inline const HistoryRing<Falcor::Texture>& getPositionWsHistory() const { return mPositionWsHistory; }
+    inline const HistoryRing<Falcor::Texture>& getNormalWsHistory() const { return mNormalWsHistory; }
 
     inline void setNextFrame()
     {
-        std::swap(mCurrentNormalWsTexture, mPreviousNormalWsTexture);
-        std::swap(mCurrentPositionWsTexture, mPreviousPositionWsTexture);
+        // The render resolution carries over until the next setRenderDims() call.
+        const Falcor::uint2 renderDims = getRenderDims();
+
+        mPositionWsHistory.setNextFrame();
+        mNormalWsHistory.setNextFrame();
+        mRenderDimsHistory[getHistorySlot(0)] = renderDims;
+
+        if (mPositionWsHistory.isValidationEnabled())
+            FALCOR_CHECK(mPositionWsHistory.getFrameId() == mNormalWsHistory.getFrameId(), "GBuffer histories are out of sync.");
     }
 
 private:
     void createTextures();
     void compilePrograms();
 
+    inline size_t getHistorySlot(uint32_t age) const { return mPositionWsHistory.getFrameId(age) % mCameraHistory.size(); }
+
     Falcor::ref<Falcor::Device> mpDevice;
     Falcor::ref<Falcor::Scene> mpScene;
 
     uint32_t mWidth;
     uint32_t mHeight;
+    bool mPacked = true;
+
+    // Holds the primary hit distance instead of the position in the packed layout.
+    HistoryRing<Falcor::Texture> mPositionWsHistory;
+    HistoryRing<Falcor::Texture> mNormalWsHistory;
 
-    Falcor::ref<Falcor::Texture> mCurrentPositionWsTexture;
-    Falcor::ref<Falcor::Texture> mPreviousPositionWsTexture;
+    // Camera of each frame in the history, indexed by frame ID modulo the history depth.
+    // Used to reconstruct positions in the packed layout.
+    std::vector<Falcor::CameraData> mCameraHistory;
+
+    // Render resolution of each frame in the history, indexed like the camera history.
+    std::vector<Falcor::uint2> mRenderDimsHistory;
 
     Falcor::ref<Falcor::Texture> mAlbedoTexture;
     Falcor::ref<Falcor::Texture> mSpecularTexture;
 
-    Falcor::ref<Falcor::Texture> mCurrentNormalWsTexture;
-    Falcor::ref<Falcor::Texture> mPreviousNormalWsTexture;
-
     Falcor::ref<Falcor::Program> mpRaytraceProgram;
     Falcor::ref<Falcor::RtProgramVars> mpRtVars;
 
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Falcor.h"
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace Restir
+{
+// Ring of per-pixel resources holding the last N frames of a Restir resource.
+// Age 0 is the resource written this frame, age 1 the previous frame and so on up to getDepth() - 1.
+// Moving to the next frame only rotates the ring index, resources are never copied or reallocated.
+template<typename ResourceType>
+class HistoryRing
+{
+public:
+    using CreateFunc = std::function<Falcor::ref<ResourceType>()>;
+
+    static constexpr uint64_t kInvalidFrameId = std::numeric_limits<uint64_t>::max();
+
+    // (Re)create all resources of the ring, e.g. on resize.
+    // The frame counter keeps running but all previous frames are invalidated since their content is gone.
+    void init(uint32_t depth, const CreateFunc& createFunc)
+    {
+        FALCOR_CHECK(depth >= 1, "History ring depth must be at least 1.");
+
+        mResources.resize(depth);
+        for (auto& pResource : mResources)
+            pResource = createFunc();
+
+        mFrameIds.assign(depth, kInvalidFrameId);
+        mHead = 0;
+        mFrameIds[mHead] = mFrameId;
+
+        validate();
+    }
+
+    // Rotate the ring so that the oldest resource becomes the one written this frame.
+    inline void setNextFrame()
+    {
+        FALCOR_ASSERT(!mResources.empty());
+
+        mHead = (mHead + 1) % getDepth();
+        mFrameIds[mHead] = ++mFrameId;
+
+        validate();
+    }
+
+    inline const Falcor::ref<ResourceType>& get(uint32_t age = 0) const { return mResources[getSlot(age)]; }
+
+    // Returns true if the resource of the given age holds data of a frame rendered since the last init().
+    inline bool isValid(uint32_t age) const { return age < getDepth() && mFrameIds[getSlot(age)] != kInvalidFrameId; }
+
+    inline uint32_t getDepth() const { return (uint32_t)mResources.size(); }
+    inline uint64_t getFrameId() const { return mFrameId; }
+    inline uint64_t getFrameId(uint32_t age) const { return mFrameIds[getSlot(age)]; }
+
+    inline void setValidationEnabled(bool enabled) { mValidationEnabled = enabled; }
+    inline bool isValidationEnabled() const { return mValidationEnabled; }
+
+    // Host-side consistency check of the ring indices and frame IDs, only run when validation is enabled.
+    // Each valid slot must hold the frame ID matching its age and the invalidated slots must be the oldest ones.
+    void validate() const
+    {
+        if (!mValidationEnabled)
+            return;
+
+        FALCOR_CHECK(!mResources.empty(), "History ring is not initialized.");
+        FALCOR_CHECK(mFrameIds.size() == mResources.size(), "History ring frame IDs do not match its depth.");
+        FALCOR_CHECK(mHead < getDepth(), "History ring head {} is out of range (depth {}).", mHead, getDepth());
+
+        bool foundInvalid = false;
+        for (uint32_t age = 0; age < getDepth(); ++age)
+        {
+            FALCOR_CHECK(mResources[getSlot(age)] != nullptr, "History ring resource of age {} is missing.", age);
+
+            const uint64_t frameId = mFrameIds[getSlot(age)];
+            if (frameId == kInvalidFrameId)
+            {
+                FALCOR_CHECK(age > 0, "History ring resource of the current frame is invalid.");
+                foundInvalid = true;
+                continue;
+            }
+
+            FALCOR_CHECK(!foundInvalid, "History ring resource of age {} is valid but a newer one is not.", age);
+            FALCOR_CHECK(
+                frameId + age == mFrameId, "History ring resource of age {} holds frame {} but frame {} is expected.", age, frameId, mFrameId - age
+            );
+        }
+    }
+
+private:
+    inline uint32_t getSlot(uint32_t age) const
+    {
+        FALCOR_ASSERT(age < getDepth());
+        return (mHead + getDepth() - age) % getDepth();
+    }
+
+    std::vector<Falcor::ref<ResourceType>> mResources;
+    std::vector<uint64_t> mFrameIds;
+    uint32_t mHead = 0u;
+    uint64_t mFrameId = 0u;
+    bool mValidationEnabled = false;
+};
+} // namespace Restir
@@ -1,4 +1,6 @@
 #include "LightManager.h"
+#include "SceneSettings.h"
+#include "Utils/Math/FalcorMath.h"
 
 namespace Restir
 {
@@ -11,6 +13,8 @@ LightManager::LightManager() {}
 
 void LightManager::init(Falcor::ref<Falcor::Device> pDevice, Falcor::ref<Falcor::Scene> pScene, SceneName sceneName)
 {
+    mpDevice = pDevice;
+
     //------------------------------------------------------------------------------------------------------------
     //	Create lights
     //------------------------------------------------------------------------------------------------------------
@@ -66,6 +70,119 @@ void LightManager::init(Falcor::ref<Falcor::Device> pDevice, Falcor::ref<Falcor:
         mLightProbabilities.data(),
         false
     );
+
+    //------------------------------------------------------------------------------------------------------------
+    //	Create light clusters
+    //------------------------------------------------------------------------------------------------------------
+    if (SceneSettingsSingleton::instance()->useLightClusters)
+        createLightClusters();
+
+    //------------------------------------------------------------------------------------------------------------
+    //	Create light tiles
+    //------------------------------------------------------------------------------------------------------------
+    if (SceneSettingsSingleton::instance()->useLightTiles)
+        createLightTiles();
+}
+
+float LightManager::computeLightInfluenceRadius(const Light& light) const
+{
+    // The shaded contribution of a light is about luma(color) * falloff / d^(2 + sceneShadingLightExponent).
+    const float exponent = 2.0f + SceneSettingsSingleton::instance()->sceneShadingLightExponent;
+    const float threshold = SceneSettingsSingleton::instance()->lightInfluenceThreshold;
+
+    return std::pow(luma(light.mColor) * light.mfallOff / threshold, 1.0f / exponent) + light.mRadius;
+}
+
+void LightManager::createLightClusters()
+{
+    Falcor::LightClusterBuilder::Options options;
+    options.gridSize = SceneSettingsSingleton::instance()->lightClusterGridSize;
+    mpLightClusterBuilder = std::make_unique<Falcor::LightClusterBuilder>(options);
+
+    // Lights are static, their bounds are computed once. The weights match the global light probabilities.
+    mLightBounds.clear();
+    mLightBounds.reserve(mLights.size());
+    for (const Light& light : mLights)
+        mLightBounds.push_back({light.mWsPosition, computeLightInfluenceRadius(light), luma(light.mColor)});
+
+    mGpuLightClusterRangesBuffer = mpDevice->createStructuredBuffer(
+        sizeof(Falcor::uint2),
+        mpLightClusterBuilder->getClusterCount(),
+        Falcor::ResourceBindFlags::ShaderResource,
+        Falcor::MemoryType::DeviceLocal,
+        nullptr,
+        false
+    );
+}
+
+void LightManager::createLightTiles()
+{
+    Falcor::LightTileBuilder::Options options;
+    options.tileCount = SceneSettingsSingleton::instance()->lightTileCount;
+    options.tileSize = SceneSettingsSingleton::instance()->lightTileSize;
+
+    // The tiles are drawn on the GPU, the builder only provides the CDF the presampling pass inverts.
+    Falcor::LightTileBuilder builder(options);
+    builder.setWeights(mLightProbabilities);
+
+    mGpuLightCdfBuffer = mpDevice->createStructuredBuffer(
+        sizeof(float),
+        (uint32_t)builder.getCdf().size(),
+        Falcor::ResourceBindFlags::ShaderResource,
+        Falcor::MemoryType::DeviceLocal,
+        builder.getCdf().data(),
+        false
+    );
+
+    mGpuLightTilesBuffer = mpDevice->createStructuredBuffer(
+        sizeof(LightTileSample),
+        options.tileCount * options.tileSize,
+        Falcor::ResourceBindFlags::ShaderResource | Falcor::ResourceBindFlags::UnorderedAccess,
+        Falcor::MemoryType::DeviceLocal,
+        nullptr,
+        false
+    );
+}
+
+void LightManager::updateLightClusters(const Falcor::ref<Falcor::Camera>& pCamera)
+{
+    FALCOR_ASSERT(mpLightClusterBuilder);
+
+    Falcor::LightClusterBuilder::ViewParams view;
+    view.viewMat = pCamera->getViewMatrix();
+    view.tanHalfFovY = std::tan(0.5f * Falcor::focalLengthToFovY(pCamera->getFocalLength(), pCamera->getFrameHeight()));
+    view.tanHalfFovX = view.tanHalfFovY * pCamera->getAspectRatio();
+    view.nearZ = pCamera->getNearPlane();
+    view.farZ = pCamera->getFarPlane();
+
+    mpLightClusterBuilder->build(view, mLightBounds);
+
+    const auto& ranges = mpLightClusterBuilder->getClusterRanges();
+    mGpuLightClusterRangesBuffer->setBlob(ranges.data(), 0, ranges.size() * sizeof(ranges[0]));
+
+    // The number of entries changes with the view, grow the buffer when needed.
+    const auto& entries = mpLightClusterBuilder->getEntries();
+    const uint32_t entryCount = std::max((uint32_t)entries.size(), 1u);
+    if (!mGpuLightClusterEntriesBuffer || mGpuLightClusterEntriesBuffer->getElementCount() < entryCount)
+    {
+        const uint32_t capacity = mGpuLightClusterEntriesBuffer ? std::max(entryCount, mGpuLightClusterEntriesBuffer->getElementCount() * 2)
+                                                                : entryCount;
+        mGpuLightClusterEntriesBuffer = mpDevice->createStructuredBuffer(
+            sizeof(Falcor::LightClusterEntry), capacity, Falcor::ResourceBindFlags::ShaderResource, Falcor::MemoryType::DeviceLocal, nullptr, false
+        );
+    }
+
+    if (!entries.empty())
+        mGpuLightClusterEntriesBuffer->setBlob(entries.data(), 0, entries.size() * sizeof(entries[0]));
+}
+
+void LightManager::bindLightClusters(const Falcor::ShaderVar& var) const
+{
+    FALCOR_ASSERT(mpLightClusterBuilder);
+
+    var["grid"].setBlob(mpLightClusterBuilder->getGrid());
+    var["ranges"] = mGpuLightClusterRangesBuffer;
+    var["entries"] = mGpuLightClusterEntriesBuffer;
 }
 
 void LightManager::createArcadeSceneLights(Falcor::ref<Falcor::Scene> pScene)
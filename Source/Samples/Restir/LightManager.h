@@ -3,6 +3,8 @@
 #include "SceneName.h"
 #include "Singleton.h"
 #include "FloatRandomNumberGenerator.h"
+#include "Rendering/Lights/LightClusterBuilder.h"
+#include "Rendering/Lights/LightTileBuilder.h"
 
 namespace Restir
 {
@@ -14,6 +16,13 @@ struct Light
     float mfallOff;
 };
 
+// Matches RestirLightTileSample in Light.slangh.
+struct LightTileSample
+{
+    Light mLight;
+    float mPdf;
+};
+
 struct LightManager
 {
     LightManager();
@@ -25,6 +34,17 @@ struct LightManager
     inline const std::vector<float>& getLightProbabilities() const { return mLightProbabilities; }
     inline const Falcor::ref<Falcor::Buffer>& getLightProbabilitiesGpuBuffer() const { return mGpuLightProbabilityBuffer; }
 
+    // Light clusters. Only available when SceneSettings::useLightClusters is enabled.
+    void updateLightClusters(const Falcor::ref<Falcor::Camera>& pCamera);
+    void bindLightClusters(const Falcor::ShaderVar& var) const;
+    inline const Falcor::LightClusterBuilder::Stats& getLightClusterStats() const { return mpLightClusterBuilder->getStats(); }
+    inline bool hasLightClusters() const { return mpLightClusterBuilder != nullptr; }
+
+    // Light tiles. Only available when SceneSettings::useLightTiles is enabled, they are filled by the LightPresamplingPass.
+    inline bool hasLightTiles() const { return mGpuLightTilesBuffer != nullptr; }
+    inline const Falcor::ref<Falcor::Buffer>& getLightCdfGpuBuffer() const { return mGpuLightCdfBuffer; }
+    inline const Falcor::ref<Falcor::Buffer>& getLightTilesGpuBuffer() const { return mGpuLightTilesBuffer; }
+
 private:
     void createArcadeSceneLights(Falcor::ref<Falcor::Scene> pScene);
     void createDragonBuddhaSceneLights(Falcor::ref<Falcor::Scene> pScene);
@@ -38,11 +58,25 @@ private:
         uint32_t nbLightsAlongSegment
     );
 
+    // Distance from the light center beyond which its shading contribution is below SceneSettings::lightInfluenceThreshold.
+    float computeLightInfluenceRadius(const Light& light) const;
+    void createLightClusters();
+    void createLightTiles();
+
     std::vector<Light> mLights;
     Falcor::ref<Falcor::Buffer> mGpuLightBuffer;
 
     std::vector<float> mLightProbabilities;
     Falcor::ref<Falcor::Buffer> mGpuLightProbabilityBuffer;
+
+    Falcor::ref<Falcor::Device> mpDevice;
+    std::unique_ptr<Falcor::LightClusterBuilder> mpLightClusterBuilder;
+    std::vector<Falcor::LightClusterBuilder::LightBounds> mLightBounds;
+    Falcor::ref<Falcor::Buffer> mGpuLightClusterRangesBuffer;
+    Falcor::ref<Falcor::Buffer> mGpuLightClusterEntriesBuffer;
+
+    Falcor::ref<Falcor::Buffer> mGpuLightCdfBuffer;
+    Falcor::ref<Falcor::Buffer> mGpuLightTilesBuffer;
 };
 
 using LightManagerSingleton = Singleton<LightManager>;
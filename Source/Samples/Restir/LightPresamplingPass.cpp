@@ -0,0 +1,35 @@
+#include "LightPresamplingPass.h"
+#include "LightManager.h"
+#include "SceneSettings.h"
+
+namespace Restir
+{
+using namespace Falcor;
+
+LightPresamplingPass::LightPresamplingPass(ref<Device> pDevice)
+{
+    mpPresamplingPass = ComputePass::create(pDevice, "Samples/Restir/LightPresamplingPass.slang", "EntryPoint");
+}
+
+void LightPresamplingPass::render(Falcor::RenderContext* pRenderContext)
+{
+    FALCOR_PROFILE(pRenderContext, "LightPresamplingPass::render");
+
+    const uint32_t lightTileCount = SceneSettingsSingleton::instance()->lightTileCount;
+    const uint32_t lightTileSize = SceneSettingsSingleton::instance()->lightTileSize;
+
+    auto var = mpPresamplingPass->getRootVar();
+
+    var["PerFrameCB"]["lightCount"] = (uint32_t)LightManagerSingleton::instance()->getLights().size();
+    var["PerFrameCB"]["lightTileCount"] = lightTileCount;
+    var["PerFrameCB"]["lightTileSize"] = lightTileSize;
+    var["PerFrameCB"]["frameIndex"] = ++mFrameIndex;
+
+    var["gLights"] = LightManagerSingleton::instance()->getLightGpuBuffer();
+    var["gLightProbabilities"] = LightManagerSingleton::instance()->getLightProbabilitiesGpuBuffer();
+    var["gLightCdf"] = LightManagerSingleton::instance()->getLightCdfGpuBuffer();
+    var["gLightTiles"] = LightManagerSingleton::instance()->getLightTilesGpuBuffer();
+
+    mpPresamplingPass->execute(pRenderContext, lightTileSize, lightTileCount);
+}
+} // namespace Restir
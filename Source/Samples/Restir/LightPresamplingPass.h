@@ -0,0 +1,19 @@
+#pragma once
+#include "Falcor.h"
+
+namespace Restir
+{
+// Fills the light tiles of the LightManager with lights sampled proportionally to their luma.
+class LightPresamplingPass
+{
+public:
+    LightPresamplingPass(Falcor::ref<Falcor::Device> pDevice);
+
+    void render(Falcor::RenderContext* pRenderContext);
+
+private:
+    uint32_t mFrameIndex = 0u;
+
+    Falcor::ref<Falcor::ComputePass> mpPresamplingPass;
+};
+} // namespace Restir
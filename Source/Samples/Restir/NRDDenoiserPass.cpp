@@ -27,8 +27,9 @@ NRDDenoiserPass::NRDDenoiserPass(
 {
     mpDevice->requireD3D12();
 
-    mpPackNRDPass = ComputePass::create(pDevice, "Samples/Restir/NRDDenoiserPass_PackNRD.slang", "PackNRD");
-    mpUnpackNRDPass = ComputePass::create(pDevice, "Samples/Restir/NRDDenoiserPass_UnpackNRD.slang", "UnpackNRD");
+    const DefineList gBufferDefines = GBufferSingleton::instance()->getDefines();
+    mpPackNRDPass = ComputePass::create(pDevice, "Samples/Restir/NRDDenoiserPass_PackNRD.slang", "PackNRD", gBufferDefines);
+    mpUnpackNRDPass = ComputePass::create(pDevice, "Samples/Restir/NRDDenoiserPass_UnpackNRD.slang", "UnpackNRD", gBufferDefines);
 
     createFalcorTextures(pDevice);
     initNRD();
@@ -376,10 +377,8 @@ void NRDDenoiserPass::packNRD(Falcor::RenderContext* pRenderContext)
     var["gViewZ"] = mViewZTexture;
     var["gMotionVector"] = mMotionVectorTexture;
 
-    var["gPositionWs"] = GBufferSingleton::instance()->getCurrentPositionWsTexture();
-    var["gAlbedo"] = GBufferSingleton::instance()->getAlbedoTexture();
-    var["gNormalWs"] = GBufferSingleton::instance()->getCurrentNormalWsTexture();
-    var["gSpecular"] = GBufferSingleton::instance()->getSpecularTexture();
+    GBufferSingleton::instance()->bindGeometry(var["gGBuffer"]);
+    GBufferSingleton::instance()->bindMaterial(var["gMaterial"]);
 
     mpPackNRDPass->execute(pRenderContext, mWidth, mHeight);
 }
@@ -392,7 +391,7 @@ void NRDDenoiserPass::unpackNRD(Falcor::RenderContext* pRenderContext)
 
     var["PerFrameCB"]["viewportDims"] = uint2(mWidth, mHeight);
     var["gInOutOutput"] = mOuputTexture;
-    var["gPositionWs"] = GBufferSingleton::instance()->getCurrentPositionWsTexture();
+    GBufferSingleton::instance()->bindGeometry(var["gGBuffer"]);
 
     mpUnpackNRDPass->execute(pRenderContext, mWidth, mHeight);
 }
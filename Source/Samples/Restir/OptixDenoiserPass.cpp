@@ -69,8 +69,14 @@ OptixDenoiserPass::OptixDenoiserPass(
     : mpDevice(pDevice), mpScene(pScene), mInColorFromShadingPassTexture(inColorTexture), mWidth(width), mHeight(height)
 {
     mpConvertTexToBuf = ComputePass::create(mpDevice, "Samples/Restir/OptixDenoiserPass_ConvertTexToBuf.slang", "main");
-    mpConvertNormalsToBuf = ComputePass::create(mpDevice, "Samples/Restir/OptixDenoiserPass_ConvertNormalsToBuf.slang", "main");
-    mpComputeMotionVectors = ComputePass::create(mpDevice, "Samples/Restir/OptixDenoiserPass_ComputeMotionVectors.slang", "main");
+
+    const DefineList gBufferDefines = GBufferSingleton::instance()->getDefines();
+    mpConvertAlbedoToBuf =
+        ComputePass::create(mpDevice, "Samples/Restir/OptixDenoiserPass_ConvertAlbedoToBuf.slang", "main", gBufferDefines);
+    mpConvertNormalsToBuf =
+        ComputePass::create(mpDevice, "Samples/Restir/OptixDenoiserPass_ConvertNormalsToBuf.slang", "main", gBufferDefines);
+    mpComputeMotionVectors =
+        ComputePass::create(mpDevice, "Samples/Restir/OptixDenoiserPass_ComputeMotionVectors.slang", "main", gBufferDefines);
     mpConvertBufToTex = FullScreenPass::create(mpDevice, "Samples/Restir/OptixDenoiserPass_ConvertBufToTex.slang");
     mpFbo = Fbo::create(mpDevice);
 
@@ -208,14 +214,10 @@ void OptixDenoiserPass::render(RenderContext* pRenderContext)
     const uint2 bufferSize = uint2(mWidth, mHeight);
 
     convertTexToBuf(pRenderContext, mInColorFromShadingPassTexture, mDenoiser.interop.denoiserInput.buffer, bufferSize);
-    convertTexToBuf(pRenderContext, GBufferSingleton::instance()->getAlbedoTexture(), mDenoiser.interop.albedo.buffer, bufferSize);
+    convertAlbedoToBuf(pRenderContext, mDenoiser.interop.albedo.buffer, bufferSize);
 
     convertNormalsToBuf(
-        pRenderContext,
-        GBufferSingleton::instance()->getCurrentNormalWsTexture(),
-        mDenoiser.interop.normal.buffer,
-        bufferSize,
-        transpose(inverse(mpScene->getCamera()->getViewMatrix()))
+        pRenderContext, mDenoiser.interop.normal.buffer, bufferSize, transpose(inverse(mpScene->getCamera()->getViewMatrix()))
     );
 
     computeMotionVectors(pRenderContext, mDenoiser.interop.motionVec.buffer, bufferSize);
@@ -332,7 +334,7 @@ void OptixDenoiserPass::computeMotionVectors(RenderContext* pRenderContext, cons
     var["GlobalCB"]["viewportDims"] = uint2(mWidth, mHeight);
     var["GlobalCB"]["previousFrameViewProjMat"] = transpose(mPreviousFrameViewProjMat);
 
-    var["gInPositionWs"] = GBufferSingleton::instance()->getCurrentPositionWsTexture();
+    GBufferSingleton::instance()->bindGeometry(var["gGBuffer"]);
 
     var["gOutBuf"] = buf;
 
@@ -350,20 +352,26 @@ void OptixDenoiserPass::convertTexToBuf(RenderContext* pRenderContext, const ref
     mpConvertTexToBuf->execute(pRenderContext, size.x, size.y);
 }
 
-void OptixDenoiserPass::convertNormalsToBuf(
-    RenderContext* pRenderContext,
-    const ref<Texture>& tex,
-    const ref<Buffer>& buf,
-    const uint2& size,
-    float4x4 viewIT
-)
+void OptixDenoiserPass::convertAlbedoToBuf(RenderContext* pRenderContext, const ref<Buffer>& buf, const uint2& size)
+{
+    FALCOR_PROFILE(pRenderContext, "OptixDenoiserPass::convertAlbedoToBuf");
+
+    auto var = mpConvertAlbedoToBuf->getRootVar();
+    var["GlobalCB"]["viewportDims"] = uint2(mWidth, mHeight);
+    GBufferSingleton::instance()->bindGeometry(var["gGBuffer"]);
+    GBufferSingleton::instance()->bindMaterial(var["gMaterial"]);
+    var["gOutBuf"] = buf;
+    mpConvertAlbedoToBuf->execute(pRenderContext, size.x, size.y);
+}
+
+void OptixDenoiserPass::convertNormalsToBuf(RenderContext* pRenderContext, const ref<Buffer>& buf, const uint2& size, float4x4 viewIT)
 {
     FALCOR_PROFILE(pRenderContext, "OptixDenoiserPass::convertNormalsToBuf");
 
     auto var = mpConvertNormalsToBuf->getRootVar();
     var["GlobalCB"]["viewportDims"] = uint2(mWidth, mHeight);
     var["GlobalCB"]["gViewIT"] = viewIT;
-    var["gInTex"] = tex;
+    GBufferSingleton::instance()->bindGeometry(var["gGBuffer"]);
     var["gOutBuf"] = buf;
     mpConvertNormalsToBuf->execute(pRenderContext, size.x, size.y); // mpConvertTexToBuf->execute(pRenderContext, size.x, size.y);
 }
@@ -77,13 +77,8 @@ private:
     void setupDenoiser();
 
     void convertTexToBuf(RenderContext* pRenderContext, const ref<Texture>& tex, const ref<Buffer>& buf, const uint2& size);
-    void convertNormalsToBuf(
-        RenderContext* pRenderContext,
-        const ref<Texture>& tex,
-        const ref<Buffer>& buf,
-        const uint2& size,
-        float4x4 viewIT
-    );
+    void convertAlbedoToBuf(RenderContext* pRenderContext, const ref<Buffer>& buf, const uint2& size);
+    void convertNormalsToBuf(RenderContext* pRenderContext, const ref<Buffer>& buf, const uint2& size, float4x4 viewIT);
     void convertBufToTex(RenderContext* pRenderContext, const ref<Buffer>& buf, const ref<Texture>& tex, const uint2& size);
     void computeMotionVectors(RenderContext* pRenderContext, const ref<Buffer>& buf, const uint2& size);
 
@@ -141,6 +136,7 @@ private:
 
 
     ref<ComputePass> mpConvertTexToBuf;
+    ref<ComputePass> mpConvertAlbedoToBuf;
     ref<ComputePass> mpConvertNormalsToBuf;
     ref<ComputePass> mpComputeMotionVectors;
     ref<FullScreenPass> mpConvertBufToTex;
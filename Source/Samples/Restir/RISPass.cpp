@@ -10,32 +10,59 @@ using namespace Falcor;
 
 RISPass::RISPass(ref<Device> pDevice, uint32_t width, uint32_t height) : mWidth(width), mHeight(height)
 {
-    mpRISPass = ComputePass::create(pDevice, "Samples/Restir/RISPass.slang", "EntryPoint");
+    FALCOR_CHECK(
+        !LightManagerSingleton::instance()->hasLightClusters() || !LightManagerSingleton::instance()->hasLightTiles(),
+        "Light clusters and light tiles can't be used together."
+    );
+
+    DefineList defines = GBufferSingleton::instance()->getDefines();
+    defines.add("USE_LIGHT_CLUSTERS", LightManagerSingleton::instance()->hasLightClusters() ? "1" : "0");
+    defines.add("USE_LIGHT_TILES", LightManagerSingleton::instance()->hasLightTiles() ? "1" : "0");
+    defines.add("USE_ADAPTIVE_RIS", SceneSettingsSingleton::instance()->adaptiveRIS ? "1" : "0");
+
+    mpRISPass = ComputePass::create(pDevice, "Samples/Restir/RISPass.slang", "EntryPoint", defines);
 }
 
-void RISPass::render(Falcor::RenderContext* pRenderContext, ref<Camera> pCamera)
+void RISPass::render(Falcor::RenderContext* pRenderContext, ref<Camera> pCamera, const AdaptiveSamplingPass* pAdaptiveSamplingPass)
 {
     FALCOR_PROFILE(pRenderContext, "RISPass::render");
 
     auto var = mpRISPass->getRootVar();
 
-    var["PerFrameCB"]["viewportDims"] = uint2(mWidth, mHeight);
+    const uint2 renderDims = GBufferSingleton::instance()->getRenderDims();
+
+    var["PerFrameCB"]["viewportDims"] = renderDims;
     var["PerFrameCB"]["cameraPositionWs"] = pCamera->getPosition();
+    var["PerFrameCB"]["cameraForwardWs"] = normalize(pCamera->getTarget() - pCamera->getPosition());
     var["PerFrameCB"]["sampleIndex"] = ++mSampleIndex;
     var["PerFrameCB"]["nbReservoirPerPixel"] = SceneSettingsSingleton::instance()->nbReservoirPerPixel;
     var["PerFrameCB"]["lightCount"] = (uint32_t)LightManagerSingleton::instance()->getLights().size();
     var["PerFrameCB"]["RISSamplesCount"] = SceneSettingsSingleton::instance()->RISSamplesCount;
+    var["PerFrameCB"]["lightTileCount"] = SceneSettingsSingleton::instance()->lightTileCount;
+    var["PerFrameCB"]["lightTileSize"] = SceneSettingsSingleton::instance()->lightTileSize;
+    var["PerFrameCB"]["minRISSamplesCount"] = SceneSettingsSingleton::instance()->adaptiveMinRISSamplesCount;
+    var["PerFrameCB"]["maxRISSamplesCount"] = SceneSettingsSingleton::instance()->adaptiveMaxRISSamplesCount;
 
     var["gReservoirs"] = ReservoirManagerSingleton::instance()->getCurrentFrameReservoirBuffer();
     var["gLights"] = LightManagerSingleton::instance()->getLightGpuBuffer();
     var["gLightProbabilities"] = LightManagerSingleton::instance()->getLightProbabilitiesGpuBuffer();
 
-    var["gPositionWs"] = GBufferSingleton::instance()->getCurrentPositionWsTexture();
-    var["gNormalWs"] = GBufferSingleton::instance()->getCurrentNormalWsTexture();
-    var["gAlbedo"] = GBufferSingleton::instance()->getAlbedoTexture();
-    var["gSpecular"] = GBufferSingleton::instance()->getSpecularTexture();
+    if (LightManagerSingleton::instance()->hasLightClusters())
+        LightManagerSingleton::instance()->bindLightClusters(var["gLightClusters"]);
+
+    if (SceneSettingsSingleton::instance()->adaptiveRIS)
+    {
+        FALCOR_CHECK(pAdaptiveSamplingPass, "Adaptive RIS requires the adaptive sampling pass.");
+        pAdaptiveSamplingPass->bindShaderData(var);
+    }
+
+    if (LightManagerSingleton::instance()->hasLightTiles())
+        var["gLightTiles"] = LightManagerSingleton::instance()->getLightTilesGpuBuffer();
+
+    GBufferSingleton::instance()->bindGeometry(var["gGBuffer"]);
+    GBufferSingleton::instance()->bindMaterial(var["gMaterial"]);
 
-    mpRISPass->execute(pRenderContext, mWidth, mHeight);
+    mpRISPass->execute(pRenderContext, renderDims.x, renderDims.y);
 }
 } // namespace Restir
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "Falcor.h"
+#include "AdaptiveSamplingPass.h"
 
 namespace Restir
 {
@@ -8,7 +9,12 @@ class RISPass
 public:
     RISPass(Falcor::ref<Falcor::Device> pDevice, uint32_t width, uint32_t height);
 
-    void render(Falcor::RenderContext* pRenderContext, Falcor::ref<Falcor::Camera> pCamera);
+    // pAdaptiveSamplingPass must be provided when SceneSettings::adaptiveRIS is enabled.
+    void render(
+        Falcor::RenderContext* pRenderContext,
+        Falcor::ref<Falcor::Camera> pCamera,
+        const AdaptiveSamplingPass* pAdaptiveSamplingPass = nullptr
+    );
 
 private:
     uint32_t mWidth;
@@ -19,22 +19,23 @@ void ReservoirManager::init(Falcor::ref<Falcor::Device> pDevice, uint32_t width,
     //	Create GPU reservoirs
     //------------------------------------------------------------------------------------------------------------
 
-    mCurrentFrameReservoir = pDevice->createStructuredBuffer(
-        sizeof(RestirReservoir),
-        reservoirs.size(),
-        Falcor::ResourceBindFlags::ShaderResource | Falcor::ResourceBindFlags::UnorderedAccess,
-        Falcor::MemoryType::DeviceLocal,
-        reservoirs.data(),
-        false
-    );
-
-    mPreviousFrameReservoir = pDevice->createStructuredBuffer(
-        sizeof(RestirReservoir),
-        reservoirs.size(),
-        Falcor::ResourceBindFlags::ShaderResource | Falcor::ResourceBindFlags::UnorderedAccess,
-        Falcor::MemoryType::DeviceLocal,
-        reservoirs.data(),
-        false
+    // The ring needs at least the previous frame for temporal reuse.
+    const uint32_t historyDepth = std::max(SceneSettingsSingleton::instance()->reservoirHistoryDepth, 2u);
+
+    mReservoirs.setValidationEnabled(SceneSettingsSingleton::instance()->validateHistory);
+    mReservoirs.init(
+        historyDepth,
+        [&]()
+        {
+            return pDevice->createStructuredBuffer(
+                sizeof(RestirReservoir),
+                reservoirs.size(),
+                Falcor::ResourceBindFlags::ShaderResource | Falcor::ResourceBindFlags::UnorderedAccess,
+                Falcor::MemoryType::DeviceLocal,
+                reservoirs.data(),
+                false
+            );
+        }
     );
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "HistoryRing.h"
 #include "Singleton.h"
 
 namespace Restir
@@ -26,14 +27,17 @@ struct ReservoirManager
 
     void init(Falcor::ref<Falcor::Device> pDevice, uint32_t width, uint32_t height);
 
-    inline const Falcor::ref<Falcor::Buffer>& getCurrentFrameReservoirBuffer() const { return mCurrentFrameReservoir; }
-    inline const Falcor::ref<Falcor::Buffer>& getPreviousFrameReservoirBuffer() const { return mPreviousFrameReservoir; }
+    inline const Falcor::ref<Falcor::Buffer>& getCurrentFrameReservoirBuffer() const { return mReservoirs.get(0); }
+    inline const Falcor::ref<Falcor::Buffer>& getPreviousFrameReservoirBuffer() const { return mReservoirs.get(1); }
 
-    inline void setNextFrame() { std::swap(mCurrentFrameReservoir, mPreviousFrameReservoir); }
+    // Reservoirs of older frames, age 0 being the current frame.
+    inline const Falcor::ref<Falcor::Buffer>& getReservoirBuffer(uint32_t age) const { return mReservoirs.get(age); }
+    inline const HistoryRing<Falcor::Buffer>& getReservoirHistory() const { return mReservoirs; }
+
+    inline void setNextFrame() { mReservoirs.setNextFrame(); }
 
 private:
-    Falcor::ref<Falcor::Buffer> mCurrentFrameReservoir;
-    Falcor::ref<Falcor::Buffer> mPreviousFrameReservoir;
+    HistoryRing<Falcor::Buffer> mReservoirs;
 };
 
 using ReservoirManagerSingleton = Singleton<ReservoirManager>;
@@ -8,6 +8,7 @@
 #include "Utils/Math/FalcorMath.h"
 #include "Utils/UI/TextRenderer.h"
 #include <sstream>
+#include <args.hxx>
 #include <windows.h>
 #include <iostream>
 
@@ -43,7 +44,17 @@ std::wstring ExePath()
     return std::wstring(buffer).substr(0, pos);
 }
 
-RestirApp::RestirApp(const SampleAppConfig& config) : SampleApp(config) {}
+RestirApp::RestirApp(const SampleAppConfig& config) : RestirApp(config, std::nullopt, {}) {}
+
+RestirApp::RestirApp(
+    const SampleAppConfig& config,
+    const std::optional<Restir::BenchmarkOptions>& benchmarkOptions,
+    const std::filesystem::path& recordCameraPathFile
+)
+    : SampleApp(config), mBenchmarkOptions(benchmarkOptions), mRecordCameraPathFile(recordCameraPathFile)
+{
+    FALCOR_CHECK(!mBenchmarkOptions || mRecordCameraPathFile.empty(), "A camera path cannot be recorded while benchmarking.");
+}
 
 RestirApp::~RestirApp() {}
 
@@ -79,6 +90,28 @@ void RestirApp::onLoad(RenderContext* pRenderContext)
     Restir::ApplicationPathsManagerSingleton::instance()->setSharedDataPath(str);
 
     loadScene(getTargetFbo().get(), pRenderContext);
+
+    if (mBenchmarkOptions)
+    {
+        mpBenchmark = std::make_unique<Restir::Benchmark>(*mBenchmarkOptions);
+
+        // Pin the clock to a fixed time step so that animations and the frame seeds only depend on the frame index.
+        // The passes seed their samplers with frame counters starting at 0, so every run renders the same frames.
+        getGlobalClock().setTime(0.0).setFramerate(60);
+        getDevice()->getProfiler()->setEnabled(true);
+
+        if (mpAdaptiveSamplingPass || mpDynamicResolution)
+            logWarning("Benchmark: adaptive RIS or dynamic resolution is enabled, the workload depends on the measured frame times.");
+    }
+}
+
+void RestirApp::onShutdown()
+{
+    if (!mRecordCameraPathFile.empty() && mRecordedCameraPath.getKeyframeCount() > 0)
+    {
+        mRecordedCameraPath.save(mRecordCameraPathFile);
+        logInfo("Recorded {} camera keyframes to '{}'.", mRecordedCameraPath.getKeyframeCount(), mRecordCameraPathFile.string());
+    }
 }
 
 void RestirApp::onResize(uint32_t width, uint32_t height)
@@ -97,6 +130,12 @@ void RestirApp::onFrameRender(RenderContext* pRenderContext, const ref<Fbo>& pTa
 {
     if (mpScene)
     {
+        if (mpBenchmark && !mpBenchmark->beginFrame(getDevice()->getProfiler(), mpCamera))
+        {
+            shutdown();
+            return;
+        }
+
         IScene::UpdateFlags updates = mpScene->update(pRenderContext, getGlobalClock().getTime());
         if (is_set(updates, IScene::UpdateFlags::GeometryChanged))
             FALCOR_THROW("This sample does not support scene geometry changes.");
@@ -109,7 +148,55 @@ void RestirApp::onFrameRender(RenderContext* pRenderContext, const ref<Fbo>& pTa
     getTextRenderer().render(pRenderContext, getFrameRate().getMsg(), pTargetFbo, {20, 20});
 }
 
-void RestirApp::onGuiRender(Gui* pGui) {}
+void RestirApp::onGuiRender(Gui* pGui)
+{
+    if (!mpScene)
+        return;
+
+    const bool hasLightClusters = Restir::LightManagerSingleton::instance()->hasLightClusters();
+    if (!hasLightClusters && !mpAdaptiveSamplingPass && !mpDynamicResolution)
+        return;
+
+    Gui::Window w(pGui, "Restir", {300, 200}, {10, 80});
+
+    if (hasLightClusters)
+    {
+        if (auto g = w.group("Light clusters", true))
+        {
+            const auto& stats = Restir::LightManagerSingleton::instance()->getLightClusterStats();
+            g.text(fmt::format("Clusters: {} ({} non-empty)", stats.clusterCount, stats.nonEmptyClusterCount));
+            g.text(fmt::format("Light references: {}", stats.lightReferenceCount));
+            g.text(fmt::format("Lights per non-empty cluster: {:.2f} avg, {} max", stats.avgLightsPerNonEmptyCluster, stats.maxLightsPerCluster));
+            g.text(fmt::format("Culled lights: {}", stats.culledLightCount));
+        }
+    }
+
+    if (mpAdaptiveSamplingPass)
+    {
+        if (auto g = w.group("Adaptive RIS", true))
+        {
+            const auto& controller = mpAdaptiveSamplingPass->getController();
+            g.text(fmt::format("GPU frame time: {:.2f} ms (target {:.2f} ms)", controller.getFilteredTimeMs(), controller.getOptions().targetTimeMs));
+            g.text(fmt::format("Budget scale: {:.2f}", controller.getScale()));
+            g.text(fmt::format(
+                "Candidate budget per pixel: {:.1f}",
+                Restir::SceneSettingsSingleton::instance()->RISSamplesCount * controller.getScale()
+            ));
+        }
+    }
+
+    if (mpDynamicResolution)
+    {
+        if (auto g = w.group("Dynamic resolution", true))
+        {
+            const auto& controller = mpDynamicResolution->getController();
+            const uint2 renderDims = mpDynamicResolution->getRenderResolution();
+            g.text(fmt::format("GPU frame time: {:.2f} ms (target {:.2f} ms)", controller.getFilteredTimeMs(), controller.getOptions().targetTimeMs));
+            g.text(fmt::format("Resolution scale: {:.2f}", mpDynamicResolution->getScale()));
+            g.text(fmt::format("Render resolution: {}x{}", renderDims.x, renderDims.y));
+        }
+    }
+}
 
 bool RestirApp::onKeyEvent(const KeyboardEvent& keyEvent)
 {
@@ -171,6 +258,8 @@ void RestirApp::loadScene(const Fbo* pTargetFbo, RenderContext* pRenderContext)
         Restir::SceneSettingsSingleton::instance()->temporalNormalThreshold = 0.8f;
 
         Restir::SceneSettingsSingleton::instance()->sceneAmbientColor = Falcor::float3(0.04f, 0.04f, 0.04f);
+
+        Restir::SceneSettingsSingleton::instance()->useLightClusters = true;
         break;
     }
 
@@ -185,6 +274,34 @@ void RestirApp::loadScene(const Fbo* pTargetFbo, RenderContext* pRenderContext)
     Restir::ReservoirManagerSingleton::instance()->init(getDevice(), pTargetFbo->getWidth(), pTargetFbo->getHeight());
 
     // Create the render passes.
+    const Restir::SceneSettings& settings = *Restir::SceneSettingsSingleton::instance();
+    FALCOR_CHECK(!settings.adaptiveRIS || !settings.dynamicResolution, "Adaptive RIS and dynamic resolution can't be used together.");
+
+    if (settings.dynamicResolution)
+    {
+        // The resolution is driven by the GPU frame time measured by the profiler.
+        // All the resources keep the output resolution, frames are rendered in their top-left corner.
+        getDevice()->getProfiler()->setEnabled(true);
+
+        DynamicResolution::Options options;
+        options.targetTimeMs = settings.dynamicResolutionTargetFrameTimeMs;
+        options.minScale = settings.dynamicResolutionMinScale;
+        options.maxScale = settings.dynamicResolutionMaxScale;
+        mpDynamicResolution = std::make_unique<DynamicResolution>(uint2(pTargetFbo->getWidth(), pTargetFbo->getHeight()), options);
+
+        mpUpscalePass = new Restir::UpscalePass(getDevice(), pTargetFbo->getWidth(), pTargetFbo->getHeight());
+    }
+
+    if (Restir::SceneSettingsSingleton::instance()->adaptiveRIS)
+    {
+        // The budget is driven by the GPU frame time measured by the profiler.
+        getDevice()->getProfiler()->setEnabled(true);
+        mpAdaptiveSamplingPass = new Restir::AdaptiveSamplingPass(getDevice(), pTargetFbo->getWidth(), pTargetFbo->getHeight());
+    }
+
+    if (Restir::LightManagerSingleton::instance()->hasLightTiles())
+        mpLightPresamplingPass = new Restir::LightPresamplingPass(getDevice());
+
     mpRISPass = new Restir::RISPass(getDevice(), pTargetFbo->getWidth(), pTargetFbo->getHeight());
     mpVisibilityPass = new Restir::VisibilityPass(getDevice(), mpScene, pTargetFbo->getWidth(), pTargetFbo->getHeight());
 
@@ -199,13 +316,16 @@ void RestirApp::loadScene(const Fbo* pTargetFbo, RenderContext* pRenderContext)
     mpShadingPass = new Restir::ShadingPass(getDevice(), pTargetFbo->getWidth(), pTargetFbo->getHeight());
 
 #if USE_DENOISING
+    // The denoiser runs at the output resolution.
+    ref<Texture>& pDenoiserInput = mpUpscalePass ? mpUpscalePass->getOuputTexture() : mpShadingPass->getOuputTexture();
+
 #if DENOISING_NRD
     mpDenoisingPass = new Restir::NRDDenoiserPass(
-        getDevice(), pRenderContext, mpScene, mpShadingPass->getOuputTexture(), pTargetFbo->getWidth(), pTargetFbo->getHeight()
+        getDevice(), pRenderContext, mpScene, pDenoiserInput, pTargetFbo->getWidth(), pTargetFbo->getHeight()
     );
 #else
     mpDenoisingPass = new Restir::OptixDenoiserPass(
-        getDevice(), mpScene, pRenderContext, mpShadingPass->getOuputTexture(), pTargetFbo->getWidth(), pTargetFbo->getHeight()
+        getDevice(), mpScene, pRenderContext, pDenoiserInput, pTargetFbo->getWidth(), pTargetFbo->getHeight()
     );
 #endif
 #endif
@@ -216,15 +336,33 @@ void RestirApp::render(RenderContext* pRenderContext, const ref<Fbo>& pTargetFbo
     FALCOR_ASSERT(mpScene);
     FALCOR_PROFILE(pRenderContext, "RestirApp::render");
 
-    /*
-    std::cout << mpCamera->getPosition().x << " " << mpCamera->getPosition().y << " " << mpCamera->getPosition().z << std::endl;
-    std::cout << mpCamera->getTarget().x << " " << mpCamera->getTarget().y << " " << mpCamera->getTarget().z << std::endl;
-    std::cout << mpCamera->getUpVector().x << " " << mpCamera->getUpVector().y << " " << mpCamera->getUpVector().z << std::endl;
-    std::cout << mpCamera->getFocalLength() << std::endl;
-    std::cout << "-------------------------------------------------------------------------------------------------" << std::endl;
-    */
+    if (!mRecordCameraPathFile.empty())
+        mRecordedCameraPath.addKeyframe(mpCamera);
+
+    if (mpAdaptiveSamplingPass || mpDynamicResolution)
+    {
+        // GPU time of the last frame the profiler has resolved.
+        const Profiler::Event* pEvent = getDevice()->getProfiler()->getEvent("/onFrameRender/RestirApp::render");
+
+        if (mpAdaptiveSamplingPass)
+            mpAdaptiveSamplingPass->updateBudget(pEvent->getGpuTime());
+
+        if (mpDynamicResolution)
+        {
+            mpDynamicResolution->update(pEvent->getGpuTime());
+            Restir::GBufferSingleton::instance()->setRenderDims(mpDynamicResolution->getRenderResolution());
+        }
+    }
+
     Restir::GBufferSingleton::instance()->render(pRenderContext);
-    mpRISPass->render(pRenderContext, mpCamera);
+
+    if (Restir::LightManagerSingleton::instance()->hasLightClusters())
+        Restir::LightManagerSingleton::instance()->updateLightClusters(mpCamera);
+
+    if (mpLightPresamplingPass)
+        mpLightPresamplingPass->render(pRenderContext);
+
+    mpRISPass->render(pRenderContext, mpCamera, mpAdaptiveSamplingPass);
     mpVisibilityPass->render(pRenderContext);
 
 #if USE_TEMPORAL_FILTERING
@@ -237,24 +375,81 @@ void RestirApp::render(RenderContext* pRenderContext, const ref<Fbo>& pTargetFbo
 
     mpShadingPass->render(pRenderContext, mpCamera);
 
+    // Output resolution texture of this frame.
+    ref<Texture> pColorTexture = mpShadingPass->getOuputTexture();
+    if (mpUpscalePass)
+    {
+        mpUpscalePass->render(pRenderContext, mpShadingPass->getOuputTexture(), Restir::GBufferSingleton::instance()->getRenderDims());
+        pColorTexture = mpUpscalePass->getOuputTexture();
+    }
+
+    if (mpAdaptiveSamplingPass)
+        mpAdaptiveSamplingPass->render(pRenderContext, mpShadingPass->getOuputTexture());
+
 #if USE_DENOISING
     mpDenoisingPass->render(pRenderContext);
     pRenderContext->blit(mpDenoisingPass->getOuputTexture()->getSRV(), pTargetFbo->getRenderTargetView(0));
 #else
-    pRenderContext->blit(mpShadingPass->getOuputTexture()->getSRV(), pTargetFbo->getRenderTargetView(0));
+    pRenderContext->blit(pColorTexture->getSRV(), pTargetFbo->getRenderTargetView(0));
 #endif
 
     Restir::GBufferSingleton::instance()->setNextFrame();
     Restir::ReservoirManagerSingleton::instance()->setNextFrame();
+
+    if (Restir::SceneSettingsSingleton::instance()->validateHistory)
+    {
+        FALCOR_CHECK(
+            Restir::GBufferSingleton::instance()->getPositionWsHistory().getFrameId() ==
+                Restir::ReservoirManagerSingleton::instance()->getReservoirHistory().getFrameId(),
+            "GBuffer and reservoir histories are out of sync."
+        );
+    }
 }
 
 int runMain(int argc, char** argv)
 {
+    args::ArgumentParser parser("Restir sample.");
+    parser.helpParams.programName = "Restir";
+    args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
+    args::ValueFlag<std::string> benchmarkFlag(parser, "path", "Run the benchmark replaying the given camera path file.", {"benchmark"});
+    args::ValueFlag<uint32_t> warmupFramesFlag(parser, "N", "Number of benchmark warmup frames.", {"warmup-frames"}, 60u);
+    args::ValueFlag<uint32_t> measuredFramesFlag(parser, "N", "Number of benchmark measured frames.", {"measured-frames"}, 600u);
+    args::ValueFlag<std::string> benchmarkOutputFlag(
+        parser, "path", "Benchmark results path, without extension.", {"benchmark-output"}, "RestirBenchmark"
+    );
+    args::ValueFlag<std::string> recordCameraFlag(parser, "path", "Record the camera path to the given file on exit.", {"record-camera"});
+
+    try
+    {
+        parser.ParseCLI(argc, argv);
+    }
+    catch (const args::Help&)
+    {
+        std::cout << parser;
+        return 0;
+    }
+    catch (const args::ParseError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    std::optional<Restir::BenchmarkOptions> benchmarkOptions;
+    if (benchmarkFlag)
+    {
+        benchmarkOptions = Restir::BenchmarkOptions();
+        benchmarkOptions->cameraPathFile = args::get(benchmarkFlag);
+        benchmarkOptions->warmupFrames = args::get(warmupFramesFlag);
+        benchmarkOptions->measuredFrames = args::get(measuredFramesFlag);
+        benchmarkOptions->outputPath = args::get(benchmarkOutputFlag);
+    }
+
     SampleAppConfig config;
     config.windowDesc.title = "HelloRestir";
     config.windowDesc.resizableWindow = true;
 
-    RestirApp helloRestir(config);
+    RestirApp helloRestir(config, benchmarkOptions, recordCameraFlag ? args::get(recordCameraFlag) : std::string());
     return helloRestir.run();
 }
 
@@ -1,15 +1,23 @@
 #pragma once
 
 #include "Falcor.h"
+#include "AdaptiveSamplingPass.h"
+#include "Benchmark.h"
+#include "CameraPath.h"
 #include "NRDDenoiserPass.h"
 #include "GBuffer.h"
+#include "LightPresamplingPass.h"
 #include "OptixDenoiserPass.h"
 #include "RISPass.h"
 #include "ShadingPass.h"
 #include "SpatialFilteringPass.h"
 #include "TemporalFilteringPass.h"
+#include "UpscalePass.h"
 #include "VisibilityPass.h"
 #include "Core/SampleApp.h"
+#include "Rendering/Utils/DynamicResolution.h"
+#include <memory>
+#include <optional>
 
 using namespace Falcor;
 
@@ -19,9 +27,11 @@ class RestirApp : public SampleApp
 {
 public:
     RestirApp(const SampleAppConfig& config);
+    RestirApp(const SampleAppConfig& config, const std::optional<Restir::BenchmarkOptions>& benchmarkOptions, const std::filesystem::path& recordCameraPathFile);
     ~RestirApp();
 
     void onLoad(RenderContext* pRenderContext) override;
+    void onShutdown() override;
     void onResize(uint32_t width, uint32_t height) override;
     void onFrameRender(RenderContext* pRenderContext, const ref<Fbo>& pTargetFbo) override;
     void onGuiRender(Gui* pGui) override;
@@ -35,11 +45,23 @@ private:
     ref<Scene> mpScene;
     ref<Camera> mpCamera;
 
+    std::unique_ptr<Restir::Benchmark> mpBenchmark;
+    std::optional<Restir::BenchmarkOptions> mBenchmarkOptions;
+
+    // Camera path recorded from the interactive camera, one keyframe per frame.
+    Restir::CameraPath mRecordedCameraPath;
+    std::filesystem::path mRecordCameraPathFile;
+
+    Restir::AdaptiveSamplingPass* mpAdaptiveSamplingPass = nullptr;
+    Restir::LightPresamplingPass* mpLightPresamplingPass = nullptr;
     Restir::RISPass* mpRISPass = nullptr;
     Restir::VisibilityPass* mpVisibilityPass = nullptr;
     Restir::ShadingPass* mpShadingPass = nullptr;
     Restir::TemporalFilteringPass* mpTemporalFilteringPass = nullptr;
     Restir::SpatialFilteringPass* mpSpatialFilteringPass = nullptr;
+    Restir::UpscalePass* mpUpscalePass = nullptr;
+
+    std::unique_ptr<DynamicResolution> mpDynamicResolution;
 
 #if DENOISING_NRD
     Restir::NRDDenoiserPass* mpDenoisingPass = nullptr;
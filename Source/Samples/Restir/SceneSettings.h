@@ -9,6 +9,25 @@ struct SceneSettings
     uint32_t RISSamplesCount = 32u;
     uint32_t nbReservoirPerPixel = 4u;
 
+    // Adaptive RIS settings. When enabled, each pixel uses RISSamplesCount * budget scale * pixel weight candidates.
+    // The budget scale is driven by the GPU frame time and the pixel weight by the variance and change of its luminance.
+    // The number of reservoirs per pixel is not adapted since it defines the reservoir buffer layout.
+    bool adaptiveRIS = false;
+    float adaptiveTargetFrameTimeMs = 16.6f;
+    uint32_t adaptiveMinRISSamplesCount = 4u;
+    uint32_t adaptiveMaxRISSamplesCount = 64u;
+    float adaptiveMinPixelWeight = 0.25f;
+    float adaptiveSensitivity = 4.0f;
+    float adaptiveMomentsAlpha = 0.2f;
+
+    // Dynamic resolution settings. When enabled, frames are rendered at a per-axis scale of the output resolution in
+    // [dynamicResolutionMinScale, dynamicResolutionMaxScale], driven by the GPU frame time, and upscaled before denoising.
+    // Exclusive with adaptive RIS since both adapt the workload to the same frame time.
+    bool dynamicResolution = false;
+    float dynamicResolutionTargetFrameTimeMs = 16.6f;
+    float dynamicResolutionMinScale = 0.5f;
+    float dynamicResolutionMaxScale = 1.0f;
+
     // Temporal settings
     float temporalWsRadiusThreshold = 999999999.0f;
     float temporalLinearDepthThreshold = 0.4f;
@@ -18,6 +37,29 @@ struct SceneSettings
     float spatialWsRadiusThreshold = 999999999.0f;
     float spatialNormalThreshold = 0.12f;
 
+    // Light cluster settings. When enabled, RIS candidates are drawn from the lights influencing the pixel's cluster.
+    // A light influences the points where its shading contribution is above lightInfluenceThreshold.
+    bool useLightClusters = false;
+    Falcor::uint3 lightClusterGridSize = Falcor::uint3(16u, 9u, 24u);
+    float lightInfluenceThreshold = 0.05f;
+
+    // Light tile settings. When enabled, lights are pre-sampled each frame into lightTileCount tiles of lightTileSize samples
+    // and each 16x16 screen tile draws its RIS candidates from a single light tile. Exclusive with light clusters.
+    bool useLightTiles = false;
+    uint32_t lightTileCount = 128u;
+    uint32_t lightTileSize = 1024u;
+
+    // GBuffer settings. The packed layout uses 16 bytes per pixel instead of 64 and reconstructs positions from depth.
+    bool packedGBuffer = true;
+
+    // History settings. The depth is the number of frames kept for temporal reuse, the current frame included.
+    uint32_t reservoirHistoryDepth = 2u;
+    uint32_t gBufferHistoryDepth = 2u;
+    // Formats of the unpacked GBuffer history.
+    Falcor::ResourceFormat positionHistoryFormat = Falcor::ResourceFormat::RGBA32Float;
+    Falcor::ResourceFormat normalHistoryFormat = Falcor::ResourceFormat::RGBA32Float;
+    bool validateHistory = false;
+
     // Lighting settings
     float sceneShadingLightExponent = 1.0f;
     Falcor::float3 sceneAmbientColor = Falcor::float3(0.0f, 0.0f, 0.0f);
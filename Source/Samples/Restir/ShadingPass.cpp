@@ -11,7 +11,7 @@ using namespace Falcor;
 
 ShadingPass::ShadingPass(Falcor::ref<Falcor::Device> pDevice, uint32_t width, uint32_t height) : mWidth(width), mHeight(height)
 {
-    mpShadingPass = ComputePass::create(pDevice, "Samples/Restir/ShadingPass.slang", "ShadingPass");
+    mpShadingPass = ComputePass::create(pDevice, "Samples/Restir/ShadingPass.slang", "ShadingPass", GBufferSingleton::instance()->getDefines());
 
     mpOuputTexture = pDevice->createTexture2D(
         width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource
@@ -28,7 +28,9 @@ void ShadingPass::render(Falcor::RenderContext* pRenderContext, ref<Camera> pCam
 
     auto var = mpShadingPass->getRootVar();
 
-    var["PerFrameCB"]["viewportDims"] = uint2(mWidth, mHeight);
+    const uint2 renderDims = GBufferSingleton::instance()->getRenderDims();
+
+    var["PerFrameCB"]["viewportDims"] = renderDims;
     var["PerFrameCB"]["cameraPositionWs"] = pCamera->getPosition();
     var["PerFrameCB"]["nbReservoirPerPixel"] = SceneSettingsSingleton::instance()->nbReservoirPerPixel;
     var["PerFrameCB"]["sceneShadingLightExponent"] = SceneSettingsSingleton::instance()->sceneShadingLightExponent;
@@ -37,13 +39,11 @@ void ShadingPass::render(Falcor::RenderContext* pRenderContext, ref<Camera> pCam
     var["gOutput"] = mpOuputTexture;
     var["gReservoirs"] = ReservoirManagerSingleton::instance()->getCurrentFrameReservoirBuffer();
 
-    var["gPositionWs"] = GBufferSingleton::instance()->getCurrentPositionWsTexture();
-    var["gNormalWs"] = GBufferSingleton::instance()->getCurrentNormalWsTexture();
-    var["gAlbedo"] = GBufferSingleton::instance()->getAlbedoTexture();
-    var["gSpecular"] = GBufferSingleton::instance()->getSpecularTexture();
+    GBufferSingleton::instance()->bindGeometry(var["gGBuffer"]);
+    GBufferSingleton::instance()->bindMaterial(var["gMaterial"]);
 
     var["gBlueNoise"] = mpBlueNoiseTexture;
 
-    mpShadingPass->execute(pRenderContext, mWidth, mHeight);
+    mpShadingPass->execute(pRenderContext, renderDims.x, renderDims.y);
 }
 } // namespace Restir
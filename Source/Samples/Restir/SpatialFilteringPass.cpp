@@ -10,7 +10,9 @@ using namespace Falcor;
 SpatialFilteringPass::SpatialFilteringPass(ref<Device> pDevice, Falcor::ref<Falcor::Scene> pScene, uint32_t width, uint32_t height)
     : mpScene(pScene), mWidth(width), mHeight(height)
 {
-    mpSpatialFilteringPass = ComputePass::create(pDevice, "Samples/Restir/SpatialFilteringPass.slang", "SpatialFiltering");
+    mpSpatialFilteringPass = ComputePass::create(
+        pDevice, "Samples/Restir/SpatialFilteringPass.slang", "SpatialFiltering", GBufferSingleton::instance()->getDefines()
+    );
 
     const uint32_t nbPixels = width * height;
     const uint32_t nbReservoirs = nbPixels * SceneSettingsSingleton::instance()->nbReservoirPerPixel;
@@ -37,7 +39,9 @@ void SpatialFilteringPass::performSpatialFiltering(Falcor::RenderContext* pRende
 
     auto var = mpSpatialFilteringPass->getRootVar();
 
-    var["PerFrameCB"]["viewportDims"] = uint2(mWidth, mHeight);
+    const uint2 renderDims = GBufferSingleton::instance()->getRenderDims();
+
+    var["PerFrameCB"]["viewportDims"] = renderDims;
     var["PerFrameCB"]["cameraPositionWs"] = mpScene->getCamera()->getPosition();
     var["PerFrameCB"]["nbReservoirPerPixel"] = SceneSettingsSingleton::instance()->nbReservoirPerPixel;
     var["PerFrameCB"]["sampleIndex"] = ++mSampleIndex;
@@ -48,12 +52,10 @@ void SpatialFilteringPass::performSpatialFiltering(Falcor::RenderContext* pRende
     var["gCurrentFrameReservoirs"] = ReservoirManagerSingleton::instance()->getCurrentFrameReservoirBuffer();
     var["gStagingReservoirs"] = mpStagingReservoirs;
 
-    var["gPositionWs"] = GBufferSingleton::instance()->getCurrentPositionWsTexture();
-    var["gNormalWs"] = GBufferSingleton::instance()->getCurrentNormalWsTexture();
-    var["gAlbedo"] = GBufferSingleton::instance()->getAlbedoTexture();
-    var["gSpecular"] = GBufferSingleton::instance()->getSpecularTexture();
+    GBufferSingleton::instance()->bindGeometry(var["gGBuffer"]);
+    GBufferSingleton::instance()->bindMaterial(var["gMaterial"]);
 
-    mpSpatialFilteringPass->execute(pRenderContext, mWidth, mHeight);
+    mpSpatialFilteringPass->execute(pRenderContext, renderDims.x, renderDims.y);
 }
 
 void SpatialFilteringPass::performReservoirCopy(Falcor::RenderContext* pRenderContext)
@@ -15,21 +15,35 @@ TemporalFilteringPass::TemporalFilteringPass(
 )
     : mpScene(pScene), mWidth(width), mHeight(height)
 {
-    mpTemporalFilteringPass = ComputePass::create(pDevice, "Samples/Restir/TemporalFilteringPass.slang", "TemporalFilteringPass");
+    mpTemporalFilteringPass = ComputePass::create(
+        pDevice, "Samples/Restir/TemporalFilteringPass.slang", "TemporalFilteringPass", GBufferSingleton::instance()->getDefines()
+    );
 }
 
 void TemporalFilteringPass::render(Falcor::RenderContext* pRenderContext)
 {
     FALCOR_PROFILE(pRenderContext, "TemporalFilteringPass::render");
 
+    // Nothing to reuse on the first frame after the history was (re)created.
+    if (!ReservoirManagerSingleton::instance()->getReservoirHistory().isValid(1) ||
+        !GBufferSingleton::instance()->getPositionWsHistory().isValid(1))
+    {
+        mPreviousFrameViewProjMat = mpScene->getCamera()->getViewProjMatrix();
+        return;
+    }
+
     auto var = mpTemporalFilteringPass->getRootVar();
 
-    var["PerFrameCB"]["viewportDims"] = uint2(mWidth, mHeight);
+    const uint2 renderDims = GBufferSingleton::instance()->getRenderDims();
+
+    var["PerFrameCB"]["viewportDims"] = renderDims;
     var["PerFrameCB"]["cameraPositionWs"] = mpScene->getCamera()->getPosition();
     var["PerFrameCB"]["previousFrameViewProjMat"] = transpose(mPreviousFrameViewProjMat);
     var["PerFrameCB"]["nbReservoirPerPixel"] = SceneSettingsSingleton::instance()->nbReservoirPerPixel;
     var["PerFrameCB"]["sampleIndex"] = ++mSampleIndex;
-    var["PerFrameCB"]["motion"] = (uint)(mPreviousFrameViewProjMat != mpScene->getCamera()->getViewProjMatrix());
+    // A resolution change moves the reprojected pixels as much as a camera change.
+    const bool resolutionChanged = any(renderDims != GBufferSingleton::instance()->getRenderDims(1));
+    var["PerFrameCB"]["motion"] = (uint)(mPreviousFrameViewProjMat != mpScene->getCamera()->getViewProjMatrix() || resolutionChanged);
 
     var["PerFrameCB"]["temporalLinearDepthThreshold"] = SceneSettingsSingleton::instance()->temporalLinearDepthThreshold;
     var["PerFrameCB"]["temporalWsRadiusThreshold"] = SceneSettingsSingleton::instance()->temporalWsRadiusThreshold;
@@ -38,15 +52,11 @@ void TemporalFilteringPass::render(Falcor::RenderContext* pRenderContext)
     var["gCurrentFrameReservoirs"] = ReservoirManagerSingleton::instance()->getCurrentFrameReservoirBuffer();
     var["gPreviousFrameReservoirs"] = ReservoirManagerSingleton::instance()->getPreviousFrameReservoirBuffer();
 
-    var["gCurrentPositionWs"] = GBufferSingleton::instance()->getCurrentPositionWsTexture();
-    var["gPreviousPositionWs"] = GBufferSingleton::instance()->getPreviousPositionWsTexture();
-
-    var["gCurrentNormalWs"] = GBufferSingleton::instance()->getCurrentNormalWsTexture();
-    var["gPreviousNormalWs"] = GBufferSingleton::instance()->getPreviousNormalWsTexture();
-    var["gAlbedo"] = GBufferSingleton::instance()->getAlbedoTexture();
-    var["gSpecular"] = GBufferSingleton::instance()->getSpecularTexture();
+    GBufferSingleton::instance()->bindGeometry(var["gCurrentGBuffer"], 0);
+    GBufferSingleton::instance()->bindGeometry(var["gPreviousGBuffer"], 1);
+    GBufferSingleton::instance()->bindMaterial(var["gMaterial"]);
 
-    mpTemporalFilteringPass->execute(pRenderContext, mWidth, mHeight);
+    mpTemporalFilteringPass->execute(pRenderContext, renderDims.x, renderDims.y);
     mPreviousFrameViewProjMat = mpScene->getCamera()->getViewProjMatrix();
 }
 } // namespace Restir
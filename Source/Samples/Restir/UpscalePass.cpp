@@ -0,0 +1,41 @@
+#include "UpscalePass.h"
+#include "Rendering/Utils/DynamicResolution.h"
+
+namespace Restir
+{
+using namespace Falcor;
+
+UpscalePass::UpscalePass(ref<Device> pDevice, uint32_t width, uint32_t height) : mWidth(width), mHeight(height)
+{
+    mpUpscalePass = ComputePass::create(pDevice, "Samples/Restir/UpscalePass.slang", "EntryPoint");
+
+    Sampler::Desc samplerDesc;
+    samplerDesc.setFilterMode(TextureFilteringMode::Linear, TextureFilteringMode::Linear, TextureFilteringMode::Point);
+    samplerDesc.setAddressingMode(TextureAddressingMode::Clamp, TextureAddressingMode::Clamp, TextureAddressingMode::Clamp);
+    mpLinearSampler = pDevice->createSampler(samplerDesc);
+
+    mpOuputTexture = pDevice->createTexture2D(
+        width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource
+    );
+    mpOuputTexture->setName("UpscalePass ouput texture");
+}
+
+void UpscalePass::render(Falcor::RenderContext* pRenderContext, const ref<Texture>& pInputTexture, uint2 renderDims)
+{
+    FALCOR_PROFILE(pRenderContext, "UpscalePass::render");
+
+    const uint2 inputDims = uint2(pInputTexture->getWidth(), pInputTexture->getHeight());
+
+    auto var = mpUpscalePass->getRootVar();
+
+    var["PerFrameCB"]["outputDims"] = uint2(mWidth, mHeight);
+    var["PerFrameCB"]["uvScale"] = DynamicResolution::computeUvScale(renderDims, inputDims);
+    var["PerFrameCB"]["uvMax"] = (float2(renderDims) - 0.5f) / float2(inputDims);
+
+    var["gInput"] = pInputTexture;
+    var["gLinearSampler"] = mpLinearSampler;
+    var["gOutput"] = mpOuputTexture;
+
+    mpUpscalePass->execute(pRenderContext, mWidth, mHeight);
+}
+} // namespace Restir
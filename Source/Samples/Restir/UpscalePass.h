@@ -0,0 +1,26 @@
+#pragma once
+#include "Falcor.h"
+
+namespace Restir
+{
+// Bilinear upscale of the rendered sub-rectangle of a texture to the full output resolution.
+// Used with dynamic resolution, see SceneSettings::dynamicResolution.
+class UpscalePass
+{
+public:
+    UpscalePass(Falcor::ref<Falcor::Device> pDevice, uint32_t width, uint32_t height);
+
+    // renderDims is the size of the sub-rectangle rendered in the input this frame.
+    void render(Falcor::RenderContext* pRenderContext, const Falcor::ref<Falcor::Texture>& pInputTexture, Falcor::uint2 renderDims);
+
+    inline Falcor::ref<Falcor::Texture>& getOuputTexture() { return mpOuputTexture; };
+
+private:
+    uint32_t mWidth;
+    uint32_t mHeight;
+
+    Falcor::ref<Falcor::ComputePass> mpUpscalePass;
+    Falcor::ref<Falcor::Sampler> mpLinearSampler;
+    Falcor::ref<Falcor::Texture> mpOuputTexture;
+};
+} // namespace Restir
@@ -1,5 +1,6 @@
 #include "VisibilityPass.h"
 
+#include "GBuffer.h"
 #include "ReservoirManager.h"
 #include "SceneSettings.h"
 
@@ -47,12 +48,14 @@ void VisibilityPass::render(Falcor::RenderContext* pRenderContext)
 
     auto var = mpRtVars->getRootVar();
 
-    var["PerFrameCB"]["viewportDims"] = uint2(mWidth, mHeight);
+    const uint2 renderDims = GBufferSingleton::instance()->getRenderDims();
+
+    var["PerFrameCB"]["viewportDims"] = renderDims;
     var["PerFrameCB"]["nbReservoirPerPixel"] = SceneSettingsSingleton::instance()->nbReservoirPerPixel;
 
     var["gReservoirs"] = ReservoirManagerSingleton::instance()->getCurrentFrameReservoirBuffer();
 
-    mpScene->raytrace(pRenderContext, mpRaytraceProgram.get(), mpRtVars, uint3(mWidth, mHeight, 1));
+    mpScene->raytrace(pRenderContext, mpRaytraceProgram.get(), mpRtVars, uint3(renderDims, 1));
 }
 
 } // namespace Restir
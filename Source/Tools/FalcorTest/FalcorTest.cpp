@@ -28,6 +28,7 @@
 #include "Core/Error.h"
 #include "Utils/StringUtils.h"
 #include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
 
 #include <args.hxx>
 
@@ -58,6 +59,18 @@ int runMain(int argc, char** argv)
     args::ValueFlag<uint32_t> repeatFlag(parser, "N", "Number of times to repeat the test.", {'r', "repeat"});
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag enableAftermathFlag(parser, "", "Enable Aftermath GPU crash dump.", {"enable-aftermath"});
+    args::Flag benchmarkFlag(parser, "", "Run benchmarks instead of tests.", {'b', "benchmark"});
+    args::ValueFlag<std::string> benchmarkJsonFlag(parser, "path", "Write benchmark results to a JSON file.", {"benchmark-json"});
+    args::ValueFlag<std::string> benchmarkBaselineFlag(
+        parser, "path", "Compare benchmark results against a baseline JSON file.", {"benchmark-baseline"}
+    );
+    args::ValueFlag<double> benchmarkThresholdFlag(
+        parser, "percent", "Median slowdown reported as a regression (default: 10).", {"benchmark-threshold"}
+    );
+    args::ValueFlag<uint32_t> benchmarkSamplesFlag(parser, "N", "Number of samples per benchmark (default: 30).", {"benchmark-samples"});
+    args::ValueFlag<double> benchmarkMinTimeFlag(
+        parser, "ms", "Minimum time per benchmark sample in milliseconds (default: 10).", {"benchmark-min-time"}
+    );
 
     args::CompletionFlag completionFlag(parser, {"complete"});
 
@@ -130,6 +143,43 @@ int runMain(int argc, char** argv)
     if (repeatFlag)
         options.repeat = args::get(repeatFlag);
 
+    if (benchmarkFlag)
+    {
+        unittest::BenchmarkRunOptions benchmarkOptions;
+        benchmarkOptions.suiteFilter = options.testSuiteFilter;
+        benchmarkOptions.nameFilter = options.testCaseFilter;
+        benchmarkOptions.tagFilter = options.tagFilter;
+        if (benchmarkJsonFlag)
+            benchmarkOptions.jsonReportPath = args::get(benchmarkJsonFlag);
+        if (benchmarkBaselineFlag)
+            benchmarkOptions.baselinePath = args::get(benchmarkBaselineFlag);
+        if (benchmarkThresholdFlag)
+            benchmarkOptions.regressionThreshold = args::get(benchmarkThresholdFlag) / 100.0;
+        if (benchmarkSamplesFlag)
+            benchmarkOptions.sampleCount = args::get(benchmarkSamplesFlag);
+        if (benchmarkMinTimeFlag)
+            benchmarkOptions.minSampleTime = args::get(benchmarkMinTimeFlag) / 1000.0;
+
+        if (listTestSuites || listTestCases)
+        {
+            auto benchmarks = unittest::enumerateBenchmarks();
+            benchmarks = unittest::filterBenchmarks(
+                benchmarks, benchmarkOptions.suiteFilter, benchmarkOptions.nameFilter, benchmarkOptions.tagFilter
+            );
+            std::set<std::string> suites;
+            for (const auto& benchmark : benchmarks)
+            {
+                if (listTestSuites && suites.insert(benchmark.suiteName).second)
+                    fmt::print("{}\n", benchmark.suiteName);
+                if (listTestCases)
+                    fmt::print("{}:{}\n", benchmark.suiteName, benchmark.name);
+            }
+            return 0;
+        }
+
+        return unittest::runBenchmarks(benchmarkOptions);
+    }
+
     if (listTestSuites || listTestCases || listTags)
     {
         std::vector<unittest::Test> tests = unittest::enumerateTests();
@@ -263,4 +263,51 @@ GPU_TEST(Texture2D_LoadMips)
     EXPECT_EQ(result[2].z, 255);
     EXPECT_EQ(result[2].w, 255);
 }
+
+GPU_TEST(Texture_ContentHash)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    const std::filesystem::path paths[] = {
+        getRuntimeDirectory() / "test_content_hash0.png",
+        getRuntimeDirectory() / "test_content_hash1.png",
+        getRuntimeDirectory() / "test_content_hash2.png",
+    };
+
+    // The first two files hold identical texels, the third differs in a single texel.
+    uint8_t data[4 * 16];
+    for (uint32_t i = 0; i < 16 * 4; i++)
+        data[i] = (uint8_t)(i * 13);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        if (i == 2)
+            data[5] ^= 0xff;
+        Bitmap::saveImage(
+            paths[i], 4, 4, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA8Unorm, true, data
+        );
+    }
+
+    ref<Texture> textures[3];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        textures[i] = Texture::createFromFile(pDevice, paths[i], false, false);
+        ASSERT(textures[i] != nullptr);
+        ASSERT(textures[i]->getContentHash().has_value());
+    }
+
+    // Identical texels hash to the same value independent of the file.
+    EXPECT(textures[0]->compareDesc(textures[1].get()));
+    EXPECT_EQ(*textures[0]->getContentHash(), *textures[1]->getContentHash());
+
+    // Different texels change the hash.
+    EXPECT(textures[0]->compareDesc(textures[2].get()));
+    EXPECT_NE(*textures[0]->getContentHash(), *textures[2]->getContentHash());
+
+    // Textures created from memory have no content hash.
+    auto pTexture = pDevice->createTexture2D(4, 4, ResourceFormat::RGBA8Unorm, 1, 1, data);
+    EXPECT(!pTexture->getContentHash().has_value());
+
+    for (const auto& path : paths)
+        std::filesystem::remove(path);
+}
 } // namespace Falcor
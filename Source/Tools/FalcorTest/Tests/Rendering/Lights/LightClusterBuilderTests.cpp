@@ -0,0 +1,183 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Lights/LightClusterBuilder.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+LightClusterBuilder::ViewParams getTestView()
+{
+    // Camera at (0,0,5) looking at the origin, so view space is world space shifted by 5 along z.
+    LightClusterBuilder::ViewParams view;
+    view.viewMat = math::matrixFromLookAt(float3(0.f, 0.f, 5.f), float3(0.f), float3(0.f, 1.f, 0.f));
+    view.tanHalfFovY = 0.5f;
+    view.tanHalfFovX = 0.5f * 16.f / 9.f;
+    view.nearZ = 0.1f;
+    view.farZ = 100.f;
+    return view;
+}
+
+bool clusterHasLight(const LightClusterBuilder& builder, uint32_t clusterIndex, uint32_t lightIndex)
+{
+    const uint2 range = builder.getClusterRanges()[clusterIndex];
+    for (uint32_t i = range.x; i < range.x + range.y; ++i)
+    {
+        if (builder.getEntries()[i].lightIndex == lightIndex)
+            return true;
+    }
+    return false;
+}
+} // namespace
+
+CPU_TEST(LightClusterBuilder_SingleLight)
+{
+    LightClusterBuilder builder;
+    const auto view = getTestView();
+    builder.build(view, {{float3(0.f), 0.5f, 1.f}});
+
+    const auto& stats = builder.getStats();
+    EXPECT_EQ(stats.clusterCount, 16u * 9u * 24u);
+    EXPECT_EQ(stats.culledLightCount, 0u);
+    EXPECT_GT(stats.nonEmptyClusterCount, 0u);
+    EXPECT_LT(stats.nonEmptyClusterCount, stats.clusterCount / 4);
+    EXPECT_EQ(stats.lightReferenceCount, stats.nonEmptyClusterCount);
+    EXPECT_EQ(stats.maxLightsPerCluster, 1u);
+    EXPECT_EQ(stats.avgLightsPerNonEmptyCluster, 1.f);
+
+    // The cluster at the light center references it, a cluster far away does not.
+    const uint32_t centerCluster = builder.findCluster(float3(0.f, 0.f, -5.f));
+    ASSERT_NE(centerCluster, LightClusterBuilder::kInvalidIndex);
+    EXPECT(clusterHasLight(builder, centerCluster, 0));
+
+    const uint32_t farCluster = builder.findCluster(float3(0.f, 0.f, -50.f));
+    ASSERT_NE(farCluster, LightClusterBuilder::kInvalidIndex);
+    EXPECT_EQ(builder.getClusterRanges()[farCluster].y, 0u);
+
+    float pmf = 0.f;
+    EXPECT_EQ(builder.sampleLight(centerCluster, 0.5f, pmf), 0u);
+    EXPECT_EQ(pmf, 1.f);
+    EXPECT_EQ(builder.sampleLight(farCluster, 0.5f, pmf), LightClusterBuilder::kInvalidIndex);
+    EXPECT_EQ(pmf, 0.f);
+}
+
+CPU_TEST(LightClusterBuilder_CulledLights)
+{
+    LightClusterBuilder builder;
+    const auto view = getTestView();
+    builder.build(
+        view,
+        {
+            {float3(0.f, 0.f, 10.f), 1.f, 1.f},    // Behind the camera.
+            {float3(0.f, 0.f, -200.f), 1.f, 1.f},  // Beyond the far plane.
+            {float3(100.f, 0.f, 0.f), 1.f, 1.f},   // Outside the side planes.
+        }
+    );
+
+    const auto& stats = builder.getStats();
+    EXPECT_EQ(stats.culledLightCount, 3u);
+    EXPECT_EQ(stats.nonEmptyClusterCount, 0u);
+    EXPECT_EQ(stats.lightReferenceCount, 0u);
+    EXPECT(builder.getEntries().empty());
+
+    EXPECT_EQ(builder.findCluster(float3(0.f, 0.f, 1.f)), LightClusterBuilder::kInvalidIndex);
+    EXPECT_EQ(builder.findCluster(float3(100.f, 0.f, -5.f)), LightClusterBuilder::kInvalidIndex);
+}
+
+CPU_TEST(LightClusterBuilder_Conservative)
+{
+    // Every point inside the frustum must find all lights whose sphere contains it in its cluster.
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+
+    LightClusterBuilder builder({uint3(8, 6, 12)});
+    const auto view = getTestView();
+
+    std::vector<LightClusterBuilder::LightBounds> lights(64);
+    for (auto& light : lights)
+    {
+        light.center = float3(u(rng) * 20.f - 10.f, u(rng) * 10.f - 5.f, u(rng) * -40.f + 5.f);
+        light.radius = 0.1f + u(rng) * 4.f;
+    }
+    builder.build(view, lights);
+
+    uint32_t testedCount = 0;
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        const float depth = view.nearZ + u(rng) * 40.f;
+        const float3 posV((u(rng) * 2.f - 1.f) * depth * view.tanHalfFovX, (u(rng) * 2.f - 1.f) * depth * view.tanHalfFovY, -depth);
+        const uint32_t clusterIndex = builder.findCluster(posV);
+        ASSERT_NE(clusterIndex, LightClusterBuilder::kInvalidIndex);
+
+        const float3 posW = posV + float3(0.f, 0.f, 5.f);
+        for (uint32_t lightIndex = 0; lightIndex < lights.size(); ++lightIndex)
+        {
+            const float3 d = posW - lights[lightIndex].center;
+            if (dot(d, d) > lights[lightIndex].radius * lights[lightIndex].radius)
+                continue;
+
+            EXPECT(clusterHasLight(builder, clusterIndex, lightIndex)) << "point = " << i << ", light = " << lightIndex;
+            testedCount++;
+        }
+    }
+    EXPECT_GT(testedCount, 100u);
+
+    // Culling must be effective, clusters should not reference every light.
+    EXPECT_LT(builder.getStats().maxLightsPerCluster, (uint32_t)lights.size());
+}
+
+CPU_TEST(LightClusterBuilder_Sampling)
+{
+    LightClusterBuilder builder({uint3(1, 1, 1)});
+    builder.build(getTestView(), {{float3(0.f), 1.f, 1.f}, {float3(0.f), 1.f, 0.f}, {float3(0.f), 1.f, 3.f}});
+    ASSERT_EQ(builder.getStats().lightReferenceCount, 3u);
+
+    // Lights are selected proportionally to their weight, zero weight lights are never selected.
+    const auto& entries = builder.getEntries();
+    EXPECT_EQ(entries[0].cdf, 0.25f);
+    EXPECT_EQ(entries[1].cdf, 0.25f);
+    EXPECT_EQ(entries[2].cdf, 1.f);
+
+    float pmf = 0.f;
+    EXPECT_EQ(builder.sampleLight(0, 0.f, pmf), 0u);
+    EXPECT_EQ(pmf, 0.25f);
+    EXPECT_EQ(builder.sampleLight(0, 0.2f, pmf), 0u);
+    EXPECT_EQ(builder.sampleLight(0, 0.25f, pmf), 2u);
+    EXPECT_EQ(pmf, 0.75f);
+    EXPECT_EQ(builder.sampleLight(0, 0.99f, pmf), 2u);
+
+    // A cluster of zero weight lights selects them uniformly.
+    builder.build(getTestView(), {{float3(0.f), 1.f, 0.f}, {float3(0.f), 1.f, 0.f}});
+    EXPECT_EQ(builder.sampleLight(0, 0.2f, pmf), 0u);
+    EXPECT_EQ(pmf, 0.5f);
+    EXPECT_EQ(builder.sampleLight(0, 0.7f, pmf), 1u);
+    EXPECT_EQ(pmf, 0.5f);
+}
+} // namespace Falcor
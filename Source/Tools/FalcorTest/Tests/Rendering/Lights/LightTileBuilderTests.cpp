@@ -0,0 +1,99 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Lights/LightTileBuilder.h"
+#include <random>
+
+namespace Falcor
+{
+CPU_TEST(LightTileBuilder_Pdf)
+{
+    LightTileBuilder builder;
+    builder.setWeights({1.f, 0.f, 3.f, 0.f});
+
+    EXPECT_EQ(builder.getLightCount(), 4u);
+    EXPECT_EQ(builder.getPdf(0), 0.25f);
+    EXPECT_EQ(builder.getPdf(1), 0.f);
+    EXPECT_EQ(builder.getPdf(2), 0.75f);
+    EXPECT_EQ(builder.getPdf(3), 0.f);
+
+    // Zero weight lights are never selected.
+    EXPECT_EQ(builder.sampleLight(0.f), 0u);
+    EXPECT_EQ(builder.sampleLight(0.2f), 0u);
+    EXPECT_EQ(builder.sampleLight(0.25f), 2u);
+    EXPECT_EQ(builder.sampleLight(0.99999f), 2u);
+
+    EXPECT_THROW(builder.setWeights({0.f, 0.f}));
+    EXPECT_THROW(builder.setWeights({1.f, -1.f}));
+}
+
+CPU_TEST(LightTileBuilder_Tiles)
+{
+    const uint32_t lightCount = 100;
+    std::vector<float> weights(lightCount);
+    for (uint32_t i = 0; i < lightCount; ++i)
+        weights[i] = (i % 10 == 0) ? 0.f : (float)(i + 1);
+
+    LightTileBuilder::Options options;
+    options.tileCount = 16;
+    options.tileSize = 512;
+    LightTileBuilder builder(options);
+    builder.setWeights(weights);
+
+    std::mt19937 rng;
+    builder.build(rng);
+    ASSERT_EQ(builder.getSamples().size(), (size_t)options.tileCount * options.tileSize);
+
+    for (uint32_t t = 0; t < options.tileCount; ++t)
+    {
+        // Each tile is stratified, so the number of samples of each light is within one of its expected count.
+        std::vector<uint32_t> counts(lightCount, 0);
+        const LightTileBuilder::Sample* pTile = builder.getTile(t);
+        for (uint32_t i = 0; i < options.tileSize; ++i)
+        {
+            ASSERT_LT(pTile[i].lightIndex, lightCount);
+            EXPECT_EQ(pTile[i].pdf, builder.getPdf(pTile[i].lightIndex));
+            counts[pTile[i].lightIndex]++;
+        }
+
+        for (uint32_t i = 0; i < lightCount; ++i)
+        {
+            const float expected = builder.getPdf(i) * options.tileSize;
+            EXPECT_LE(std::abs(counts[i] - expected), 2.f) << "tile = " << t << ", light = " << i;
+            if (weights[i] == 0.f)
+                EXPECT_EQ(counts[i], 0u) << "tile = " << t << ", light = " << i;
+        }
+    }
+
+    // Tiles are drawn independently.
+    EXPECT(!std::equal(
+        builder.getTile(0), builder.getTile(1), builder.getTile(2),
+        [](const auto& a, const auto& b) { return a.lightIndex == b.lightIndex; }
+    ));
+}
+} // namespace Falcor
@@ -0,0 +1,107 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/DynamicResolution.h"
+#include <cmath>
+
+namespace Falcor
+{
+CPU_TEST(DynamicResolution_RenderResolution)
+{
+    EXPECT(all(DynamicResolution::computeRenderResolution(uint2(1920, 1080), 1.f) == uint2(1920, 1080)));
+    EXPECT(all(DynamicResolution::computeRenderResolution(uint2(1920, 1080), 0.5f) == uint2(960, 540)));
+    EXPECT(all(DynamicResolution::computeRenderResolution(uint2(1921, 1081), 0.5f) == uint2(961, 541)));
+    EXPECT(all(DynamicResolution::computeRenderResolution(uint2(3, 1), 0.01f) == uint2(1, 1)));
+
+    const float2 uvScale = DynamicResolution::computeUvScale(uint2(960, 270), uint2(1920, 1080));
+    EXPECT_EQ(uvScale.x, 0.5f);
+    EXPECT_EQ(uvScale.y, 0.25f);
+}
+
+CPU_TEST(DynamicResolution_MapPixel)
+{
+    // Identity at equal resolutions.
+    for (uint32_t x = 0; x < 16; ++x)
+        EXPECT(all(DynamicResolution::mapPixel(uint2(x, 15 - x), uint2(16, 16), uint2(16, 16)) == uint2(x, 15 - x)));
+
+    // Half resolution: each destination pixel covers 2x2 source pixels.
+    EXPECT(all(DynamicResolution::mapPixel(uint2(0, 0), uint2(16, 16), uint2(8, 8)) == uint2(0, 0)));
+    EXPECT(all(DynamicResolution::mapPixel(uint2(1, 3), uint2(16, 16), uint2(8, 8)) == uint2(0, 1)));
+    EXPECT(all(DynamicResolution::mapPixel(uint2(15, 15), uint2(16, 16), uint2(8, 8)) == uint2(7, 7)));
+
+    // Upscaling goes back to the pixel covering the same center.
+    EXPECT(all(DynamicResolution::mapPixel(uint2(7, 0), uint2(8, 8), uint2(16, 16)) == uint2(15, 1)));
+
+    // Results stay inside the destination.
+    EXPECT(all(DynamicResolution::mapPixel(uint2(99, 99), uint2(100, 100), uint2(33, 7)) == uint2(32, 6)));
+}
+
+CPU_TEST(DynamicResolution_Controller)
+{
+    DynamicResolution::Options options;
+    options.minScale = 0.5f;
+    options.maxScale = 1.f;
+    options.scaleStep = 0.05f;
+    options.targetTimeMs = 10.f;
+
+    DynamicResolution dynRes(uint2(1000, 500), options);
+    EXPECT_EQ(dynRes.getScale(), 1.f);
+    EXPECT(all(dynRes.getRenderResolution() == uint2(1000, 500)));
+
+    // Frame time proportional to the pixel count, 20 ms at full resolution.
+    // The pixel count must halve, i.e. a per-axis scale of about 0.707.
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        const uint2 res = dynRes.getRenderResolution();
+        dynRes.update(20.f * (float)(res.x * res.y) / (1000.f * 500.f));
+    }
+    EXPECT_GE(dynRes.getScale(), 0.6f);
+    EXPECT_LE(dynRes.getScale(), 0.75f);
+
+    // The scale is quantized and the resolution follows it.
+    const float steps = dynRes.getScale() / options.scaleStep;
+    EXPECT_LT(std::abs(steps - std::round(steps)), 1e-3f);
+    EXPECT(all(dynRes.getRenderResolution() == DynamicResolution::computeRenderResolution(uint2(1000, 500), dynRes.getScale())));
+
+    // Overloaded: clamped at the minimum scale.
+    for (uint32_t i = 0; i < 200; ++i)
+        dynRes.update(100.f);
+    EXPECT_EQ(dynRes.getScale(), 0.5f);
+    EXPECT(all(dynRes.getRenderResolution() == uint2(500, 250)));
+
+    // Idle: back to full resolution.
+    for (uint32_t i = 0; i < 200; ++i)
+        dynRes.update(1.f);
+    EXPECT_EQ(dynRes.getScale(), 1.f);
+
+    dynRes.update(100.f);
+    dynRes.reset();
+    EXPECT_EQ(dynRes.getScale(), 1.f);
+    EXPECT(all(dynRes.getRenderResolution() == uint2(1000, 500)));
+}
+} // namespace Falcor
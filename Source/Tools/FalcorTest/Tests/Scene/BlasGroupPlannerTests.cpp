@@ -0,0 +1,201 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
+#include "Scene/BlasGroupPlanner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint64_t kMemoryBudget = 1ull << 29;
+const uint64_t kAlignment = 256;
+
+uint64_t alignSize(double size)
+{
+    return std::max<uint64_t>(kAlignment, ((uint64_t)size + kAlignment - 1) / kAlignment * kAlignment);
+}
+
+/// Create BLASes with log-normal distributed sizes, similar to the mesh groups of a large scene.
+/// The scratch size is a variable fraction of the result size.
+std::vector<BlasGroupPlanner::BlasDesc> createBlases(uint32_t count, double meanLogSize, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::lognormal_distribution<double> sizeDist(meanLogSize, 1.5);
+    std::uniform_real_distribution<double> scratchDist(0.25, 1.5);
+
+    std::vector<BlasGroupPlanner::BlasDesc> blases(count);
+    for (auto& blas : blases)
+    {
+        double size = std::min(sizeDist(rng), 0.25 * kMemoryBudget);
+        blas.resultByteSize = alignSize(size);
+        blas.scratchByteSize = alignSize(size * scratchDist(rng));
+        blas.predictedFinalByteSize = alignSize(size * 0.5);
+    }
+    return blases;
+}
+
+/// Check that every BLAS is in exactly one group and that the group and plan sizes are consistent.
+void validatePlan(UnitTestContext& ctx, const std::vector<BlasGroupPlanner::BlasDesc>& blases, const BlasGroupPlanner::Plan& plan)
+{
+    std::vector<uint32_t> groupCount(blases.size(), 0);
+    uint64_t resultBufferSize = 0;
+    uint64_t scratchBufferSize = 0;
+    uint64_t predictedFinalByteSize = 0;
+
+    for (const auto& group : plan.groups)
+    {
+        EXPECT(!group.blasIndices.empty());
+        EXPECT(std::is_sorted(group.blasIndices.begin(), group.blasIndices.end()));
+
+        uint64_t resultByteSize = 0;
+        uint64_t scratchByteSize = 0;
+        for (uint32_t blasId : group.blasIndices)
+        {
+            ASSERT_LT(blasId, blases.size());
+            groupCount[blasId]++;
+            resultByteSize += blases[blasId].resultByteSize;
+            scratchByteSize += blases[blasId].scratchByteSize;
+            predictedFinalByteSize += blases[blasId].predictedFinalByteSize;
+        }
+        EXPECT_EQ(group.resultByteSize, resultByteSize);
+        EXPECT_EQ(group.scratchByteSize, scratchByteSize);
+        resultBufferSize = std::max(resultBufferSize, resultByteSize);
+        scratchBufferSize = std::max(scratchBufferSize, scratchByteSize);
+    }
+
+    EXPECT(std::all_of(groupCount.begin(), groupCount.end(), [](uint32_t count) { return count == 1; }));
+    EXPECT_EQ(plan.resultBufferSize, resultBufferSize);
+    EXPECT_EQ(plan.scratchBufferSize, scratchBufferSize);
+    EXPECT_EQ(plan.predictedFinalByteSize, predictedFinalByteSize);
+}
+} // namespace
+
+CPU_TEST(BlasGroupPlanner_SingleGroup)
+{
+    auto blases = createBlases(100, 10.0, 1);
+    auto plan = BlasGroupPlanner::plan(blases, kMemoryBudget);
+    validatePlan(ctx, blases, plan);
+    EXPECT_EQ(plan.groups.size(), 1);
+
+    EXPECT(BlasGroupPlanner::plan({}, kMemoryBudget).groups.empty());
+}
+
+CPU_TEST(BlasGroupPlanner_OversizedBlas)
+{
+    // The budget is less than the largest result size plus the largest scratch size.
+    std::vector<BlasGroupPlanner::BlasDesc> blases = {
+        {1000, 100, 500},
+        {100, 400, 50},
+        {100, 1000, 50},
+        {300, 300, 150},
+    };
+    auto plan = BlasGroupPlanner::plan(blases, 1600);
+    validatePlan(ctx, blases, plan);
+
+    // The shared buffers must hold the largest result and the largest scratch size.
+    // The planner should not need more than that, while packing in ID order does.
+    EXPECT_EQ(plan.resultBufferSize + plan.scratchBufferSize, 2000);
+    EXPECT_EQ(plan.groups.size(), 3);
+
+    auto sequential = BlasGroupPlanner::planSequential(blases, 1600);
+    validatePlan(ctx, blases, sequential);
+    EXPECT_EQ(sequential.resultBufferSize + sequential.scratchBufferSize, 2100);
+    EXPECT_EQ(sequential.groups.size(), 3);
+}
+
+CPU_TEST(BlasGroupPlanner_Random)
+{
+    for (uint32_t seed = 0; seed < 8; seed++)
+    {
+        auto blases = createBlases(2000, 15.0, seed);
+        auto plan = BlasGroupPlanner::plan(blases, kMemoryBudget);
+        auto sequential = BlasGroupPlanner::planSequential(blases, kMemoryBudget);
+        validatePlan(ctx, blases, plan);
+        validatePlan(ctx, blases, sequential);
+
+        EXPECT_LE(plan.resultBufferSize + plan.scratchBufferSize, kMemoryBudget) << "seed " << seed;
+        EXPECT_LE(plan.groups.size(), sequential.groups.size()) << "seed " << seed;
+        EXPECT_LT(plan.getPeakByteSize(), sequential.getPeakByteSize()) << "seed " << seed;
+    }
+}
+
+CPU_TEST(BlasGroupPlanner_CompactionHistory)
+{
+    BlasCompactionHistory history;
+
+    // Without history the default ratio is used. Uncompacted BLASes keep their size.
+    EXPECT_EQ(history.predictFinalByteSize(0, 1000, true), 600);
+    EXPECT_EQ(history.predictFinalByteSize(0, 1000, false), 1000);
+
+    history.record(0, 1000, 300, true);
+    history.record(1, 1000, 500, true);
+    history.record(2, 1000, 1000, false);
+    EXPECT_EQ(history.getCompactionRatio(), 0.4);
+
+    // Recorded BLASes use their own ratio, others the aggregate one.
+    EXPECT_EQ(history.predictFinalByteSize(0, 2000, true), 600);
+    EXPECT_EQ(history.predictFinalByteSize(1, 2000, true), 1000);
+    EXPECT_EQ(history.predictFinalByteSize(2, 2000, true), 800);
+    EXPECT_EQ(history.predictFinalByteSize(5, 2000, true), 800);
+
+    // Recording a BLAS again replaces its previous entry.
+    history.record(1, 1000, 300, true);
+    EXPECT_EQ(history.getCompactionRatio(), 0.3);
+
+    history.clear();
+    EXPECT_EQ(history.getCompactionRatio(), BlasCompactionHistory::kDefaultCompactionRatio);
+}
+
+CPU_BENCHMARK(BlasGroupPlanner_Plan, BENCHMARK_PARAM("blases", 1000, 10000, 50000))
+{
+    // Plan synthetic scenes with many mesh groups. The plan is checked against packing in ID order.
+    const uint32_t blasCount = (uint32_t)ctx.getParam("blases");
+    auto blases = createBlases(blasCount, 12.0, blasCount);
+    ctx.setItemsPerIteration(blasCount);
+
+    BlasGroupPlanner::Plan plan;
+    ctx.run(
+        [&]()
+        {
+            plan = BlasGroupPlanner::plan(blases, kMemoryBudget);
+            doNotOptimize(plan.groups.data());
+        }
+    );
+
+    auto sequential = BlasGroupPlanner::planSequential(blases, kMemoryBudget);
+    validatePlan(ctx, blases, plan);
+    EXPECT_LE(plan.groups.size(), sequential.groups.size());
+    EXPECT_LE(plan.getPeakByteSize(), sequential.getPeakByteSize());
+}
+} // namespace Falcor
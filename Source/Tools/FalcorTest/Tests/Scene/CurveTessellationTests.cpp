@@ -0,0 +1,289 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
+#include "Scene/Curves/CurveTessellation.h"
+
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct Groom
+{
+    std::vector<uint32_t> vertexCountsPerStrand;
+    std::vector<float3> controlPoints;
+    std::vector<float> widths;
+    std::vector<float2> UVs;
+
+    uint32_t getStrandCount() const { return (uint32_t)vertexCountsPerStrand.size(); }
+};
+
+/// Create a synthetic hair groom of wavy strands growing from the unit disk.
+/// Some control points are duplicated to exercise duplicate removal.
+Groom createGroom(uint32_t strandCount, uint32_t maxVertexCountPerStrand, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+
+    Groom groom;
+    for (uint32_t i = 0; i < strandCount; ++i)
+    {
+        uint32_t vertexCount = 4 + rng() % (maxVertexCountPerStrand - 3);
+        groom.vertexCountsPerStrand.push_back(vertexCount);
+
+        float3 root(2.f * u(rng) - 1.f, 0.f, 2.f * u(rng) - 1.f);
+        float phase = 6.f * u(rng);
+        for (uint32_t j = 0; j < vertexCount; ++j)
+        {
+            float y = 0.1f * j;
+            float3 p = root + float3(0.02f * std::sin(phase + 3.f * y), y, 0.02f * std::cos(phase + 3.f * y));
+            if (j > 1 && rng() % 8 == 0)
+                p = groom.controlPoints.back();
+            groom.controlPoints.push_back(p);
+            groom.widths.push_back(0.01f * (1.f - 0.5f * j / vertexCount));
+            groom.UVs.push_back(float2(root.x, root.z));
+        }
+    }
+    return groom;
+}
+} // namespace
+
+CPU_TEST(CurveTessellation_SweptSphere)
+{
+    Groom groom = createGroom(1000, 16, 1);
+    const uint32_t keepOneEveryXStrands = 3;
+
+    auto result = CurveTessellation::convertToLinearSweptSphere(
+        groom.getStrandCount(),
+        groom.vertexCountsPerStrand.data(),
+        groom.controlPoints.data(),
+        groom.widths.data(),
+        groom.UVs.data(),
+        1,
+        4,
+        keepOneEveryXStrands,
+        2,
+        1.f,
+        float4x4::identity()
+    );
+
+    uint32_t keptStrandCount = div_round_up(groom.getStrandCount(), keepOneEveryXStrands);
+    ASSERT_EQ(result.radius.size(), result.points.size());
+    ASSERT_EQ(result.texCrds.size(), result.points.size());
+    ASSERT_EQ(result.indices.size(), result.points.size() - keptStrandCount);
+
+    // Segments connect consecutive points and never cross strands, so every strand ends with a point that starts no segment.
+    uint32_t strandEndCount = 0;
+    for (size_t i = 0; i < result.indices.size(); ++i)
+    {
+        EXPECT_LT(result.indices[i] + 1, result.points.size());
+        if (i > 0)
+            strandEndCount += result.indices[i] - result.indices[i - 1] - 1;
+    }
+    strandEndCount += (uint32_t)result.points.size() - result.indices[result.indices.size() - 1] - 1;
+    EXPECT_EQ(strandEndCount, keptStrandCount);
+
+    for (float r : result.radius)
+        EXPECT_GT(r, 0.f);
+}
+
+CPU_TEST(CurveTessellation_PolytubeStraightStrand)
+{
+    const uint32_t vertexCount = 5;
+    const uint32_t subdivPerSegment = 4;
+    const uint32_t pointCountPerCrossSection = 6;
+    const float width = 0.1f;
+
+    std::vector<float3> controlPoints;
+    std::vector<float> widths;
+    for (uint32_t i = 0; i < vertexCount; ++i)
+    {
+        controlPoints.push_back(float3(0.f, (float)i, 0.f));
+        widths.push_back(width);
+    }
+
+    auto result = CurveTessellation::convertToPolytube(
+        1, &vertexCount, controlPoints.data(), widths.data(), nullptr, subdivPerSegment, 1, 1, 1.f, pointCountPerCrossSection
+    );
+
+    const uint32_t pointCount = subdivPerSegment * (vertexCount - 1) + 1;
+    ASSERT_EQ(result.vertices.size(), pointCount * pointCountPerCrossSection);
+    ASSERT_EQ(result.normals.size(), result.vertices.size());
+    ASSERT_EQ(result.tangents.size(), result.vertices.size());
+    ASSERT_EQ(result.radii.size(), result.vertices.size());
+    EXPECT_EQ(result.texCrds.size(), 0);
+    ASSERT_EQ(result.faceVertexCounts.size(), 2 * pointCountPerCrossSection * (pointCount - 1));
+    ASSERT_EQ(result.faceVertexIndices.size(), 3 * result.faceVertexCounts.size());
+
+    // All tube vertices lie on a cylinder around the y-axis.
+    for (size_t i = 0; i < result.vertices.size(); ++i)
+    {
+        const float3& v = result.vertices[i];
+        EXPECT_LE(std::abs(std::sqrt(v.x * v.x + v.z * v.z) - result.radii[i]), 1e-5f);
+        EXPECT_LE(std::abs(result.tangents[i].y - 1.f), 1e-5f);
+        EXPECT_LE(std::abs(result.normals[i].y), 1e-5f);
+    }
+
+    for (uint32_t count : result.faceVertexCounts)
+        EXPECT_EQ(count, 3);
+    for (uint32_t index : result.faceVertexIndices)
+        EXPECT_LT(index, result.vertices.size());
+}
+
+CPU_TEST(CurveTessellation_Parallel)
+{
+    // Strands are tessellated in parallel into the output arrays. The result must match tessellating the strands one by one.
+    Groom groom = createGroom(1000, 16, 2);
+
+    auto sweptSphere = [&](uint32_t strandCount, uint32_t strandOffset, uint32_t pointOffset)
+    {
+        return CurveTessellation::convertToLinearSweptSphere(
+            strandCount,
+            groom.vertexCountsPerStrand.data() + strandOffset,
+            groom.controlPoints.data() + pointOffset,
+            groom.widths.data() + pointOffset,
+            groom.UVs.data() + pointOffset,
+            1,
+            4,
+            1,
+            1,
+            1.f,
+            float4x4::identity()
+        );
+    };
+    auto polytube = [&](uint32_t strandCount, uint32_t strandOffset, uint32_t pointOffset)
+    {
+        return CurveTessellation::convertToPolytube(
+            strandCount,
+            groom.vertexCountsPerStrand.data() + strandOffset,
+            groom.controlPoints.data() + pointOffset,
+            groom.widths.data() + pointOffset,
+            groom.UVs.data() + pointOffset,
+            4,
+            1,
+            1,
+            1.f,
+            4
+        );
+    };
+
+    auto sweptSphereResult = sweptSphere(groom.getStrandCount(), 0, 0);
+    auto meshResult = polytube(groom.getStrandCount(), 0, 0);
+
+    size_t point = 0;
+    size_t segment = 0;
+    size_t vertex = 0;
+    size_t face = 0;
+    uint32_t pointOffset = 0;
+    for (uint32_t i = 0; i < groom.getStrandCount(); ++i)
+    {
+        auto strand = sweptSphere(1, i, pointOffset);
+        ASSERT_LE(point + strand.points.size(), sweptSphereResult.points.size());
+        ASSERT_LE(segment + strand.indices.size(), sweptSphereResult.indices.size());
+        for (size_t j = 0; j < strand.points.size(); ++j, ++point)
+        {
+            EXPECT(all(sweptSphereResult.points[point] == strand.points[j])) << "strand " << i;
+            EXPECT_EQ(sweptSphereResult.radius[point], strand.radius[j]) << "strand " << i;
+            EXPECT(all(sweptSphereResult.texCrds[point] == strand.texCrds[j])) << "strand " << i;
+        }
+        for (size_t j = 0; j < strand.indices.size(); ++j, ++segment)
+            EXPECT_EQ(sweptSphereResult.indices[segment], strand.indices[j] + point - strand.points.size()) << "strand " << i;
+
+        auto strandMesh = polytube(1, i, pointOffset);
+        ASSERT_LE(vertex + strandMesh.vertices.size(), meshResult.vertices.size());
+        ASSERT_LE(face + strandMesh.faceVertexIndices.size(), meshResult.faceVertexIndices.size());
+        for (size_t j = 0; j < strandMesh.vertices.size(); ++j, ++vertex)
+        {
+            EXPECT(all(meshResult.vertices[vertex] == strandMesh.vertices[j])) << "strand " << i;
+            EXPECT(all(meshResult.normals[vertex] == strandMesh.normals[j])) << "strand " << i;
+            EXPECT(all(meshResult.tangents[vertex] == strandMesh.tangents[j])) << "strand " << i;
+            EXPECT_EQ(meshResult.radii[vertex], strandMesh.radii[j]) << "strand " << i;
+        }
+        for (size_t j = 0; j < strandMesh.faceVertexIndices.size(); ++j, ++face)
+        {
+            const size_t expected = strandMesh.faceVertexIndices[j] + vertex - strandMesh.vertices.size();
+            EXPECT_EQ(meshResult.faceVertexIndices[face], expected) << "strand " << i;
+        }
+
+        pointOffset += groom.vertexCountsPerStrand[i];
+    }
+    EXPECT_EQ(point, sweptSphereResult.points.size());
+    EXPECT_EQ(segment, sweptSphereResult.indices.size());
+    EXPECT_EQ(vertex, meshResult.vertices.size());
+    EXPECT_EQ(face, meshResult.faceVertexIndices.size());
+}
+
+CPU_BENCHMARK(CurveTessellation_Groom, BENCHMARK_PARAM("polytube", 0, 1))
+{
+    // Tessellate a synthetic groom, the throughput is reported in strands.
+    Groom groom = createGroom(20000, 16, 2);
+    const bool polytube = ctx.getParam("polytube") != 0;
+    ctx.setItemsPerIteration(groom.getStrandCount());
+    ctx.run(
+        [&]()
+        {
+            if (polytube)
+            {
+                auto result = CurveTessellation::convertToPolytube(
+                    groom.getStrandCount(),
+                    groom.vertexCountsPerStrand.data(),
+                    groom.controlPoints.data(),
+                    groom.widths.data(),
+                    groom.UVs.data(),
+                    4,
+                    1,
+                    1,
+                    1.f,
+                    4
+                );
+                doNotOptimize(result.vertices.data());
+            }
+            else
+            {
+                auto result = CurveTessellation::convertToLinearSweptSphere(
+                    groom.getStrandCount(),
+                    groom.vertexCountsPerStrand.data(),
+                    groom.controlPoints.data(),
+                    groom.widths.data(),
+                    groom.UVs.data(),
+                    1,
+                    4,
+                    1,
+                    1,
+                    1.f,
+                    float4x4::identity()
+                );
+                doNotOptimize(result.points.data());
+            }
+        }
+    );
+}
+} // namespace Falcor
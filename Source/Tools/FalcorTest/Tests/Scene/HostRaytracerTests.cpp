@@ -0,0 +1,272 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
+#include "Scene/HostRaytracer.h"
+#include "Utils/Math/MatrixMath.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+using Ray = HostRaytracer::Ray;
+using TriangleHit = HostRaytracer::TriangleHit;
+
+HostRaytracer::Geometry createRandomTriangles(std::mt19937& rng, uint32_t triangleCount, float extent)
+{
+    std::uniform_real_distribution<float> pos(-extent, extent);
+    std::uniform_real_distribution<float> offset(-0.2f, 0.2f);
+    HostRaytracer::Geometry geometry;
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        float3 center(pos(rng), pos(rng), pos(rng));
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            geometry.indices.push_back((uint32_t)geometry.positions.size());
+            geometry.positions.push_back(center + float3(offset(rng), offset(rng), offset(rng)));
+        }
+    }
+    return geometry;
+}
+
+/// Create a UV sphere with the given number of segments.
+HostRaytracer::Geometry createSphere(uint32_t segments)
+{
+    HostRaytracer::Geometry geometry;
+    const uint32_t rings = segments / 2;
+    for (uint32_t r = 0; r <= rings; ++r)
+    {
+        const float theta = (float)M_PI * r / rings;
+        for (uint32_t s = 0; s <= segments; ++s)
+        {
+            const float phi = 2.f * (float)M_PI * s / segments;
+            geometry.positions.push_back(float3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+    for (uint32_t r = 0; r < rings; ++r)
+    {
+        for (uint32_t s = 0; s < segments; ++s)
+        {
+            const uint32_t i0 = r * (segments + 1) + s;
+            const uint32_t i1 = i0 + segments + 1;
+            geometry.indices.insert(geometry.indices.end(), {i0, i1, i0 + 1, i0 + 1, i1, i1 + 1});
+        }
+    }
+    return geometry;
+}
+
+/// Brute force reference. Returns the hit distance, or infinity on a miss.
+float traceReference(
+    const std::vector<HostRaytracer::BlasDesc>& blases,
+    const std::vector<HostRaytracer::InstanceDesc>& instances,
+    const Ray& ray,
+    uint32_t& instanceID,
+    uint32_t& primitiveIndex
+)
+{
+    float tClosest = std::numeric_limits<float>::infinity();
+    for (const auto& instance : instances)
+    {
+        const auto& blas = blases[instance.blasIndex];
+        for (uint32_t geometryIndex = 0; geometryIndex < (uint32_t)blas.size(); ++geometryIndex)
+        {
+            const auto& geometry = blas[geometryIndex];
+            for (uint32_t i = 0; i < (uint32_t)geometry.indices.size() / 3; ++i)
+            {
+                const float3 v0 = transformPoint(instance.transform, geometry.positions[geometry.indices[i * 3]]);
+                const float3 v1 = transformPoint(instance.transform, geometry.positions[geometry.indices[i * 3 + 1]]);
+                const float3 v2 = transformPoint(instance.transform, geometry.positions[geometry.indices[i * 3 + 2]]);
+                const float3 e1 = v1 - v0;
+                const float3 e2 = v2 - v0;
+                const float3 p = cross(ray.dir, e2);
+                const float det = dot(e1, p);
+                if (det == 0.f)
+                    continue;
+                const float3 s = ray.origin - v0;
+                const float u = dot(s, p) / det;
+                const float3 q = cross(s, e1);
+                const float v = dot(ray.dir, q) / det;
+                const float t = dot(e2, q) / det;
+                if (u < 0.f || v < 0.f || u + v > 1.f || t < ray.tMin || t >= ray.tMax || t >= tClosest)
+                    continue;
+                tClosest = t;
+                instanceID = instance.instanceID + geometryIndex;
+                primitiveIndex = i;
+            }
+        }
+    }
+    return tClosest;
+}
+} // namespace
+
+CPU_TEST(HostRaytracer_Random)
+{
+    std::mt19937 rng(1234);
+    std::vector<HostRaytracer::BlasDesc> blases(2);
+    blases[0].push_back(createRandomTriangles(rng, 500, 1.f));
+    blases[0].push_back(createRandomTriangles(rng, 300, 1.f));
+    blases[1].push_back(createRandomTriangles(rng, 1000, 2.f));
+
+    std::vector<HostRaytracer::InstanceDesc> instances(3);
+    instances[0] = {0, 0, float4x4::identity()};
+    instances[1] = {0, 2, mul(matrixFromTranslation(float3(3.f, 0.f, 0.f)), matrixFromRotation(0.7f, normalize(float3(1.f, 2.f, 3.f))))};
+    instances[2] = {1, 4, mul(matrixFromTranslation(float3(-2.f, 1.f, 0.f)), matrixFromScaling(float3(0.5f, 1.f, 2.f)))};
+
+    HostRaytracer raytracer(blases, instances);
+    EXPECT_EQ(raytracer.getStats().triangleCount, 1800);
+    EXPECT_EQ(raytracer.getStats().instanceCount, 3);
+
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<Ray> rays(2000);
+    for (auto& ray : rays)
+    {
+        ray.origin = float3(dist(rng), dist(rng), dist(rng)) * 5.f;
+        ray.dir = normalize(float3(dist(rng), dist(rng), dist(rng)));
+        ray.tMin = 0.01f;
+        ray.tMax = 8.f;
+    }
+
+    std::vector<TriangleHit> hits;
+    std::vector<uint8_t> anyHits;
+    raytracer.traceClosest(rays, hits);
+    raytracer.traceAny(rays, anyHits);
+
+    uint32_t hitCount = 0;
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        uint32_t instanceID = 0;
+        uint32_t primitiveIndex = 0;
+        const float tRef = traceReference(blases, instances, rays[i], instanceID, primitiveIndex);
+        const bool refHit = tRef < std::numeric_limits<float>::infinity();
+
+        EXPECT_EQ(hits[i].isValid(), refHit) << "ray " << i;
+        EXPECT_EQ(anyHits[i] != 0, refHit) << "ray " << i;
+        if (refHit && hits[i].isValid())
+        {
+            hitCount++;
+            EXPECT_LE(std::abs(hits[i].t - tRef), 1e-4f * tRef) << "ray " << i;
+            EXPECT_EQ(hits[i].instanceID, instanceID) << "ray " << i;
+            EXPECT_EQ(hits[i].primitiveIndex, primitiveIndex) << "ray " << i;
+            EXPECT(all(hits[i].barycentrics >= 0.f) && hits[i].barycentrics.x + hits[i].barycentrics.y <= 1.f);
+        }
+    }
+    EXPECT_GT(hitCount, 100);
+}
+
+CPU_TEST(HostRaytracer_Barycentrics)
+{
+    // Single triangle instanced with a translation.
+    std::vector<HostRaytracer::BlasDesc> blases(1);
+    blases[0].push_back({{float3(0.f, 0.f, 0.f), float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f)}, {0, 1, 2}});
+    std::vector<HostRaytracer::InstanceDesc> instances = {{0, 7, matrixFromTranslation(float3(0.f, 0.f, -2.f))}};
+    HostRaytracer raytracer(blases, instances);
+
+    Ray ray;
+    ray.origin = float3(0.25f, 0.5f, 1.f);
+    ray.dir = float3(0.f, 0.f, -1.f);
+    TriangleHit hit = raytracer.traceClosest(ray);
+    ASSERT(hit.isValid());
+    EXPECT_EQ(hit.instanceID, 7);
+    EXPECT_EQ(hit.primitiveIndex, 0);
+    EXPECT_LE(std::abs(hit.t - 3.f), 1e-6f);
+    EXPECT_LE(std::abs(hit.barycentrics.x - 0.25f), 1e-6f);
+    EXPECT_LE(std::abs(hit.barycentrics.y - 0.5f), 1e-6f);
+
+    // The hit is outside [tMin, tMax].
+    ray.tMax = 2.9f;
+    EXPECT(!raytracer.traceClosest(ray).isValid());
+    EXPECT(!raytracer.traceAny(ray));
+    ray.tMax = 10.f;
+    ray.tMin = 3.1f;
+    EXPECT(!raytracer.traceAny(ray));
+
+    // Missing the triangle.
+    ray.tMin = 0.f;
+    ray.origin = float3(0.75f, 0.5f, 1.f);
+    EXPECT(!raytracer.traceAny(ray));
+
+    // Empty scene.
+    HostRaytracer emptyRaytracer({}, {});
+    EXPECT(!emptyRaytracer.traceClosest(ray).isValid());
+}
+
+CPU_BENCHMARK(HostRaytracer_Spheres, BENCHMARK_PARAM("anyHit", 0, 1))
+{
+    // A grid of instanced spheres with 16K triangles each, viewed by a pinhole camera.
+    std::vector<HostRaytracer::BlasDesc> blases(1);
+    blases[0].push_back(createSphere(128));
+    std::vector<HostRaytracer::InstanceDesc> instances;
+    const uint32_t gridSize = 8;
+    for (uint32_t y = 0; y < gridSize; ++y)
+    {
+        for (uint32_t x = 0; x < gridSize; ++x)
+        {
+            float3 offset(2.5f * (x - 0.5f * gridSize), 2.5f * (y - 0.5f * gridSize), 0.f);
+            instances.push_back({0, (uint32_t)instances.size(), matrixFromTranslation(offset)});
+        }
+    }
+    HostRaytracer raytracer(blases, instances);
+
+    const uint32_t width = 1024;
+    const uint32_t height = 1024;
+    std::vector<Ray> rays(width * height);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            Ray& ray = rays[y * width + x];
+            ray.origin = float3(0.f, 0.f, 20.f);
+            ray.dir = normalize(float3((x + 0.5f) / width - 0.5f, (y + 0.5f) / height - 0.5f, -1.f));
+        }
+    }
+
+    const bool anyHit = ctx.getParam("anyHit") != 0;
+    std::vector<TriangleHit> hits;
+    std::vector<uint8_t> anyHits;
+    ctx.setItemsPerIteration(rays.size());
+    ctx.run(
+        [&]()
+        {
+            if (anyHit)
+            {
+                raytracer.traceAny(rays, anyHits);
+                doNotOptimize(anyHits.data());
+            }
+            else
+            {
+                raytracer.traceClosest(rays, hits);
+                doNotOptimize(hits.data());
+            }
+        }
+    );
+}
+} // namespace Falcor
@@ -0,0 +1,287 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
+#include "Scene/LoopSubdivide.h"
+#include "Utils/Math/FNVHash.h"
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct Torus
+{
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<uint32_t> indices;
+};
+
+/// Create a closed torus with 4 * size * size triangles.
+Torus createTorus(uint32_t size)
+{
+    const uint32_t majorCount = 2 * size;
+    const uint32_t minorCount = size;
+    const float majorRadius = 2.f;
+    const float minorRadius = 1.f;
+
+    Torus torus;
+    for (uint32_t i = 0; i < majorCount; ++i)
+    {
+        const float u = 2.f * float(M_PI) * i / majorCount;
+        for (uint32_t j = 0; j < minorCount; ++j)
+        {
+            const float v = 2.f * float(M_PI) * j / minorCount;
+            const float3 normal(std::cos(u) * std::cos(v), std::sin(u) * std::cos(v), std::sin(v));
+            torus.positions.push_back(float3(majorRadius * std::cos(u), majorRadius * std::sin(u), 0.f) + minorRadius * normal);
+            torus.normals.push_back(normal);
+        }
+    }
+
+    for (uint32_t i = 0; i < majorCount; ++i)
+    {
+        for (uint32_t j = 0; j < minorCount; ++j)
+        {
+            uint32_t i0 = i * minorCount + j;
+            uint32_t i1 = i * minorCount + (j + 1) % minorCount;
+            uint32_t i2 = ((i + 1) % majorCount) * minorCount + j;
+            uint32_t i3 = ((i + 1) % majorCount) * minorCount + (j + 1) % minorCount;
+            torus.indices.insert(torus.indices.end(), {i0, i2, i1, i1, i2, i3});
+        }
+    }
+    return torus;
+}
+
+struct Mesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+};
+
+/// Closed mesh where all vertices have valence 3.
+Mesh createTetrahedron()
+{
+    return {
+        {{1.f, 1.f, 1.f}, {1.f, -1.f, -1.f}, {-1.f, 1.f, -1.f}, {-1.f, -1.f, 1.f}},
+        {0, 1, 2, 0, 3, 1, 0, 2, 3, 1, 3, 2},
+    };
+}
+
+/// Open mesh of 2x2 quads split into triangles, with boundary vertices and an interior vertex of valence 6.
+Mesh createGrid()
+{
+    Mesh grid;
+    for (uint32_t y = 0; y < 3; ++y)
+        for (uint32_t x = 0; x < 3; ++x)
+            grid.positions.push_back(float3(float(x), float(y), 0.f));
+    for (uint32_t y = 0; y < 2; ++y)
+    {
+        for (uint32_t x = 0; x < 2; ++x)
+        {
+            uint32_t i0 = y * 3 + x;
+            uint32_t i1 = i0 + 1;
+            uint32_t i2 = i0 + 3;
+            uint32_t i3 = i2 + 1;
+            grid.indices.insert(grid.indices.end(), {i0, i1, i3, i0, i3, i2});
+        }
+    }
+    return grid;
+}
+
+/// Reference result of a subdivision level. Checksums are sums of positions and normalized normals weighted by (vertex index + 1).
+struct Reference
+{
+    uint32_t levels;
+    size_t vertexCount;
+    size_t indexCount;
+    uint64_t indexHash;
+    std::array<double, 3> positionChecksum;
+    std::array<double, 3> normalChecksum;
+};
+
+void checkReference(UnitTestContext& ctx, const Mesh& mesh, const Reference& ref)
+{
+    auto result = loopSubdivide(ref.levels, mesh.positions, mesh.indices);
+    ASSERT_EQ(result.positions.size(), ref.vertexCount) << "levels " << ref.levels;
+    ASSERT_EQ(result.normals.size(), ref.vertexCount) << "levels " << ref.levels;
+    ASSERT_EQ(result.indices.size(), ref.indexCount) << "levels " << ref.levels;
+    EXPECT_EQ(fnvHashArray64(result.indices.data(), result.indices.size() * sizeof(uint32_t)), ref.indexHash) << "levels " << ref.levels;
+
+    std::array<double, 3> positionChecksum = {};
+    std::array<double, 3> normalChecksum = {};
+    double weightSum = 0.0;
+    for (size_t i = 0; i < result.positions.size(); ++i)
+    {
+        const double weight = double(i + 1);
+        const float3 normal = normalize(result.normals[i]);
+        for (int c = 0; c < 3; ++c)
+        {
+            positionChecksum[c] += weight * result.positions[i][c];
+            normalChecksum[c] += weight * normal[c];
+        }
+        weightSum += weight;
+    }
+
+    // Per-vertex errors of 1e-5 allow for differences in floating-point contraction between compilers.
+    const double tolerance = 1e-5 * weightSum;
+    for (int c = 0; c < 3; ++c)
+    {
+        EXPECT_LE(std::abs(positionChecksum[c] - ref.positionChecksum[c]), tolerance) << "levels " << ref.levels << " component " << c;
+        EXPECT_LE(std::abs(normalChecksum[c] - ref.normalChecksum[c]), tolerance) << "levels " << ref.levels << " component " << c;
+    }
+}
+
+void checkLevel1(
+    UnitTestContext& ctx,
+    const Mesh& mesh,
+    fstd::span<const float3> expectedPositions,
+    fstd::span<const float3> expectedNormals,
+    fstd::span<const uint32_t> expectedIndices
+)
+{
+    auto result = loopSubdivide(1, mesh.positions, mesh.indices);
+    ASSERT_EQ(result.positions.size(), expectedPositions.size());
+    ASSERT_EQ(result.normals.size(), expectedNormals.size());
+    ASSERT_EQ(result.indices.size(), expectedIndices.size());
+    for (size_t i = 0; i < expectedPositions.size(); ++i)
+    {
+        EXPECT_LT(length(result.positions[i] - expectedPositions[i]), 1e-5f) << "vertex " << i;
+        EXPECT_LT(length(normalize(result.normals[i]) - expectedNormals[i]), 1e-5f) << "vertex " << i;
+    }
+    for (size_t i = 0; i < expectedIndices.size(); ++i)
+        EXPECT_EQ(result.indices[i], expectedIndices[i]) << "index " << i;
+}
+} // namespace
+
+// The reference values were generated with the original pbrt-v3 based implementation.
+
+CPU_TEST(LoopSubdivide_Tetrahedron)
+{
+    const Mesh tetrahedron = createTetrahedron();
+
+    // Even vertices are moved to the limit surface, odd (edge) vertices follow in order of their creation.
+    const float a = 0.2f;
+    const float b = 0.29166667f;
+    const float n = 0.57735027f;
+    const float3 kPositions[] = {
+        {a, a, a}, {a, -a, -a}, {-a, a, -a}, {-a, -a, a}, {b, 0.f, 0.f},
+        {0.f, 0.f, -b}, {0.f, b, 0.f}, {0.f, 0.f, b}, {0.f, -b, 0.f}, {-b, 0.f, 0.f},
+    };
+    const float3 kNormals[] = {
+        {-n, -n, -n}, {-n, n, n}, {n, -n, n}, {n, n, -n}, {-1.f, 0.f, 0.f},
+        {0.f, 0.f, 1.f}, {0.f, -1.f, 0.f}, {0.f, 0.f, -1.f}, {0.f, 1.f, 0.f}, {1.f, 0.f, 0.f},
+    };
+    const uint32_t kIndices[] = {
+        0, 4, 6, 4, 1, 5, 6, 5, 2, 4, 5, 6, 0, 7, 4, 7, 3, 8, 4, 8, 1, 7, 8, 4,
+        0, 6, 7, 6, 2, 9, 7, 9, 3, 6, 9, 7, 1, 8, 5, 8, 3, 9, 5, 9, 2, 8, 9, 5,
+    };
+    checkLevel1(ctx, tetrahedron, kPositions, kNormals, kIndices);
+
+    const Reference kReferences[] = {
+        {1, 10, 48, 0xa543d380a6b6a795ull, {-2.25833336, -0.98333329, 0.583333371}, {7.30940104, 3.15470032, -2.00000037}},
+        {2, 34, 192, 0x04ba278911d2b765ull, {-22.5161444, -11.8453119, 2.31770848}, {82.1293863, 42.7732758, -13.7133202}},
+        {3, 130, 768, 0xbde36083e7eada75ull, {-324.525426, -167.088154, 4.13362699}, {1237.89605, 637.86861, -70.9324698}},
+    };
+    for (const auto& ref : kReferences)
+        checkReference(ctx, tetrahedron, ref);
+}
+
+CPU_TEST(LoopSubdivide_OpenGrid)
+{
+    const Mesh grid = createGrid();
+
+    // Boundary vertices use the boundary rules and stay in the plane of the grid.
+    const float c = 0.51041667f;
+    const float d = 1.48958333f;
+    const float3 kPositions[] = {
+        {0.175f, 0.175f, 0.f}, {1.f, 0.f, 0.f}, {1.825f, 0.175f, 0.f}, {0.f, 1.f, 0.f}, {1.f, 1.f, 0.f},
+        {2.f, 1.f, 0.f}, {0.175f, 1.825f, 0.f}, {1.f, 2.f, 0.f}, {1.825f, 1.825f, 0.f}, {0.525f, 0.025f, 0.f},
+        {1.f, 0.5f, 0.f}, {c, c, 0.f}, {0.5f, 1.f, 0.f}, {0.025f, 0.525f, 0.f}, {1.475f, 0.025f, 0.f},
+        {1.975f, 0.525f, 0.f}, {1.5f, 0.5f, 0.f}, {1.5f, 1.f, 0.f}, {1.f, 1.5f, 0.f}, {0.5f, 1.5f, 0.f},
+        {0.525f, 1.975f, 0.f}, {0.025f, 1.475f, 0.f}, {1.975f, 1.475f, 0.f}, {d, d, 0.f}, {1.475f, 1.975f, 0.f},
+    };
+    const std::vector<float3> kNormals(std::size(kPositions), float3(0.f, 0.f, -1.f));
+    const uint32_t kIndices[] = {
+        0, 9, 11, 9, 1, 10, 11, 10, 4, 9, 10, 11, 0, 11, 13, 11, 4, 12, 13, 12, 3, 11, 12, 13,
+        1, 14, 16, 14, 2, 15, 16, 15, 5, 14, 15, 16, 1, 16, 10, 16, 5, 17, 10, 17, 4, 16, 17, 10,
+        3, 12, 19, 12, 4, 18, 19, 18, 7, 12, 18, 19, 3, 19, 21, 19, 7, 20, 21, 20, 6, 19, 20, 21,
+        4, 17, 23, 17, 5, 22, 23, 22, 8, 17, 22, 23, 4, 23, 18, 23, 8, 24, 18, 24, 7, 23, 24, 18,
+    };
+    checkLevel1(ctx, grid, kPositions, kNormals, kIndices);
+
+    const Reference kReferences[] = {
+        {1, 25, 96, 0xde7bc0fdbd6f484bull, {344.374997, 379.875001, 0.0}, {0.0, 0.0, -325.0}},
+        {2, 81, 384, 0x77f44036245fa915ull, {3520.56321, 3839.30696, 0.0}, {0.0, 0.0, -3321.0}},
+        {3, 289, 1536, 0xf95d1fa9caa87aabull, {44494.5302, 48576.8397, 0.0}, {0.0, 0.0, -41905.0}},
+    };
+    for (const auto& ref : kReferences)
+        checkReference(ctx, grid, ref);
+}
+
+CPU_TEST(LoopSubdivide_Torus)
+{
+    const Torus torus = createTorus(8);
+    const size_t vertexCount = torus.positions.size();
+    const size_t faceCount = torus.indices.size() / 3;
+
+    auto result = loopSubdivide(1, torus.positions, torus.indices);
+
+    // Each face is split into four, and a vertex is added per edge. The torus is closed, so there are 3/2 edges per face.
+    ASSERT_EQ(result.indices.size(), 3 * 4 * faceCount);
+    ASSERT_EQ(result.positions.size(), vertexCount + faceCount * 3 / 2);
+    ASSERT_EQ(result.normals.size(), result.positions.size());
+
+    // Original vertices come first and stay close to the torus, with normals along the surface normal.
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        EXPECT_LT(length(result.positions[i] - torus.positions[i]), 0.2f) << "vertex " << i;
+        const float3 normal = normalize(result.normals[i]);
+        EXPECT_GT(std::abs(dot(normal, torus.normals[i])), 0.8f) << "vertex " << i;
+    }
+    for (uint32_t index : result.indices)
+        EXPECT_LT(index, result.positions.size());
+}
+
+CPU_BENCHMARK(LoopSubdivide_Torus, BENCHMARK_PARAM("faces", 65536, 1048576))
+{
+    const uint32_t size = (uint32_t)std::sqrt(double(ctx.getParam("faces") / 4));
+    const Torus torus = createTorus(size);
+    ctx.setItemsPerIteration(torus.indices.size() / 3);
+
+    ctx.run(
+        [&]()
+        {
+            auto result = loopSubdivide(1, torus.positions, torus.indices);
+            doNotOptimize(result.indices.data());
+        }
+    );
+}
+} // namespace Falcor
@@ -0,0 +1,223 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
+#include "Scene/Material/MaterialSystem.h"
+#include "Scene/Material/StandardMaterial.h"
+
+namespace Falcor
+{
+namespace
+{
+ref<StandardMaterial> createMaterial(ref<Device> pDevice, const std::string& name, float roughness, float metallic)
+{
+    auto pMaterial = StandardMaterial::create(pDevice, name);
+    pMaterial->setBaseColor(float4(0.5f, 0.25f, 0.125f, 1.f));
+    pMaterial->setRoughness(roughness);
+    pMaterial->setMetallic(metallic);
+    return pMaterial;
+}
+} // namespace
+
+GPU_TEST(MaterialSystem_ContentHash)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    // Identical parameters hash to the same value, the name is not part of the content.
+    auto pA = createMaterial(pDevice, "A", 0.5f, 0.f);
+    auto pB = createMaterial(pDevice, "B", 0.5f, 0.f);
+    EXPECT(pA->isEqual(pB));
+    EXPECT_EQ(pA->getContentHash(), pB->getContentHash());
+
+    // Negative zero compares equal and must hash like positive zero.
+    pB->setDisplacementOffset(1.f);
+    pB->setDisplacementOffset(-0.f);
+    EXPECT(pA->isEqual(pB));
+    EXPECT_EQ(pA->getContentHash(), pB->getContentHash());
+
+    // Different parameters change the hash.
+    auto pC = createMaterial(pDevice, "C", 0.75f, 0.f);
+    EXPECT(!pA->isEqual(pC));
+    EXPECT_NE(pA->getContentHash(), pC->getContentHash());
+}
+
+GPU_TEST(MaterialSystem_RemoveDuplicateMaterials)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    MaterialSystem materials(pDevice);
+
+    const uint8_t texel[4] = {255, 0, 0, 255};
+    auto pTexture = pDevice->createTexture2D(1, 1, ResourceFormat::RGBA8Unorm, 1, 1, texel);
+    auto pOtherTexture = pDevice->createTexture2D(1, 1, ResourceFormat::RGBA8Unorm, 1, 1, texel);
+
+    Sampler::Desc samplerDesc;
+    samplerDesc.setFilterMode(TextureFilteringMode::Point, TextureFilteringMode::Point, TextureFilteringMode::Point);
+    auto pSampler = pDevice->createSampler(samplerDesc);
+
+    std::vector<ref<StandardMaterial>> added = {
+        createMaterial(pDevice, "unique0", 0.5f, 0.f),
+        createMaterial(pDevice, "unique1", 0.5f, 1.f),
+        createMaterial(pDevice, "duplicate0", 0.5f, 0.f),
+        createMaterial(pDevice, "texture0", 0.5f, 0.f),
+        createMaterial(pDevice, "texture1", 0.5f, 0.f),
+        createMaterial(pDevice, "sampler", 0.5f, 0.f),
+        createMaterial(pDevice, "duplicate1", 0.5f, 1.f),
+    };
+    added[3]->setBaseColorTexture(pTexture);
+    added[4]->setBaseColorTexture(pOtherTexture);
+    added[5]->setDefaultTextureSampler(pSampler);
+
+    for (const auto& pMaterial : added)
+        materials.addMaterial(pMaterial);
+
+    // Adding a material twice returns its ID.
+    EXPECT_EQ(materials.addMaterial(added[1]), MaterialID(1));
+
+    std::vector<MaterialID> idMap;
+    size_t removed = materials.removeDuplicateMaterials(idMap);
+    EXPECT_EQ(removed, 2u);
+    EXPECT_EQ(materials.getMaterialCount(), 5u);
+
+    // Duplicates map to the first occurrence, materials with other textures or samplers are kept.
+    const std::vector<MaterialID> expected = {
+        MaterialID(0), MaterialID(1), MaterialID(0), MaterialID(2), MaterialID(3), MaterialID(4), MaterialID(1),
+    };
+    ASSERT_EQ(idMap.size(), expected.size());
+    for (size_t i = 0; i < idMap.size(); i++)
+        EXPECT_EQ(idMap[i], expected[i]) << "material " << added[i]->getName();
+
+    // The lookup of added materials follows the new IDs.
+    EXPECT_EQ(materials.addMaterial(added[3]), MaterialID(2));
+    EXPECT_EQ(materials.getMaterialCount(), 5u);
+}
+
+GPU_TEST(MaterialSystem_RemoveDuplicateMaterialsOrder)
+{
+    // Every unique material is added ten times, interleaved with the others.
+    ref<Device> pDevice = ctx.getDevice();
+    const size_t materialCount = 500;
+    const uint32_t uniqueCount = uint32_t(materialCount / 10);
+
+    MaterialSystem materials(pDevice);
+    for (size_t i = 0; i < materialCount; i++)
+    {
+        const size_t j = i % uniqueCount;
+        materials.addMaterial(createMaterial(pDevice, fmt::format("material{}", i), float(j % 10) / 10.f, float(j / 10) / 10.f));
+    }
+
+    std::vector<MaterialID> idMap;
+    size_t removed = materials.removeDuplicateMaterials(idMap);
+    EXPECT_EQ(removed, materialCount - uniqueCount);
+    EXPECT_EQ(materials.getMaterialCount(), uniqueCount);
+
+    // The first occurrences keep their order, duplicates map to them.
+    ASSERT_EQ(idMap.size(), materialCount);
+    for (size_t i = 0; i < materialCount; i++)
+        EXPECT_EQ(idMap[i], MaterialID(uint32_t(i % uniqueCount))) << "material " << i;
+}
+
+GPU_TEST(MaterialSystem_RemoveDuplicateTextures)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    MaterialSystem materials(pDevice);
+
+    const uint8_t texels[16] = {255, 0, 0, 255, 0, 255, 0, 255, 0, 0, 255, 255, 255, 255, 255, 255};
+    // The content hash stands in for the texels, which are the same for all textures.
+    auto createTexture = [&](uint32_t width, uint32_t height, std::optional<uint64_t> hash)
+    {
+        auto pTexture = pDevice->createTexture2D(width, height, ResourceFormat::RGBA8Unorm, 1, 1, texels);
+        pTexture->setContentHash(hash);
+        return pTexture;
+    };
+
+    auto pTexture = createTexture(2, 2, 1);
+    auto pIdentical = createTexture(2, 2, 1);
+    auto pDifferent = createTexture(2, 2, 2);
+    // Same hash as pTexture but a different desc, e.g. a hash collision between images of different sizes.
+    auto pCollision = createTexture(4, 1, 1);
+    auto pNoHash = createTexture(2, 2, std::nullopt);
+
+    std::vector<ref<StandardMaterial>> added = {
+        createMaterial(pDevice, "texture", 0.5f, 0.f),
+        createMaterial(pDevice, "identical", 0.5f, 0.f),
+        createMaterial(pDevice, "different", 0.5f, 0.f),
+        createMaterial(pDevice, "collision", 0.5f, 0.f),
+        createMaterial(pDevice, "noHash", 0.5f, 0.f),
+    };
+    added[0]->setBaseColorTexture(pTexture);
+    added[1]->setBaseColorTexture(pIdentical);
+    added[2]->setBaseColorTexture(pDifferent);
+    added[3]->setBaseColorTexture(pCollision);
+    added[4]->setBaseColorTexture(pNoHash);
+    // The same texture in another slot is replaced as well.
+    added[4]->setSpecularTexture(pIdentical);
+
+    for (const auto& pMaterial : added)
+        materials.addMaterial(pMaterial);
+
+    EXPECT_EQ(materials.removeDuplicateTextures(), 2u);
+
+    const ref<Texture> expected[] = {pTexture, pTexture, pDifferent, pCollision, pNoHash};
+    for (size_t i = 0; i < added.size(); i++)
+        EXPECT(added[i]->getBaseColorTexture() == expected[i]) << "material " << added[i]->getName();
+    EXPECT(added[4]->getSpecularTexture() == pTexture);
+
+    // Running again finds no more duplicates.
+    EXPECT_EQ(materials.removeDuplicateTextures(), 0u);
+}
+
+CPU_BENCHMARK(MaterialSystem_RemoveDuplicateMaterials, BENCHMARK_PARAM("materials", 5000, 50000))
+{
+    // Synthetic scene where every unique material is duplicated ten times, similar to imported scenes
+    // that create a material per mesh. Each iteration adds all materials to a new material system.
+    const size_t materialCount = (size_t)ctx.getParam("materials");
+    const uint32_t uniqueCount = uint32_t(materialCount / 10);
+
+    ref<Device> pDevice = make_ref<Device>(Device::Desc());
+    std::vector<ref<Material>> sceneMaterials(materialCount);
+    for (size_t i = 0; i < materialCount; i++)
+    {
+        const size_t j = i % uniqueCount;
+        sceneMaterials[i] = createMaterial(pDevice, fmt::format("material{}", i), float(j % 100) / 100.f, float(j / 100) / 100.f);
+    }
+
+    ctx.setItemsPerIteration(materialCount);
+    ctx.run(
+        [&]()
+        {
+            MaterialSystem materials(pDevice);
+            for (const auto& pMaterial : sceneMaterials)
+                materials.addMaterial(pMaterial);
+
+            std::vector<MaterialID> idMap;
+            doNotOptimize(materials.removeDuplicateMaterials(idMap));
+            EXPECT_EQ(materials.getMaterialCount(), uniqueCount);
+        }
+    );
+}
+} // namespace Falcor
@@ -0,0 +1,288 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
+#include "Core/Platform/OS.h"
+#include "Scene/NativeMeshLoader.h"
+#include "Scene/TriangleMesh.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Unique temporary file path with the given extension, the file is deleted when the object goes out of scope.
+class TempFile
+{
+public:
+    TempFile(const std::string& extension) : mPath(getTempFilePath()) { mPath += extension; }
+    ~TempFile() { std::filesystem::remove(mPath); }
+
+    const std::filesystem::path& getPath() const { return mPath; }
+
+private:
+    std::filesystem::path mPath;
+};
+
+template<typename T>
+void writeBinary(std::ofstream& ofs, T value, bool bigEndian)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if (bigEndian)
+        std::reverse(bytes, bytes + sizeof(T));
+    ofs.write(bytes, sizeof(T));
+}
+
+const float3 kQuadPositions[] = {{0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}, {1.f, 1.f, 0.f}, {0.f, 1.f, 0.f}};
+
+/// Write a unit quad with normals and texture coordinates to a binary PLY file.
+/// The vertices have an extra ignored property and an extra element follows the faces.
+void writeQuadPLY(const std::filesystem::path& path, bool bigEndian, bool splitQuad)
+{
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << "ply\nformat " << (bigEndian ? "binary_big_endian" : "binary_little_endian") << " 1.0\n";
+    ofs << "comment Test quad\nelement vertex 4\nproperty float x\nproperty float y\nproperty double z\nproperty uchar red\n";
+    ofs << "property float nx\nproperty float ny\nproperty float nz\nproperty float u\nproperty float v\n";
+    ofs << "element face " << (splitQuad ? 2 : 1) << "\nproperty list uchar int vertex_indices\n";
+    ofs << "element extra 1\nproperty list uchar float values\nend_header\n";
+    for (const float3& p : kQuadPositions)
+    {
+        writeBinary<float>(ofs, p.x, bigEndian);
+        writeBinary<float>(ofs, p.y, bigEndian);
+        writeBinary<double>(ofs, p.z, bigEndian);
+        writeBinary<uint8_t>(ofs, 255, bigEndian);
+        writeBinary<float>(ofs, 0.f, bigEndian);
+        writeBinary<float>(ofs, 0.f, bigEndian);
+        writeBinary<float>(ofs, 1.f, bigEndian);
+        writeBinary<float>(ofs, p.x, bigEndian);
+        writeBinary<float>(ofs, p.y, bigEndian);
+    }
+    auto writeFace = [&](std::initializer_list<int32_t> indices)
+    {
+        writeBinary<uint8_t>(ofs, (uint8_t)indices.size(), bigEndian);
+        for (int32_t index : indices)
+            writeBinary<int32_t>(ofs, index, bigEndian);
+    };
+    if (splitQuad)
+    {
+        writeFace({0, 1, 2});
+        writeFace({0, 2, 3});
+    }
+    else
+    {
+        writeFace({0, 1, 2, 3});
+    }
+    writeBinary<uint8_t>(ofs, 2, bigEndian);
+    writeBinary<float>(ofs, 1.f, bigEndian);
+    writeBinary<float>(ofs, 2.f, bigEndian);
+}
+
+void checkQuad(CPUUnitTestContext& ctx, const NativeMeshLoader::MeshData& mesh)
+{
+    ASSERT_EQ(mesh.positions.size(), 4);
+    ASSERT_EQ(mesh.normals.size(), 4);
+    ASSERT_EQ(mesh.texCrds.size(), 4);
+    ASSERT_EQ(mesh.indices.size(), 6);
+
+    const uint32_t expectedIndices[] = {0, 1, 2, 0, 2, 3};
+    for (size_t i = 0; i < 6; ++i)
+        EXPECT_EQ(mesh.indices[i], expectedIndices[i]);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        EXPECT(all(mesh.positions[i] == kQuadPositions[i]));
+        EXPECT(all(mesh.normals[i] == float3(0.f, 0.f, 1.f)));
+        // Texture coordinates are flipped vertically.
+        EXPECT(all(mesh.texCrds[i] == float2(kQuadPositions[i].x, 1.f - kQuadPositions[i].y)));
+    }
+}
+
+/// Write a grid of quads with all vertex attributes to an OBJ file and the triangulated grid to a binary PLY file.
+void writeGrid(const std::filesystem::path& objPath, const std::filesystem::path& plyPath, uint32_t size)
+{
+    const uint32_t vertexCount = (size + 1) * (size + 1);
+    const uint32_t triangleCount = size * size * 2;
+
+    std::ofstream obj(objPath);
+    std::ofstream ply(plyPath, std::ios::binary);
+    ply << "ply\nformat binary_little_endian 1.0\nelement vertex " << vertexCount << "\n";
+    ply << "property float x\nproperty float y\nproperty float z\n";
+    ply << "element face " << triangleCount << "\nproperty list uchar uint vertex_indices\nend_header\n";
+
+    for (uint32_t y = 0; y <= size; ++y)
+    {
+        for (uint32_t x = 0; x <= size; ++x)
+        {
+            float3 p = float3(float(x), float(y), 0.1f * ((x * 7 + y * 3) % 5)) / float(size);
+            obj << fmt::format("v {} {} {}\nvt {} {}\nvn 0 0 1\n", p.x, p.y, p.z, p.x, p.y);
+            ply.write(reinterpret_cast<const char*>(&p), sizeof(p));
+        }
+    }
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            uint32_t i0 = y * (size + 1) + x;
+            uint32_t i1 = i0 + 1;
+            uint32_t i2 = i1 + size + 1;
+            uint32_t i3 = i0 + size + 1;
+            obj << fmt::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2} {3}/{3}/{3}\n", i0 + 1, i1 + 1, i2 + 1, i3 + 1);
+            for (const auto& triangle : {std::array<uint32_t, 3>{i0, i1, i2}, std::array<uint32_t, 3>{i0, i2, i3}})
+            {
+                ply.put(3);
+                ply.write(reinterpret_cast<const char*>(triangle.data()), sizeof(triangle));
+            }
+        }
+    }
+}
+} // namespace
+
+CPU_TEST(NativeMeshLoader_BinaryPLY)
+{
+    TempFile file(".ply");
+    const std::filesystem::path& path = file.getPath();
+    for (bool bigEndian : {false, true})
+    {
+        for (bool splitQuad : {false, true})
+        {
+            writeQuadPLY(path, bigEndian, splitQuad);
+            checkQuad(ctx, NativeMeshLoader::load(path));
+        }
+    }
+}
+
+CPU_TEST(NativeMeshLoader_AsciiPLY)
+{
+    TempFile file(".ply");
+    const std::filesystem::path& path = file.getPath();
+    {
+        std::ofstream ofs(path);
+        ofs << "ply\r\nformat ascii 1.0\r\nelement vertex 4\r\n";
+        ofs << "property float x\nproperty float y\nproperty float z\nproperty float nx\nproperty float ny\nproperty float nz\n";
+        ofs << "property float s\nproperty float t\nelement face 1\nproperty list uchar uint vertex_index\nend_header\n";
+        ofs << "0 0 0 0 0 1 0 0\n1 0 0 0 0 1 1 0\n1.0e0 1 0 0 0 1 1 1\n0 1 0 0 0 1 0 1\n4 0 1 2 3\n";
+    }
+    checkQuad(ctx, NativeMeshLoader::load(path));
+}
+
+CPU_TEST(NativeMeshLoader_OBJ)
+{
+    TempFile file(".obj");
+    const std::filesystem::path& path = file.getPath();
+
+    // Negative indices, shared normal and a trailing comment.
+    {
+        std::ofstream ofs(path);
+        ofs << "# Test quad\nmtllib test.mtl\no quad\nv 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n";
+        ofs << "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvn 0 0 1\ng group\ns 1\nusemtl material\n";
+        ofs << "f -4/-4/-1 -3/-3/-1 -2/-2/-1 4/4/1 # comment\n";
+    }
+    checkQuad(ctx, NativeMeshLoader::load(path));
+
+    // Positions only.
+    {
+        std::ofstream ofs(path);
+        ofs << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3\nf 1 3 4\n";
+    }
+    auto mesh = NativeMeshLoader::load(path);
+    EXPECT_EQ(mesh.positions.size(), 4);
+    EXPECT_EQ(mesh.indices.size(), 6);
+    EXPECT(mesh.normals.empty());
+    EXPECT(mesh.texCrds.empty());
+
+    mesh.generateSmoothNormals();
+    ASSERT_EQ(mesh.normals.size(), 4);
+    EXPECT(all(mesh.normals[0] == float3(0.f, 0.f, 1.f)));
+
+    mesh.generateFlatNormals();
+    EXPECT_EQ(mesh.positions.size(), 6);
+    EXPECT_EQ(mesh.normals.size(), 6);
+    EXPECT(all(mesh.positions[5] == kQuadPositions[3]));
+
+    // Out of range index.
+    {
+        std::ofstream ofs(path);
+        ofs << "v 0 0 0\nf 1 2 3\n";
+    }
+    EXPECT_THROW(NativeMeshLoader::load(path));
+}
+
+CPU_TEST(NativeMeshLoader_Grid)
+{
+    // Both loaders produce the same triangles as ASSIMP.
+    TempFile objFile(".obj");
+    TempFile plyFile(".ply");
+    const uint32_t gridSize = 16;
+    writeGrid(objFile.getPath(), plyFile.getPath(), gridSize);
+
+    for (const auto& path : {plyFile.getPath(), objFile.getPath()})
+    {
+        auto mesh = NativeMeshLoader::load(path);
+        EXPECT_EQ(mesh.getTriangleCount(), gridSize * gridSize * 2) << path;
+        EXPECT_EQ(mesh.getVertexCount(), (gridSize + 1) * (gridSize + 1)) << path;
+
+        auto pAssimpMesh = TriangleMesh::createFromFile(path, TriangleMesh::ImportFlags::None);
+        ASSERT(pAssimpMesh != nullptr);
+        EXPECT_EQ(pAssimpMesh->getIndices().size(), mesh.indices.size()) << path;
+    }
+}
+
+CPU_BENCHMARK(NativeMeshLoader_Load, BENCHMARK_PARAM("obj", 0, 1), BENCHMARK_PARAM("assimp", 0, 1))
+{
+    // Load a grid with 2M triangles with the native loader or ASSIMP.
+    TempFile objFile(".obj");
+    TempFile plyFile(".ply");
+    const uint32_t gridSize = 1000;
+    writeGrid(objFile.getPath(), plyFile.getPath(), gridSize);
+
+    const std::filesystem::path& path = ctx.getParam("obj") ? objFile.getPath() : plyFile.getPath();
+    const bool assimp = ctx.getParam("assimp") != 0;
+    ctx.setItemsPerIteration(gridSize * gridSize * 2);
+    ctx.run(
+        [&]()
+        {
+            if (assimp)
+            {
+                auto pMesh = TriangleMesh::createFromFile(path, TriangleMesh::ImportFlags::None);
+                doNotOptimize(pMesh.get());
+            }
+            else
+            {
+                auto mesh = NativeMeshLoader::load(path);
+                doNotOptimize(mesh.indices.data());
+            }
+        }
+    );
+}
+} // namespace Falcor
@@ -0,0 +1,225 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/SceneBuilderDump.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Core/Plugin.h"
+#include "Core/Platform/OS.h"
+#include <cmath>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+SceneBuilder::Node createNode(const std::string& name, NodeID parent = NodeID::Invalid(), float4x4 transform = float4x4::identity())
+{
+    return SceneBuilder::Node{name, transform, float4x4::identity(), float4x4::identity(), parent};
+}
+
+/// Temporary file that is deleted when the object goes out of scope.
+class TempFile
+{
+public:
+    TempFile(const std::string& extension) : mPath(getTempFilePath()) { mPath += extension; }
+    ~TempFile() { std::filesystem::remove(mPath); }
+
+    const std::filesystem::path& getPath() const { return mPath; }
+
+private:
+    std::filesystem::path mPath;
+};
+
+/// Write an OBJ file with a triangle fan of the given size and a material library with a single material.
+void writeFanOBJ(const TempFile& objFile, const TempFile& mtlFile, const std::string& name, uint32_t triangleCount)
+{
+    std::ofstream mtl(mtlFile.getPath());
+    mtl << "newmtl " << name << "Material\nKd 0.5 0.5 0.5\n";
+
+    std::ofstream obj(objFile.getPath());
+    obj << "mtllib " << mtlFile.getPath().filename().string() << "\n";
+    obj << "o " << name << "\n";
+    obj << "v 0 0 0\n";
+    for (uint32_t i = 0; i <= triangleCount; ++i)
+    {
+        const float angle = i * 0.1f;
+        obj << "v " << std::cos(angle) << " " << std::sin(angle) << " 0\n";
+    }
+    obj << "usemtl " << name << "Material\n";
+    for (uint32_t i = 0; i < triangleCount; ++i)
+        obj << "f 1 " << i + 2 << " " << i + 3 << "\n";
+}
+} // namespace
+
+GPU_TEST(SceneBuilder_ForkMerge)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    SceneBuilder builder(pDevice, Settings());
+
+    // Objects added to the parent before the merge keep their IDs.
+    NodeID rootID = builder.addNode(createNode("root"));
+    auto pParentMaterial = StandardMaterial::create(pDevice, "parent");
+    builder.addMaterial(pParentMaterial);
+    builder.addLight(PointLight::create("parentLight"));
+
+    auto pFork = builder.fork();
+    NodeID forkRootID = pFork->addNode(createNode("forkRoot"));
+    NodeID forkChildID = pFork->addNode(createNode("forkChild", forkRootID));
+    auto pForkMaterial = StandardMaterial::create(pDevice, "fork");
+    MeshID meshID = pFork->addTriangleMesh(TriangleMesh::createQuad(), pForkMaterial);
+    pFork->addMeshInstance(forkChildID, meshID);
+    auto pForkLight = PointLight::create("forkLight");
+    pFork->addLight(pForkLight);
+    auto pAnimation = pFork->createAnimation(pForkLight, "forkAnimation", 1.0);
+    ASSERT(pAnimation != nullptr);
+    NodeID animationNodeID = pAnimation->getNodeID();
+
+    // Skinned triangle driven by a bone node of the fork, the other bone slots are unused.
+    const float4x4 boneTransform = math::matrixFromTranslation(float3(1.f, 2.f, 3.f));
+    NodeID boneID = pFork->addNode(createNode("forkBone", forkRootID, boneTransform));
+    const uint32_t indices[] = {0, 1, 2};
+    const float3 positions[] = {float3(0.f), float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f)};
+    const float3 normals[] = {float3(0.f, 0.f, 1.f), float3(0.f, 0.f, 1.f), float3(0.f, 0.f, 1.f)};
+    const uint4 boneIDs[] = {
+        uint4(boneID.get(), NodeID::kInvalidID, NodeID::kInvalidID, NodeID::kInvalidID),
+        uint4(boneID.get(), NodeID::kInvalidID, NodeID::kInvalidID, NodeID::kInvalidID),
+        uint4(boneID.get(), NodeID::kInvalidID, NodeID::kInvalidID, NodeID::kInvalidID),
+    };
+    const float4 boneWeights[] = {float4(1.f, 0.f, 0.f, 0.f), float4(1.f, 0.f, 0.f, 0.f), float4(1.f, 0.f, 0.f, 0.f)};
+
+    SceneBuilder::Mesh skinnedMesh;
+    skinnedMesh.name = "skinned";
+    skinnedMesh.faceCount = 1;
+    skinnedMesh.vertexCount = 3;
+    skinnedMesh.indexCount = 3;
+    skinnedMesh.pIndices = indices;
+    skinnedMesh.topology = Vao::Topology::TriangleList;
+    skinnedMesh.pMaterial = pForkMaterial;
+    skinnedMesh.positions = {positions, SceneBuilder::Mesh::AttributeFrequency::Vertex};
+    skinnedMesh.normals = {normals, SceneBuilder::Mesh::AttributeFrequency::Vertex};
+    skinnedMesh.boneIDs = {boneIDs, SceneBuilder::Mesh::AttributeFrequency::Vertex};
+    skinnedMesh.boneWeights = {boneWeights, SceneBuilder::Mesh::AttributeFrequency::Vertex};
+    pFork->addMeshInstance(forkChildID, pFork->addMesh(skinnedMesh));
+
+    builder.merge(*pFork);
+
+    // Nodes are appended and the links between them are remapped.
+    const uint32_t nodeOffset = 1;
+    ASSERT_EQ(builder.getNodeCount(), 5u);
+    EXPECT_EQ(builder.getNode(rootID).name, "root");
+    EXPECT_EQ(builder.getNode(NodeID{forkRootID.get() + nodeOffset}).name, "forkRoot");
+    EXPECT_EQ(builder.getNode(NodeID{forkChildID.get() + nodeOffset}).parent, NodeID{forkRootID.get() + nodeOffset});
+    EXPECT_EQ(builder.getNode(NodeID{animationNodeID.get() + nodeOffset}).name, "forkAnimation");
+
+    // Materials and lights are appended, animated objects refer to the remapped nodes.
+    ASSERT_EQ(builder.getMaterials().size(), 2u);
+    EXPECT(builder.getMaterials()[0] == pParentMaterial);
+    EXPECT(builder.getMaterials()[1] == pForkMaterial);
+    ASSERT_EQ(builder.getLights().size(), 2u);
+    EXPECT(builder.getLights()[1] == pForkLight);
+    EXPECT_EQ(pForkLight->getNodeID(), NodeID{animationNodeID.get() + nodeOffset});
+    ASSERT_EQ(builder.getAnimations().size(), 1u);
+    EXPECT_EQ(builder.getAnimations()[0]->getNodeID(), NodeID{animationNodeID.get() + nodeOffset});
+    EXPECT(builder.isNodeAnimated(NodeID{animationNodeID.get() + nodeOffset}));
+
+    // Bone IDs of skinned meshes refer to the remapped bone node, the dump prints the transforms of the used bones.
+    EXPECT_EQ(builder.getNode(NodeID{boneID.get() + nodeOffset}).name, "forkBone");
+    const auto dump = SceneBuilderDump::getDebugContent(builder);
+    ASSERT(dump.count("skinned") == 1);
+    const std::string& skinnedDump = dump.at("skinned");
+    EXPECT(skinnedDump.find(fmt::format("boneXform: {} x w1", boneTransform)) != std::string::npos) << skinnedDump;
+    EXPECT_EQ(skinnedDump.find("boneXform: identity"), std::string::npos) << skinnedDump;
+
+    // Only forked builders can be merged.
+    SceneBuilder other(pDevice, Settings());
+    EXPECT_THROW(builder.merge(other));
+}
+
+GPU_TEST(SceneBuilder_ImportParallel)
+{
+    PluginManager::instance().loadPluginByName("AssimpImporter");
+
+    ref<Device> pDevice = ctx.getDevice();
+
+    // Files of different sizes, so the imports finish in a different order than they were started.
+    const uint32_t kFileCount = 6;
+    std::vector<std::unique_ptr<TempFile>> files;
+    std::vector<std::filesystem::path> paths;
+    for (uint32_t i = 0; i < kFileCount; ++i)
+    {
+        auto pObjFile = std::make_unique<TempFile>(".obj");
+        auto pMtlFile = std::make_unique<TempFile>(".mtl");
+        writeFanOBJ(*pObjFile, *pMtlFile, fmt::format("fan{}", i), (kFileCount - i) * 20);
+        paths.push_back(pObjFile->getPath());
+        files.push_back(std::move(pObjFile));
+        files.push_back(std::move(pMtlFile));
+    }
+
+    SceneBuilder parallelBuilder(pDevice, Settings());
+    parallelBuilder.importParallel(paths);
+
+    SceneBuilder sequentialBuilder(pDevice, Settings());
+    for (const auto& path : paths)
+        sequentialBuilder.import(path);
+
+    // The IDs match the sequential import regardless of the order the jobs finished in.
+    ASSERT_EQ(parallelBuilder.getNodeCount(), sequentialBuilder.getNodeCount());
+    for (uint32_t i = 0; i < parallelBuilder.getNodeCount(); ++i)
+    {
+        const auto& parallelNode = parallelBuilder.getNode(NodeID{i});
+        const auto& sequentialNode = sequentialBuilder.getNode(NodeID{i});
+        EXPECT_EQ(parallelNode.name, sequentialNode.name) << "node " << i;
+        EXPECT_EQ(parallelNode.parent, sequentialNode.parent) << "node " << i;
+    }
+    ASSERT_EQ(parallelBuilder.getMaterials().size(), sequentialBuilder.getMaterials().size());
+    for (size_t i = 0; i < parallelBuilder.getMaterials().size(); ++i)
+        EXPECT_EQ(parallelBuilder.getMaterials()[i]->getName(), sequentialBuilder.getMaterials()[i]->getName()) << "material " << i;
+    EXPECT(SceneBuilderDump::getDebugContent(parallelBuilder) == SceneBuilderDump::getDebugContent(sequentialBuilder));
+
+    // Both builders produce the same scene.
+    ref<Scene> pParallelScene = parallelBuilder.getScene();
+    ref<Scene> pSequentialScene = sequentialBuilder.getScene();
+    ASSERT(pParallelScene != nullptr);
+    ASSERT(pSequentialScene != nullptr);
+    ASSERT_EQ(pParallelScene->getMeshCount(), pSequentialScene->getMeshCount());
+    EXPECT_EQ(pParallelScene->getMeshCount(), kFileCount);
+    for (uint32_t i = 0; i < pParallelScene->getMeshCount(); ++i)
+    {
+        const MeshID meshID{i};
+        EXPECT_EQ(pParallelScene->getMeshName(i), pSequentialScene->getMeshName(i)) << "mesh " << i;
+        EXPECT_EQ(pParallelScene->getMesh(meshID).vertexCount, pSequentialScene->getMesh(meshID).vertexCount) << "mesh " << i;
+        EXPECT_EQ(pParallelScene->getMesh(meshID).indexCount, pSequentialScene->getMesh(meshID).indexCount) << "mesh " << i;
+        EXPECT_EQ(
+            pParallelScene->getMaterial(MaterialID{pParallelScene->getMesh(meshID).materialID})->getName(),
+            pSequentialScene->getMaterial(MaterialID{pSequentialScene->getMesh(meshID).materialID})->getName()
+        ) << "mesh " << i;
+    }
+    EXPECT_EQ(pParallelScene->getGeometryInstanceCount(), pSequentialScene->getGeometryInstanceCount());
+}
+} // namespace Falcor
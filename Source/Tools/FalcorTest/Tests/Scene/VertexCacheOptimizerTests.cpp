@@ -0,0 +1,187 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
+#include "Scene/VertexCacheOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct Grid
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+};
+
+/// Create a grid of quads with the triangles in random order.
+Grid createShuffledGrid(uint32_t gridSize)
+{
+    Grid grid;
+    for (uint32_t y = 0; y <= gridSize; ++y)
+    {
+        for (uint32_t x = 0; x <= gridSize; ++x)
+            grid.positions.push_back(float3(float(x), float(y), 0.f));
+    }
+
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y < gridSize; ++y)
+    {
+        for (uint32_t x = 0; x < gridSize; ++x)
+        {
+            uint32_t i0 = y * (gridSize + 1) + x;
+            uint32_t i1 = i0 + 1;
+            uint32_t i2 = i0 + gridSize + 1;
+            uint32_t i3 = i2 + 1;
+            triangles.push_back({i0, i1, i2});
+            triangles.push_back({i1, i3, i2});
+        }
+    }
+
+    std::mt19937 rng(1234);
+    std::shuffle(triangles.begin(), triangles.end(), rng);
+    for (const auto& tri : triangles)
+        grid.indices.insert(grid.indices.end(), tri.begin(), tri.end());
+    return grid;
+}
+
+/// Return the sorted list of triangles with each triangle rotated so that its smallest index comes first.
+/// The winding is preserved. The optional vertex order maps the indices back to the original vertices.
+std::vector<std::array<uint32_t, 3>> getCanonicalTriangles(const std::vector<uint32_t>& indices, const std::vector<uint32_t>* pVertexOrder = nullptr)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<uint32_t, 3> tri;
+        for (size_t k = 0; k < 3; ++k)
+            tri[k] = pVertexOrder ? (*pVertexOrder)[indices[i + k]] : indices[i + k];
+        std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+        triangles.push_back(tri);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+} // namespace
+
+CPU_TEST(VertexCacheOptimizer_Stats)
+{
+    // Two triangles sharing an edge.
+    std::vector<uint32_t> indices = {0, 1, 2, 2, 1, 3};
+    auto stats = VertexCacheOptimizer::computeStats(indices, 5);
+    EXPECT_EQ(stats.triangleCount, 2);
+    EXPECT_EQ(stats.vertexCount, 4);
+    EXPECT_EQ(stats.cacheMisses, 4);
+    EXPECT_EQ(stats.getACMR(), 2.f);
+    EXPECT_EQ(stats.getATVR(), 1.f);
+
+    // With a cache of size one, only consecutive accesses to the same vertex hit.
+    stats = VertexCacheOptimizer::computeStats(indices, 5, 1);
+    EXPECT_EQ(stats.cacheMisses, 5);
+}
+
+CPU_TEST(VertexCacheOptimizer_Grid)
+{
+    const uint32_t gridSize = 64;
+    Grid grid = createShuffledGrid(gridSize);
+    const uint32_t vertexCount = (uint32_t)grid.positions.size();
+    const auto refTriangles = getCanonicalTriangles(grid.indices);
+
+    auto statsBefore = VertexCacheOptimizer::computeStats(grid.indices, vertexCount);
+
+    std::vector<uint32_t> indices = grid.indices;
+    VertexCacheOptimizer::optimizeTriangleOrder(indices, vertexCount);
+    EXPECT(getCanonicalTriangles(indices) == refTriangles);
+    auto statsTriangleOrder = VertexCacheOptimizer::computeStats(indices, vertexCount);
+
+    VertexCacheOptimizer::optimizeOverdraw(indices, grid.positions);
+    EXPECT(getCanonicalTriangles(indices) == refTriangles);
+    auto statsOverdraw = VertexCacheOptimizer::computeStats(indices, vertexCount);
+
+    auto vertexOrder = VertexCacheOptimizer::optimizeVertexOrder(indices, vertexCount);
+    ASSERT_EQ(vertexOrder.size(), vertexCount);
+    EXPECT(getCanonicalTriangles(indices, &vertexOrder) == refTriangles);
+    auto statsAfter = VertexCacheOptimizer::computeStats(indices, vertexCount);
+
+    // The vertex order is a permutation and vertices are referenced in order of first use.
+    std::vector<uint32_t> sortedOrder = vertexOrder;
+    std::sort(sortedOrder.begin(), sortedOrder.end());
+    for (uint32_t i = 0; i < vertexCount; ++i)
+        EXPECT_EQ(sortedOrder[i], i);
+    uint32_t nextVertex = 0;
+    for (uint32_t index : indices)
+    {
+        EXPECT_LE(index, nextVertex);
+        if (index == nextVertex)
+            nextVertex++;
+    }
+
+    // A shuffled grid misses for almost every vertex. A good ordering gets well below one miss per triangle.
+    EXPECT_GE(statsBefore.getACMR(), 2.5f);
+    EXPECT_LE(statsTriangleOrder.getACMR(), 0.8f);
+    // Overdraw sorting only moves whole clusters and vertex reordering does not change the access pattern.
+    EXPECT_LE(statsOverdraw.getACMR(), statsTriangleOrder.getACMR() * 1.05f);
+    EXPECT_EQ(statsAfter.cacheMisses, statsOverdraw.cacheMisses);
+}
+
+CPU_TEST(VertexCacheOptimizer_Unreferenced)
+{
+    // Vertex 1 and 4 are not referenced and must be moved to the end.
+    std::vector<uint32_t> indices = {3, 0, 2};
+    auto vertexOrder = VertexCacheOptimizer::optimizeVertexOrder(indices, 5);
+    EXPECT(vertexOrder == std::vector<uint32_t>({3, 0, 2, 1, 4}));
+    EXPECT(indices == std::vector<uint32_t>({0, 1, 2}));
+}
+
+CPU_BENCHMARK(VertexCacheOptimizer_Optimize, BENCHMARK_PARAM("gridSize", 100, 500))
+{
+    const Grid grid = createShuffledGrid((uint32_t)ctx.getParam("gridSize"));
+    const uint32_t vertexCount = (uint32_t)grid.positions.size();
+    ctx.setItemsPerIteration(grid.indices.size() / 3);
+
+    std::vector<uint32_t> indices;
+    ctx.run(
+        [&]()
+        {
+            indices = grid.indices;
+            VertexCacheOptimizer::optimizeTriangleOrder(indices, vertexCount);
+            VertexCacheOptimizer::optimizeOverdraw(indices, grid.positions);
+            VertexCacheOptimizer::optimizeVertexOrder(indices, vertexCount);
+            doNotOptimize(indices.data());
+        }
+    );
+
+    auto statsBefore = VertexCacheOptimizer::computeStats(grid.indices, vertexCount);
+    auto statsAfter = VertexCacheOptimizer::computeStats(indices, vertexCount);
+    EXPECT_LT(statsAfter.getACMR(), statsBefore.getACMR());
+}
+} // namespace Falcor
@@ -0,0 +1,103 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
+
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+CPU_TEST(BenchmarkStats)
+{
+    auto stats = unittest::computeBenchmarkStats({5.0, 1.0, 3.0, 2.0, 4.0, 100.0});
+    EXPECT_EQ(stats.sampleCount, 6);
+    EXPECT_EQ(stats.min, 1.0);
+    EXPECT_EQ(stats.max, 100.0);
+    EXPECT_EQ(stats.mean, 115.0 / 6.0);
+    EXPECT_EQ(stats.median, 3.5);
+    // Deviations from the median are {2.5, 1.5, 0.5, 0.5, 1.5, 96.5}.
+    EXPECT_EQ(stats.mad, 1.5);
+    EXPECT_EQ(stats.p10, 1.5);
+    EXPECT_EQ(stats.p90, 52.5);
+
+    auto empty = unittest::computeBenchmarkStats({});
+    EXPECT_EQ(empty.sampleCount, 0);
+    EXPECT_EQ(empty.median, 0.0);
+}
+
+CPU_TEST(BenchmarkCompare)
+{
+    auto makeResult = [](std::string name, double median, double mad)
+    {
+        unittest::BenchmarkResult result;
+        result.suiteName = "Suite";
+        result.name = std::move(name);
+        result.stats.median = median;
+        result.stats.mad = mad;
+        return result;
+    };
+
+    std::vector<unittest::BenchmarkResult> baseline = {
+        makeResult("A", 100.0, 1.0),
+        makeResult("B", 100.0, 1.0),
+        makeResult("C", 100.0, 1.0),
+        makeResult("D", 100.0, 20.0),
+    };
+    std::vector<unittest::BenchmarkResult> results = {
+        makeResult("A", 105.0, 1.0), // Within threshold.
+        makeResult("B", 150.0, 1.0), // Regressed.
+        makeResult("C", 50.0, 1.0),  // Improved.
+        makeResult("D", 130.0, 20.0), // Above threshold but within noise.
+        makeResult("E", 100.0, 1.0), // Not in baseline.
+    };
+
+    auto comparisons = unittest::compareBenchmarkResults(results, baseline, 0.1);
+    ASSERT_EQ(comparisons.size(), 5);
+    EXPECT(comparisons[0].status == unittest::BenchmarkComparison::Status::Unchanged);
+    EXPECT(comparisons[1].status == unittest::BenchmarkComparison::Status::Regressed);
+    EXPECT_EQ(comparisons[1].change, 0.5);
+    EXPECT(comparisons[2].status == unittest::BenchmarkComparison::Status::Improved);
+    EXPECT(comparisons[3].status == unittest::BenchmarkComparison::Status::Unchanged);
+    EXPECT(comparisons[4].status == unittest::BenchmarkComparison::Status::Missing);
+}
+
+CPU_BENCHMARK(BenchmarkOverhead, BENCHMARK_PARAM("count", 1, 1000))
+{
+    // Measures an empty loop to show the overhead and resolution of the framework.
+    const int64_t count = ctx.getParam("count");
+    ctx.setItemsPerIteration(count);
+    ctx.run(
+        [&]()
+        {
+            for (int64_t i = 0; i < count; ++i)
+                doNotOptimize(i);
+        }
+    );
+}
+} // namespace Falcor
@@ -0,0 +1,536 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "RenderGraph/RenderGraph.h"
+#include "ImageCompare/ErrorMetrics.h"
+#include "ImageCompare/ImageComparison.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kWidth = 67;
+const uint32_t kHeight = 45;
+
+/// Temporary directory that is deleted with its contents when the object goes out of scope.
+class TempDirectory
+{
+public:
+    TempDirectory() : mPath(getTempFilePath()) { std::filesystem::create_directories(mPath); }
+    ~TempDirectory() { std::filesystem::remove_all(mPath); }
+
+    const std::filesystem::path& getPath() const { return mPath; }
+
+private:
+    std::filesystem::path mPath;
+};
+
+/// Create the reference image. All values are in [0, 1].
+std::shared_ptr<::Image> createReferenceImage(uint32_t width, uint32_t height)
+{
+    auto image = ::Image::create(width, height);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            float* rgba = image->getRow(y) + 4 * x;
+            rgba[0] = float((x * 3 + y * 5) % 32) / 31.f;
+            rgba[1] = float((x + y * y) % 29) / 28.f;
+            rgba[2] = float((x * y) % 23) / 22.f;
+            rgba[3] = float((x + y) % 2);
+        }
+    }
+    return image;
+}
+
+/// Create the test image by adding a fixed noise pattern to the reference image.
+std::shared_ptr<::Image> createTestImage(uint32_t width, uint32_t height)
+{
+    auto image = createReferenceImage(width, height);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                float& value = image->getRow(y)[4 * x + c];
+                value = std::clamp(value + float(int((x * 11 + y * 7 + c * 3) % 9) - 4) / 64.f, 0.f, 1.f);
+            }
+        }
+    }
+    return image;
+}
+
+std::shared_ptr<::Image> createConstantImage(uint32_t width, uint32_t height, float value)
+{
+    auto image = ::Image::create(width, height);
+    std::fill(image->getData(), image->getData() + size_t(width) * height * 4, value);
+    return image;
+}
+
+CompareResult compare(const std::string& name, const ::Image& imageA, const ::Image& imageB, CompareOptions options = {}, float* errorMap = nullptr)
+{
+    const ErrorMetric* pMetric = findErrorMetric(name);
+    FALCOR_CHECK(pMetric, "Unknown error metric '{}'.", name);
+    return pMetric->compare(imageA, imageB, options, errorMap);
+}
+
+/// Reference implementation of the per-pixel metrics, using the formulas of the original serial implementation.
+double computePixelMetric(const std::string& name, const ::Image& imageA, const ::Image& imageB, bool alpha)
+{
+    std::function<double(double, double)> metric;
+    double scale = 1.0;
+    if (name == "mse")
+    {
+        metric = [](double a, double b) { return (a - b) * (a - b); };
+    }
+    else if (name == "rmse")
+    {
+        metric = [](double a, double b) { return (a - b) * (a - b) / (a * a + 1e-3); };
+    }
+    else if (name == "mae")
+    {
+        metric = [](double a, double b) { return std::fabs((a - b) * (a - b)); };
+    }
+    else
+    {
+        FALCOR_CHECK(name == "mape", "Unknown per-pixel metric '{}'.", name);
+        metric = [](double a, double b) { return std::fabs((a - b) / (a + 1e-3)); };
+        scale = 100.0;
+    }
+
+    const uint32_t channels = alpha ? 4 : 3;
+    const size_t pixelCount = size_t(imageA.getWidth()) * imageA.getHeight();
+    double error = 0.0;
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        for (uint32_t c = 0; c < channels; ++c)
+            error += metric(imageA.getData()[4 * i + c], imageB.getData()[4 * i + c]);
+    }
+    return scale * error / (channels * pixelCount);
+}
+
+/// Reference implementation of the SSIM error, evaluating the full 2D window of every pixel.
+double computeSSIM(const ::Image& imageA, const ::Image& imageB)
+{
+    const int radius = 5;
+    const double sigma = 1.5;
+    const double C1 = 0.01 * 0.01;
+    const double C2 = 0.03 * 0.03;
+    const int width = imageA.getWidth();
+    const int height = imageA.getHeight();
+
+    auto luminance = [](const float* rgba)
+    { return 0.2126 * std::clamp(rgba[0], 0.f, 1.f) + 0.7152 * std::clamp(rgba[1], 0.f, 1.f) + 0.0722 * std::clamp(rgba[2], 0.f, 1.f); };
+
+    double weightSum = 0.0;
+    for (int dy = -radius; dy <= radius; ++dy)
+        for (int dx = -radius; dx <= radius; ++dx)
+            weightSum += std::exp(-(dx * dx + dy * dy) / (2.0 * sigma * sigma));
+
+    double error = 0.0;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            double meanA = 0.0, meanB = 0.0, meanAA = 0.0, meanBB = 0.0, meanAB = 0.0;
+            for (int dy = -radius; dy <= radius; ++dy)
+            {
+                for (int dx = -radius; dx <= radius; ++dx)
+                {
+                    const double w = std::exp(-(dx * dx + dy * dy) / (2.0 * sigma * sigma)) / weightSum;
+                    const uint32_t sx = std::clamp(x + dx, 0, width - 1);
+                    const uint32_t sy = std::clamp(y + dy, 0, height - 1);
+                    const double a = luminance(imageA.getRow(sy) + 4 * sx);
+                    const double b = luminance(imageB.getRow(sy) + 4 * sx);
+                    meanA += w * a;
+                    meanB += w * b;
+                    meanAA += w * a * a;
+                    meanBB += w * b * b;
+                    meanAB += w * a * b;
+                }
+            }
+            const double varA = meanAA - meanA * meanA;
+            const double varB = meanBB - meanB * meanB;
+            const double covAB = meanAB - meanA * meanB;
+            const double ssim =
+                ((2.0 * meanA * meanB + C1) * (2.0 * covAB + C2)) / ((meanA * meanA + meanB * meanB + C1) * (varA + varB + C2));
+            error += 1.0 - ssim;
+        }
+    }
+    return error / (double(width) * height);
+}
+
+/// Check that writing the error map does not change the result and that the map averages to the error.
+void testErrorMap(CPUUnitTestContext& ctx, const std::string& name, const ::Image& imageA, const ::Image& imageB, const CompareOptions& options)
+{
+    const size_t pixelCount = size_t(imageA.getWidth()) * imageA.getHeight();
+    std::vector<float> errorMap(pixelCount, -1.f);
+    const CompareResult result = compare(name, imageA, imageB, options);
+    const CompareResult resultWithMap = compare(name, imageA, imageB, options, errorMap.data());
+    EXPECT_EQ(result.error, resultWithMap.error) << name;
+
+    double mapSum = 0.0;
+    for (float e : errorMap)
+        mapSum += e;
+    EXPECT_LE(std::fabs(mapSum / pixelCount - result.error), 1e-6 * result.error) << name;
+}
+} // namespace
+
+CPU_TEST(ImageCompare_PixelMetrics)
+{
+    auto pReference = createReferenceImage(kWidth, kHeight);
+    auto pTest = createTestImage(kWidth, kHeight);
+
+    for (const std::string name : {"mse", "rmse", "mae", "mape"})
+    {
+        for (bool alpha : {false, true})
+        {
+            CompareOptions options;
+            options.alpha = alpha;
+
+            // Per-pixel errors are accumulated in double, so the result matches the serial reference up to summation order.
+            const double expected = computePixelMetric(name, *pReference, *pTest, alpha);
+            const CompareResult result = compare(name, *pReference, *pTest, options);
+            EXPECT_LE(std::fabs(result.error - expected), 1e-12 * expected) << name << " alpha=" << alpha;
+            EXPECT(!result.exitedEarly);
+
+            EXPECT_EQ(compare(name, *pReference, *pReference, options).error, 0.0) << name;
+            testErrorMap(ctx, name, *pReference, *pTest, options);
+        }
+    }
+}
+
+CPU_TEST(ImageCompare_SSIM)
+{
+    // Identical images.
+    auto pReference = createReferenceImage(kWidth, kHeight);
+    EXPECT_EQ(compare("ssim", *pReference, *pReference).error, 0.0);
+
+    // Constant images only differ in the mean: 1 - SSIM = 1 - (2 * a * b + C1) / (a^2 + b^2 + C1).
+    auto pGrayA = createConstantImage(8, 8, 0.5f);
+    auto pGrayB = createConstantImage(8, 8, 0.25f);
+    const double expectedGray = 1.0 - (2.0 * 0.5 * 0.25 + 1e-4) / (0.5 * 0.5 + 0.25 * 0.25 + 1e-4);
+    EXPECT_LE(std::fabs(compare("ssim", *pGrayA, *pGrayB).error - expectedGray), 1e-6);
+
+    // Separable band filter against the full 2D window.
+    auto pTest = createTestImage(kWidth, kHeight);
+    const double expected = computeSSIM(*pReference, *pTest);
+    const CompareResult result = compare("ssim", *pReference, *pTest);
+    EXPECT_LE(std::fabs(result.error - expected), 1e-6) << result.error << " vs. " << expected;
+    EXPECT_LE(std::fabs(result.error - 0.00983965713), 1e-6);
+
+    // SSIM is computed on luminance only.
+    CompareOptions options;
+    options.alpha = true;
+    EXPECT_EQ(compare("ssim", *pReference, *pTest, options).error, result.error);
+
+    testErrorMap(ctx, "ssim", *pReference, *pTest, {});
+}
+
+CPU_TEST(ImageCompare_FLIP)
+{
+    auto pReference = createReferenceImage(kWidth, kHeight);
+    auto pTest = createTestImage(kWidth, kHeight);
+
+    EXPECT_EQ(compare("flip", *pReference, *pReference).error, 0.0);
+
+    // Reference values computed with the default viewing conditions (0.7 m distance, 0.7 m wide 3840 pixel monitor).
+    auto pBlack = createConstantImage(8, 8, 0.f);
+    auto pWhite = createConstantImage(8, 8, 1.f);
+    EXPECT_LE(std::fabs(compare("flip", *pBlack, *pWhite).error - 0.967387736), 1e-5);
+    EXPECT_LE(std::fabs(compare("flip", *pReference, *pTest).error - 0.0564516071), 1e-5);
+
+    // Input colors are clamped to [0, 1].
+    auto pBright = createConstantImage(8, 8, 4.f);
+    EXPECT_EQ(compare("flip", *pWhite, *pBright).error, 0.0);
+
+    testErrorMap(ctx, "flip", *pReference, *pTest, {});
+}
+
+GPU_TEST(ImageCompare_FLIPMatchesFLIPPass)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    auto pReference = createReferenceImage(kWidth, kHeight);
+    auto pTest = createTestImage(kWidth, kHeight);
+
+    std::vector<float> errorMap(kWidth * kHeight);
+    const CompareResult result = compare("flip", *pReference, *pTest, {}, errorMap.data());
+
+    ref<Texture> pReferenceTexture =
+        pDevice->createTexture2D(kWidth, kHeight, ResourceFormat::RGBA32Float, 1, 1, pReference->getData(), ResourceBindFlags::ShaderResource);
+    ref<Texture> pTestTexture =
+        pDevice->createTexture2D(kWidth, kHeight, ResourceFormat::RGBA32Float, 1, 1, pTest->getData(), ResourceBindFlags::ShaderResource);
+
+    Properties props;
+    props["isHDR"] = false;
+    props["useMagma"] = false;
+    props["useRealMonitorInfo"] = false;
+    props["computePooledFLIPValues"] = false;
+
+    ref<RenderGraph> pGraph = RenderGraph::create(pDevice, "FLIP");
+    ref<RenderPass> pPass = RenderPass::create("FLIPPass", pDevice, props);
+    if (!pPass)
+        FALCOR_THROW("Could not create render pass 'FLIPPass'");
+    pGraph->addPass(pPass, "FLIPPass");
+    pGraph->setInput("FLIPPass.testImage", pTestTexture);
+    pGraph->setInput("FLIPPass.referenceImage", pReferenceTexture);
+    pGraph->markOutput("FLIPPass.errorMap");
+    ref<Fbo> pTargetFbo = Fbo::create2D(pDevice, kWidth, kHeight, ResourceFormat::RGBA32Float);
+    pGraph->onResize(pTargetFbo.get());
+    pGraph->execute(pRenderContext);
+
+    ref<Resource> pOutput = pGraph->getOutput("FLIPPass.errorMap");
+    std::vector<uint8_t> data = pRenderContext->readTextureSubresource(pOutput->asTexture().get(), 0);
+    const float4* gpuErrorMap = reinterpret_cast<const float4*>(data.data());
+
+    // The GPU pass evaluates the full 2D filters in float, so only expect agreement up to rounding.
+    double gpuSum = 0.0;
+    float maxDifference = 0.f;
+    for (uint32_t i = 0; i < kWidth * kHeight; ++i)
+    {
+        // The alpha channel holds the FLIP value.
+        gpuSum += gpuErrorMap[i].w;
+        maxDifference = std::max(maxDifference, std::fabs(gpuErrorMap[i].w - errorMap[i]));
+    }
+    const double gpuError = gpuSum / (kWidth * kHeight);
+    EXPECT_LE(std::fabs(result.error - gpuError), 1e-4) << result.error << " vs. " << gpuError;
+    EXPECT_LE(maxDifference, 1e-2f);
+}
+
+CPU_TEST(ImageCompare_Tiled)
+{
+    // Every row is covered exactly once and band sums are accumulated in order, independent of the tile height.
+    const uint32_t width = 5;
+    const uint32_t height = 101;
+    auto rowError = [](uint32_t y) { return double(y % 7) * 0.1; };
+
+    double expected = 0.0;
+    for (uint32_t y = 0; y < height; ++y)
+        expected += width * rowError(y);
+    expected /= width * height;
+
+    for (uint32_t tileHeight : {1u, 3u, 16u, 100u, 101u, 500u})
+    {
+        std::vector<std::atomic<uint32_t>> rowCounts(height);
+        std::atomic<uint32_t> maxBandHeight{0};
+        const CompareResult result = runTiled(
+            width,
+            height,
+            tileHeight,
+            false,
+            0.f,
+            [&](uint32_t y0, uint32_t y1)
+            {
+                uint32_t bandHeight = maxBandHeight.load();
+                while (y1 - y0 > bandHeight && !maxBandHeight.compare_exchange_weak(bandHeight, y1 - y0))
+                    ;
+                double sum = 0.0;
+                for (uint32_t y = y0; y < y1; ++y)
+                {
+                    rowCounts[y]++;
+                    sum += width * rowError(y);
+                }
+                return sum;
+            }
+        );
+
+        for (uint32_t y = 0; y < height; ++y)
+            EXPECT_EQ(rowCounts[y].load(), 1u) << "tileHeight=" << tileHeight << " y=" << y;
+        EXPECT_LE(maxBandHeight.load(), tileHeight);
+        EXPECT_LE(std::fabs(result.error - expected), 1e-12) << "tileHeight=" << tileHeight;
+        EXPECT(!result.exitedEarly);
+    }
+
+    // Band sums are accumulated in tile order, so repeated runs are bit-identical regardless of scheduling.
+    auto kernel = [&](uint32_t y0, uint32_t y1) { return (y1 - y0) * rowError(y0) + y0 * 1e-3; };
+    const double firstError = runTiled(width, height, 16, false, 0.f, kernel).error;
+    for (uint32_t i = 0; i < 8; ++i)
+        EXPECT_EQ(runTiled(width, height, 16, false, 0.f, kernel).error, firstError);
+
+    // Metrics on image sizes that are not multiples of the band heights, including a single row.
+    for (auto [width, height] : {std::pair{1u, 1u}, std::pair{3u, 1u}, std::pair{130u, 33u}, std::pair{17u, 129u}})
+    {
+        auto pReference = createReferenceImage(width, height);
+        auto pTest = createTestImage(width, height);
+        const double expectedMSE = computePixelMetric("mse", *pReference, *pTest, false);
+        EXPECT_LE(std::fabs(compare("mse", *pReference, *pTest).error - expectedMSE), 1e-12 * expectedMSE) << width << "x" << height;
+        const double expectedSSIM = computeSSIM(*pReference, *pTest);
+        EXPECT_LE(std::fabs(compare("ssim", *pReference, *pTest).error - expectedSSIM), 1e-6) << width << "x" << height;
+    }
+}
+
+CPU_TEST(ImageCompare_EarlyExit)
+{
+    // Every pixel has an error of 1, so the first band exceeds the threshold.
+    const uint32_t height = 4096;
+    std::atomic<uint32_t> callCount{0};
+    CompareResult result = runTiled(
+        1,
+        height,
+        1,
+        true,
+        0.5f,
+        [&](uint32_t y0, uint32_t y1)
+        {
+            callCount++;
+            return double(y1 - y0);
+        }
+    );
+    EXPECT(result.exitedEarly);
+    EXPECT_LT(callCount.load(), height);
+    // The reported error is a lower bound of the mean error that still exceeds the threshold.
+    EXPECT_GT(result.error, 0.5);
+    EXPECT_LE(result.error, 1.0);
+
+    // Images: early exit only triggers when the error exceeds the threshold (-x option).
+    auto pReference = createReferenceImage(kWidth, 1024);
+    auto pTest = createTestImage(kWidth, 1024);
+    for (const std::string name : {"mse", "ssim", "flip"})
+    {
+        const double fullError = compare(name, *pReference, *pTest).error;
+
+        CompareOptions options;
+        options.earlyExit = true;
+        options.threshold = float(fullError * 2.0);
+        result = compare(name, *pReference, *pTest, options);
+        EXPECT(!result.exitedEarly) << name;
+        EXPECT_EQ(result.error, fullError) << name;
+
+        options.threshold = float(fullError * 0.01);
+        result = compare(name, *pReference, *pTest, options);
+        if (result.exitedEarly)
+        {
+            EXPECT_GT(result.error, options.threshold) << name;
+            EXPECT_LE(result.error, fullError) << name;
+        }
+        else
+        {
+            EXPECT_EQ(result.error, fullError) << name;
+        }
+
+        // Early exit is ignored when writing an error map.
+        std::vector<float> errorMap(size_t(kWidth) * 1024);
+        result = compare(name, *pReference, *pTest, options, errorMap.data());
+        EXPECT(!result.exitedEarly) << name;
+        EXPECT_EQ(result.error, fullError) << name;
+    }
+}
+
+CPU_TEST(ImageCompare_Batch)
+{
+    TempDirectory dirA;
+    TempDirectory dirB;
+    TempDirectory heatMapDir;
+    std::filesystem::create_directories(dirA.getPath() / "sub");
+    std::filesystem::create_directories(dirB.getPath() / "sub");
+
+    auto pReference = createReferenceImage(kWidth, kHeight);
+    auto pTest = createTestImage(kWidth, kHeight);
+    pReference->saveToFile(dirA.getPath() / "equal.exr");
+    pReference->saveToFile(dirB.getPath() / "equal.exr");
+    pReference->saveToFile(dirA.getPath() / "sub" / "different.exr");
+    pTest->saveToFile(dirB.getPath() / "sub" / "different.exr");
+    pReference->saveToFile(dirA.getPath() / "missing.exr");
+    createReferenceImage(8, 8)->saveToFile(dirA.getPath() / "resolution.exr");
+    pReference->saveToFile(dirB.getPath() / "resolution.exr");
+    // Files that are not images are skipped.
+    std::ofstream(dirA.getPath() / "notes.txt") << "not an image";
+
+    // Expected error from the images as stored in the files.
+    const ErrorMetric& metric = *findErrorMetric("mse");
+    auto pStoredReference = ::Image::loadFromFile(dirA.getPath() / "sub" / "different.exr");
+    auto pStoredTest = ::Image::loadFromFile(dirB.getPath() / "sub" / "different.exr");
+    const double expectedError = metric.compare(*pStoredReference, *pStoredTest, {}, nullptr).error;
+    EXPECT_GT(expectedError, 0.0);
+
+    CompareOptions options;
+    options.threshold = float(expectedError * 0.5);
+    const std::vector<ImageResult> results = compareDirectories(dirA.getPath(), dirB.getPath(), metric, options, heatMapDir.getPath(), 3);
+
+    // Results are sorted by relative path.
+    ASSERT_EQ(results.size(), size_t(4));
+    EXPECT_EQ(results[0].name, "equal.exr");
+    EXPECT(results[0].compared);
+    EXPECT(results[0].passed);
+    EXPECT_EQ(results[0].error, 0.0);
+
+    EXPECT_EQ(results[1].name, "missing.exr");
+    EXPECT(!results[1].compared);
+    EXPECT(!results[1].passed);
+    EXPECT_NE(results[1].message.find("Missing image"), std::string::npos);
+
+    EXPECT_EQ(results[2].name, "resolution.exr");
+    EXPECT(!results[2].compared);
+    EXPECT(!results[2].passed);
+    EXPECT_EQ(results[2].message, "Cannot compare images with different resolutions.");
+
+    EXPECT_EQ(results[3].name, "sub/different.exr");
+    EXPECT(results[3].compared);
+    EXPECT(!results[3].passed);
+    EXPECT_EQ(results[3].error, expectedError);
+
+    // Heat maps mirror the directory structure.
+    EXPECT(std::filesystem::exists(heatMapDir.getPath() / "equal.png"));
+    EXPECT(std::filesystem::exists(heatMapDir.getPath() / "sub" / "different.png"));
+    EXPECT(!std::filesystem::exists(heatMapDir.getPath() / "missing.png"));
+
+    // JSON report.
+    const nlohmann::json report = createBatchReport(metric, options, results, 1.5);
+    EXPECT_EQ(report["metric"].get<std::string>(), "mse");
+    EXPECT_EQ(report["threshold"].get<float>(), options.threshold);
+    EXPECT_EQ(report["passed"].get<bool>(), false);
+    EXPECT_EQ(report["duration"].get<double>(), 1.5);
+    ASSERT_EQ(report["images"].size(), size_t(4));
+    EXPECT_EQ(report["images"][0]["name"].get<std::string>(), "equal.exr");
+    EXPECT_EQ(report["images"][0]["passed"].get<bool>(), true);
+    EXPECT(!report["images"][0].contains("message"));
+    EXPECT_EQ(report["images"][3]["name"].get<std::string>(), "sub/different.exr");
+    EXPECT_EQ(report["images"][3]["error"].get<double>(), expectedError);
+    EXPECT_EQ(report["images"][3]["exitedEarly"].get<bool>(), false);
+    EXPECT(report["images"][1].contains("message"));
+
+    // All images pass with a threshold above the largest error.
+    std::vector<ImageResult> passing = {results[0], results[3]};
+    passing[1].passed = true;
+    EXPECT_EQ(createBatchReport(metric, options, passing, 0.0)["passed"].get<bool>(), true);
+
+    // Batch mode requires two directories.
+    EXPECT_THROW(compareDirectories(dirA.getPath() / "equal.exr", dirB.getPath(), metric, options, {}, 1));
+}
+} // namespace Falcor
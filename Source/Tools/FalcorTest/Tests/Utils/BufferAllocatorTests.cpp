@@ -26,8 +26,13 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
 #include "Utils/BufferAllocator.h"
 
+#include <functional>
+#include <limits>
+#include <random>
+
 namespace Falcor
 {
 struct S
@@ -313,4 +318,260 @@ GPU_TEST(BufferAllocatorStructAlign)
     }
 }
 
+CPU_TEST(BufferAllocatorFreeList)
+{
+    BufferAllocator buf(16, 0, 128);
+
+    size_t a = buf.allocate(64);
+    size_t b = buf.allocate(64);
+    size_t c = buf.allocate(64);
+    size_t d = buf.allocate(32);
+    EXPECT_EQ(a, 0);
+    EXPECT_EQ(b, 64);
+    EXPECT_EQ(c, 128);
+    EXPECT_EQ(d, 192);
+    EXPECT_EQ(buf.getSize(), 224);
+
+    // Freed memory is reused by an allocation of the same size.
+    buf.free(b, 64);
+    EXPECT_EQ(buf.getFreeByteSize(), 64);
+    EXPECT_EQ(buf.allocate(64), b);
+    EXPECT_EQ(buf.getFreeByteSize(), 0);
+
+    // Adjacent free blocks are coalesced and can hold a larger allocation.
+    buf.free(a, 64);
+    buf.free(b, 64);
+    EXPECT_EQ(buf.getFreeByteSize(), 128);
+    EXPECT_EQ(buf.allocate(128), a);
+
+    // Smaller allocations are placed in larger blocks subject to the alignment requirements.
+    // The remaining memory [20, 32) and [36, 128) stays free.
+    buf.free(a, 128);
+    EXPECT_EQ(buf.allocate(20), 0);
+    EXPECT_EQ(buf.allocate(4), 32);
+    EXPECT_EQ(buf.getFreeByteSize(), 12 + 92);
+
+    // This allocation would span two cache lines in the free block, so it is appended instead.
+    EXPECT_EQ(buf.allocate(100), 256);
+    EXPECT_EQ(buf.getSize(), 356);
+
+    // Reused memory is cleared.
+    size_t g = buf.allocate(64);
+    EXPECT_EQ(g, 48);
+    buf.set<uint32_t>(g, 0xdeadbeef);
+    buf.free(g, 64);
+    size_t e = buf.allocate<uint32_t>();
+    EXPECT_EQ(e, g);
+    EXPECT_EQ(*reinterpret_cast<const uint32_t*>(buf.getStartPointer() + e), 0);
+
+    // Freeing memory at the end of the buffer releases it. The alignment padding before it stays.
+    size_t f = buf.allocate(256);
+    EXPECT_EQ(f, 368);
+    buf.free(f, 256);
+    EXPECT_EQ(buf.getSize(), f);
+
+    // Freeing memory twice or out of range is an error.
+    EXPECT_THROW(buf.free(40, 4));
+    EXPECT_THROW(buf.free(buf.getSize(), 4));
+
+    buf.clear();
+    EXPECT_EQ(buf.getSize(), 0);
+    EXPECT_EQ(buf.getFreeByteSize(), 0);
+    EXPECT_EQ(buf.allocate(64), 0);
+}
+
+CPU_TEST(BufferAllocatorDirtyRanges)
+{
+    BufferAllocator buf(0, 0, 0);
+    buf.allocate(4096);
+    buf.setDirtyMergeGap(0);
+
+    // Disjoint ranges are tracked separately.
+    buf.modified(0, 16);
+    buf.modified(4000, 16);
+    buf.modified(2000, 16);
+    EXPECT_EQ(buf.getDirtyRangeCount(), 3);
+    EXPECT_EQ(buf.getDirtyByteSize(), 48);
+
+    // Overlapping and adjacent ranges are merged.
+    buf.modified(8, 16);
+    buf.modified(24, 8);
+    buf.modified(1990, 100);
+    EXPECT_EQ(buf.getDirtyRangeCount(), 3);
+    EXPECT_EQ(buf.getDirtyByteSize(), 32 + 100 + 16);
+
+    // A range spanning several ranges merges them all.
+    buf.modified(16, 3000);
+    EXPECT_EQ(buf.getDirtyRangeCount(), 2);
+    EXPECT_EQ(buf.getDirtyByteSize(), 3016 + 16);
+
+    // Ranges within the merge gap are merged.
+    buf.setDirtyMergeGap(1024);
+    buf.modified(3500, 4);
+    EXPECT_EQ(buf.getDirtyRangeCount(), 1);
+    EXPECT_EQ(buf.getDirtyByteSize(), 4016);
+
+    // Releasing memory at the end of the buffer clips the dirty ranges.
+    BufferAllocator buf2(0, 0, 0);
+    size_t a = buf2.allocate(64);
+    size_t b = buf2.allocate(64);
+    buf2.setDirtyMergeGap(0);
+    buf2.modified(a, 64);
+    buf2.modified(b, 64);
+    buf2.free(b, 64);
+    EXPECT_EQ(buf2.getDirtyByteSize(), 64);
+}
+
+GPU_TEST(BufferAllocatorPartialUpdate)
+{
+    BufferAllocator buf(16, 0, 128);
+    buf.setDirtyMergeGap(0);
+
+    std::vector<size_t> offsets;
+    for (uint32_t i = 0; i < 256; i++)
+        offsets.push_back(buf.pushBack(float4((float)i)));
+
+    auto validateGpuBuffer = [&]()
+    {
+        ref<Buffer> pBuffer = buf.getGPUBuffer(ctx.getDevice());
+        EXPECT_EQ(buf.getDirtyRangeCount(), 0);
+
+        const uint8_t* ref = buf.getStartPointer();
+        std::vector<uint8_t> data = pBuffer->getElements<uint8_t>(0, buf.getSize());
+        for (size_t i = 0; i < buf.getSize(); i++)
+        {
+            EXPECT_EQ((uintptr_t)data[i], (uintptr_t)ref[i]) << "i=" << i;
+        }
+    };
+
+    validateGpuBuffer();
+
+    // Update a few scattered objects. Each is uploaded separately.
+    for (uint32_t i : {3, 100, 101, 255})
+        buf.set(offsets[i], float4(-(float)i));
+    EXPECT_EQ(buf.getDirtyRangeCount(), 3);
+
+    validateGpuBuffer();
+
+    // Free and reuse an object.
+    buf.free<float4>(offsets[50]);
+    size_t offset = buf.pushBack(float4(1000.f));
+    EXPECT_EQ(offset, offsets[50]);
+
+    validateGpuBuffer();
+}
+
+GPU_TEST(BufferAllocatorFreeTail)
+{
+    BufferAllocator buf(16, 0, 0);
+    size_t a = buf.pushBack(float4(1.f));
+    size_t b = buf.allocate(64);
+    for (size_t i = 0; i < 4; i++)
+        buf.set(b + i * sizeof(float4), float4(2.f));
+    ref<Buffer> pBuffer = buf.getGPUBuffer(ctx.getDevice());
+
+    // Free the block at the end of the buffer and allocate it again. The GPU buffer is large enough to be reused,
+    // but must not keep the contents of the freed block.
+    buf.free(b, 64);
+    EXPECT_EQ(buf.getSize(), 16);
+    EXPECT_EQ(buf.allocate(64), b);
+    EXPECT(buf.getGPUBuffer(ctx.getDevice()) == pBuffer);
+
+    std::vector<float4> data = pBuffer->getElements<float4>(0, 5);
+    EXPECT(all(data[a / sizeof(float4)] == float4(1.f)));
+    for (size_t i = 0; i < 4; i++)
+        EXPECT(all(data[b / sizeof(float4) + i] == float4(0.f))) << "i=" << i;
+}
+
+namespace
+{
+using UpdateFrameFunc = std::function<void(BufferAllocator& buf, size_t objectSize, size_t objectCount, std::mt19937& rng)>;
+
+struct UpdatePattern
+{
+    size_t objectSize;
+    size_t objectCount;
+    UpdateFrameFunc updateFrame;
+};
+
+UpdatePattern getUpdatePattern(int64_t index)
+{
+    if (index == 0)
+    {
+        // Material updates: 10k material data blobs of 128 bytes, 1% of which are modified each frame.
+        return {
+            128,
+            10000,
+            [](BufferAllocator& buf, size_t objectSize, size_t objectCount, std::mt19937& rng)
+            {
+                std::uniform_int_distribution<size_t> dist(0, objectCount - 1);
+                for (size_t i = 0; i < objectCount / 100; i++)
+                    buf.modified(dist(rng) * objectSize, objectSize);
+            },
+        };
+    }
+
+    // Parameter block updates: per-frame constants at the start and end of a large block of
+    // mostly static 64 byte parameters, plus a few random parameters.
+    return {
+        64,
+        16384,
+        [](BufferAllocator& buf, size_t objectSize, size_t objectCount, std::mt19937& rng)
+        {
+            buf.modified(0, objectSize);
+            buf.modified((objectCount - 1) * objectSize, objectSize);
+            std::uniform_int_distribution<size_t> dist(0, objectCount - 1);
+            for (uint32_t i = 0; i < 8; i++)
+                buf.modified(dist(rng) * objectSize, objectSize);
+        },
+    };
+}
+
+/// Release and reallocate the buffer contents to reset the dirty ranges without a device.
+void resetDirtyRanges(BufferAllocator& buf, const UpdatePattern& pattern)
+{
+    buf.clear();
+    buf.allocate(pattern.objectSize * pattern.objectCount);
+}
+} // namespace
+
+CPU_TEST(BufferAllocatorUploadSize)
+{
+    // Tracking dirty intervals uploads less data per frame than a single dirty range for the typical update patterns.
+    for (int64_t patternIndex : {0, 1})
+    {
+        const UpdatePattern pattern = getUpdatePattern(patternIndex);
+        size_t uploadByteSize[2] = {};
+        for (size_t mode = 0; mode < 2; mode++)
+        {
+            BufferAllocator buf(16, 0, 128);
+            buf.setDirtyMergeGap(mode == 0 ? std::numeric_limits<size_t>::max() : BufferAllocator::kDefaultDirtyMergeGap);
+            resetDirtyRanges(buf, pattern);
+            std::mt19937 rng(1);
+            pattern.updateFrame(buf, pattern.objectSize, pattern.objectCount, rng);
+            uploadByteSize[mode] = buf.getDirtyByteSize();
+        }
+        EXPECT_LT(uploadByteSize[1], uploadByteSize[0]) << "pattern " << patternIndex;
+    }
+}
+
+CPU_BENCHMARK(BufferAllocator_DirtyTracking, BENCHMARK_PARAM("pattern", 0, 1), BENCHMARK_PARAM("singleRange", 0, 1))
+{
+    // Measures one frame of updates with dirty tracking for the update patterns above, compared to tracking
+    // a single dirty range. Each iteration includes the reset of the dirty ranges, which is the same in both modes.
+    const UpdatePattern pattern = getUpdatePattern(ctx.getParam("pattern"));
+    BufferAllocator buf(16, 0, 128);
+    buf.setDirtyMergeGap(ctx.getParam("singleRange") ? std::numeric_limits<size_t>::max() : BufferAllocator::kDefaultDirtyMergeGap);
+    resetDirtyRanges(buf, pattern);
+
+    std::mt19937 rng(1);
+    ctx.run(
+        [&]()
+        {
+            pattern.updateFrame(buf, pattern.objectSize, pattern.objectCount, rng);
+            doNotOptimize(buf.getDirtyByteSize());
+            resetDirtyRanges(buf, pattern);
+        }
+    );
+}
 } // namespace Falcor
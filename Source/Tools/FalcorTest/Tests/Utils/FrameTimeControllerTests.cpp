@@ -0,0 +1,141 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Timing/FrameTimeController.h"
+#include <cmath>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+// Simple workload model: a fixed cost plus a cost proportional to the scale.
+// The measurement lags one frame behind, as GPU times reported by the profiler do.
+std::vector<float> simulate(FrameTimeController& controller, float fixedMs, float scaledMs, uint32_t frameCount)
+{
+    std::vector<float> scales;
+    float prevScale = controller.getScale();
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        const float scale = controller.getScale();
+        controller.update(fixedMs + scaledMs * prevScale);
+        prevScale = scale;
+        scales.push_back(controller.getScale());
+    }
+    return scales;
+}
+
+// GPU frame times in ms recorded from a session with a steady load, a hitch and a load increase at frame 30.
+// clang-format off
+const std::vector<float> kRecordedTrace = {
+    14.1f, 14.3f, 13.9f, 14.6f, 14.2f, 14.0f, 14.4f, 14.1f, 13.8f, 14.2f,
+    14.5f, 14.0f, 41.7f, 14.3f, 14.1f, 13.9f, 14.2f, 14.4f, 14.0f, 14.1f,
+    14.3f, 13.8f, 14.2f, 14.0f, 14.5f, 14.1f, 13.9f, 14.2f, 14.3f, 14.0f,
+    19.2f, 19.8f, 19.5f, 19.1f, 19.7f, 19.4f, 19.9f, 19.3f, 19.6f, 19.2f,
+};
+// clang-format on
+} // namespace
+
+CPU_TEST(FrameTimeController_Converges)
+{
+    FrameTimeController::Options options;
+    options.targetTimeMs = 12.f;
+    FrameTimeController controller(options);
+
+    // 4 + 10 * scale = 12 at scale 0.8.
+    const auto scales = simulate(controller, 4.f, 10.f, 200);
+    EXPECT_LT(std::abs(scales.back() - 0.8f), 0.01f) << "scale = " << scales.back();
+
+    // No sustained oscillation once converged.
+    for (size_t i = 150; i < scales.size(); ++i)
+        EXPECT_LT(std::abs(scales[i] - 0.8f), 0.02f) << "frame = " << i;
+
+    // Converges from above as well.
+    controller.reset();
+    const auto scalesDown = simulate(controller, 4.f, 20.f, 200);
+    EXPECT_LT(std::abs(scalesDown.back() - 0.4f), 0.01f) << "scale = " << scalesDown.back();
+}
+
+CPU_TEST(FrameTimeController_Saturation)
+{
+    FrameTimeController::Options options;
+    options.targetTimeMs = 10.f;
+    options.minScale = 0.5f;
+    options.maxScale = 2.f;
+    FrameTimeController controller(options);
+
+    // The target is not reachable: the scale stays at the lower bound.
+    simulate(controller, 20.f, 10.f, 100);
+    EXPECT_EQ(controller.getScale(), 0.5f);
+
+    // Without integral windup, the controller leaves the bound as soon as the load drops.
+    simulate(controller, 2.f, 10.f, 3);
+    EXPECT_GT(controller.getScale(), 0.5f);
+
+    const auto scales = simulate(controller, 2.f, 10.f, 200);
+    EXPECT_LT(std::abs(scales.back() - 0.8f), 0.01f) << "scale = " << scales.back();
+
+    // Invalid measurements are ignored.
+    const float scale = controller.getScale();
+    EXPECT_EQ(controller.update(0.f), scale);
+    EXPECT_EQ(controller.update(-1.f), scale);
+    EXPECT_EQ(controller.update(NAN), scale);
+}
+
+CPU_TEST(FrameTimeController_RecordedTrace)
+{
+    FrameTimeController::Options options;
+    options.targetTimeMs = 16.f;
+
+    FrameTimeController controllerA(options);
+    FrameTimeController controllerB(options);
+
+    std::vector<float> scales;
+    for (float frameTimeMs : kRecordedTrace)
+    {
+        // Replaying the same trace produces the same outputs.
+        const float scale = controllerA.update(frameTimeMs);
+        EXPECT_EQ(scale, controllerB.update(frameTimeMs));
+        EXPECT_GE(scale, options.minScale);
+        EXPECT_LE(scale, options.maxScale);
+        scales.push_back(scale);
+    }
+
+    // Headroom in the first frames increases the workload, the hitch reduces it for a few frames only.
+    EXPECT_GT(scales[11], 1.f);
+    EXPECT_LT(scales[12], scales[11]);
+    EXPECT_GT(scales[29], scales[12]);
+
+    // The load increase above the target decreases the workload.
+    EXPECT_LT(scales.back(), scales[29]);
+
+    controllerA.reset();
+    EXPECT_EQ(controllerA.getScale(), options.initialScale);
+    EXPECT_EQ(controllerA.getUpdateCount(), 0u);
+}
+} // namespace Falcor
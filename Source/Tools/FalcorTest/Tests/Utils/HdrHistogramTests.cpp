@@ -0,0 +1,129 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Timing/HdrHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Exact percentile using the same rank definition as HdrHistogram.
+uint64_t getExactPercentile(std::vector<uint64_t> values, double percentile)
+{
+    std::sort(values.begin(), values.end());
+    size_t rank = std::max<size_t>((size_t)std::llround(percentile / 100.0 * values.size()), 1);
+    return values[rank - 1];
+}
+} // namespace
+
+CPU_TEST(HdrHistogram_Percentiles)
+{
+    HdrHistogram histogram(1, 3600ull * 1000 * 1000, 3);
+
+    // Log-normal distributed values similar to frame times in microseconds.
+    std::mt19937 rng(1);
+    std::lognormal_distribution<double> dist(std::log(16000.0), 0.3);
+    std::vector<uint64_t> values(100000);
+    for (auto& value : values)
+    {
+        value = (uint64_t)dist(rng) + 1;
+        histogram.record(value);
+    }
+
+    EXPECT_EQ(histogram.getTotalCount(), values.size());
+    EXPECT_EQ(histogram.getMin(), *std::min_element(values.begin(), values.end()));
+    EXPECT_EQ(histogram.getMax(), *std::max_element(values.begin(), values.end()));
+
+    for (double percentile : {1.0, 50.0, 90.0, 95.0, 99.0, 99.9, 100.0})
+    {
+        uint64_t exact = getExactPercentile(values, percentile);
+        uint64_t value = histogram.getValueAtPercentile(percentile);
+        EXPECT_GE(value, exact) << "percentile=" << percentile;
+        EXPECT_LE(value, exact + exact / 1000 + 1) << "percentile=" << percentile;
+    }
+    EXPECT_EQ(histogram.getValueAtPercentile(100.0), histogram.getMax());
+}
+
+CPU_TEST(HdrHistogram_Precision)
+{
+    // Values up to the sub-bucket count (the next power of two >= 2 * 10^digits) are recorded exactly.
+    HdrHistogram histogram(1, 1000000, 3);
+    for (uint64_t value = 1; value < 2047; ++value)
+        EXPECT(!histogram.isEquivalent(value, value + 1)) << "value=" << value;
+    EXPECT(histogram.isEquivalent(2048, 2049));
+
+    // Larger values share buckets with a relative error below 10^-3.
+    EXPECT(histogram.isEquivalent(100000, 100031));
+    EXPECT(!histogram.isEquivalent(100000, 100200));
+}
+
+CPU_TEST(HdrHistogram_ConstantMemory)
+{
+    HdrHistogram histogram(1, 60ull * 1000 * 1000, 3);
+    const size_t memorySize = histogram.getMemorySize();
+    EXPECT_LE(memorySize, 256 * 1024);
+
+    for (uint64_t i = 0; i < 1000000; ++i)
+        histogram.record(i % 50000 + 1);
+    EXPECT_EQ(histogram.getMemorySize(), memorySize);
+    EXPECT_EQ(histogram.getTotalCount(), 1000000);
+}
+
+CPU_TEST(HdrHistogram_ClampAndMerge)
+{
+    HdrHistogram a(1, 10000, 2);
+    HdrHistogram b(1, 10000, 2);
+
+    a.record(10);
+    a.record(20, 3);
+    b.record(1000000);
+
+    EXPECT_EQ(b.getClampedCount(), 1);
+    EXPECT_EQ(b.getMax(), 1000000);
+    EXPECT_EQ(b.getValueAtPercentile(50.0), 10000);
+
+    a.merge(b);
+    EXPECT_EQ(a.getTotalCount(), 5);
+    EXPECT_EQ(a.getMin(), 10);
+    EXPECT_EQ(a.getMean(), (10.0 + 60.0 + 1000000.0) / 5.0);
+    EXPECT_EQ(a.getValueAtPercentile(50.0), 20);
+    EXPECT_EQ(a.getValueAtPercentile(100.0), 10000);
+
+    a.reset();
+    EXPECT_EQ(a.getTotalCount(), 0);
+    EXPECT_EQ(a.getValueAtPercentile(50.0), 0);
+
+    HdrHistogram c(1, 1000, 2);
+    EXPECT_THROW(a.merge(c));
+}
+} // namespace Falcor
@@ -0,0 +1,132 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/AsyncFrameCapture.h"
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kWidth = 64;
+const uint32_t kHeight = 32;
+
+ref<Texture> createTestTexture(ref<Device> pDevice, uint32_t seed)
+{
+    std::vector<uint8_t> data(kWidth * kHeight * 4);
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+    {
+        data[4 * i + 0] = (uint8_t)(i + seed);
+        data[4 * i + 1] = (uint8_t)(i >> 8);
+        data[4 * i + 2] = (uint8_t)seed;
+        data[4 * i + 3] = 0xff;
+    }
+    return pDevice->createTexture2D(kWidth, kHeight, ResourceFormat::RGBA8Unorm, 1, 1, data.data(), ResourceBindFlags::ShaderResource);
+}
+} // namespace
+
+GPU_TEST(AsyncFrameCapture_PNG)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+
+    // Capture more frames than there are readback buffers and allow only one image to be pending.
+    AsyncFrameCapture::Options options;
+    options.readbackCount = 2;
+    options.threadCount = 2;
+    options.maxPendingByteSize = 1;
+    AsyncFrameCapture capture(pDevice, options);
+
+    const uint32_t frameCount = 5;
+    std::vector<std::filesystem::path> paths;
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        paths.push_back(getRuntimeDirectory() / fmt::format("test_async_capture.{}.png", frame));
+        capture.capture(pRenderContext, createTestTexture(pDevice, frame), frame, paths.back(), Bitmap::FileFormat::PngFile);
+    }
+    capture.flush();
+
+    auto stats = capture.getStats();
+    EXPECT_EQ(stats.frameCount, frameCount);
+    EXPECT_EQ(stats.imageCount, frameCount);
+    EXPECT_EQ(stats.failedCount, 0);
+    EXPECT_EQ(stats.byteCount, frameCount * kWidth * kHeight * 4);
+
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        auto bmp = Bitmap::createFromFile(paths[frame], true /* top-down */);
+        EXPECT(bmp != nullptr);
+        if (bmp)
+        {
+            EXPECT_EQ(bmp->getWidth(), kWidth);
+            EXPECT_EQ(bmp->getHeight(), kHeight);
+            // PNG files are loaded in BGRX order.
+            const uint8_t* data = bmp->getData();
+            for (uint32_t i = 0; i < kWidth * kHeight; i++)
+            {
+                EXPECT_EQ(data[4 * i + 2], (uint8_t)(i + frame)) << "frame=" << frame << " i=" << i;
+                EXPECT_EQ(data[4 * i + 0], (uint8_t)frame) << "frame=" << frame << " i=" << i;
+            }
+        }
+        std::filesystem::remove(paths[frame]);
+    }
+}
+
+GPU_TEST(AsyncFrameCapture_Raw)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    AsyncFrameCapture::Options options;
+    options.encodeMode = AsyncFrameCapture::EncodeMode::Raw;
+    AsyncFrameCapture capture(pDevice, options);
+
+    // The file extension is replaced in raw mode.
+    const auto path = getRuntimeDirectory() / "test_async_capture.png";
+    const auto rawPath = getRuntimeDirectory() / "test_async_capture.raw";
+    capture.capture(pDevice->getRenderContext(), createTestTexture(pDevice, 7), 0, path, Bitmap::FileFormat::PngFile);
+    capture.flush();
+
+    EXPECT(!std::filesystem::exists(path));
+    ASSERT(std::filesystem::exists(rawPath));
+
+    // The header is 24 bytes, followed by the texel data.
+    std::ifstream file(rawPath, std::ios::binary);
+    std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove(rawPath);
+
+    ASSERT_EQ(contents.size(), 24 + kWidth * kHeight * 4);
+    EXPECT_EQ(std::string(contents.begin(), contents.begin() + 4), "FRAW");
+    const uint32_t* header = reinterpret_cast<const uint32_t*>(contents.data());
+    EXPECT_EQ(header[2], kWidth);
+    EXPECT_EQ(header[3], kHeight);
+    EXPECT_EQ(header[4], (uint32_t)ResourceFormat::RGBA8Unorm);
+    EXPECT_EQ(header[5], kWidth * 4);
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+        EXPECT_EQ(contents[24 + 4 * i], (uint8_t)(i + 7)) << "i=" << i;
+}
+} // namespace Falcor
@@ -26,8 +26,11 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
 #include "Utils/Image/Bitmap.h"
 
+#include <vector>
+
 namespace Falcor
 {
 GPU_TEST(Bitmap_LinearRamp_PNG)
@@ -74,4 +77,28 @@ GPU_TEST(Bitmap_LinearRamp_PNG)
     // Delete the test file.
     std::filesystem::remove(path);
 }
+
+CPU_BENCHMARK(Bitmap_LoadPNG, BENCHMARK_PARAM("size", 256, 1024))
+{
+    const auto path = getRuntimeDirectory() / "benchmark_load.png";
+    const uint32_t size = (uint32_t)ctx.getParam("size");
+
+    std::vector<uint8_t> data(size * size * 4);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (uint8_t)(i * 7);
+    Bitmap::saveImage(
+        path, size, size, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::ExportAlpha, ResourceFormat::RGBA8Unorm, true, data.data()
+    );
+
+    ctx.setItemsPerIteration(size * size);
+    ctx.run(
+        [&]()
+        {
+            auto bmp = Bitmap::createFromFile(path, true /* top-down */);
+            doNotOptimize(bmp.get());
+        }
+    );
+
+    std::filesystem::remove(path);
+}
 } // namespace Falcor
@@ -0,0 +1,361 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
+#include "Utils/JobSystem.h"
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+using JobHandle = JobSystem::JobHandle;
+using Priority = JobSystem::Priority;
+
+// CPU bound work standing in for mesh processing or texture decoding.
+uint32_t busyWork(uint32_t seed, uint32_t iterations)
+{
+    uint32_t x = seed | 1;
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    return x;
+}
+
+// Tracks the number of threads running work at the same time.
+struct ConcurrencyTracker
+{
+    std::atomic<uint32_t> current{0};
+    std::atomic<uint32_t> peak{0};
+
+    template<typename Func>
+    void run(Func&& func)
+    {
+        const uint32_t count = ++current;
+        uint32_t prevPeak = peak.load();
+        while (count > prevPeak && !peak.compare_exchange_weak(prevPeak, count))
+            ;
+        func();
+        --current;
+    }
+};
+} // namespace
+
+CPU_TEST(JobSystem_Submit)
+{
+    JobSystem jobSystem(4);
+
+    std::atomic<uint32_t> counter{0};
+    std::vector<JobHandle> jobs;
+    for (uint32_t i = 0; i < 1000; ++i)
+        jobs.push_back(jobSystem.submit([&]() { ++counter; }, Priority(i % 3)));
+
+    jobSystem.wait(jobs);
+    EXPECT_EQ(counter.load(), 1000u);
+    for (const auto& job : jobs)
+        EXPECT(job.isDone());
+
+    // Empty handles are finished.
+    JobHandle empty;
+    EXPECT(!empty.isValid());
+    EXPECT(empty.isDone());
+    jobSystem.wait(empty);
+}
+
+CPU_TEST(JobSystem_Dependencies)
+{
+    JobSystem jobSystem(4);
+
+    for (uint32_t run = 0; run < 50; ++run)
+    {
+        std::mutex mutex;
+        std::vector<char> order;
+        auto record = [&](char c)
+        {
+            return [&, c]()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(c);
+            };
+        };
+
+        // Diamond: A -> (B, C) -> D.
+        JobHandle a = jobSystem.submit(record('A'));
+        const JobHandle depsA[] = {a};
+        JobHandle b = jobSystem.submit(record('B'), Priority::Normal, depsA);
+        JobHandle c = jobSystem.submit(record('C'), Priority::Low, depsA);
+        const JobHandle depsBC[] = {b, c};
+        JobHandle d = jobSystem.submit(record('D'), Priority::High, depsBC);
+
+        jobSystem.wait(d);
+        EXPECT(a.isDone() && b.isDone() && c.isDone());
+        ASSERT_EQ(order.size(), 4u);
+        EXPECT_EQ(order.front(), 'A');
+        EXPECT_EQ(order.back(), 'D');
+    }
+}
+
+CPU_TEST(JobSystem_Priority)
+{
+    JobSystem jobSystem(1);
+
+    // Keep the only worker busy while the jobs are queued.
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    JobHandle blocker = jobSystem.submit(
+        [&]()
+        {
+            started = true;
+            while (!release)
+                std::this_thread::yield();
+        }
+    );
+    while (!started)
+        std::this_thread::yield();
+
+    std::mutex mutex;
+    std::vector<Priority> order;
+    std::vector<JobHandle> jobs;
+    for (Priority priority : {Priority::Low, Priority::Normal, Priority::High, Priority::Low, Priority::High})
+    {
+        jobs.push_back(jobSystem.submit(
+            [&, priority]()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(priority);
+            },
+            priority
+        ));
+    }
+
+    // The waiting thread runs the queued jobs itself, highest priority first.
+    jobSystem.wait(jobs);
+    release = true;
+    jobSystem.wait(blocker);
+
+    ASSERT_EQ(order.size(), 5u);
+    for (size_t i = 1; i < order.size(); ++i)
+        EXPECT_LE((uint32_t)order[i - 1], (uint32_t)order[i]);
+}
+
+CPU_TEST(JobSystem_Exceptions)
+{
+    JobSystem jobSystem(2);
+
+    JobHandle failing = jobSystem.submit([]() { throw std::runtime_error("job failed"); });
+    EXPECT_THROW(jobSystem.wait(failing));
+
+    // Dependents still run.
+    std::atomic<bool> ran{false};
+    const JobHandle deps[] = {failing};
+    jobSystem.wait(jobSystem.submit([&]() { ran = true; }, Priority::Normal, deps));
+    EXPECT(ran.load());
+
+    EXPECT_THROW(jobSystem.parallelFor(0, 100, [](size_t i) {
+        if (i == 57)
+            throw std::runtime_error("iteration failed");
+    }));
+}
+
+CPU_TEST(JobSystem_ParallelFor)
+{
+    JobSystem jobSystem(4);
+
+    std::vector<uint32_t> values(10000, 0);
+    jobSystem.parallelFor(0, values.size(), [&](size_t i) { values[i] += (uint32_t)i; });
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(values[i], (uint32_t)i);
+
+    // Explicit grain sizes, including larger than the range.
+    for (size_t grain : {1, 7, 100000})
+    {
+        std::atomic<size_t> sum{0};
+        jobSystem.parallelFor(10, 1010, [&](size_t i) { sum += i; }, grain);
+        EXPECT_EQ(sum.load(), (size_t)(10 + 1009) * 1000 / 2);
+    }
+
+    // Empty ranges.
+    jobSystem.parallelFor(5, 5, [&](size_t) { EXPECT(false); });
+    jobSystem.parallelFor(5, 0, [&](size_t) { EXPECT(false); });
+}
+
+CPU_TEST(JobSystem_NestedParallelFor)
+{
+    // A single worker makes nested waits more likely to find their own work queued behind them.
+    for (uint32_t threadCount : {1u, 4u})
+    {
+        JobSystem jobSystem(threadCount);
+
+        std::atomic<uint32_t> counter{0};
+        jobSystem.parallelFor(
+            0,
+            16,
+            [&](size_t)
+            {
+                jobSystem.parallelFor(
+                    0,
+                    100,
+                    [&](size_t) { jobSystem.parallelFor(0, 10, [&](size_t) { ++counter; }, 1); },
+                    1
+                );
+            },
+            1
+        );
+        EXPECT_EQ(counter.load(), 16000u);
+
+        // Waiting on a job from inside a job.
+        std::atomic<bool> innerDone{false};
+        JobHandle outer = jobSystem.submit(
+            [&]()
+            {
+                JobHandle inner = jobSystem.submit([&]() { innerDone = true; });
+                jobSystem.wait(inner);
+                EXPECT(innerDone.load());
+            }
+        );
+        jobSystem.wait(outer);
+    }
+}
+
+CPU_TEST(JobSystem_ParallelReduce)
+{
+    JobSystem jobSystem(4);
+
+    const size_t count = 100000;
+    auto sum = [&](size_t grain)
+    {
+        return jobSystem.parallelReduce(
+            0,
+            count,
+            uint64_t(0),
+            [](size_t begin, size_t end)
+            {
+                uint64_t s = 0;
+                for (size_t i = begin; i < end; ++i)
+                    s += i;
+                return s;
+            },
+            [](uint64_t a, uint64_t b) { return a + b; },
+            grain
+        );
+    };
+
+    EXPECT_EQ(sum(0), (uint64_t)count * (count - 1) / 2);
+    EXPECT_EQ(sum(1000), (uint64_t)count * (count - 1) / 2);
+
+    // Chunks are combined in order: concatenating strings gives the sequence.
+    const std::string digits = jobSystem.parallelReduce(
+        0,
+        10,
+        std::string(),
+        [](size_t begin, size_t end)
+        {
+            std::string s;
+            for (size_t i = begin; i < end; ++i)
+                s += char('0' + i);
+            return s;
+        },
+        [](std::string a, std::string b) { return a + b; },
+        3
+    );
+    EXPECT_EQ(digits, std::string("0123456789"));
+
+    EXPECT_EQ(jobSystem.parallelReduce(3, 3, 42, [](size_t, size_t) { return 0; }, [](int a, int b) { return a + b; }), 42);
+}
+
+CPU_BENCHMARK(JobSystem_ConcurrentLoad, BENCHMARK_PARAM("shared", 0, 1))
+{
+    // A scene import and a texture loader running at the same time, each sized to use the whole CPU.
+    // With dedicated pools (shared = 0) this runs twice as many threads as cores. With the shared job system
+    // (shared = 1) the work of both is interleaved on the same workers and the concurrency stays bounded.
+    const bool shared = ctx.getParam("shared") != 0;
+    const uint32_t coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t kMeshCount = 256;
+    const size_t kTextureCount = 64;
+    const uint32_t kMeshWork = 20000;
+    const uint32_t kTextureWork = 80000;
+
+    JobSystem jobSystem;
+    ConcurrencyTracker tracker;
+    std::atomic<uint32_t> result{0};
+
+    auto processMesh = [&](size_t i) { tracker.run([&]() { result += busyWork((uint32_t)i, kMeshWork); }); };
+    auto loadTexture = [&](size_t i) { tracker.run([&]() { result += busyWork((uint32_t)i + 1000, kTextureWork); }); };
+
+    // Dedicated pool: one thread per core pulling items from a shared counter.
+    auto runDedicatedPool = [&](size_t itemCount, const std::function<void(size_t)>& func)
+    {
+        std::atomic<size_t> next{0};
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < coreCount; ++t)
+            threads.emplace_back(
+                [&]()
+                {
+                    for (size_t i = next++; i < itemCount; i = next++)
+                        func(i);
+                }
+            );
+        for (auto& thread : threads)
+            thread.join();
+    };
+
+    ctx.setItemsPerIteration(kMeshCount + kTextureCount);
+    ctx.run(
+        [&]()
+        {
+            if (shared)
+            {
+                std::vector<JobHandle> textureJobs;
+                for (size_t i = 0; i < kTextureCount; ++i)
+                    textureJobs.push_back(jobSystem.submit([&, i]() { loadTexture(i); }, Priority::Low));
+                jobSystem.parallelFor(0, kMeshCount, processMesh, 1);
+                jobSystem.wait(textureJobs);
+            }
+            else
+            {
+                std::thread textureLoader([&]() { runDedicatedPool(kTextureCount, loadTexture); });
+                runDedicatedPool(kMeshCount, processMesh);
+                textureLoader.join();
+            }
+        }
+    );
+    doNotOptimize(result.load());
+
+    // The workers plus the submitting thread.
+    if (shared)
+        EXPECT_LE(tracker.peak.load(), jobSystem.getThreadCount() + 1);
+    logInfo("JobSystem_ConcurrentLoad: shared = {}, peak concurrency {} on {} cores.", shared, tracker.peak.load(), coreCount);
+}
+} // namespace Falcor
@@ -0,0 +1,232 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+// Redirects the log to a temporary file for the lifetime of the object.
+// The logger settings are global, so tests using a log file are serialized when running tests in parallel.
+class ScopedLogFile
+{
+public:
+    ScopedLogFile()
+        : mLock(getMutex())
+        , mPath(getTempFilePath())
+        , mPrevPath(Logger::getLogFilePath())
+        , mPrevOutputs(Logger::getOutputs())
+        , mPrevVerbosity(Logger::getVerbosity())
+    {
+        Logger::setLogFilePath(mPath);
+        Logger::setOutputs(Logger::OutputFlags::File);
+        Logger::setVerbosity(Logger::Level::Info);
+    }
+
+    ~ScopedLogFile()
+    {
+        Logger::setLogFilePath(mPrevPath);
+        Logger::setOutputs(mPrevOutputs);
+        Logger::setVerbosity(mPrevVerbosity);
+        std::filesystem::remove(mPath);
+    }
+
+    // Returns the lines of the log file containing the given tag.
+    std::vector<std::string> readLines(const std::string& tag) const
+    {
+        Logger::flush();
+        std::vector<std::string> lines;
+        std::ifstream file(mPath);
+        for (std::string line; std::getline(file, line);)
+        {
+            if (line.find(tag) != std::string::npos)
+                lines.push_back(line);
+        }
+        return lines;
+    }
+
+private:
+    static std::mutex& getMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::lock_guard<std::mutex> mLock;
+    std::filesystem::path mPath;
+    std::filesystem::path mPrevPath;
+    Logger::OutputFlags mPrevOutputs;
+    Logger::Level mPrevVerbosity;
+};
+} // namespace
+
+CPU_TEST(Logger_Order)
+{
+    const uint32_t kThreadCount = 4;
+    const uint32_t kMessagesPerThread = 1000;
+
+    ScopedLogFile logFile;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < kThreadCount; ++t)
+    {
+        threads.emplace_back(
+            [t]()
+            {
+                for (uint32_t i = 0; i < kMessagesPerThread; ++i)
+                    logInfo("LoggerTest::order {} {}", t, i);
+            }
+        );
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    // The messages of each thread are written in the order they were logged.
+    std::vector<uint32_t> nextMessage(kThreadCount, 0);
+    for (const auto& line : logFile.readLines("LoggerTest::order"))
+    {
+        uint32_t t = 0, i = 0;
+        ASSERT_EQ(std::sscanf(line.c_str(), "(Info) LoggerTest::order %u %u", &t, &i), 2) << line;
+        ASSERT_LT(t, kThreadCount);
+        EXPECT_EQ(i, nextMessage[t]) << "thread " << t;
+        nextMessage[t] = i + 1;
+    }
+    for (uint32_t t = 0; t < kThreadCount; ++t)
+        EXPECT_EQ(nextMessage[t], kMessagesPerThread) << "thread " << t;
+}
+
+CPU_TEST(Logger_DeferredFormatting)
+{
+    ScopedLogFile logFile;
+
+    // Arguments are copied, changing them after the call doesn't change the message.
+    std::string name = "mesh";
+    std::string_view nameView = name;
+    std::filesystem::path path = "dir/file.txt";
+    logInfo("LoggerTest::deferred {} {} {} {:.2f} {}", name, nameView, path, 1.5f, 42);
+    name = "XXXX";
+    path = "other";
+
+    // Disabled messages are skipped.
+    logDebug("LoggerTest::deferred disabled {}", 1);
+
+    auto lines = logFile.readLines("LoggerTest::deferred");
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_EQ(lines[0], "(Info) LoggerTest::deferred mesh mesh dir/file.txt 1.50 42");
+}
+
+CPU_TEST(Logger_Once)
+{
+    ScopedLogFile logFile;
+
+    for (int i = 0; i < 3; ++i)
+        logWarningOnce("LoggerTest::once {}", "message");
+
+    EXPECT_EQ(logFile.readLines("LoggerTest::once").size(), 1);
+}
+
+CPU_TEST(Logger_RateLimit)
+{
+    const uint32_t kMessageCount = 300;
+
+    ScopedLogFile logFile;
+
+    for (uint32_t i = 0; i < kMessageCount; ++i)
+        logInfo("LoggerTest::rateLimit");
+
+    // Identical messages are limited per time window, the suppressed ones are reported when the window ends.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    Logger::flush();
+
+    uint32_t writtenCount = 0;
+    uint32_t suppressedCount = 0;
+    for (const auto& line : logFile.readLines("LoggerTest::rateLimit"))
+    {
+        uint32_t count = 0;
+        if (std::sscanf(line.c_str(), "(Warning) Suppressed %u repeats", &count) == 1)
+            suppressedCount += count;
+        else
+            ++writtenCount;
+    }
+    EXPECT_LT(writtenCount, kMessageCount);
+    EXPECT_EQ(writtenCount + suppressedCount, kMessageCount);
+}
+
+CPU_TEST(Logger_RateLimitErrors)
+{
+    const uint32_t kMessageCount = 300;
+
+    ScopedLogFile logFile;
+
+    for (uint32_t i = 0; i < kMessageCount; ++i)
+        logError("LoggerTest::rateLimitErrors");
+
+    // Errors are never suppressed.
+    EXPECT_EQ(logFile.readLines("LoggerTest::rateLimitErrors").size(), kMessageCount);
+}
+
+CPU_BENCHMARK(Logger_Throughput, BENCHMARK_PARAM("threads", 1, 4, 16))
+{
+    // Several threads logging formatted messages at the same time, e.g. the importer processing meshes in parallel.
+    const uint32_t threadCount = (uint32_t)ctx.getParam("threads");
+    const uint32_t kMessagesPerThread = 1000;
+
+    ScopedLogFile logFile;
+
+    ctx.setItemsPerIteration(threadCount * kMessagesPerThread);
+    ctx.run(
+        [&]()
+        {
+            std::vector<std::thread> threads;
+            for (uint32_t t = 0; t < threadCount; ++t)
+            {
+                threads.emplace_back(
+                    [t]()
+                    {
+                        for (uint32_t i = 0; i < kMessagesPerThread; ++i)
+                            logInfo("LoggerTest::throughput thread {} mesh {} has {} vertices", t, i, i * 3);
+                    }
+                );
+            }
+            for (auto& thread : threads)
+                thread.join();
+            Logger::flush();
+        }
+    );
+}
+} // namespace Falcor
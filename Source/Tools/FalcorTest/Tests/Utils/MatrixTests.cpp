@@ -26,11 +26,14 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/Math/MatrixJson.h"
 
 #include <fmt/format.h>
 #include <iostream>
+#include <random>
+#include <vector>
 
 namespace Falcor
 {
@@ -856,4 +859,67 @@ CPU_TEST(Matrix_Json)
     );
 }
 
+/// Create random affine transforms (rotation followed by translation).
+static std::vector<float4x4> createRandomTransforms(size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<float4x4> transforms(count);
+    for (auto& transform : transforms)
+    {
+        float4x4 rotation = math::matrixFromRotationXYZ(dist(rng) * 3.f, dist(rng) * 3.f, dist(rng) * 3.f);
+        transform = mul(math::matrixFromTranslation(float3(dist(rng), dist(rng), dist(rng))), rotation);
+    }
+    return transforms;
+}
+
+CPU_BENCHMARK(Matrix_mul)
+{
+    const size_t kCount = 1024;
+    const auto a = createRandomTransforms(kCount, 1);
+    const auto b = createRandomTransforms(kCount, 2);
+    std::vector<float4x4> result(kCount);
+    ctx.setItemsPerIteration(kCount);
+    ctx.run(
+        [&]()
+        {
+            for (size_t i = 0; i < kCount; ++i)
+                result[i] = mul(a[i], b[i]);
+            doNotOptimize(result.data());
+        }
+    );
+}
+
+CPU_BENCHMARK(Matrix_inverse)
+{
+    const size_t kCount = 1024;
+    const auto a = createRandomTransforms(kCount, 1);
+    std::vector<float4x4> result(kCount);
+    ctx.setItemsPerIteration(kCount);
+    ctx.run(
+        [&]()
+        {
+            for (size_t i = 0; i < kCount; ++i)
+                result[i] = inverse(a[i]);
+            doNotOptimize(result.data());
+        }
+    );
+}
+
+CPU_BENCHMARK(Matrix_transformPoint)
+{
+    const size_t kCount = 1024;
+    const auto a = createRandomTransforms(kCount, 1);
+    std::vector<float3> result(kCount);
+    ctx.setItemsPerIteration(kCount);
+    ctx.run(
+        [&]()
+        {
+            for (size_t i = 0; i < kCount; ++i)
+                result[i] = transformPoint(a[i], float3(float(i)));
+            doNotOptimize(result.data());
+        }
+    );
+}
+
 } // namespace Falcor
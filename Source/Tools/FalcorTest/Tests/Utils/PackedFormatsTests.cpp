@@ -26,6 +26,8 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Testing/UnitTest.h"
+#include "Utils/Math/FormatConversion.h"
+#include "Utils/Math/PackedFormats.h"
 #include <random>
 
 namespace Falcor
@@ -45,6 +47,64 @@ std::vector<float3> testData = {
 };
 }
 
+CPU_TEST(Normal2x16RoundTrip)
+{
+    std::mt19937 rng;
+    auto dist = std::uniform_real_distribution<float>(-1.f, 1.f);
+
+    std::vector<float3> normals = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    while (normals.size() < 10000)
+    {
+        float3 n = float3(dist(rng), dist(rng), dist(rng));
+        if (length(n) > 1e-3f)
+            normals.push_back(normalize(n));
+    }
+
+    for (size_t i = 0; i < normals.size(); i++)
+    {
+        float3 decoded = decodeNormal2x16(encodeNormal2x16(normals[i]));
+        EXPECT_LT(length(decoded - normals[i]), 1e-4f) << "i = " << i;
+    }
+}
+
+CPU_TEST(R11G11B10RoundTrip)
+{
+    std::mt19937 rng;
+    auto dist = std::uniform_real_distribution<float>();
+
+    EXPECT_EQ(unpackR11G11B10(packR11G11B10(float3(0.f))), float3(0.f));
+    EXPECT_EQ(unpackR11G11B10(packR11G11B10(float3(1.f))), float3(1.f));
+
+    // Values above the range are clamped to the largest representable value.
+    float3 clamped = unpackR11G11B10(packR11G11B10(float3(1e10f)));
+    EXPECT_EQ(clamped, float3(64512.f));
+
+    // Red and green have a 6-bit mantissa, blue a 5-bit mantissa. Allow for one ulp due to the rounding through half precision.
+    for (size_t i = 0; i < 10000; i++)
+    {
+        float3 c = float3(dist(rng), dist(rng), dist(rng)) * std::pow(2.f, dist(rng) * 20.f - 10.f);
+        float3 decoded = unpackR11G11B10(packR11G11B10(c));
+        EXPECT_LE(std::abs(decoded.x - c.x), c.x * (1.f / 64.f) + 1e-4f) << "i = " << i;
+        EXPECT_LE(std::abs(decoded.y - c.y), c.y * (1.f / 64.f) + 1e-4f) << "i = " << i;
+        EXPECT_LE(std::abs(decoded.z - c.z), c.z * (1.f / 32.f) + 1e-4f) << "i = " << i;
+    }
+}
+
+CPU_TEST(Unorm4x8RoundTrip)
+{
+    // All 8-bit values are reproduced exactly.
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint packed = i | ((255 - i) << 8) | ((i / 2) << 16) | ((255 - i / 2) << 24);
+        float4 v = unpackUnorm4x8(packed);
+        EXPECT_EQ(packUnorm4x8(v), packed);
+        EXPECT_LT(std::abs(v.x - float(i) / 255.f), 1e-6f);
+    }
+
+    // Values outside [0,1] are clamped and NaN is encoded as zero.
+    EXPECT_EQ(packUnorm4x8(float4(-1.f, 2.f, std::numeric_limits<float>::quiet_NaN(), 0.5f)), 0x8000ff00u);
+}
+
 GPU_TEST(LogLuvHDR)
 {
     std::mt19937 rng;
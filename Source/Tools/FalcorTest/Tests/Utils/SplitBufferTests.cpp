@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Testing/UnitTest.h"
+#include "Testing/Benchmark.h"
 #include "Utils/SplitBuffer.h"
 
 #include <random>
@@ -652,4 +653,21 @@ GPU_TEST(SplitBuffer_StructuredBuffer_Many32B)
     }
 }
 
+CPU_BENCHMARK(SplitBuffer_Insert, BENCHMARK_PARAM("rangeSize", 16, 1024))
+{
+    // Insert 1M items in ranges of the given size, as done when building the scene's geometry buffers.
+    const size_t kItemCount = 1 << 20;
+    const size_t rangeSize = (size_t)ctx.getParam("rangeSize");
+    std::vector<S32B> items(rangeSize, S32B(1.f));
+    ctx.setItemsPerIteration(kItemCount);
+    ctx.run(
+        [&]()
+        {
+            SplitBuffer<S32B, false> buffer;
+            for (size_t i = 0; i < kItemCount; i += rangeSize)
+                doNotOptimize(buffer.insert(items.begin(), items.end()));
+        }
+    );
+}
+
 } // namespace Falcor
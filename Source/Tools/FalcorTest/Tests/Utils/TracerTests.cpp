@@ -0,0 +1,223 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Timing/Tracer.h"
+#include <nlohmann/json.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+nlohmann::json exportTrace()
+{
+    return nlohmann::json::parse(Tracer::toChromeTraceJson());
+}
+
+// The tracer state is global, tests using it are serialized when running tests in parallel.
+std::mutex& getTracerMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+size_t countEvents(const nlohmann::json& trace, const std::string& name, const std::string& phase)
+{
+    size_t count = 0;
+    for (const auto& event : trace["traceEvents"])
+    {
+        if (event["name"] == name && event["ph"] == phase)
+            ++count;
+    }
+    return count;
+}
+} // namespace
+
+CPU_TEST(Tracer_Disabled)
+{
+    std::lock_guard<std::mutex> lock(getTracerMutex());
+    Tracer::stop();
+    Tracer::clear();
+
+    {
+        TraceScope scope("TracerTest::disabled");
+        EXPECT(!scope.isActive());
+    }
+    Tracer::recordCounter("TracerTest::disabledCounter", 1.0);
+
+    // Recording functions always record, only the scope checks if tracing is enabled.
+    auto trace = exportTrace();
+    EXPECT_EQ(countEvents(trace, "TracerTest::disabled", "X"), 0);
+    EXPECT_EQ(countEvents(trace, "TracerTest::disabledCounter", "C"), 1);
+    Tracer::clear();
+}
+
+CPU_TEST(Tracer_Events)
+{
+    const uint32_t kThreadCount = 4;
+    const uint32_t kEventsPerThread = 100;
+
+    std::lock_guard<std::mutex> lock(getTracerMutex());
+    Tracer::clear();
+    Tracer::start();
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < kThreadCount; ++i)
+    {
+        threads.emplace_back(
+            [i]()
+            {
+                Tracer::setThreadName("TracerTest" + std::to_string(i));
+                for (uint32_t j = 0; j < kEventsPerThread; ++j)
+                {
+                    TraceScope scope("TracerTest::scope");
+                    scope.setDetail("detail");
+                }
+                Tracer::recordInstant("TracerTest::instant");
+                Tracer::recordCounter("TracerTest::counter", i);
+            }
+        );
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    // Dynamic names are copied into the event.
+    std::string name = "TracerTest::dynamic";
+    uint64_t startTime = Tracer::getTimestamp();
+    Tracer::recordDynamicComplete(name, startTime, startTime + 1000);
+    name.clear();
+
+    Tracer::stop();
+
+    auto trace = exportTrace();
+    EXPECT_EQ(countEvents(trace, "TracerTest::scope", "X"), kThreadCount * kEventsPerThread);
+    EXPECT_EQ(countEvents(trace, "TracerTest::instant", "i"), kThreadCount);
+    EXPECT_EQ(countEvents(trace, "TracerTest::counter", "C"), kThreadCount);
+    EXPECT_EQ(countEvents(trace, "TracerTest::dynamic", "X"), 1);
+
+    // Each thread is named and scope events carry their detail and a non-negative duration.
+    size_t namedThreadCount = 0;
+    for (const auto& event : trace["traceEvents"])
+    {
+        if (event["ph"] == "M" && event["args"]["name"].get<std::string>().rfind("TracerTest", 0) == 0)
+            ++namedThreadCount;
+        if (event["name"] == "TracerTest::scope")
+        {
+            EXPECT_EQ(event["args"]["detail"], "detail");
+            EXPECT_GE(event["dur"].get<double>(), 0.0);
+        }
+        if (event["name"] == "TracerTest::dynamic")
+            EXPECT_EQ(event["dur"].get<double>(), 1.0);
+    }
+    EXPECT_EQ(namedThreadCount, kThreadCount);
+
+    // Cleared events are not exported.
+    Tracer::clear();
+    EXPECT_EQ(countEvents(exportTrace(), "TracerTest::scope", "X"), 0);
+}
+
+CPU_TEST(Tracer_Overflow)
+{
+    const size_t kCapacity = 16;
+    const size_t kEventCount = 100;
+
+    std::lock_guard<std::mutex> lock(getTracerMutex());
+    Tracer::clear();
+    Tracer::setBufferCapacity(kCapacity);
+
+    // The capacity applies to threads recording their first event after setBufferCapacity().
+    std::thread thread(
+        []()
+        {
+            for (size_t i = 0; i < kEventCount; ++i)
+                Tracer::recordCounter("TracerTest::overflow", double(i));
+        }
+    );
+    thread.join();
+    Tracer::setBufferCapacity(Tracer::kDefaultBufferCapacity);
+
+    // The oldest events are overwritten, the events of the exited thread can still be exported.
+    EXPECT_EQ(Tracer::getOverwrittenEventCount(), kEventCount - kCapacity);
+    std::vector<double> values;
+    for (const auto& event : exportTrace()["traceEvents"])
+    {
+        if (event["name"] == "TracerTest::overflow")
+            values.push_back(event["args"]["value"].get<double>());
+    }
+    ASSERT_EQ(values.size(), kCapacity);
+    for (size_t i = 0; i < kCapacity; ++i)
+        EXPECT_EQ(values[i], double(kEventCount - kCapacity + i));
+
+    Tracer::clear();
+    EXPECT_EQ(Tracer::getOverwrittenEventCount(), 0);
+    EXPECT_EQ(countEvents(exportTrace(), "TracerTest::overflow", "C"), 0);
+}
+
+CPU_TEST(Tracer_ScopeDetail)
+{
+    std::lock_guard<std::mutex> lock(getTracerMutex());
+    Tracer::clear();
+
+    // The detail expression is only evaluated when tracing is enabled.
+    uint32_t evaluationCount = 0;
+    auto getDetail = [&]()
+    {
+        ++evaluationCount;
+        return std::string("detail");
+    };
+    {
+        FALCOR_TRACE_SCOPE_DETAIL("TracerTest::scopeDetail", getDetail());
+    }
+    EXPECT_EQ(evaluationCount, 0);
+
+    // The macro is a single declaration, an else following it in an if statement binds to that if.
+    Tracer::start();
+    bool elseTaken = false;
+    if (evaluationCount == 0)
+        FALCOR_TRACE_SCOPE_DETAIL("TracerTest::scopeDetail", getDetail());
+    else
+        elseTaken = true;
+    Tracer::stop();
+    EXPECT(!elseTaken);
+
+#if FALCOR_ENABLE_TRACING
+    EXPECT_EQ(evaluationCount, 1);
+    auto trace = exportTrace();
+    EXPECT_EQ(countEvents(trace, "TracerTest::scopeDetail", "X"), 1);
+    for (const auto& event : trace["traceEvents"])
+    {
+        if (event["name"] == "TracerTest::scopeDetail")
+            EXPECT_EQ(event["args"]["detail"], "detail");
+    }
+#endif
+    Tracer::clear();
+}
+} // namespace Falcor
@@ -0,0 +1,302 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ErrorMetrics.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <execution>
+#include <mutex>
+#include <numeric>
+
+#include <cmath>
+
+namespace
+{
+const uint32_t kPixelTileHeight = 16;
+const uint32_t kSSIMTileHeight = 32;
+
+// SSIM parameters (Wang et al. 2004): 11x11 Gaussian window with sigma 1.5, dynamic range of 1.
+const int kSSIMRadius = 5;
+const float kSSIMSigma = 1.5f;
+const float kSSIMC1 = sqr(0.01f);
+const float kSSIMC2 = sqr(0.03f);
+
+// Per-channel error functions. Per-pixel errors are accumulated in double precision.
+
+struct MSE
+{
+    static constexpr double kScale = 1.0;
+    double operator()(double a, double b) const { return sqr(a - b); }
+};
+
+struct RMSE
+{
+    static constexpr double kScale = 1.0;
+    double operator()(double a, double b) const { return sqr(a - b) / (sqr(a) + 1e-3); }
+};
+
+struct MAE
+{
+    static constexpr double kScale = 1.0;
+    double operator()(double a, double b) const { return std::fabs(sqr(a - b)); }
+};
+
+struct MAPE
+{
+    static constexpr double kScale = 100.0;
+    double operator()(double a, double b) const { return std::fabs((a - b) / (a + 1e-3)); }
+};
+
+/// Sum an array of values in double precision using independent accumulators.
+double sumValues(const float* values, uint32_t count)
+{
+    double acc[4] = {};
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        for (uint32_t j = 0; j < 4; ++j)
+            acc[j] += values[i + j];
+    }
+    for (; i < count; ++i)
+        acc[0] += values[i];
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+/// Evaluate the per-pixel error of a row and return the sum. Per-pixel errors are written to errors if it is non-null.
+template<typename Metric, uint32_t kChannels>
+double evalPixelRow(const float* a, const float* b, float* errors, uint32_t width)
+{
+    Metric metric;
+    double sum = 0.0;
+    for (uint32_t x = 0; x < width; ++x)
+    {
+        double error = 0.0;
+        for (uint32_t c = 0; c < kChannels; ++c)
+            error += metric(a[4 * x + c], b[4 * x + c]);
+        error = Metric::kScale * error / kChannels;
+        if (errors)
+            errors[x] = float(error);
+        sum += error;
+    }
+    return sum;
+}
+
+template<typename Metric>
+CompareResult comparePixels(const Image& imageA, const Image& imageB, const CompareOptions& options, float* errorMap)
+{
+    const uint32_t width = imageA.getWidth();
+    const auto evalRow = options.alpha ? evalPixelRow<Metric, 4> : evalPixelRow<Metric, 3>;
+
+    return runTiled(
+        width,
+        imageA.getHeight(),
+        kPixelTileHeight,
+        options.earlyExit && !errorMap,
+        options.threshold,
+        [&](uint32_t y0, uint32_t y1)
+        {
+            double sum = 0.0;
+            for (uint32_t y = y0; y < y1; ++y)
+                sum += evalRow(imageA.getRow(y), imageB.getRow(y), errorMap ? errorMap + size_t(y) * width : nullptr, width);
+            return sum;
+        }
+    );
+}
+
+float luminance(const float* rgba)
+{
+    return 0.2126f * clamp(rgba[0], 0.f, 1.f) + 0.7152f * clamp(rgba[1], 0.f, 1.f) + 0.0722f * clamp(rgba[2], 0.f, 1.f);
+}
+
+CompareResult compareSSIM(const Image& imageA, const Image& imageB, const CompareOptions& options, float* errorMap)
+{
+    const uint32_t width = imageA.getWidth();
+    const uint32_t height = imageA.getHeight();
+    const uint32_t paddedWidth = width + 2 * kSSIMRadius;
+
+    std::array<float, 2 * kSSIMRadius + 1> weights;
+    for (int i = -kSSIMRadius; i <= kSSIMRadius; ++i)
+        weights[i + kSSIMRadius] = std::exp(-float(i * i) / (2.f * sqr(kSSIMSigma)));
+    const float weightSum = std::accumulate(weights.begin(), weights.end(), 0.f);
+    for (float& w : weights)
+        w /= weightSum;
+
+    return runTiled(
+        width,
+        height,
+        kSSIMTileHeight,
+        options.earlyExit && !errorMap,
+        options.threshold,
+        [&](uint32_t y0, uint32_t y1)
+        {
+            // Horizontally filtered moments (mean A, mean B, E[A^2], E[B^2], E[AB]) of all rows covered by the band and its halo.
+            const uint32_t haloHeight = y1 - y0 + 2 * kSSIMRadius;
+            std::vector<float> moments(5 * size_t(haloHeight) * width);
+            std::vector<float> lumA(paddedWidth);
+            std::vector<float> lumB(paddedWidth);
+            for (uint32_t i = 0; i < haloHeight; ++i)
+            {
+                const uint32_t y = clamp(int(y0 + i) - kSSIMRadius, 0, int(height) - 1);
+                const float* rowA = imageA.getRow(y);
+                const float* rowB = imageB.getRow(y);
+                for (uint32_t x = 0; x < paddedWidth; ++x)
+                {
+                    const uint32_t sx = clamp(int(x) - kSSIMRadius, 0, int(width) - 1);
+                    lumA[x] = luminance(rowA + 4 * sx);
+                    lumB[x] = luminance(rowB + 4 * sx);
+                }
+
+                float* dst = moments.data() + 5 * size_t(i) * width;
+                std::fill(dst, dst + 5 * width, 0.f);
+                for (size_t k = 0; k < weights.size(); ++k)
+                {
+                    const float w = weights[k];
+                    const float* a = lumA.data() + k;
+                    const float* b = lumB.data() + k;
+                    for (uint32_t x = 0; x < width; ++x)
+                    {
+                        dst[x] += w * a[x];
+                        dst[width + x] += w * b[x];
+                        dst[2 * width + x] += w * a[x] * a[x];
+                        dst[3 * width + x] += w * b[x] * b[x];
+                        dst[4 * width + x] += w * a[x] * b[x];
+                    }
+                }
+            }
+
+            // Vertical filter and per-pixel SSIM.
+            std::vector<float> filtered(5 * size_t(width));
+            std::vector<float> errors(width);
+            double sum = 0.0;
+            for (uint32_t y = y0; y < y1; ++y)
+            {
+                std::fill(filtered.begin(), filtered.end(), 0.f);
+                for (size_t k = 0; k < weights.size(); ++k)
+                {
+                    const float w = weights[k];
+                    const float* src = moments.data() + 5 * (size_t(y - y0) + k) * width;
+                    for (uint32_t x = 0; x < 5 * width; ++x)
+                        filtered[x] += w * src[x];
+                }
+
+                const float* meanA = filtered.data();
+                const float* meanB = meanA + width;
+                const float* meanAA = meanB + width;
+                const float* meanBB = meanAA + width;
+                const float* meanAB = meanBB + width;
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    const float varA = meanAA[x] - sqr(meanA[x]);
+                    const float varB = meanBB[x] - sqr(meanB[x]);
+                    const float covAB = meanAB[x] - meanA[x] * meanB[x];
+                    const float ssim = ((2.f * meanA[x] * meanB[x] + kSSIMC1) * (2.f * covAB + kSSIMC2)) /
+                                       ((sqr(meanA[x]) + sqr(meanB[x]) + kSSIMC1) * (varA + varB + kSSIMC2));
+                    errors[x] = 1.f - ssim;
+                }
+
+                if (errorMap)
+                    std::copy(errors.begin(), errors.end(), errorMap + size_t(y) * width);
+                sum += sumValues(errors.data(), width);
+            }
+            return sum;
+        }
+    );
+}
+
+const std::vector<ErrorMetric> kErrorMetrics = {
+    {"mse", "Mean Squared Error", comparePixels<MSE>},
+    {"rmse", "Relative Mean Squared Error", comparePixels<RMSE>},
+    {"mae", "Mean Absolute Error", comparePixels<MAE>},
+    {"mape", "Mean Absolute Percentage Error", comparePixels<MAPE>},
+    {"ssim", "Structural Dissimilarity (1 - SSIM) of luminance", compareSSIM},
+    {"flip", "FLIP perceptual error (LDR)", compareFLIP},
+};
+} // namespace
+
+const std::vector<ErrorMetric>& getErrorMetrics()
+{
+    return kErrorMetrics;
+}
+
+const ErrorMetric* findErrorMetric(const std::string& name)
+{
+    auto it = std::find_if(kErrorMetrics.begin(), kErrorMetrics.end(), [&name](const ErrorMetric& metric) { return metric.name == name; });
+    return it != kErrorMetrics.end() ? &*it : nullptr;
+}
+
+CompareResult runTiled(
+    uint32_t width,
+    uint32_t height,
+    uint32_t tileHeight,
+    bool allowEarlyExit,
+    float threshold,
+    const std::function<double(uint32_t y0, uint32_t y1)>& kernel
+)
+{
+    const uint32_t tileCount = (height + tileHeight - 1) / tileHeight;
+    const double pixelCount = double(width) * height;
+
+    std::vector<uint32_t> tiles(tileCount);
+    std::iota(tiles.begin(), tiles.end(), 0);
+    std::vector<double> tileSums(tileCount, 0.0);
+
+    std::mutex mutex;
+    double partialSum = 0.0;
+    std::atomic<bool> exceeded{false};
+
+    std::for_each(
+        std::execution::par,
+        tiles.begin(),
+        tiles.end(),
+        [&](uint32_t tile)
+        {
+            if (exceeded.load(std::memory_order_relaxed))
+                return;
+
+            const uint32_t y0 = tile * tileHeight;
+            const uint32_t y1 = std::min(height, y0 + tileHeight);
+            const double sum = kernel(y0, y1);
+            tileSums[tile] = sum;
+
+            if (allowEarlyExit)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                partialSum += sum;
+                if (partialSum / pixelCount > threshold)
+                    exceeded = true;
+            }
+        }
+    );
+
+    // Sum in tile order so that the result does not depend on scheduling.
+    CompareResult result;
+    result.error = std::accumulate(tileSums.begin(), tileSums.end(), 0.0) / pixelCount;
+    result.exitedEarly = exceeded;
+    return result;
+}
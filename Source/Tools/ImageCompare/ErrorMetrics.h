@@ -0,0 +1,91 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Image.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+struct CompareOptions
+{
+    bool alpha = false;     ///< Include alpha channel (per-pixel metrics only).
+    float threshold = 0.f;  ///< Error threshold.
+    bool earlyExit = false; ///< Stop comparing as soon as the error is known to exceed the threshold (ignored when writing an error map).
+};
+
+struct CompareResult
+{
+    double error = 0.0;       ///< Mean error over all pixels. Lower bound of the mean error if the comparison exited early.
+    bool exitedEarly = false; ///< True if the comparison stopped early because the threshold was exceeded.
+};
+
+struct ErrorMetric
+{
+    using CompareFunc = std::function<CompareResult(const Image& imageA, const Image& imageB, const CompareOptions& options, float* errorMap)>;
+
+    std::string name;
+    std::string desc;
+    CompareFunc compare;
+};
+
+/** Returns the list of available error metrics.
+ */
+const std::vector<ErrorMetric>& getErrorMetrics();
+
+/** Returns the error metric with the given name or nullptr if it does not exist.
+ */
+const ErrorMetric* findErrorMetric(const std::string& name);
+
+/** Run a row band kernel over an image in parallel.
+    The image is split into bands of tileHeight rows. For each band, the kernel is called with the
+    row range [y0, y1) and returns the sum of the per-pixel errors in that band. All per-pixel errors
+    are assumed to be non-negative, which allows stopping early once the partial mean exceeds the threshold.
+    Band sums are accumulated in a fixed order so results are deterministic.
+    @param[in] width Image width.
+    @param[in] height Image height.
+    @param[in] tileHeight Number of rows per band.
+    @param[in] allowEarlyExit Allow stopping early once the threshold is exceeded.
+    @param[in] threshold Error threshold.
+    @param[in] kernel Band kernel with signature double(uint32_t y0, uint32_t y1).
+    @return The comparison result.
+*/
+CompareResult runTiled(
+    uint32_t width,
+    uint32_t height,
+    uint32_t tileHeight,
+    bool allowEarlyExit,
+    float threshold,
+    const std::function<double(uint32_t y0, uint32_t y1)>& kernel
+);
+
+/** Compute the FLIP error between two images on the CPU.
+    This is a port of the LDR-FLIP evaluator used by FLIPPass, using separable filters.
+    Input colors are treated as linear RGB and clamped to [0, 1]. Viewing conditions match the FLIPPass defaults.
+*/
+CompareResult compareFLIP(const Image& imageA, const Image& imageB, const CompareOptions& options, float* errorMap);
@@ -0,0 +1,419 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ErrorMetrics.h"
+
+#include <cmath>
+
+/** CPU port of the LDR-FLIP image difference evaluator used by FLIPPass (see FLIPPass.cs.slang).
+
+    FLIP: A Difference Evaluator for Alternating Images
+    High Performance Graphics 2020,
+    by Pontus Andersson, Jim Nilsson, Tomas Akenine-Moller,
+    Magnus Oskarsson, Kalle Astrom, and Mark D. Fairchild.
+
+    The GPU version evaluates the full 2D filter footprint per pixel. All FLIP filters are sums of
+    separable kernels, so here they are evaluated as a horizontal pass over a band of rows followed
+    by a vertical pass, which is considerably cheaper for the default viewing conditions.
+*/
+
+namespace
+{
+// Viewing conditions, matching the FLIPPass defaults.
+const float kMonitorDistanceMeters = 0.7f;
+const float kMonitorWidthMeters = 0.7f;
+const uint32_t kMonitorWidthPixels = 3840;
+
+// FLIP constants.
+const float kQc = 0.7f;
+const float kPc = 0.4f;
+const float kPt = 0.95f;
+const float kW = 0.082f;
+const float kQf = 0.5f;
+
+const float kPi = 3.14159265358979323846f;
+const float kSqrt1_2 = 0.70710678118654752440f;
+
+const uint32_t kTileHeight = 64;
+
+struct Color
+{
+    float x, y, z;
+};
+
+// Color space conversions, matching Utils/Color/ColorHelpers.slang (D65 reference illuminant).
+
+Color linearRGBToXYZ(Color c)
+{
+    return {
+        (10135552.0f / 24577794.0f) * c.x + (8788810.0f / 24577794.0f) * c.y + (4435075.0f / 24577794.0f) * c.z,
+        (2613072.0f / 12288897.0f) * c.x + (8788810.0f / 12288897.0f) * c.y + (887015.0f / 12288897.0f) * c.z,
+        (1425312.0f / 73733382.0f) * c.x + (8788810.0f / 73733382.0f) * c.y + (70074185.0f / 73733382.0f) * c.z,
+    };
+}
+
+Color XYZToLinearRGB(Color c)
+{
+    return {
+        3.241003275f * c.x - 1.537398934f * c.y - 0.498615861f * c.z,
+        -0.969224334f * c.x + 1.875930071f * c.y + 0.041554224f * c.z,
+        0.055639423f * c.x - 0.204011202f * c.y + 1.057148933f * c.z,
+    };
+}
+
+Color XYZToCIELab(Color c)
+{
+    const float delta = 6.0f / 29.0f;
+    const float deltaCube = delta * delta * delta;
+    const float factor = 1.0f / (3.0f * delta * delta);
+    const float term = 4.0f / 29.0f;
+    auto f = [&](float t) { return t > deltaCube ? std::cbrt(t) : factor * t + term; };
+
+    const float fx = f(c.x * 1.052156925f);
+    const float fy = f(c.y);
+    const float fz = f(c.z * 0.918357670f);
+    return {116.0f * fy - 16.0f, 500.0f * (fx - fy), 200.0f * (fy - fz)};
+}
+
+Color XYZToYCxCz(Color c)
+{
+    const float x = c.x * 1.052156925f;
+    const float z = c.z * 0.918357670f;
+    return {116.0f * c.y - 16.0f, 500.0f * (x - c.y), 200.0f * (c.y - z)};
+}
+
+Color YCxCzToXYZ(Color c)
+{
+    const float y = (c.x + 16.0f) / 116.0f;
+    const float x = c.y / 500.0f + y;
+    const float z = y - c.z / 200.0f;
+    return {x * 0.950428545f, y, z * 1.088900371f};
+}
+
+Color clampColor(Color c)
+{
+    return {clamp(c.x, 0.f, 1.f), clamp(c.y, 0.f, 1.f), clamp(c.z, 0.f, 1.f)};
+}
+
+Color hunt(Color c)
+{
+    const float huntValue = 0.01f * c.x;
+    return {c.x, huntValue * c.y, huntValue * c.z};
+}
+
+float HyAB(Color a, Color b)
+{
+    return std::fabs(a.x - b.x) + std::sqrt(sqr(a.y - b.y) + sqr(a.z - b.z));
+}
+
+float redistributeErrors(float colorDifference, float featureDifference, float maxDistance)
+{
+    float error = std::pow(colorDifference, kQc);
+
+    // Normalization.
+    const float perceptualCutoff = kPc * maxDistance;
+    if (error < perceptualCutoff)
+        error *= kPt / perceptualCutoff;
+    else
+        error = kPt + ((error - perceptualCutoff) / (maxDistance - perceptualCutoff)) * (1.0f - kPt);
+
+    return std::pow(error, 1.0f - featureDifference);
+}
+
+/// 1D filter kernels of size 2 * radius + 1.
+struct Kernels
+{
+    int radius = 0;
+
+    // Contrast sensitivity filters for the Y, Cx and Cz channels, each normalized to unit sum.
+    // The Cz filter is a weighted sum of two Gaussians.
+    std::vector<float> csfA;
+    std::vector<float> csfRG;
+    std::vector<float> csfBY1;
+    std::vector<float> csfBY2;
+    float weightBY1 = 0.f;
+    float weightBY2 = 0.f;
+
+    // Feature detection filters. The 2D edge/point filters are the outer product of edge/point with gauss.
+    std::vector<float> gauss;
+    std::vector<float> edge;
+    std::vector<float> point;
+};
+
+float sumKernel(const std::vector<float>& values)
+{
+    float result = 0.f;
+    for (float v : values)
+        result += v;
+    return result;
+}
+
+void scale(std::vector<float>& values, float factor)
+{
+    for (float& v : values)
+        v *= factor;
+}
+
+Kernels createKernels(float pixelsPerDegree)
+{
+    Kernels kernels;
+
+    // Use radius of the spatial filter kernel, as it is always greater than or equal to the radius of the feature detection kernel.
+    const int radius = int(std::ceil(3.0f * std::sqrt(0.04f / (2.0f * kPi * kPi)) * pixelsPerDegree));
+    const size_t size = 2 * radius + 1;
+    kernels.radius = radius;
+
+    // Contrast sensitivity. The 2D weight of each term is a * sqrt(pi / b) * exp(-pi^2 * |p|^2 / b) with p in degrees.
+    const float dx = 1.0f / pixelsPerDegree;
+    auto csf = [&](float b)
+    {
+        std::vector<float> kernel(size);
+        for (int x = -radius; x <= radius; ++x)
+            kernel[x + radius] = std::exp(-sqr(x * dx) * kPi * kPi / b);
+        return kernel;
+    };
+
+    kernels.csfA = csf(0.0047f);
+    kernels.csfRG = csf(0.0053f);
+    kernels.csfBY1 = csf(0.04f);
+    kernels.csfBY2 = csf(0.025f);
+    const float sumBY1 = 34.1f * std::sqrt(kPi / 0.04f) * sqr(sumKernel(kernels.csfBY1));
+    const float sumBY2 = 13.5f * std::sqrt(kPi / 0.025f) * sqr(sumKernel(kernels.csfBY2));
+    kernels.weightBY1 = sumBY1 / (sumBY1 + sumBY2);
+    kernels.weightBY2 = sumBY2 / (sumBY1 + sumBY2);
+    for (auto* kernel : {&kernels.csfA, &kernels.csfRG, &kernels.csfBY1, &kernels.csfBY2})
+        scale(*kernel, 1.f / sumKernel(*kernel));
+
+    // Feature detection. Positive and negative lobes of the point filter are normalized separately.
+    const float sigmaFeatures = 0.5f * kW * pixelsPerDegree;
+    kernels.gauss.resize(size);
+    kernels.edge.resize(size);
+    kernels.point.resize(size);
+    float edgeSum = 0.f;
+    float pointPositiveSum = 0.f;
+    float pointNegativeSum = 0.f;
+    for (int x = -radius; x <= radius; ++x)
+    {
+        const float g = std::exp(-float(x * x) / (2.0f * sqr(sigmaFeatures)));
+        const float e = -x * g;
+        const float p = (x * x / sqr(sigmaFeatures) - 1.f) * g;
+        kernels.gauss[x + radius] = g;
+        kernels.edge[x + radius] = e;
+        kernels.point[x + radius] = p;
+        edgeSum += std::max(e, 0.f);
+        pointPositiveSum += std::max(p, 0.f);
+        pointNegativeSum += std::max(-p, 0.f);
+    }
+    scale(kernels.gauss, 1.f / sumKernel(kernels.gauss));
+    scale(kernels.edge, 1.f / edgeSum);
+    for (float& p : kernels.point)
+        p /= p >= 0.f ? pointPositiveSum : pointNegativeSum;
+
+    return kernels;
+}
+
+/// Planes produced by the horizontal filter pass.
+enum Plane
+{
+    kPlaneA,     ///< Y filtered with csfA.
+    kPlaneRG,    ///< Cx filtered with csfRG.
+    kPlaneBY1,   ///< Cz filtered with csfBY1.
+    kPlaneBY2,   ///< Cz filtered with csfBY2.
+    kPlaneGauss, ///< Luminance filtered with gauss.
+    kPlaneEdge,  ///< Luminance filtered with edge.
+    kPlanePoint, ///< Luminance filtered with point.
+    kPlaneCount,
+};
+
+/// dst[x] = sum_k kernel[k] * src[x + k]
+void convolveRow(const float* src, const std::vector<float>& kernel, float* dst, uint32_t width)
+{
+    std::fill(dst, dst + width, 0.f);
+    for (size_t k = 0; k < kernel.size(); ++k)
+    {
+        const float w = kernel[k];
+        const float* s = src + k;
+        for (uint32_t x = 0; x < width; ++x)
+            dst[x] += w * s[x];
+    }
+}
+
+/// dst[x] += w * src[x]
+void accumulateRow(const float* src, float w, float* dst, uint32_t width)
+{
+    for (uint32_t x = 0; x < width; ++x)
+        dst[x] += w * src[x];
+}
+
+/** Filters one image over a band of rows.
+    The horizontal pass is run over the band and its halo, the vertical pass then produces the
+    filtered colors and feature gradients of one output row at a time.
+*/
+class BandFilter
+{
+public:
+    struct Row
+    {
+        const float* Y;
+        const float* Cx;
+        const float* Cz;
+        const float* edgeX;
+        const float* edgeY;
+        const float* pointX;
+        const float* pointY;
+    };
+
+    BandFilter(const Image& image, const Kernels& kernels, uint32_t y0, uint32_t y1)
+        : mKernels(kernels), mY0(y0), mWidth(image.getWidth()), mOutput(7 * size_t(mWidth))
+    {
+        const int radius = kernels.radius;
+        const uint32_t haloHeight = y1 - y0 + 2 * radius;
+        const uint32_t paddedWidth = mWidth + 2 * radius;
+
+        mPlanes.resize(kPlaneCount * size_t(haloHeight) * mWidth);
+        std::vector<float> Y(paddedWidth);
+        std::vector<float> Cx(paddedWidth);
+        std::vector<float> Cz(paddedWidth);
+        std::vector<float> L(paddedWidth);
+
+        for (uint32_t i = 0; i < haloHeight; ++i)
+        {
+            const uint32_t y = clamp(int(y0 + i) - radius, 0, int(image.getHeight()) - 1);
+            const float* row = image.getRow(y);
+            for (uint32_t x = 0; x < paddedWidth; ++x)
+            {
+                const float* rgba = row + 4 * clamp(int(x) - radius, 0, int(mWidth) - 1);
+                const Color c = XYZToYCxCz(linearRGBToXYZ(clampColor({rgba[0], rgba[1], rgba[2]})));
+                Y[x] = c.x;
+                Cx[x] = c.y;
+                Cz[x] = c.z;
+                L[x] = (c.x + 16.0f) / 116.0f; // Normalized Y from YCxCz.
+            }
+
+            convolveRow(Y.data(), kernels.csfA, getPlane(i, kPlaneA), mWidth);
+            convolveRow(Cx.data(), kernels.csfRG, getPlane(i, kPlaneRG), mWidth);
+            convolveRow(Cz.data(), kernels.csfBY1, getPlane(i, kPlaneBY1), mWidth);
+            convolveRow(Cz.data(), kernels.csfBY2, getPlane(i, kPlaneBY2), mWidth);
+            convolveRow(L.data(), kernels.gauss, getPlane(i, kPlaneGauss), mWidth);
+            convolveRow(L.data(), kernels.edge, getPlane(i, kPlaneEdge), mWidth);
+            convolveRow(L.data(), kernels.point, getPlane(i, kPlanePoint), mWidth);
+        }
+    }
+
+    /// Run the vertical pass for image row y. The returned pointers are valid until the next call.
+    Row filterRow(uint32_t y)
+    {
+        std::fill(mOutput.begin(), mOutput.end(), 0.f);
+        float* Y = mOutput.data();
+        float* Cx = Y + mWidth;
+        float* Cz = Cx + mWidth;
+        float* edgeX = Cz + mWidth;
+        float* edgeY = edgeX + mWidth;
+        float* pointX = edgeY + mWidth;
+        float* pointY = pointX + mWidth;
+
+        const Kernels& k = mKernels;
+        for (int j = 0; j <= 2 * k.radius; ++j)
+        {
+            const uint32_t i = y - mY0 + j;
+            accumulateRow(getPlane(i, kPlaneA), k.csfA[j], Y, mWidth);
+            accumulateRow(getPlane(i, kPlaneRG), k.csfRG[j], Cx, mWidth);
+            accumulateRow(getPlane(i, kPlaneBY1), k.weightBY1 * k.csfBY1[j], Cz, mWidth);
+            accumulateRow(getPlane(i, kPlaneBY2), k.weightBY2 * k.csfBY2[j], Cz, mWidth);
+            accumulateRow(getPlane(i, kPlaneEdge), k.gauss[j], edgeX, mWidth);
+            accumulateRow(getPlane(i, kPlaneGauss), k.edge[j], edgeY, mWidth);
+            accumulateRow(getPlane(i, kPlanePoint), k.gauss[j], pointX, mWidth);
+            accumulateRow(getPlane(i, kPlaneGauss), k.point[j], pointY, mWidth);
+        }
+
+        return {Y, Cx, Cz, edgeX, edgeY, pointX, pointY};
+    }
+
+private:
+    float* getPlane(uint32_t haloRow, Plane plane) { return mPlanes.data() + (size_t(haloRow) * kPlaneCount + plane) * mWidth; }
+
+    const Kernels& mKernels;
+    uint32_t mY0;
+    uint32_t mWidth;
+    std::vector<float> mPlanes;
+    std::vector<float> mOutput;
+};
+} // namespace
+
+CompareResult compareFLIP(const Image& imageA, const Image& imageB, const CompareOptions& options, float* errorMap)
+{
+    const float pixelsPerDegree = kMonitorDistanceMeters * (kMonitorWidthPixels / kMonitorWidthMeters) * (kPi / 180.0f);
+    const Kernels kernels = createKernels(pixelsPerDegree);
+    const float maxDistance =
+        std::pow(HyAB(hunt(XYZToCIELab(linearRGBToXYZ({0.f, 1.f, 0.f}))), hunt(XYZToCIELab(linearRGBToXYZ({0.f, 0.f, 1.f})))), kQc);
+
+    const uint32_t width = imageA.getWidth();
+
+    return runTiled(
+        width,
+        imageA.getHeight(),
+        kTileHeight,
+        options.earlyExit && !errorMap,
+        options.threshold,
+        [&](uint32_t y0, uint32_t y1)
+        {
+            BandFilter reference(imageA, kernels, y0, y1);
+            BandFilter test(imageB, kernels, y0, y1);
+            std::vector<float> errors(width);
+            double sum = 0.0;
+
+            for (uint32_t y = y0; y < y1; ++y)
+            {
+                const BandFilter::Row r = reference.filterRow(y);
+                const BandFilter::Row t = test.filterRow(y);
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    // Color pipeline.
+                    const Color filteredReference = clampColor(XYZToLinearRGB(YCxCzToXYZ({r.Y[x], r.Cx[x], r.Cz[x]})));
+                    const Color filteredTest = clampColor(XYZToLinearRGB(YCxCzToXYZ({t.Y[x], t.Cx[x], t.Cz[x]})));
+                    const float colorDiff =
+                        HyAB(hunt(XYZToCIELab(linearRGBToXYZ(filteredReference))), hunt(XYZToCIELab(linearRGBToXYZ(filteredTest))));
+
+                    // Feature pipeline.
+                    const float edgeDifference =
+                        std::fabs(std::hypot(r.edgeX[x], r.edgeY[x]) - std::hypot(t.edgeX[x], t.edgeY[x]));
+                    const float pointDifference =
+                        std::fabs(std::hypot(r.pointX[x], r.pointY[x]) - std::hypot(t.pointX[x], t.pointY[x]));
+                    const float featureDiff = std::pow(std::max(pointDifference, edgeDifference) * kSqrt1_2, kQf);
+
+                    errors[x] = redistributeErrors(colorDiff, featureDiff, maxDistance);
+                }
+
+                if (errorMap)
+                    std::copy(errors.begin(), errors.end(), errorMap + size_t(y) * width);
+                for (float e : errors)
+                    sum += e;
+            }
+            return sum;
+        }
+    );
+}
@@ -0,0 +1,88 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <algorithm>
+
+#include <cstdint>
+
+template<typename T>
+T sqr(T x)
+{
+    return x * x;
+}
+
+template<typename T>
+T lerp(T a, T b, T t)
+{
+    return a + t * (b - a);
+}
+
+template<typename T>
+T clamp(T x, T lo, T hi)
+{
+    return std::max(lo, std::min(hi, x));
+}
+
+/** Simple RGBA32F image stored in top-down row order.
+ */
+class Image
+{
+public:
+    Image(uint32_t width, uint32_t height) : mWidth(width), mHeight(height), mData(std::make_unique<float[]>(size_t(width) * height * 4)) {}
+
+    uint32_t getWidth() const { return mWidth; }
+    uint32_t getHeight() const { return mHeight; }
+    const float* getData() const { return mData.get(); }
+    float* getData() { return mData.get(); }
+
+    const float* getRow(uint32_t y) const { return mData.get() + size_t(y) * mWidth * 4; }
+    float* getRow(uint32_t y) { return mData.get() + size_t(y) * mWidth * 4; }
+
+    static std::shared_ptr<Image> create(uint32_t width, uint32_t height) { return std::make_shared<Image>(width, height); }
+
+    /** Load an image from file.
+        Float RGBA/RGB images (e.g. EXR) are copied directly into the image without an intermediate conversion bitmap.
+        Throws std::runtime_error on failure.
+    */
+    static std::shared_ptr<Image> loadFromFile(const std::filesystem::path& path);
+
+    /** Save the image to file. Throws std::runtime_error on failure.
+     */
+    void saveToFile(const std::filesystem::path& path, bool writeAlpha = true) const;
+
+    /** Check if a file has an image format that can be loaded.
+     */
+    static bool isSupportedFile(const std::filesystem::path& path);
+
+private:
+    uint32_t mWidth;
+    uint32_t mHeight;
+    std::unique_ptr<float[]> mData;
+};
@@ -0,0 +1,233 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ImageComparison.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <cmath>
+
+namespace
+{
+std::shared_ptr<Image> generateHeatMap(uint32_t width, uint32_t height, const float* errorMap)
+{
+    auto writeColor = [](float t, float* dst)
+    {
+        static const float colors[5][3] = {
+            {0.f, 0.f, 1.f}, // blue
+            {0.f, 1.f, 1.f}, // teal
+            {0.f, 1.f, 0.f}, // green
+            {1.f, 1.f, 0.f}, // yellow
+            {1.f, 0.f, 0.f}, // red
+        };
+
+        int c = clamp(int(std::floor(t * 4.f)), 0, 3);
+        for (size_t i = 0; i < 3; ++i)
+            *dst++ = lerp(colors[c][i], colors[c + 1][i], t * 4.f - c);
+        *dst++ = 1.f;
+    };
+
+    const auto [minValue, maxValue] = std::minmax_element(errorMap, errorMap + size_t(width) * height);
+    const float range = std::max(1e-5f, *maxValue - *minValue);
+    auto image = Image::create(width, height);
+    float* dst = image->getData();
+    for (size_t i = 0; i < size_t(width) * height; ++i)
+    {
+        float t = clamp((errorMap[i] - *minValue) / range, 0.f, 1.f);
+        writeColor(t, dst);
+        dst += 4;
+    }
+
+    return image;
+}
+} // namespace
+
+ImageResult compareImages(
+    const std::filesystem::path& pathA,
+    const std::filesystem::path& pathB,
+    const ErrorMetric& metric,
+    const CompareOptions& options,
+    const std::filesystem::path& heatMapPath
+)
+{
+    ImageResult result;
+
+    // Load both images concurrently.
+    auto loadImage = [](const std::filesystem::path& path, std::string& message)
+    {
+        try
+        {
+            return Image::loadFromFile(path);
+        }
+        catch (const std::runtime_error& e)
+        {
+            message = "Cannot load image from '" + path.string() + "' (Error: " + e.what() + ").";
+            return std::shared_ptr<Image>{};
+        }
+    };
+    std::string messageB;
+    auto futureB = std::async(std::launch::async, loadImage, pathB, std::ref(messageB));
+    auto imageA = loadImage(pathA, result.message);
+    auto imageB = futureB.get();
+    if (!imageA)
+        return result;
+    if (!imageB)
+    {
+        result.message = messageB;
+        return result;
+    }
+
+    // Check resolution.
+    if (imageA->getWidth() != imageB->getWidth() || imageA->getHeight() != imageB->getHeight())
+    {
+        result.message = "Cannot compare images with different resolutions.";
+        return result;
+    }
+
+    uint32_t width = imageA->getWidth();
+    uint32_t height = imageA->getHeight();
+
+    // Compare images.
+    std::unique_ptr<float[]> errorMap = heatMapPath.empty() ? nullptr : std::make_unique<float[]>(size_t(width) * height);
+    CompareResult compareResult = metric.compare(*imageA, *imageB, options, errorMap.get());
+    result.compared = true;
+    result.error = compareResult.error;
+    result.exitedEarly = compareResult.exitedEarly;
+
+    // Generate heat map.
+    if (errorMap)
+    {
+        auto heatMap = generateHeatMap(width, height, errorMap.get());
+        try
+        {
+            heatMap->saveToFile(heatMapPath);
+        }
+        catch (const std::runtime_error& e)
+        {
+            result.message = "Cannot save image to '" + heatMapPath.string() + "' (Error: " + e.what() + ").";
+        }
+    }
+
+    // Treat nans and infs as errors.
+    result.passed = !std::isnan(result.error) && !std::isinf(result.error) && result.error <= options.threshold;
+    return result;
+}
+
+nlohmann::json toJson(const ImageResult& result)
+{
+    nlohmann::json json = {
+        {"name", result.name},
+        {"error", result.error},
+        {"passed", result.passed},
+        {"exitedEarly", result.exitedEarly},
+    };
+    if (!result.message.empty())
+        json["message"] = result.message;
+    return json;
+}
+
+std::vector<ImageResult> compareDirectories(
+    const std::filesystem::path& dirA,
+    const std::filesystem::path& dirB,
+    const ErrorMetric& metric,
+    const CompareOptions& options,
+    const std::filesystem::path& heatMapDir,
+    uint32_t jobCount
+)
+{
+    if (!std::filesystem::is_directory(dirA) || !std::filesystem::is_directory(dirB))
+        throw std::runtime_error("Batch mode requires two directories.");
+
+    std::vector<std::filesystem::path> names;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dirA))
+    {
+        if (entry.is_regular_file() && Image::isSupportedFile(entry.path()))
+            names.push_back(std::filesystem::relative(entry.path(), dirA));
+    }
+    std::sort(names.begin(), names.end());
+
+    std::vector<ImageResult> results(names.size());
+    std::atomic<size_t> nextIndex{0};
+    auto worker = [&]()
+    {
+        for (size_t i = nextIndex++; i < names.size(); i = nextIndex++)
+        {
+            const auto& name = names[i];
+            std::filesystem::path heatMapPath;
+            if (!heatMapDir.empty())
+            {
+                heatMapPath = heatMapDir / name;
+                heatMapPath.replace_extension(".png");
+                std::error_code ec;
+                std::filesystem::create_directories(heatMapPath.parent_path(), ec);
+            }
+
+            if (std::filesystem::exists(dirB / name))
+            {
+                results[i] = compareImages(dirA / name, dirB / name, metric, options, heatMapPath);
+            }
+            else
+            {
+                results[i].message = "Missing image '" + (dirB / name).string() + "'.";
+            }
+            results[i].name = name.generic_string();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < std::max(jobCount, 1u); ++i)
+        workers.emplace_back(worker);
+    for (auto& thread : workers)
+        thread.join();
+
+    return results;
+}
+
+nlohmann::json createBatchReport(const ErrorMetric& metric, const CompareOptions& options, const std::vector<ImageResult>& results, double duration)
+{
+    bool passed = true;
+    nlohmann::json images = nlohmann::json::array();
+    for (const auto& result : results)
+    {
+        passed &= result.passed;
+        images.push_back(toJson(result));
+    }
+
+    return {
+        {"metric", metric.name},
+        {"threshold", options.threshold},
+        {"passed", passed},
+        {"duration", duration},
+        {"images", images},
+    };
+}
@@ -0,0 +1,90 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "ErrorMetrics.h"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct ImageResult
+{
+    std::string name;
+    bool compared = false; ///< True if the images were loaded and compared.
+    double error = 0.0;
+    bool passed = false;
+    bool exitedEarly = false;
+    std::string message;
+};
+
+/** Compare two image files.
+    Load errors and resolution mismatches are reported in the result message.
+    @param[in] pathA Path of the reference image.
+    @param[in] pathB Path of the test image.
+    @param[in] metric Error metric.
+    @param[in] options Compare options.
+    @param[in] heatMapPath Path of the error heat map to write (empty to skip).
+    @return The comparison result.
+*/
+ImageResult compareImages(
+    const std::filesystem::path& pathA,
+    const std::filesystem::path& pathB,
+    const ErrorMetric& metric,
+    const CompareOptions& options,
+    const std::filesystem::path& heatMapPath
+);
+
+/** Compare all images in directory A against the images with the same relative path in directory B.
+    Image pairs are compared on jobCount worker threads, each comparison is itself parallelized.
+    Throws std::runtime_error if either path is not a directory.
+    @param[in] dirA Directory of the reference images.
+    @param[in] dirB Directory of the test images.
+    @param[in] metric Error metric.
+    @param[in] options Compare options.
+    @param[in] heatMapDir Directory to write error heat maps to (empty to skip).
+    @param[in] jobCount Number of image pairs compared concurrently.
+    @return The comparison results, sorted by relative path.
+*/
+std::vector<ImageResult> compareDirectories(
+    const std::filesystem::path& dirA,
+    const std::filesystem::path& dirB,
+    const ErrorMetric& metric,
+    const CompareOptions& options,
+    const std::filesystem::path& heatMapDir,
+    uint32_t jobCount
+);
+
+/** Convert a comparison result to its JSON report entry.
+ */
+nlohmann::json toJson(const ImageResult& result);
+
+/** Create the JSON report of a batch comparison.
+ */
+nlohmann::json createBatchReport(const ErrorMetric& metric, const CompareOptions& options, const std::vector<ImageResult>& results, double duration);
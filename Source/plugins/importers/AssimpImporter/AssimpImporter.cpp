@@ -32,10 +32,12 @@
 #include "Utils/StringUtils.h"
 #include "Utils/NumericRange.h"
 #include "Utils/Timing/TimeReport.h"
+#include "Utils/Timing/Tracer.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/FalcorMath.h"
 #include "Scene/Importer.h"
 #include "Scene/SceneBuilder.h"
+#include "Scene/NativeMeshLoader.h"
 #include "Scene/Material/Material.h"
 #include "Scene/Material/StandardMaterial.h"
 
@@ -598,6 +600,7 @@ void createMeshes(ImporterData& data)
             const aiMesh* pAiMesh = meshes[i];
             if (!pAiMesh)
                 return;
+            FALCOR_TRACE_SCOPE_DETAIL("AssimpImporter::processMesh", pAiMesh->mName.C_Str());
             const uint32_t perFaceIndexCount = pAiMesh->mFaces[0].mNumIndices;
 
             SceneBuilder::Mesh mesh;
@@ -1106,8 +1109,47 @@ void dumpAssimpData(ImporterData& data)
     logInfo(out);
 }
 
+/**
+ * Import a PLY file with NativeMeshLoader, bypassing Assimp and its post-processing passes (SceneBuilder::Flags::UseNativeMeshLoader).
+ * PLY files hold a single mesh without materials, so the scene consists of a single mesh instance using a
+ * default material equivalent to the one Assimp creates.
+ */
+void importNativePLY(const std::filesystem::path& path, SceneBuilder& builder)
+{
+    TimeReport timeReport;
+
+    NativeMeshLoader::MeshData data;
+    try
+    {
+        data = NativeMeshLoader::loadPLY(path);
+    }
+    catch (const RuntimeError& e)
+    {
+        throw ImporterError(path, "Failed to open scene: {}", e.what());
+    }
+    if (data.normals.empty())
+        data.generateSmoothNormals();
+
+    timeReport.measure("Loading asset file");
+
+    ref<StandardMaterial> pMaterial = StandardMaterial::create(builder.getDevice(), "DefaultMaterial");
+    pMaterial->setBaseColor(float4(0.6f, 0.6f, 0.6f, 1.f));
+
+    const std::string name = path.stem().string();
+    NodeID nodeID = builder.addNode(SceneBuilder::Node{name, float4x4::identity()});
+    MeshID meshID = builder.addMesh(data.getSceneBuilderMesh(name, pMaterial));
+    builder.addMeshInstance(nodeID, meshID);
+
+    timeReport.measure("Creating meshes");
+    timeReport.printToLog();
+}
+
 void importInternal(const void* buffer, size_t byteSize, const std::filesystem::path& path, SceneBuilder& builder)
 {
+    if (is_set(builder.getFlags(), SceneBuilder::Flags::UseNativeMeshLoader) && !path.empty() && path.is_absolute() &&
+        hasExtension(path, "ply"))
+        return importNativePLY(path, builder);
+
     TimeReport timeReport;
 
     const SceneBuilder::Flags builderFlags = builder.getFlags();
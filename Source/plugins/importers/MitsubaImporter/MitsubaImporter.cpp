@@ -34,9 +34,13 @@
 #include "Scene/Material/PBRT/PBRTDiffuseMaterial.h"
 #include "Scene/Material/PBRT/PBRTDielectricMaterial.h"
 #include "Scene/Material/PBRT/PBRTConductorMaterial.h"
+#include "Utils/JobSystem.h"
+#include "Utils/Timing/CpuTimer.h"
+#include "Utils/Timing/Tracer.h"
 
 #include <pybind11/pybind11.h>
 
+#include <memory>
 #include <unordered_map>
 
 namespace Falcor
@@ -78,11 +82,93 @@ Transform transformFromMatrix4x4(const float4x4& m)
     return t;
 }
 
+bool isMeshFileShape(const std::string& type)
+{
+    return type == "obj" || type == "ply";
+}
+
+TriangleMesh::ImportFlags getMeshImportFlags(const Properties& props)
+{
+    auto faceNormals = props.getBool("face_normals", false);
+    if (faceNormals)
+        return TriangleMesh::ImportFlags::JoinIdenticalVertices;
+
+    // Recommend `faceNormals=false` for inverse/differentiable rendering to avoid vertex duplication.
+    return TriangleMesh::ImportFlags::GenSmoothNormals | TriangleMesh::ImportFlags::JoinIdenticalVertices;
+}
+
+/** Loads the mesh files referenced by shapes on the global job system.
+    Loads are started from the parser as soon as a shape element is closed, so file I/O overlaps with parsing
+    the rest of the document. Results are collected in scene order by buildScene(), which keeps the order of
+    insertion into the scene builder independent of load completion order.
+*/
+class ShapeLoader
+{
+public:
+    ~ShapeLoader()
+    {
+        // Don't let loads of shapes that were never taken outlive the import.
+        for (auto& [id, load] : mLoads)
+        {
+            try
+            {
+                JobSystem::getGlobal().wait(load.job);
+            }
+            catch (const std::exception&)
+            {
+            }
+        }
+    }
+
+    void enqueue(const XMLObject& inst)
+    {
+        if (inst.cls != Class::Shape || !isMeshFileShape(inst.type) || !inst.props.hasString("filename"))
+            return;
+
+        auto filename = inst.props.getString("filename");
+        auto flags = getMeshImportFlags(inst.props);
+        auto pMesh = std::make_shared<ref<TriangleMesh>>();
+        auto load = [filename, flags, pMesh]()
+        {
+            FALCOR_TRACE_SCOPE_DETAIL("MitsubaImporter::loadMesh", std::filesystem::path(filename).filename().string());
+            *pMesh = TriangleMesh::createFromFile(filename, flags);
+        };
+        mLoads.emplace(inst.id, PendingLoad{JobSystem::getGlobal().submit(load), pMesh});
+    }
+
+    /// Returns the mesh loaded for the given shape. Blocks until the load has finished.
+    /// Exceptions thrown by the load are rethrown on the calling thread.
+    ref<TriangleMesh> take(const std::string& id)
+    {
+        auto it = mLoads.find(id);
+        if (it == mLoads.end())
+            return nullptr;
+        auto load = std::move(it->second);
+        mLoads.erase(it);
+        JobSystem::getGlobal().wait(load.job);
+        return std::move(*load.pMesh);
+    }
+
+    bool has(const std::string& id) const { return mLoads.find(id) != mLoads.end(); }
+
+    size_t getPendingCount() const { return mLoads.size(); }
+
+private:
+    struct PendingLoad
+    {
+        JobSystem::JobHandle job;
+        std::shared_ptr<ref<TriangleMesh>> pMesh; ///< Written by the job, valid once the job has finished.
+    };
+
+    std::unordered_map<std::string, PendingLoad> mLoads;
+};
+
 struct BuilderContext
 {
     SceneBuilder& builder;
     std::unordered_map<std::string, XMLObject>& instances;
     std::unordered_set<std::string> warnings;
+    ShapeLoader* pShapeLoader = nullptr;
 
     void forEachReference(const XMLObject& inst, Class cls, std::function<void(const XMLObject&)> func)
     {
@@ -465,27 +551,19 @@ ShapeInfo buildShape(BuilderContext& ctx, const XMLObject& inst)
 
     ShapeInfo shape;
 
-    if (inst.type == "obj" || inst.type == "ply")
+    if (isMeshFileShape(inst.type))
     {
         auto filename = props.getString("filename");
-        auto faceNormals = props.getBool("face_normals", false);
         auto flipTexCoords = props.getBool("flip_tex_coords", true);
 
         if (props.hasBool("flip_tex_coords"))
             ctx.unsupportedParameter("flip_tex_coords");
 
-        TriangleMesh::ImportFlags flags = TriangleMesh::ImportFlags::None;
-        if (faceNormals)
-        {
-            flags = TriangleMesh::ImportFlags::JoinIdenticalVertices;
-        }
+        // Use the mesh loaded in the background during parsing if available.
+        if (ctx.pShapeLoader && ctx.pShapeLoader->has(inst.id))
+            shape.pMesh = ctx.pShapeLoader->take(inst.id);
         else
-        {
-            // Recommend `faceNormals=false` for inverse/differentiable rendering to avoid vertex duplication.
-            flags = TriangleMesh::ImportFlags::GenSmoothNormals | TriangleMesh::ImportFlags::JoinIdenticalVertices;
-        }
-
-        shape.pMesh = TriangleMesh::createFromFile(filename, flags);
+            shape.pMesh = TriangleMesh::createFromFile(filename, getMeshImportFlags(props));
         if (shape.pMesh)
             shape.pMesh->setName(inst.id);
         shape.transform = toWorld;
@@ -804,21 +882,47 @@ void MitsubaImporter::importScene(
 
     try
     {
-        pugi::xml_document doc;
-        auto result = doc.load_file(path.c_str(), pugi::parse_default | pugi::parse_comments);
-        if (!result)
-            throw ImporterError(path, "Failed to parse XML: {}", result.description());
+        auto startTime = CpuTimer::getCurrentTimePoint();
 
-        Mitsuba::XMLSource src{path.string(), doc};
+        Mitsuba::ShapeLoader shapeLoader;
         Mitsuba::XMLContext ctx;
         ctx.resolver.append(std::filesystem::path(path).parent_path());
-        Mitsuba::Properties props;
-        pugi::xml_node root = doc.document_element();
-        size_t argCounter = 0;
-        auto sceneID = Mitsuba::parseXML(src, ctx, root, Mitsuba::Tag::Invalid, props, argCounter).second;
+        ctx.onObjectParsed = [&](const Mitsuba::XMLObject& inst) { shapeLoader.enqueue(inst); };
 
-        Mitsuba::BuilderContext builderCtx{builder, ctx.instances};
+        std::string sceneID;
+        size_t meshLoadCount = 0;
+        {
+            // The XML document is only needed during parsing, release it before building the scene.
+            pugi::xml_document doc;
+            auto result = doc.load_file(path.c_str(), pugi::parse_default | pugi::parse_comments);
+            if (!result)
+                throw ImporterError(path, "Failed to parse XML: {}", result.description());
+
+            Mitsuba::XMLSource src{path.string(), doc};
+            Mitsuba::Properties props;
+            pugi::xml_node root = doc.document_element();
+            size_t argCounter = 0;
+            sceneID = Mitsuba::parseXML(src, ctx, root, Mitsuba::Tag::Invalid, props, argCounter).second;
+            meshLoadCount = shapeLoader.getPendingCount();
+        }
+
+        auto parseTime = CpuTimer::getCurrentTimePoint();
+
+        Mitsuba::BuilderContext builderCtx{builder, ctx.instances, {}, &shapeLoader};
         Mitsuba::buildScene(builderCtx, builderCtx.instances[sceneID]);
+
+        auto endTime = CpuTimer::getCurrentTimePoint();
+        double parseMs = CpuTimer::calcDuration(startTime, parseTime);
+        double fileMB = std::filesystem::file_size(path) / (1024.0 * 1024.0);
+        logInfo(
+            "MitsubaImporter: Parsed '{}' ({} objects, {} mesh files) in {:.1f} ms ({:.1f} MB/s), built scene in {:.1f} ms.",
+            path.filename().string(),
+            ctx.instances.size(),
+            meshLoadCount,
+            parseMs,
+            parseMs > 0.0 ? fileMB / (parseMs * 1e-3) : 0.0,
+            CpuTimer::calcDuration(parseTime, endTime)
+        );
     }
     catch (const RuntimeError& e)
     {
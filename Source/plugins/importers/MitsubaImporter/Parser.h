@@ -37,6 +37,7 @@
 
 #include <pugixml.hpp>
 
+#include <functional>
 #include <set>
 #include <map>
 #include <variant>
@@ -309,6 +310,9 @@ struct XMLContext
     size_t idCounter = 0;
     float4x4 transform;
     Resolver resolver;
+    /// Optional callback invoked as soon as an object element has been closed, i.e. after all its children have been parsed.
+    /// Used by the importer to start loading resources while the rest of the document is still being parsed.
+    std::function<void(const XMLObject&)> onObjectParsed;
 
     std::string offset(size_t location) { return fmt::format("{}", location); }
 };
@@ -746,6 +750,8 @@ std::pair<std::string, std::string> parseXML(
         // inst.offset = src.offset;
         // inst.src_id = src.id;
         inst.location = node.offset_debug();
+        if (ctx.onObjectParsed)
+            ctx.onObjectParsed(inst);
         return std::make_pair(name, id);
     }
     break;
@@ -62,7 +62,6 @@
 #include "Parser.h"
 #include "Builder.h"
 #include "Helpers.h"
-#include "LoopSubdivide.h"
 #include "EnvMapConverter.h"
 #include "Core/Error.h"
 #include "Core/API/Device.h"
@@ -72,6 +71,7 @@
 #include "Utils/Math/FalcorMath.h"
 #include "Utils/Math/FNVHash.h"
 #include "Scene/Importer.h"
+#include "Scene/LoopSubdivide.h"
 #include "Scene/Material/Material.h"
 #include "Scene/Material/StandardMaterial.h"
 #include "Scene/Material/RGLMaterial.h"
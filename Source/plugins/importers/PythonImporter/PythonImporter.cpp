@@ -60,19 +60,19 @@ static std::optional<std::string> parseLegacyHeader(const std::string& script)
 
 /// Set of currently imported paths, used to avoid recursion. TODO: REMOVEGLOBAL
 static std::set<std::filesystem::path> sImportPaths;
-/// Keeps track of how many recursive importers are in process. TODO: REMOVEGLOBAL
-static size_t sImportDepth;
 
 /**
  * This class is used to handle nested imports through RAII.
  * It keeps a set of import paths in sImportPaths to detect recursive imports.
  * It keeps a stack of import directories in sImportdirectories and updates the global data search directories.
  * It also keeps track of Settings, keeping them scoped to the individual scenes
+ * The previously active scene builder is restored on exit, nested imports can use a different builder (see SceneBuilder::fork()).
  */
 class ScopedImport
 {
 public:
-    ScopedImport(SceneBuilder& builder, const std::filesystem::path& path) : mBuilder(builder), mPath(path)
+    ScopedImport(SceneBuilder& builder, const std::filesystem::path& path)
+        : mBuilder(builder), mPath(path), mpPrevBuilder(getActivePythonSceneBuilder())
     {
         if (!path.empty())
         {
@@ -86,7 +86,6 @@ public:
 
         // Set global scene builder as workaround to support old Python API.
         setActivePythonSceneBuilder(&mBuilder);
-        sImportDepth++;
     }
     ~ScopedImport()
     {
@@ -98,15 +97,14 @@ public:
             mBuilder.popAssetResolver();
         }
 
-        // Unset global scene builder.
-        FALCOR_ASSERT(sImportDepth > 0);
-        if (--sImportDepth == 0)
-            setActivePythonSceneBuilder(nullptr);
+        // Restore global scene builder.
+        setActivePythonSceneBuilder(mpPrevBuilder);
     }
 
 private:
     SceneBuilder& mBuilder;
     std::filesystem::path mPath;
+    SceneBuilder* mpPrevBuilder;
 };
 
 static bool isRecursiveImport(const std::filesystem::path& path)
@@ -33,13 +33,15 @@
 #include "Scene/Material/HairMaterial.h"
 #include "Scene/Material/StandardMaterial.h"
 #include "Utils/Settings/Settings.h"
+#include "Utils/Timing/Tracer.h"
 #include "USDUtils/USDHelpers.h"
 #include "USDUtils/USDUtils.h"
 #include "USDUtils/USDScene1Utils.h"
 #include "USDUtils/Tessellator/Tessellation.h"
 #include "Utils/Settings/Settings.h"
+#include "Utils/JobSystem.h"
 
-#include <tbb/parallel_for.h>
+#include <algorithm>
 
 BEGIN_DISABLE_USD_WARNINGS
 #include <pxr/usd/usd/primRange.h>
@@ -1086,10 +1088,11 @@ namespace Falcor
         void addMeshesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
         {
             // Process collected mesh tasks.
-            tbb::parallel_for<size_t>(0, ctx.meshTasks.size(),
+            JobSystem::getGlobal().parallelFor(0, ctx.meshTasks.size(),
                 [&](size_t i)
                 {
                     FALCOR_ASSERT(ctx.meshTasks[i].sampleIdx == 0);
+                    FALCOR_TRACE_SCOPE("USDImporter::processMesh");
                     processMesh(ctx.meshes[ctx.meshTasks[i].meshId], ctx);
                 }
             );
@@ -1121,10 +1124,11 @@ namespace Falcor
                 }
 
                 // Process time-sampled mesh keyframes
-                tbb::parallel_for<size_t>(0, ctx.meshKeyframeTasks.size(),
+                JobSystem::getGlobal().parallelFor(0, ctx.meshKeyframeTasks.size(),
                     [&](size_t i)
                     {
                         auto& task = ctx.meshKeyframeTasks[i];
+                        FALCOR_TRACE_SCOPE("USDImporter::processMeshKeyframe");
                         processMeshKeyframe(ctx.meshes[task.meshId], task.meshId, task.sampleIdx, ctx);
                     }
                 );
@@ -1263,8 +1267,12 @@ namespace Falcor
         void addCurvesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
         {
             // Process collected curves.
-            tbb::parallel_for<size_t>(0, ctx.curves.size(),
-                [&](size_t i) { processCurve(ctx.curves[i], ctx); }
+            JobSystem::getGlobal().parallelFor(0, ctx.curves.size(),
+                [&](size_t i)
+                {
+                    FALCOR_TRACE_SCOPE("USDImporter::processCurve");
+                    processCurve(ctx.curves[i], ctx);
+                }
             );
 
             // Add processed curves or meshes (of the first keyframe) to scene builder.
@@ -1748,11 +1756,12 @@ namespace Falcor
                 break;
             }
 
-            tbb::parallel_for<size_t>(0, indexData.size(),
-                [&](size_t j)
+            isSameTopology = JobSystem::getGlobal().parallelReduce(0, indexData.size(), true,
+                [&](size_t begin, size_t end)
                 {
-                    isSameTopology |= (indexData[j] == refIndexData[j]);
-                }
+                    return std::equal(indexData.begin() + begin, indexData.begin() + end, refIndexData.begin() + begin);
+                },
+                [](bool a, bool b) { return a && b; }
             );
             if (!isSameTopology) break;
         }